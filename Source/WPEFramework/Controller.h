@@ -295,6 +295,7 @@ namespace Plugin {
         uint32_t endpoint_download(const Download& params);
         uint32_t endpoint_delete(const JsonData::Controller::DeleteParamsData& params);
         uint32_t endpoint_harakiri();
+        uint32_t endpoint_resetstatistics(const JsonData::Controller::ActivateParamsInfo& params);
         uint32_t get_status(const string& index, Core::JSON::ArrayType<PluginHost::MetaData::Service>& response) const;
         uint32_t get_links(Core::JSON::ArrayType<PluginHost::MetaData::Channel>& response) const;
         uint32_t get_processinfo(PluginHost::MetaData::Server& response) const;
@@ -303,6 +304,10 @@ namespace Plugin {
         uint32_t get_environment(const string& index, Core::JSON::String& response) const;
         uint32_t get_configuration(const string& index, Core::JSON::String& response) const;
         uint32_t set_configuration(const string& index, const Core::JSON::String& params);
+        uint32_t get_methods(const string& index, Core::JSON::ArrayType<PluginHost::MetaData::Method>& response) const;
+        uint32_t get_instrumentation(const string& index, Core::JSON::Boolean& response) const;
+        uint32_t set_instrumentation(const string& index, const Core::JSON::Boolean& params);
+        static uint32_t MethodHandler(const Core::ProxyType<PluginHost::Server::Service>& service, PluginHost::JSONRPC*& handler);
         void event_all(const string& callsign, const Core::JSON::String& data);
         void event_statechange(const string& callsign, const PluginHost::IShell::state& state, const PluginHost::IShell::reason& reason);
         void event_downloadcompleted(const uint32_t& result, const string& source, const string& destination);
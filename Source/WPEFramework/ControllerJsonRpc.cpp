@@ -22,6 +22,7 @@ namespace Plugin {
         Register<Download,void>(_T("download"), &Controller::endpoint_download, this);
         Register<DeleteParamsData,void>(_T("delete"), &Controller::endpoint_delete, this);
         Register<void,void>(_T("harakiri"), &Controller::endpoint_harakiri, this);
+        Register<ActivateParamsInfo,void>(_T("resetstatistics"), &Controller::endpoint_resetstatistics, this);
         Property<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(_T("status"), &Controller::get_status, nullptr, this);
         Property<Core::JSON::ArrayType<PluginHost::MetaData::Channel>>(_T("links"), &Controller::get_links, nullptr, this);
         Property<PluginHost::MetaData::Server>(_T("processinfo"), &Controller::get_processinfo, nullptr, this);
@@ -29,10 +30,13 @@ namespace Plugin {
         Property<Core::JSON::ArrayType<PluginHost::MetaData::Bridge>>(_T("discoveryresults"), &Controller::get_discoveryresults, nullptr, this);
         Property<Core::JSON::String>(_T("environment"), &Controller::get_environment, nullptr, this);
         Property<Core::JSON::String>(_T("configuration"), &Controller::get_configuration, &Controller::set_configuration, this);
+        Property<Core::JSON::ArrayType<PluginHost::MetaData::Method>>(_T("methods"), &Controller::get_methods, nullptr, this);
+        Property<Core::JSON::Boolean>(_T("instrumentation"), &Controller::get_instrumentation, &Controller::set_instrumentation, this);
     }
 
     void Controller::UnregisterAll()
     {
+        Unregister(_T("resetstatistics"));
         Unregister(_T("harakiri"));
         Unregister(_T("delete"));
         Unregister(_T("download"));
@@ -40,6 +44,8 @@ namespace Plugin {
         Unregister(_T("startdiscovery"));
         Unregister(_T("deactivate"));
         Unregister(_T("activate"));
+        Unregister(_T("instrumentation"));
+        Unregister(_T("methods"));
         Unregister(_T("configuration"));
         Unregister(_T("environment"));
         Unregister(_T("discoveryresults"));
@@ -409,6 +415,125 @@ namespace Plugin {
         return result;
     }
 
+    // Only services that dispatch through the PluginHost::JSONRPC handlers, keep per method statistics.
+    /* static */ uint32_t Controller::MethodHandler(const Core::ProxyType<PluginHost::Server::Service>& service, PluginHost::JSONRPC*& handler)
+    {
+        PluginHost::IDispatcher* dispatcher = service->Dispatcher();
+
+        handler = (dispatcher != nullptr ? dynamic_cast<PluginHost::JSONRPC*>(dispatcher) : nullptr);
+
+        return (handler != nullptr ? Core::ERROR_NONE : Core::ERROR_UNAVAILABLE);
+    }
+
+    // Method: resetstatistics - Restarts the method statistics of a service
+    // Return codes:
+    //  - ERROR_NONE: Success
+    //  - ERROR_UNKNOWN_KEY: The service does not exist
+    //  - ERROR_UNAVAILABLE: The service is not active or does not keep method statistics
+    uint32_t Controller::endpoint_resetstatistics(const ActivateParamsInfo& params)
+    {
+        uint32_t result = Core::ERROR_UNKNOWN_KEY;
+        Core::ProxyType<PluginHost::Server::Service> service;
+
+        ASSERT(_pluginServer != nullptr);
+
+        if (_pluginServer->Services().FromIdentifier(params.Callsign.Value(), service) == Core::ERROR_NONE) {
+            PluginHost::JSONRPC* handler;
+
+            ASSERT(service.IsValid());
+
+            if ((result = MethodHandler(service, handler)) == Core::ERROR_NONE) {
+                handler->ResetStatistics();
+            }
+        }
+
+        return result;
+    }
+
+    // Property: methods - Call statistics of the methods of a service
+    // Return codes:
+    //  - ERROR_NONE: Success
+    //  - ERROR_UNKNOWN_KEY: The service does not exist
+    //  - ERROR_UNAVAILABLE: The service is not active or does not keep method statistics
+    uint32_t Controller::get_methods(const string& index, Core::JSON::ArrayType<PluginHost::MetaData::Method>& response) const
+    {
+        uint32_t result = Core::ERROR_UNKNOWN_KEY;
+        Core::ProxyType<PluginHost::Server::Service> service;
+
+        ASSERT(_pluginServer != nullptr);
+
+        if (_pluginServer->Services().FromIdentifier(index, service) == Core::ERROR_NONE) {
+            PluginHost::JSONRPC* handler;
+
+            ASSERT(service.IsValid());
+
+            if ((result = MethodHandler(service, handler)) == Core::ERROR_NONE) {
+                Core::JSONRPC::Handler::Reports reports;
+
+                handler->Statistics(reports);
+
+                for (const std::pair<const string, Core::JSONRPC::Handler::Report>& entry : reports) {
+                    PluginHost::MetaData::Method& method(response.Add());
+
+                    method = entry.second;
+                    method.Name = entry.first;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // Property: instrumentation - Recording of method statistics of a service
+    // Return codes:
+    //  - ERROR_NONE: Success
+    //  - ERROR_UNKNOWN_KEY: The service does not exist
+    //  - ERROR_UNAVAILABLE: The service is not active or does not keep method statistics
+    uint32_t Controller::get_instrumentation(const string& index, Core::JSON::Boolean& response) const
+    {
+        uint32_t result = Core::ERROR_UNKNOWN_KEY;
+        Core::ProxyType<PluginHost::Server::Service> service;
+
+        ASSERT(_pluginServer != nullptr);
+
+        if (_pluginServer->Services().FromIdentifier(index, service) == Core::ERROR_NONE) {
+            PluginHost::JSONRPC* handler;
+
+            ASSERT(service.IsValid());
+
+            if ((result = MethodHandler(service, handler)) == Core::ERROR_NONE) {
+                response = handler->IsInstrumented();
+            }
+        }
+
+        return result;
+    }
+
+    // Property: instrumentation - Recording of method statistics of a service
+    // Return codes:
+    //  - ERROR_NONE: Success
+    //  - ERROR_UNKNOWN_KEY: The service does not exist
+    //  - ERROR_UNAVAILABLE: The service is not active or does not keep method statistics
+    uint32_t Controller::set_instrumentation(const string& index, const Core::JSON::Boolean& params)
+    {
+        uint32_t result = Core::ERROR_UNKNOWN_KEY;
+        Core::ProxyType<PluginHost::Server::Service> service;
+
+        ASSERT(_pluginServer != nullptr);
+
+        if (_pluginServer->Services().FromIdentifier(index, service) == Core::ERROR_NONE) {
+            PluginHost::JSONRPC* handler;
+
+            ASSERT(service.IsValid());
+
+            if ((result = MethodHandler(service, handler)) == Core::ERROR_NONE) {
+                handler->Instrumentation(params.Value());
+            }
+        }
+
+        return result;
+    }
+
     // Event: statechange - Signals a plugin state change
     void Controller::event_statechange(const string& callsign, const PluginHost::IShell::state& state, const PluginHost::IShell::reason& reason)
     {
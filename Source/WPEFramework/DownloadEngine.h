@@ -6,51 +6,369 @@
 namespace WPEFramework {
 namespace PluginHost {
 
-    class DownloadEngine : public Web::ClientTransferType<Core::SocketStream, Web::SignedFileBodyType<Crypto::SHA256>> {
+    // Downloads a file into the download storage and moves it to its destination once the SHA256
+    // of the content matches the expected one. The hash is calculated as the data comes in, the
+    // file is never read back to verify it.
+    // Every CheckpointInterval bytes the hash state is saved next to the storage (after the data
+    // it covers is flushed), so a download that is interrupted, even by a power cut, continues
+    // where it was with an HTTP Range request on the next Start of the same source and hash.
+    // If the size is known upfront, the file can be downloaded over several connections, each
+    // requesting its own range. The hash still has to be fed in order: the connection holding the
+    // start of what is not hashed yet hashes as it receives, the others only write. Once the front
+    // range is complete, the next one hashes what it already wrote (most likely still in the page
+    // cache) and continues hashing as it receives.
+    class DownloadEngine {
+    public:
+        static constexpr uint8_t MaxConnections = 8;
+        static constexpr uint32_t CheckpointInterval = 4 * 1024 * 1024;
+        static constexpr uint32_t MinimumRange = 1024 * 1024;
+
+        struct Range {
+            uint64_t _begin;
+            uint64_t _length; // 0 means up to the end of the file.
+            uint64_t _received;
+            uint32_t _result;
+            bool _done;
+        };
+
+        // The hash state of what is on storage, kept next to it to continue from.
+        class Checkpoint {
+        private:
+            static constexpr uint32_t Magic = 0x444C4350; // "DLCP"
+
+            // Followed by the source locator, in the file.
+            struct Header {
+                uint32_t _magic;
+                uint32_t _locatorLength;
+                uint64_t _offset;
+                uint8_t _hash[Crypto::HASH_SHA256];
+                Crypto::SHA256::Context _context;
+            };
+
+            Checkpoint() = delete;
+            Checkpoint(const Checkpoint&) = delete;
+            Checkpoint& operator=(const Checkpoint&) = delete;
+
+        public:
+            Checkpoint(const string& fileName)
+                : _fileName(fileName)
+            {
+            }
+            ~Checkpoint()
+            {
+            }
+
+        public:
+            inline const string& Name() const
+            {
+                return (_fileName);
+            }
+            // Returns the offset the saved state covers, 0 if there is none for this source and hash.
+            uint64_t Load(const string& source, const uint8_t hash[Crypto::HASH_SHA256], Crypto::SHA256::Context& context) const
+            {
+                uint64_t offset = 0;
+                Core::File file(_fileName);
+
+                if ((file.Size() > sizeof(Header)) && (file.Open() == true)) {
+                    Header info;
+
+                    if ((file.Read(reinterpret_cast<uint8_t*>(&info), sizeof(info)) == sizeof(info)) && (info._magic == Magic) && (info._locatorLength == source.length()) && (::memcmp(info._hash, hash, sizeof(info._hash)) == 0)) {
+                        string locator(info._locatorLength, '\0');
+
+                        if ((file.Read(reinterpret_cast<uint8_t*>(&(locator[0])), info._locatorLength) == info._locatorLength) && (locator == source)) {
+                            context = info._context;
+                            offset = info._offset;
+                        }
+                    }
+
+                    file.Close();
+                }
+
+                return (offset);
+            }
+            bool Save(const string& source, const uint8_t hash[Crypto::HASH_SHA256], const uint64_t offset, const Crypto::SHA256::Context& context) const
+            {
+                bool result = false;
+                Header info;
+                Core::File file(_fileName + _T(".new"), true);
+
+                ::memset(&info, 0, sizeof(info));
+                info._magic = Magic;
+                info._locatorLength = static_cast<uint32_t>(source.length());
+                info._offset = offset;
+                ::memcpy(info._hash, hash, sizeof(info._hash));
+                info._context = context;
+
+                if (file.Create() == true) {
+                    uint32_t length = file.Write(reinterpret_cast<const uint8_t*>(&info), sizeof(info));
+                    length += file.Write(reinterpret_cast<const uint8_t*>(source.c_str()), info._locatorLength);
+
+                    if ((length == (sizeof(info) + info._locatorLength)) && (file.SetSize(length) == true)) {
+                        Flush(file);
+
+                        // Replaces the previous checkpoint in one go.
+                        result = file.Move(_fileName);
+                    }
+                }
+
+                return (result);
+            }
+            void Destroy() const
+            {
+                Core::File(_fileName).Destroy();
+            }
+
+        private:
+            const string _fileName;
+        };
+
+        // Divides what is left after offset of a file of size bytes (0 if unknown) over at most the
+        // given number of connections.
+        static void Split(const uint64_t offset, const uint64_t size, const uint8_t connections, std::vector<Range>& ranges)
+        {
+            uint64_t left = (size > offset ? size - offset : 0);
+            uint8_t count = 1;
+
+            if ((size != 0) && (connections > 1)) {
+                // Ranges below the minimum do not win back the cost of a connection.
+                uint64_t parts = left / MinimumRange;
+
+                count = (connections > MaxConnections ? MaxConnections : connections);
+                count = (parts < count ? (parts == 0 ? 1 : static_cast<uint8_t>(parts)) : count);
+            }
+
+            ranges.resize(count);
+
+            for (uint8_t index = 0; index < count; index++) {
+                Range& range(ranges[index]);
+
+                range._begin = offset + ((left / count) * index);
+                range._length = (size == 0 ? 0 : (index == (count - 1) ? size - range._begin : left / count));
+                range._received = 0;
+                range._result = Core::ERROR_NONE;
+                range._done = false;
+            }
+        }
+
+        static void Flush(Core::File& file)
+        {
+#if defined(__LINUX__) && !defined(__APPLE__)
+            ::fdatasync(static_cast<Core::File::Handle>(file));
+#elif defined(__POSIX__)
+            ::fsync(static_cast<Core::File::Handle>(file));
+#endif
+        }
+
     private:
-        typedef Web::ClientTransferType<Core::SocketStream, Web::SignedFileBodyType<Crypto::SHA256>> BaseClass;
+        static constexpr uint16_t ReceiveBufferSize = 32 * 1024;
 
         DownloadEngine() = delete;
         DownloadEngine(const DownloadEngine&) = delete;
         DownloadEngine& operator=(const DownloadEngine&) = delete;
 
+        class Storage : public Web::FileBody {
+        private:
+            Storage(const Storage&) = delete;
+            Storage& operator=(const Storage&) = delete;
+
+        public:
+            Storage()
+                : Web::FileBody()
+                , _parent(nullptr)
+                , _index(0)
+            {
+            }
+            virtual ~Storage()
+            {
+            }
+
+        public:
+            inline Storage& operator=(const Core::File& RHS)
+            {
+                Web::FileBody::operator=(RHS);
+
+                return (*this);
+            }
+            void Link(DownloadEngine& parent, const uint8_t index)
+            {
+                _parent = &parent;
+                _index = index;
+            }
+
+        protected:
+            virtual uint32_t Deserialize() override
+            {
+                return (Web::FileBody::Deserialize());
+            }
+            virtual void Deserialize(const uint8_t stream[], const uint16_t maxLength) override
+            {
+                Web::FileBody::Deserialize(stream, maxLength);
+
+                _parent->Received(_index, stream, maxLength);
+            }
+
+        private:
+            DownloadEngine* _parent;
+            uint8_t _index;
+        };
+
+        class Connection : public Web::ClientTransferType<Core::SocketStream, Storage> {
+        private:
+            typedef Web::ClientTransferType<Core::SocketStream, Storage> BaseClass;
+
+            Connection() = delete;
+            Connection(const Connection&) = delete;
+            Connection& operator=(const Connection&) = delete;
+
+        public:
+            Connection(DownloadEngine& parent, const uint8_t index)
+                : BaseClass(false, Core::NodeId(_T("0.0.0.0")), Core::NodeId(), 1024, ReceiveBufferSize)
+                , _parent(parent)
+                , _index(index)
+            {
+                BaseClass::Body().Link(parent, index);
+            }
+            virtual ~Connection()
+            {
+            }
+
+        public:
+            uint32_t Start(const Core::URL& url, const string& storage, const uint64_t offset, const uint64_t length)
+            {
+                uint32_t result = Core::ERROR_OPENING_FAILED;
+                Core::File file(storage, true);
+
+                // The transfer writes through its own copy of the handle, at the position we leave it.
+                if ((file.Open(false) == true) && (file.Seek(offset) == true)) {
+                    result = BaseClass::Download(url, file, offset, length);
+                }
+
+                return (result);
+            }
+
+        private:
+            virtual bool Setup(const Core::URL& remote) override
+            {
+                bool result = false;
+
+                if (remote.Host().IsSet() == true) {
+                    uint16_t portNumber(remote.Port().IsSet() ? remote.Port().Value() : 80);
+
+                    BaseClass::Link().RemoteNode(Core::NodeId(remote.Host().Value().Text().c_str(), portNumber));
+
+                    result = true;
+                }
+                return (result);
+            }
+            virtual void Transfered(const uint32_t result, const Storage& /* file */) override
+            {
+                _parent.Completed(_index, result);
+            }
+
+        private:
+            DownloadEngine& _parent;
+            const uint8_t _index;
+        };
+
+        // The hash state at a moment, written to the checkpoint without holding up the receivers.
+        struct Snapshot {
+            uint32_t _session;
+            uint64_t _offset;
+            Crypto::SHA256::Context _context;
+        };
+
     public:
         DownloadEngine(const string& downloadStorage)
-            : BaseClass(false, Core::NodeId(_T("0.0.0.0")), Core::NodeId(), 1024, 1024)
-            , _storage(downloadStorage.c_str(), false)
+            : _adminLock()
+            , _checkpointLock()
+            , _storage(downloadStorage, true)
+            , _checkpoint(downloadStorage + _T(".checkpoint"))
+            , _current()
+            , _hash()
+            , _hashed(0)
+            , _checkpointed(0)
+            , _session(0)
+            , _saving(false)
+            , _catching(false)
+            , _size(0)
+            , _front(0)
+            , _ranges()
+            , _connections()
         {
         }
         virtual ~DownloadEngine()
         {
+            for (Connection* connection : _connections) {
+                delete connection;
+            }
         }
 
     public:
         uint32_t Start(const string& locator, const string& destination, const uint8_t hash[Crypto::HASH_SHA256])
+        {
+            return (Start(locator, destination, hash, 0, 1));
+        }
+
+        // With the size of the file, it can be downloaded over several connections.
+        uint32_t Start(const string& locator, const string& destination, const uint8_t hash[Crypto::HASH_SHA256], const uint64_t size, const uint8_t connections)
         {
             Core::URL url(locator);
             uint32_t result = (url.IsValid() == true ? Core::ERROR_INPROGRESS : Core::ERROR_INCORRECT_URL);
 
             if (result == Core::ERROR_INPROGRESS) {
+                uint8_t started = 0;
 
                 _adminLock.Lock();
 
                 if (_storage.IsOpen() == false) {
 
+                    _current._destination = destination;
+                    _current._source = locator;
+                    ::memcpy(_current._hash, hash, sizeof(_current._hash));
+
+                    uint64_t offset = Resume();
+
                     result = Core::ERROR_OPENING_FAILED;
 
-                    if (_storage.Create() == true) {
+                    if (_storage.IsOpen() == true) {
+                        Split(offset, size, connections, _ranges);
 
-                        result = Core::ERROR_NONE;
+                        uint8_t count = static_cast<uint8_t>(_ranges.size());
+
+                        _size = size;
+                        _front = 0;
 
-                        _current._destination = destination;
-                        _current._source = locator;
-                        ::memcpy(_current._hash, hash, sizeof(_current._hash));
+                        while (_connections.size() < count) {
+                            _connections.push_back(new Connection(*this, static_cast<uint8_t>(_connections.size())));
+                        }
 
-                        BaseClass::Download(url, _storage);
+                        result = Core::ERROR_NONE;
+                        started = count;
                     }
                 }
 
                 _adminLock.Unlock();
+
+                // Not under the lock: opening a connection waits for the socket thread, which in turn
+                // might wait for the lock to hand over data of a connection opened just before.
+                for (uint8_t index = 0; index < started; index++) {
+                    uint32_t code = _connections[index]->Start(url, _storage.Name(), _ranges[index]._begin, _ranges[index]._length);
+
+                    if (code != Core::ERROR_NONE) {
+                        if (index == 0) {
+                            // Nothing got going, so nothing will report.
+                            _adminLock.Lock();
+                            _storage.Close();
+                            _adminLock.Unlock();
+
+                            result = code;
+                            break;
+                        }
+
+                        // The ranges that did get going will report, this one never will.
+                        Completed(index, code);
+                    }
+                }
             }
 
             return (result);
@@ -59,30 +377,256 @@ namespace PluginHost {
         virtual void Transfered(const uint32_t result, const string& source, const string& destination) = 0;
 
     private:
-        virtual void Transfered(const uint32_t result, const Web::SignedFileBodyType<Crypto::SHA256>& destination) override
+        // Restores the hash of what a previous attempt of this download left behind, returns the
+        // offset to continue from and leaves the storage open.
+        uint64_t Resume()
+        {
+            Crypto::SHA256::Context context;
+            uint64_t offset = _checkpoint.Load(_current._source, _current._hash, context);
+
+            if ((offset != 0) && (_storage.Open(false) == true)) {
+                // Anything beyond the checkpoint is not covered by the hash, get it again.
+                if ((_storage.Size() >= offset) && (_storage.SetSize(offset) == true)) {
+                    _hash.State(context);
+                } else {
+                    _storage.Close();
+                    offset = 0;
+                }
+            } else {
+                offset = 0;
+            }
+
+            if (offset == 0) {
+                _checkpoint.Destroy();
+
+                _storage.Close();
+
+                if (_storage.Create() == true) {
+                    _storage.SetSize(0);
+                }
+                _hash.Reset();
+            } else {
+                TRACE_L1("Resuming the download of %s at %llu bytes", _current._source.c_str(), static_cast<unsigned long long>(offset));
+            }
+
+            _hashed = offset;
+            _checkpointed = offset;
+
+            return (offset);
+        }
+
+        // Everything up to the offset is on storage before the checkpoint claims it is. Called with
+        // the _checkpointLock taken.
+        bool Save(const uint64_t offset, const Crypto::SHA256::Context& context)
+        {
+            bool result = false;
+            Core::File storage(_storage.Name());
+
+            if (storage.Open(true) == true) {
+                Flush(storage);
+                storage.Close();
+
+                result = _checkpoint.Save(_current._source, _current._hash, offset, context);
+            }
+
+            return (result);
+        }
+
+        // Flushing takes its time, so the periodic checkpoints are written outside the _adminLock,
+        // the other connections keep on receiving meanwhile.
+        void Save(const Snapshot& snapshot)
         {
-            // Do you file magic stuff here, validate the hash and if it validates oke, move the file to the destination
-            // location. Depending on these actions, mofidy the resukt and notify the parent.
-            // For now we move on :-)
-            // TODO: Implement above sequence
-            Transfered(result, _current._source, _current._destination);
+            bool saved = false;
+
+            _checkpointLock.Lock();
+
+            // A download that ended meanwhile has written its final checkpoint, or removed it.
+            if (snapshot._session == _session) {
+                saved = Save(snapshot._offset, snapshot._context);
+            }
+
+            _checkpointLock.Unlock();
 
             _adminLock.Lock();
-            _storage.Close();
+
+            if ((saved == true) && (snapshot._session == _session)) {
+                _checkpointed = snapshot._offset;
+            }
+            _saving = false;
+
             _adminLock.Unlock();
         }
 
-        virtual bool Setup(const Core::URL& remote) override
+        void Received(const uint8_t index, const uint8_t stream[], const uint16_t length)
         {
-            bool result = false;
+            bool save = false;
+            Snapshot snapshot;
+
+            _adminLock.Lock();
+
+            Range& range(_ranges[index]);
+
+            // While the front range catches up, the thread doing so hashes this as well.
+            if ((index == _front) && (_catching == false)) {
+                ASSERT((range._begin + range._received) == _hashed);
+
+                _hash.Input(stream, length);
+                _hashed += length;
+
+                if (((_hashed - _checkpointed) >= CheckpointInterval) && (_saving == false)) {
+                    _saving = true;
+                    save = true;
+
+                    snapshot._session = _session;
+                    snapshot._offset = _hashed;
+                    snapshot._context = _hash.State();
+                }
+            }
+
+            range._received += length;
+
+            _adminLock.Unlock();
+
+            if (save == true) {
+                Save(snapshot);
+            }
+        }
+
+        void Completed(const uint8_t index, const uint32_t result)
+        {
+            bool finished = false;
+
+            _adminLock.Lock();
+
+            _ranges[index]._result = result;
+            _ranges[index]._done = true;
+
+            // Only one thread moves the front, the one catching up picks up what completed meanwhile.
+            if (_catching == false) {
+                _catching = true;
+
+                // As long as the front range is complete, the next one takes over the hashing.
+                while ((static_cast<size_t>(_front + 1) < _ranges.size()) && (_ranges[_front]._done == true) && (_ranges[_front]._result == Core::ERROR_NONE) && (_ranges[_front]._received == _ranges[_front]._length)) {
+                    _front++;
 
-            if (remote.Host().IsSet() == true) {
-                uint16_t portNumber(remote.Port().IsSet() ? remote.Port().Value() : 80);
+                    CatchUp(_ranges[_front]);
+                }
+
+                _catching = false;
+
+                finished = true;
+
+                for (const Range& range : _ranges) {
+                    finished = finished && range._done;
+                }
+            }
 
-                BaseClass::Link().RemoteNode(Core::NodeId(remote.Host().Value().Text().c_str(), portNumber));
+            if (finished == true) {
+                uint32_t status = Finish();
 
-                result = true;
+                _adminLock.Unlock();
+
+                Transfered(status, _current._source, _current._destination);
+            } else {
+                _adminLock.Unlock();
             }
+        }
+
+        // Hash what the range received while it was not at the front. Called with the _adminLock
+        // taken, it only decides what to read under it: reading and hashing is done without, so the
+        // other connections keep on receiving. The range itself might receive more meanwhile, it is
+        // caught up with until nothing is left.
+        void CatchUp(const Range& range)
+        {
+            ASSERT((_catching == true) && (range._begin == _hashed));
+
+            uint64_t hashed = 0;
+            bool complete = true;
+
+            while ((complete == true) && (range._received > hashed)) {
+                const uint64_t offset = range._begin + hashed;
+                const uint64_t length = range._received - hashed;
+                uint64_t done = 0;
+
+                _adminLock.Unlock();
+
+                Core::File file(_storage.Name());
+
+                if ((file.Open() == true) && (file.Seek(offset) == true)) {
+                    uint8_t buffer[16 * 1024];
+
+                    while (done < length) {
+                        uint32_t size = file.Read(buffer, static_cast<uint32_t>(std::min(length - done, static_cast<uint64_t>(sizeof(buffer)))));
+
+                        if (size == 0) {
+                            break;
+                        }
+
+                        _hash.Input(buffer, size);
+                        done += size;
+                    }
+                }
+
+                _adminLock.Lock();
+
+                _hashed += done;
+                hashed += done;
+                complete = (done == length);
+            }
+
+            // A short read leaves _hashed behind the range, the download is then incomplete.
+            ASSERT(complete == true);
+        }
+
+        uint32_t Finish()
+        {
+            uint32_t result = Core::ERROR_NONE;
+
+            for (const Range& range : _ranges) {
+                if (result == Core::ERROR_NONE) {
+                    result = range._result;
+                }
+            }
+
+            if ((result == Core::ERROR_NONE) && (_size != 0) && (_hashed != _size)) {
+                result = Core::ERROR_CONNECTION_CLOSED;
+            } else if ((result == Core::ERROR_NONE) || ((result == Core::ERROR_INVALID_RANGE) && (_ranges.size() == 1) && (_hashed != 0) && (_ranges[0]._received == 0))) {
+                // A resumed download that was complete already has nothing left to send, so its range
+                // is refused. Closing the hash ends it, only do so if this is the end.
+                if (::memcmp(_hash.Result(), _current._hash, sizeof(_current._hash)) == 0) {
+                    result = Core::ERROR_NONE;
+                } else if (result == Core::ERROR_NONE) {
+                    result = Core::ERROR_INCORRECT_HASH;
+                }
+            }
+
+            // Periodic checkpoints still underway are of this download, they should not land after this.
+            _checkpointLock.Lock();
+
+            _session++;
+
+            if (result == Core::ERROR_NONE) {
+                _storage.Close();
+
+                if (Core::File(_storage.Name()).Move(_current._destination) == false) {
+                    result = Core::ERROR_WRITE_ERROR;
+                }
+
+                _checkpoint.Destroy();
+            } else if ((result == Core::ERROR_INCORRECT_HASH) || (result == Core::ERROR_INVALID_RANGE)) {
+                // Nothing to resume from: the content is wrong, or the server does not do ranges.
+                _storage.Destroy();
+                _checkpoint.Destroy();
+            } else {
+                // Keep what is covered by the hash for the next attempt.
+                if ((_hashed != _checkpointed) && (Save(_hashed, _hash.State()) == true)) {
+                    _checkpointed = _hashed;
+                }
+                _storage.Close();
+            }
+
+            _checkpointLock.Unlock();
+
             return (result);
         }
 
@@ -91,10 +635,24 @@ namespace PluginHost {
             string _source;
             string _destination;
             uint8_t _hash[Crypto::HASH_SHA256];
-        } _current;
+        };
 
         Core::CriticalSection _adminLock;
+        Core::CriticalSection _checkpointLock;
         Core::File _storage;
+        Checkpoint _checkpoint;
+        DownloadInfo _current;
+        Crypto::SHA256 _hash;
+        uint64_t _hashed;
+        uint64_t _checkpointed;
+        uint32_t _session;
+        bool _saving;
+        // Set while a thread hashes what the front range received before it got to the front.
+        bool _catching;
+        uint64_t _size;
+        uint8_t _front;
+        std::vector<Range> _ranges;
+        std::vector<Connection*> _connections;
     };
 }
 }
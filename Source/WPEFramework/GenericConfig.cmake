@@ -16,6 +16,11 @@ set(PRIORITY 0 CACHE STRING "Change the nice level [-20 - 20]")
 set(POLICY 0 CACHE STRING "NA")
 set(OOMADJUST 0 CACHE STRING "Adapt the OOM score [-15 - 15]")
 set(STACKSIZE 0 CACHE STRING "Default stack size per thread")
+set(WORKERPOOL_MINIMUM 1 CACHE STRING "Minimum number of threads in the worker pool")
+set(WORKERPOOL_MAXIMUM 3 CACHE STRING "Maximum number of threads in the worker pool")
+set(WORKERPOOL_STACKSIZE 0 CACHE STRING "Stack size per worker pool thread, 0 uses the process stack size")
+set(WORKERPOOL_IDLETIME 30000 CACHE STRING "Time (ms) a worker thread may be idle before it is reaped")
+set(WORKERPOOL_LATENCY 100 CACHE STRING "Queue wait time (ms) that triggers an additional worker thread")
 
 map()
   key(plugins)
@@ -45,6 +50,16 @@ end()
 ans(PROCESS_CONFIG)
 map_append(${CONFIG} process ${PROCESS_CONFIG})
 
+map()
+    kv(minimum ${WORKERPOOL_MINIMUM})
+    kv(maximum ${WORKERPOOL_MAXIMUM})
+    kv(stacksize ${WORKERPOOL_STACKSIZE})
+    kv(idletime ${WORKERPOOL_IDLETIME})
+    kv(latency ${WORKERPOOL_LATENCY})
+end()
+ans(WORKERPOOL_CONFIG)
+map_append(${CONFIG} workerpool ${WORKERPOOL_CONFIG})
+
 map()
     kv(callsign Controller)
     key(configuration)
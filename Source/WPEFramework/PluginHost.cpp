@@ -537,6 +537,13 @@ namespace PluginHost {
                     }
                     printf("Pending:     %d\n", metaData.PendingRequests.Value());
                     printf("Occupation:  %d\n", metaData.PoolOccupation.Value());
+                    printf("Threads:     %d [%d-%d], peak %d\n", metaData.ThreadPoolRuns.Length(), metaData.Minimum.Value(), metaData.Maximum.Value(), metaData.Peak.Value());
+                    printf("Utilization: %d%%\n", metaData.Utilization.Value());
+                    printf("Latency [us]:       p50     p90     p99   p99.9\n");
+                    printf("  Queue wait:   %7u %7u %7u %7u\n", metaData.WaitTime.P50.Value(), metaData.WaitTime.P90.Value(), metaData.WaitTime.P99.Value(), metaData.WaitTime.P999.Value());
+                    printf("  Job run:      %7u %7u %7u %7u\n", metaData.RunTime.P50.Value(), metaData.RunTime.P90.Value(), metaData.RunTime.P99.Value(), metaData.RunTime.P999.Value());
+                    printf("  COM-RPC:      %7u %7u %7u %7u\n", metaData.COMRPC.P50.Value(), metaData.COMRPC.P90.Value(), metaData.COMRPC.P99.Value(), metaData.COMRPC.P999.Value());
+                    printf("  JSON-RPC:     %7u %7u %7u %7u\n", metaData.JSONRPC.P50.Value(), metaData.JSONRPC.P90.Value(), metaData.JSONRPC.P99.Value(), metaData.JSONRPC.P999.Value());
                     printf("Poolruns:\n");
                     while (index.Next() == true) {
                         printf("  Thread%02d:  %d\n", count++, index.Current().Value());
@@ -544,6 +551,34 @@ namespace PluginHost {
                     status->Release();
                     break;
                 }
+                case 'R': {
+                    RPC::CallTracer::MethodStatistics statistics;
+                    RPC::CallTracer::Instance().Statistics(statistics);
+
+                    printf("\nCOM-RPC call traces (in us):\n");
+                    printf("============================================================\n");
+                    printf("Interface  Method    Calls  RoundTrip p50/p99  Dispatch p50/p99\n");
+
+                    for (const std::pair<const std::pair<uint32_t, uint8_t>, RPC::CallTracer::Latencies>& entry : statistics) {
+                        printf("0x%08X %6d %8llu %9u/%-9u %8u/%u\n", entry.first.first, entry.first.second,
+                            static_cast<unsigned long long>(entry.second.RoundTrip.Count()),
+                            entry.second.RoundTrip.Percentile(50.0), entry.second.RoundTrip.Percentile(99.0),
+                            entry.second.Dispatch.Percentile(50.0), entry.second.Dispatch.Percentile(99.0));
+                    }
+
+                    string json;
+                    if (RPC::CallTracer::Export(tracePath, json) == Core::ERROR_NONE) {
+                        Core::File file(Core::Directory::Normalize(tracePath) + _T("comrpc.json"));
+
+                        if (file.Create() == true) {
+                            file.Write(reinterpret_cast<const uint8_t*>(json.c_str()), static_cast<uint32_t>(json.length()));
+                            printf("Chrome trace: %s\n", file.Name().c_str());
+                        }
+                    } else {
+                        printf("No traces, set %s=<N> to trace one out of every N calls.\n", COMRPC_TRACE_ENVIRONMENT);
+                    }
+                    break;
+                }
 #if !defined(__WIN32__) && !defined(__APPLE__)
                 case 'M': {
                     printf("\nMonitor callstack:\n");
@@ -571,7 +606,7 @@ namespace PluginHost {
 #endif
 
                 case '?':
-                    printf("\nOptions are: [P]lugins, [C]hannels, [S]erver stats, [M] Socket monitor stack, [0..8] Workerpool stack and [Q]uit\n\n");
+                    printf("\nOptions are: [P]lugins, [C]hannels, [S]erver stats, [R]PC call traces, [M] Socket monitor stack, [0..8] Workerpool stack and [Q]uit\n\n");
                     break;
 
                 default:
@@ -594,7 +594,7 @@ namespace PluginHost
 
     Server::Server(Server::Config & configuration, const bool background)
         : _accessor()
-        , _dispatcher(configuration.Process.IsSet() ? configuration.Process.StackSize.Value() : 0)
+        , _dispatcher(configuration.Process.IsSet() ? configuration.Process.StackSize.Value() : 0, configuration.WorkerPool)
         , _connections(*this, DetermineAccessor(configuration, _accessor), configuration.IdleTime)
         , _config(configuration.Version.Value(),
               DetermineProperModel(configuration.Model),
@@ -610,7 +610,7 @@ namespace PluginHost
               _accessor,
               Core::NodeId(configuration.Communicator.Value().c_str()),
               configuration.Redirect.Value())
-        , _services(*this, _config, configuration.Process.IsSet() ? configuration.Process.StackSize.Value() : 0)
+        , _services(*this, _config, configuration.Process.IsSet() ? configuration.Process.StackSize.Value() : 0, configuration.Process.IsSet() ? configuration.Process.Standby.Value() : 0)
         , _controller()
     {
 
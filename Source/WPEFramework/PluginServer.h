@@ -91,6 +91,7 @@ namespace PluginHost {
                     , Policy()
                     , StackSize(0)
                     , Umask(0003)
+                    , Standby(0)
                 {
                     Add(_T("user"), &User);
                     Add(_T("group"), &Group);
@@ -99,6 +100,7 @@ namespace PluginHost {
                     Add(_T("oomadjust"), &OOMAdjust);
                     Add(_T("stacksize"), &StackSize);
                     Add(_T("umask"), &Umask);
+                    Add(_T("standby"), &Standby);
                 }
                 ProcessSet(const ProcessSet& copy)
                     : Core::JSON::Container()
@@ -109,6 +111,7 @@ namespace PluginHost {
                     , Policy(copy.Policy)
                     , StackSize(copy.StackSize)
                     , Umask(copy.Umask)
+                    , Standby(copy.Standby)
                 {
                     Add(_T("user"), &User);
                     Add(_T("group"), &Group);
@@ -117,6 +120,7 @@ namespace PluginHost {
                     Add(_T("oomadjust"), &OOMAdjust);
                     Add(_T("stacksize"), &StackSize);
                     Add(_T("umask"), &Umask);
+                    Add(_T("standby"), &Standby);
                 }
                 ~ProcessSet()
                 {
@@ -131,6 +135,7 @@ namespace PluginHost {
                     OOMAdjust = RHS.OOMAdjust;
                     StackSize = RHS.StackSize;
                     Umask = RHS.Umask;
+                    Standby = RHS.Standby;
 
                     return (*this);
                 }
@@ -142,6 +147,8 @@ namespace PluginHost {
                 Core::JSON::EnumType<Core::ProcessInfo::scheduler> Policy;
                 Core::JSON::DecUInt32 StackSize;
                 Core::JSON::DecUInt16 Umask;
+                // The number of out-of-process hosts kept up and running, waiting for a plugin to be handed over.
+                Core::JSON::DecUInt8 Standby;
             };
 
             class InputConfig : public Core::JSON::Container {
@@ -180,6 +187,57 @@ namespace PluginHost {
                 Core::JSON::EnumType<PluginHost::InputHandler::type> Type;
             };
 
+            class WorkerPoolConfig : public Core::JSON::Container {
+            public:
+                WorkerPoolConfig()
+                    : Minimum(1)
+                    , Maximum(THREADPOOL_COUNT)
+                    , StackSize(0)
+                    , IdleTime(30000)
+                    , Latency(100)
+                {
+                    Add(_T("minimum"), &Minimum);
+                    Add(_T("maximum"), &Maximum);
+                    Add(_T("stacksize"), &StackSize);
+                    Add(_T("idletime"), &IdleTime);
+                    Add(_T("latency"), &Latency);
+                }
+                WorkerPoolConfig(const WorkerPoolConfig& copy)
+                    : Core::JSON::Container()
+                    , Minimum(copy.Minimum)
+                    , Maximum(copy.Maximum)
+                    , StackSize(copy.StackSize)
+                    , IdleTime(copy.IdleTime)
+                    , Latency(copy.Latency)
+                {
+                    Add(_T("minimum"), &Minimum);
+                    Add(_T("maximum"), &Maximum);
+                    Add(_T("stacksize"), &StackSize);
+                    Add(_T("idletime"), &IdleTime);
+                    Add(_T("latency"), &Latency);
+                }
+                ~WorkerPoolConfig()
+                {
+                }
+
+                WorkerPoolConfig& operator=(const WorkerPoolConfig& RHS)
+                {
+                    Minimum = RHS.Minimum;
+                    Maximum = RHS.Maximum;
+                    StackSize = RHS.StackSize;
+                    IdleTime = RHS.IdleTime;
+                    Latency = RHS.Latency;
+
+                    return (*this);
+                }
+
+                Core::JSON::DecUInt8 Minimum;
+                Core::JSON::DecUInt8 Maximum;
+                Core::JSON::DecUInt32 StackSize;
+                Core::JSON::DecUInt32 IdleTime;
+                Core::JSON::DecUInt32 Latency;
+            };
+
         public:
             Config()
                 : Version()
@@ -210,6 +268,7 @@ namespace PluginHost {
                 , DefaultTraceCategories(false)
                 , Process()
                 , Input()
+                , WorkerPool()
                 , Configs()
             {
                 // No IdleTime
@@ -232,6 +291,7 @@ namespace PluginHost {
                 Add(_T("redirect"), &Redirect);
                 Add(_T("process"), &Process);
                 Add(_T("input"), &Input);
+                Add(_T("workerpool"), &WorkerPool);
                 Add(_T("plugins"), &Plugins);
                 Add(_T("configs"), &Configs);
             }
@@ -260,6 +320,7 @@ namespace PluginHost {
             Core::JSON::String DefaultTraceCategories;
             ProcessSet Process;
             InputConfig Input;
+            WorkerPoolConfig WorkerPool;
             Core::JSON::String Configs;
             Core::JSON::ArrayType<Plugin::Config> Plugins;
         };
@@ -312,7 +373,7 @@ namespace PluginHost {
                 Core::ProxyType<Core::IDispatchType<void>> _job;
             };
 
-            typedef Core::ThreadPoolType<Core::Job, THREADPOOL_COUNT> ThreadPool;
+            typedef Core::DynamicThreadPoolType<Core::Job> ThreadPool;
 
         private:
             WorkerPoolImplementation() = delete;
@@ -320,9 +381,10 @@ namespace PluginHost {
             WorkerPoolImplementation& operator=(const WorkerPoolImplementation&) = delete;
 
         public:
-            WorkerPoolImplementation(const uint32_t stackSize)
-                : _workers(stackSize, _T("WorkerPoolImplementation"))
+            WorkerPoolImplementation(const uint32_t stackSize, const Config::WorkerPoolConfig& config)
+                : _workers(config.Minimum.Value(), config.Maximum.Value(), (config.StackSize.Value() != 0 ? config.StackSize.Value() : stackSize), config.IdleTime.Value(), config.Latency.Value(), _T("WorkerPoolImplementation"))
                 , _timer(stackSize, _T("WorkerTimer"))
+                , _jsonrpc()
             {
             }
             ~WorkerPoolImplementation()
@@ -363,15 +425,47 @@ namespace PluginHost {
             }
             virtual void GetMetaData(MetaData::Server& metaData) const override
             {
-                metaData.PendingRequests = _workers.Pending();
-                metaData.PoolOccupation = _workers.Active();
+                ThreadPool::Statistics statistics;
+                std::list<uint32_t> runs;
+
+                _workers.Collect(statistics, runs);
 
-                for (uint8_t teller = 0; teller < _workers.Count(); teller++) {
+                metaData.PendingRequests = statistics.Pending;
+                metaData.PoolOccupation = statistics.Active;
+                metaData.Minimum = _workers.Minimum();
+                metaData.Maximum = _workers.Maximum();
+                metaData.Peak = statistics.Peak;
+                metaData.Created = statistics.Created;
+                metaData.Reaped = statistics.Reaped;
+                metaData.Utilization = statistics.Utilization;
+
+                for (std::list<uint32_t>::const_iterator index(runs.begin()); index != runs.end(); index++) {
                     // Example of why copy-constructor and assignment constructor should be equal...
                     Core::JSON::DecUInt32 newElement;
-                    newElement = _workers[teller].Runs();
+                    newElement = *index;
                     metaData.ThreadPoolRuns.Add(newElement);
                 }
+                for (uint8_t teller = 0; teller < ThreadPool::Buckets; teller++) {
+                    Core::JSON::DecUInt32 newElement;
+                    newElement = statistics.QueueWait[teller];
+                    metaData.QueueWait.Add(newElement);
+                }
+
+                Core::Histogram::Snapshot wait, run, comrpc, jsonrpc;
+
+                _workers.Latencies(wait, run);
+                RPC::Administrator::Instance().RoundTrips(comrpc);
+                _jsonrpc.Merge(jsonrpc);
+
+                metaData.WaitTime = wait;
+                metaData.RunTime = run;
+                metaData.COMRPC = comrpc;
+                metaData.JSONRPC = jsonrpc;
+            }
+            // Time it took to handle a JSON-RPC message, in microseconds.
+            inline void Dispatched(const uint64_t duration)
+            {
+                _jsonrpc.Set(duration);
             }
             inline ::ThreadId ThreadId(const uint8_t index) const
             {
@@ -381,6 +475,7 @@ namespace PluginHost {
         private:
             ThreadPool _workers;
             Core::TimerType<TimedJob> _timer;
+            Core::Histogram _jsonrpc;
         };
 
     private:
@@ -1170,7 +1265,7 @@ namespace PluginHost {
                 CommunicatorServer& operator=(const CommunicatorServer&) = delete;
 
             public:
-                CommunicatorServer(const Core::NodeId& node, const string& persistentPath, const string& systemPath, const string& dataPath, const string& appPath, const string& proxyStubPath, const uint32_t stackSize)
+                CommunicatorServer(const Core::NodeId& node, const string& persistentPath, const string& systemPath, const string& dataPath, const string& appPath, const string& proxyStubPath, const uint32_t stackSize, const uint8_t standby)
                     : RPC::Communicator(node, Core::ProxyType<RPC::InvokeServerType<16, RPCPOOL_COUNT>>::Create(stackSize), proxyStubPath.empty() == false ? Core::Directory::Normalize(proxyStubPath) : proxyStubPath)
                     , _persistentPath(persistentPath.empty() == false ? Core::Directory::Normalize(persistentPath) : persistentPath)
                     , _systemPath(systemPath.empty() == false ? Core::Directory::Normalize(systemPath) : systemPath)
@@ -1190,6 +1285,10 @@ namespace PluginHost {
                         // We need to pass the communication channel NodeId via an environment variable, for process,
                         // not being started by the rpcprocess...
                         Core::SystemInfo::SetEnvironment(string(CommunicatorConnector), RPC::Communicator::Connector());
+
+                        if (standby > 0) {
+                            RPC::Communicator::Standby(RPC::Config(RPC::Communicator::Connector(), _application, _persistentPath, _systemPath, _dataPath, _appPath, _proxyStubPath), standby);
+                        }
                     }
                 }
                 virtual ~CommunicatorServer()
@@ -1463,13 +1562,13 @@ namespace PluginHost {
             };
 
         public:
-            ServiceMap(Server& server, PluginHost::Config& config, const uint32_t stackSize)
+            ServiceMap(Server& server, PluginHost::Config& config, const uint32_t stackSize, const uint8_t standby)
                 : _webbridgeConfig(config)
                 , _adminLock()
                 , _notificationLock()
                 , _services()
                 , _notifiers()
-                , _processAdministrator(config.Communicator(), config.PersistentPath(), config.SystemPath(), config.DataPath(), config.AppPath(), config.ProxyStubPath(), stackSize)
+                , _processAdministrator(config.Communicator(), config.PersistentPath(), config.SystemPath(), config.DataPath(), config.AppPath(), config.ProxyStubPath(), stackSize, standby)
                 , _server(server)
                 , _subSystems(this)
                 , _authenticationHandler(nullptr)
@@ -1829,7 +1928,9 @@ namespace PluginHost {
                             if ((_jsonrpc == true) && (_request->HasBody() == true)) {
                                 response = Factories::Instance().Response();
                                 Core::ProxyType<Core::JSONRPC::Message> message(_request->Body<Core::JSONRPC::Message>());
+                                uint64_t start = Core::Time::Monotonic();
                                 Core::ProxyType<Core::JSONRPC::Message> body = _service->Dispatcher()->Invoke(_ID, *message);
+                                _server->WorkerPool().Dispatched(Core::Time::Monotonic() - start);
                                 if (body.IsValid() == false) {
                                     response->ErrorCode = Web::STATUS_BAD_REQUEST;
                                 } else {
@@ -1938,7 +2039,9 @@ namespace PluginHost {
                                 ASSERT(message.IsValid() == true);
 
                                 if ((dispatcher != nullptr) && (message.IsValid() == true)) {
+                                    uint64_t start = Core::Time::Monotonic();
                                     _element = dispatcher->Invoke(_ID, *message);
+                                    _server->WorkerPool().Dispatched(Core::Time::Monotonic() - start);
                                 }
                             } else {
                                 _element = _service->Inbound(_ID, *_element);
@@ -86,23 +86,24 @@ namespace Process {
             MessageQueue& _handleQueue;
             std::atomic<uint8_t>& _runningFree;
         };
-        class AnnounceHandlerImplementation : public Core::IPCServerType<RPC::AnnounceMessage> {
+        template <typename MESSAGE>
+        class QueuedHandlerType : public Core::IPCServerType<MESSAGE> {
         private:
-            AnnounceHandlerImplementation() = delete;
-            AnnounceHandlerImplementation(const AnnounceHandlerImplementation&) = delete;
-            AnnounceHandlerImplementation& operator=(const AnnounceHandlerImplementation&) = delete;
+            QueuedHandlerType() = delete;
+            QueuedHandlerType(const QueuedHandlerType<MESSAGE>&) = delete;
+            QueuedHandlerType<MESSAGE>& operator=(const QueuedHandlerType<MESSAGE>&) = delete;
 
         public:
-            AnnounceHandlerImplementation(MessageQueue* queue)
+            QueuedHandlerType(MessageQueue* queue)
                 : _handleQueue(*queue)
             {
             }
-            virtual ~AnnounceHandlerImplementation()
+            virtual ~QueuedHandlerType()
             {
             }
 
         public:
-            virtual void Procedure(Core::IPCChannel& channel, Core::ProxyType<RPC::AnnounceMessage>& data)
+            virtual void Procedure(Core::IPCChannel& channel, Core::ProxyType<MESSAGE>& data)
             {
                 // Oke, see if we can reference count the IPCChannel
                 Info newElement;
@@ -124,8 +125,11 @@ namespace Process {
             , _runningFree(threads)
             , _handler(RPC::Administrator::Instance())
             , _invokeHandler(Core::ProxyType<InvokeHandlerImplementation>::Create(&_handleQueue, &_runningFree))
-            , _announceHandler(Core::ProxyType<AnnounceHandlerImplementation>::Create(&_handleQueue))
+            , _announceHandler(Core::ProxyType<QueuedHandlerType<RPC::AnnounceMessage>>::Create(&_handleQueue))
+            , _handoverHandler(Core::ProxyType<QueuedHandlerType<RPC::HandoverMessage>>::Create(&_handleQueue))
             , _announcements(nullptr)
+            , _handover(nullptr)
+            , _standby(false)
             , _minions()
         {
             for (uint8_t index = 1; index < threads; index++) {
@@ -161,17 +165,36 @@ namespace Process {
 
             _announcements = handler;
         }
+        Core::ProxyType<Core::IIPCServer> HandoverHandler()
+        {
+            return (_handoverHandler);
+        }
+        // A standby host keeps on processing, without any instance, till a plugin is handed over to it.
+        void Handover(Core::IPCServerType<RPC::HandoverMessage>* handler)
+        {
+            _handover = handler;
+            _standby = (handler != nullptr);
+        }
         void ProcessProcedures()
         {
             Core::ServiceAdministrator& admin(Core::ServiceAdministrator::Instance());
             Info newRequest;
 
-            while ((admin.Instances() > 0) && (_handleQueue.Extract(newRequest, Core::infinite) == true)) {
+            while (((admin.Instances() > 0) || (_standby == true)) && (_handleQueue.Extract(newRequest, Core::infinite) == true)) {
                 _runningFree--;
                 if (newRequest.message->Label() == RPC::InvokeMessage::Id()) {
                     Core::ProxyType<RPC::InvokeMessage> message(Core::proxy_cast<RPC::InvokeMessage>(newRequest.message));
 
                     _handler.Invoke(newRequest.channel, message);
+                } else if (newRequest.message->Label() == RPC::HandoverMessage::Id()) {
+                    ASSERT(_handover != nullptr);
+
+                    Core::ProxyType<RPC::HandoverMessage> message(Core::proxy_cast<RPC::HandoverMessage>(newRequest.message));
+
+                    _handover->Procedure(*(newRequest.channel), message);
+
+                    // From now on we live as long as the plugin does.
+                    _standby = false;
                 } else {
                     ASSERT(newRequest.message->Label() == RPC::AnnounceMessage::Id());
                     ASSERT(_announcements != nullptr);
@@ -197,14 +220,17 @@ namespace Process {
         RPC::Administrator& _handler;
         Core::ProxyType<Core::IPCServerType<RPC::InvokeMessage>> _invokeHandler;
         Core::ProxyType<Core::IPCServerType<RPC::AnnounceMessage>> _announceHandler;
+        Core::ProxyType<Core::IPCServerType<RPC::HandoverMessage>> _handoverHandler;
         Core::IPCServerType<RPC::AnnounceMessage>* _announcements;
+        Core::IPCServerType<RPC::HandoverMessage>* _handover;
+        std::atomic<bool> _standby;
         std::list<Minion> _minions;
     };
 
     class ConsoleOptions : public Core::Options {
     public:
         ConsoleOptions(int argumentCount, TCHAR* arguments[])
-            : Core::Options(argumentCount, arguments, _T("h:l:c:r:p:s:d:a:m:i:u:g:t:e:x:"))
+            : Core::Options(argumentCount, arguments, _T("h:l:c:r:p:s:d:a:m:i:u:g:t:e:x:w"))
             , Locator(nullptr)
             , ClassName(nullptr)
             , RemoteChannel(nullptr)
@@ -220,6 +246,7 @@ namespace Process {
             , Group(nullptr)
             , Threads(1)
             , EnabledLoggings(0)
+            , Standby(false)
         {
             Parse();
         }
@@ -243,6 +270,7 @@ namespace Process {
         const TCHAR* Group;
         uint8_t Threads;
         uint32_t EnabledLoggings;
+        bool Standby;
 
     private:
         virtual void Option(const TCHAR option, const TCHAR* argument)
@@ -293,6 +321,9 @@ namespace Process {
             case 't':
                 Threads = Core::NumberType<uint8_t>(Core::TextFragment(argument)).Value();
                 break;
+            case 'w':
+                Standby = true;
+                break;
             case 'h':
             default:
                 RequestUsage(true);
@@ -350,6 +381,65 @@ namespace Process {
 
         return (result);
     }
+
+    // A standby host (-w) is started without a plugin. Once the plugin is handed over, it is loaded as if it
+    // was passed on the command line.
+    class HandoverImplementation : public Core::IPCServerType<RPC::HandoverMessage> {
+    private:
+        HandoverImplementation() = delete;
+        HandoverImplementation(const HandoverImplementation&) = delete;
+        HandoverImplementation& operator=(const HandoverImplementation&) = delete;
+
+    public:
+        HandoverImplementation(ConsoleOptions& options)
+            : _options(options)
+            , _locator()
+            , _className()
+            , _persistentPath()
+            , _dataPath()
+        {
+        }
+        virtual ~HandoverImplementation()
+        {
+        }
+
+    public:
+        virtual void Procedure(Core::IPCChannel& channel, Core::ProxyType<RPC::HandoverMessage>& data) override
+        {
+            RPC::Data::Frame::Reader reader(data->Parameters().Reader());
+
+            _locator = reader.Text();
+            _className = reader.Text();
+            _options.InterfaceId = reader.Number<uint32_t>();
+            _options.Version = reader.Number<uint32_t>();
+            _persistentPath = reader.Text();
+            _dataPath = reader.Text();
+
+            _options.Locator = _locator.c_str();
+            _options.ClassName = _className.c_str();
+            _options.PersistentPath = (_persistentPath.empty() == false ? _persistentPath.c_str() : nullptr);
+            _options.DataPath = (_dataPath.empty() == false ? _dataPath.c_str() : nullptr);
+
+            TRACE_L1("Plugin %s handed over to standby process %d.", _options.ClassName, Core::ProcessInfo().Id());
+
+            void* result = AquireInterfaces(_options);
+
+            if (result != nullptr) {
+                Core::ProxyType<Core::IPCChannel> baseChannel(channel);
+
+                RPC::Administrator::Instance().RegisterInterface(baseChannel, result, _options.InterfaceId);
+            }
+
+            data->Response().Writer().Number<void*>(result);
+        }
+
+    private:
+        ConsoleOptions& _options;
+        string _locator;
+        string _className;
+        string _persistentPath;
+        string _dataPath;
+    };
 }
 } // Process
 
@@ -403,7 +493,7 @@ int main(int argc, char** argv)
 
     Process::ConsoleOptions options(argc, argv);
 
-    if ((options.RequestUsage() == true) || (options.Locator == nullptr) || (options.ClassName == nullptr) || (options.RemoteChannel == nullptr) || (options.Exchange == 0) ) {
+    if ((options.RequestUsage() == true) || ((options.Standby == false) && ((options.Locator == nullptr) || (options.ClassName == nullptr))) || (options.RemoteChannel == nullptr) || (options.Exchange == 0) ) {
         printf("Process [-h] \n");
         printf("         -l <locator>\n");
         printf("         -c <classname>\n");
@@ -419,7 +509,8 @@ int main(int argc, char** argv)
         printf("        [-d <data path>]\n");
         printf("        [-a <app path>]\n");
         printf("        [-m <proxy stub library path>]\n");
-        printf("        [-e <enabled SYSLOG categories>]\n\n");
+        printf("        [-e <enabled SYSLOG categories>]\n");
+        printf("        [-w] (standby, start without <locator> and <classname>, wait for them to be handed over)\n\n");
         printf("This application spawns a seperate process space for a plugin. The plugins");
         printf("are searched in the same order as they are done in process. Starting from:\n");
         printf(" 1) <persistent path>/<locator>\n");
@@ -447,7 +538,7 @@ int main(int argc, char** argv)
         if (remoteNode.IsValid()) {
             void* base = nullptr;
 
-            TRACE_L1("Spawning a new plugin %s.", options.ClassName);
+            TRACE_L1("Spawning a new plugin %s.", (options.Standby == false ? options.ClassName : _T("<< Standby >>")));
 
             // Firts make sure we apply the correct rights to our selves..
             if (options.User != nullptr) {
@@ -462,8 +553,11 @@ int main(int argc, char** argv)
             _invokeServer = Core::ProxyType<Process::InvokeServer>::Create(options.Threads);
             _server = (Core::ProxyType<RPC::CommunicatorClient>::Create(remoteNode, _invokeServer));
 
-            // Register an interface to handle incoming requests for interfaces.
-            if ((base = Process::AquireInterfaces(options)) != nullptr) {
+            Process::HandoverImplementation handover(options);
+
+            // Register an interface to handle incoming requests for interfaces. A standby process gets its
+            // plugin later on, it only prepares everything else.
+            if ((options.Standby == true) || ((base = Process::AquireInterfaces(options)) != nullptr)) {
                 TRACE_L1("Loading ProxyStubs from %s", (options.ProxyStubPath != nullptr ? options.ProxyStubPath : _T("<< No Proxy Stubs Loaded >>")));
 
                 if ((options.ProxyStubPath != nullptr) && (*(options.ProxyStubPath) != '\0')) {
@@ -481,6 +575,12 @@ int main(int argc, char** argv)
 
                 uint32_t result;
 
+                if (options.Standby == true) {
+                    _server->CreateFactory<RPC::HandoverMessage>(1);
+                    _server->Register(_invokeServer->HandoverHandler());
+                    _invokeServer->Handover(&handover);
+                }
+
                 // We have something to report back, do so...
                 if ((result = _server->Open((RPC::CommunicationTimeOut != Core::infinite ? 2 * RPC::CommunicationTimeOut : RPC::CommunicationTimeOut), options.InterfaceId, base, options.Exchange)) == Core::ERROR_NONE) {
                     TRACE_L1("Process up and running: %d.", Core::ProcessInfo().Id());
@@ -490,6 +590,11 @@ int main(int argc, char** argv)
                 } else {
                     TRACE_L1("Could not open the connection, error (%d)", result);
                 }
+
+                if (options.Standby == true) {
+                    _invokeServer->Handover(nullptr);
+                    _server->Unregister(_invokeServer->HandoverHandler());
+                }
             }
         }
     }
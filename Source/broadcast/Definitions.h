@@ -304,6 +304,10 @@ namespace Broadcast {
         // to process.
         virtual uint32_t Filter(const uint16_t pid, const uint8_t tableId, ISection* callback) = 0;
 
+        // Statistics of the section filtering. Sections that were dropped as unchanged repetitions, before a CRC
+        // check, count as hits, the sections that had to be checked and parsed count as misses.
+        virtual void Repeated(uint64_t& hits, uint64_t& misses) const = 0;
+
         // Using the next two methods, the frontends will be hooked up to decoders or file, and be removed from a decoder or file.
         virtual uint32_t Attach(const uint8_t index) = 0;
         virtual uint32_t Detach(const uint8_t index) = 0;
@@ -202,6 +202,85 @@ namespace Broadcast {
             private:
                 MPEG::Descriptor _data;
             };
+
+            class EXTERNAL ShortEvent {
+            private:
+                ShortEvent operator=(const ShortEvent& rhs) = delete;
+
+            public:
+                constexpr static uint8_t TAG = 0x4D;
+
+            public:
+                ShortEvent()
+                    : _data()
+                {
+                }
+                ShortEvent(const ShortEvent& copy)
+                    : _data(copy._data)
+                {
+                }
+                ShortEvent(const MPEG::Descriptor& copy)
+                    : _data(copy)
+                {
+                }
+                ~ShortEvent()
+                {
+                }
+
+            public:
+                // ISO 639-2 language code, 3 characters.
+                string Language() const
+                {
+                    return (Core::ToString(reinterpret_cast<const char*>(&(_data[0])), 3));
+                }
+                string Name() const
+                {
+                    return (Core::ToString(reinterpret_cast<const char*>(&(_data[4])), _data[3]));
+                }
+                string Text() const
+                {
+                    uint8_t offset = 3 /* language */ + 1 /* length */ + _data[3];
+                    return (_data[offset] == 0 ? string() : Core::ToString(reinterpret_cast<const char*>(&(_data[offset + 1])), _data[offset]));
+                }
+
+            private:
+                MPEG::Descriptor _data;
+            };
+
+            class EXTERNAL Content {
+            private:
+                Content operator=(const Content& rhs) = delete;
+
+            public:
+                constexpr static uint8_t TAG = 0x54;
+
+            public:
+                Content()
+                    : _data()
+                {
+                }
+                Content(const Content& copy)
+                    : _data(copy._data)
+                {
+                }
+                Content(const MPEG::Descriptor& copy)
+                    : _data(copy)
+                {
+                }
+                ~Content()
+                {
+                }
+
+            public:
+                // The first classification, content nibble level 1 (high) and level 2 (low).
+                uint8_t Genre() const
+                {
+                    return (_data.Length() > 2 ? _data[0] : 0);
+                }
+
+            private:
+                MPEG::Descriptor _data;
+            };
         }
     }
 }
@@ -4,6 +4,7 @@
 // ---- Include system wide include files ----
 
 // ---- Include local include files ----
+#include "Definitions.h"
 #include "MPEGDescriptor.h"
 #include "MPEGSection.h"
 #include "Module.h"
@@ -22,8 +23,14 @@ namespace Broadcast {
 
         class EXTERNAL EIT {
         public:
-            static const uint16_t ACTUAL = 0x42;
-            static const uint16_t OTHER = 0x46;
+            static const uint16_t PID = 0x12;
+            // Present/following information of the actual and of other transport streams.
+            static const uint16_t ACTUAL = 0x4E;
+            static const uint16_t OTHER = 0x4F;
+            // Schedule information, spread over 16 table ids each.
+            static const uint16_t SCHEDULE_ACTUAL = 0x50;
+            static const uint16_t SCHEDULE_OTHER = 0x60;
+            static const uint16_t SCHEDULE_LAST = 0x6F;
 
         public:
             enum running {
@@ -35,26 +42,26 @@ namespace Broadcast {
             };
 
         public:
-            class ServiceIterator {
+            class EventIterator {
             public:
-                ServiceIterator()
+                EventIterator()
                     : _info()
                     , _offset(~0)
                 {
                 }
-                ServiceIterator(const Core::DataElement& data)
+                EventIterator(const Core::DataElement& data)
                     : _info(data)
                     , _offset(~0)
                 {
                 }
-                ServiceIterator(const ServiceIterator& copy)
+                EventIterator(const EventIterator& copy)
                     : _info(copy._info)
                     , _offset(copy._offset)
                 {
                 }
-                ~ServiceIterator() {}
+                ~EventIterator() {}
 
-                ServiceIterator& operator=(const ServiceIterator& RHS)
+                EventIterator& operator=(const EventIterator& RHS)
                 {
                     _info = RHS._info;
                     _offset = RHS._offset;
@@ -63,58 +70,53 @@ namespace Broadcast {
                 }
 
             public:
-                inline bool IsValid() const { return (_offset < _info.Size()); }
+                inline bool IsValid() const { return ((static_cast<uint32_t>(_offset) + 12) <= _info.Size()); }
                 inline void Reset() { _offset = ~0; }
                 inline bool Next()
                 {
                     if (_offset == static_cast<uint16_t>(~0)) {
                         _offset = 0;
                     } else if (_offset < _info.Size()) {
-                        _offset += (DescriptorSize() + 5);
+                        _offset += (DescriptorSize() + 12);
                     }
 
                     return (IsValid());
                 }
-                inline bool EIT_PF() const
+                inline uint16_t EventId() const
                 {
-                    return ((_info[_offset + 2] & 0x01) != 0);
+                    return ((_info[_offset + 0] << 8) | _info[_offset + 1]);
                 }
-                inline bool EIT_Schedule() const
+                // Start time in seconds since the epoch (UTC).
+                inline uint32_t StartTime() const
                 {
-                    return ((_info[_offset + 2] & 0x02) != 0);
+                    // EXAMPLE: 93/10/13 12:45:00 is coded as "0xC079 124500", MJD 40587 is 1970/01/01.
+                    uint16_t MJD = (_info[_offset + 2] << 8) | _info[_offset + 3];
+
+                    return ((MJD > 40587 ? (MJD - 40587) * 86400 : 0) + Broadcast::ConvertBCD<uint32_t>(&(_info[_offset + 4]), 2, true) * 3600 + Broadcast::ConvertBCD<uint32_t>(&(_info[_offset + 5]), 2, true) * 60 + Broadcast::ConvertBCD<uint32_t>(&(_info[_offset + 6]), 2, true));
                 }
-                inline bool IsFreeToAir() const
+                // Duration in seconds.
+                inline uint32_t Duration() const
                 {
-                    return ((_info[_offset + 3] & 0x10) != 0);
+                    return (Broadcast::ConvertBCD<uint32_t>(&(_info[_offset + 7]), 2, true) * 3600 + Broadcast::ConvertBCD<uint32_t>(&(_info[_offset + 8]), 2, true) * 60 + Broadcast::ConvertBCD<uint32_t>(&(_info[_offset + 9]), 2, true));
                 }
                 inline running RunningMode() const
                 {
-                    return (static_cast<running>((_info[_offset + 3] & 0xE0) >> 5));
+                    return (static_cast<running>((_info[_offset + 10] & 0xE0) >> 5));
                 }
-                inline uint16_t ServiceId() const
+                inline bool IsFreeToAir() const
                 {
-                    return ((_info[_offset + 0] << 8) | _info[_offset + 1]);
+                    return ((_info[_offset + 10] & 0x10) == 0);
                 }
                 inline MPEG::DescriptorIterator Descriptors() const
                 {
                     return (MPEG::DescriptorIterator(
-                        Core::DataElement(_info, _offset + 5, DescriptorSize())));
-                }
-                inline uint8_t Services() const
-                {
-                    uint8_t count = 0;
-                    uint16_t offset = 0;
-                    while (offset < _info.Size()) {
-                        offset += (((_info[offset + 3] << 8) | _info[offset + 4]) & 0x0FFF) + 5;
-                        count++;
-                    }
-                    return (count);
+                        Core::DataElement(_info, _offset + 12, DescriptorSize())));
                 }
 
             private:
                 inline uint16_t DescriptorSize() const
                 {
-                    return ((_info[_offset + 3] << 8) | _info[_offset + 4]) & 0x0FFF;
+                    return ((_info[_offset + 10] << 8) | _info[_offset + 11]) & 0x0FFF;
                 }
 
             private:
@@ -125,22 +127,28 @@ namespace Broadcast {
         public:
             EIT()
                 : _data()
-                , _transportStreamId(~0)
+                , _serviceId(~0)
+                , _tableId(0)
+                , _version(~0)
+                , _sectionNumber(0)
             {
             }
-            EIT(const MPEG::Table& data)
-                : _data(data.Data())
-                , _transportStreamId(data.Extension())
-            {
-            }
-            EIT(const uint16_t transportStreamId, const Core::DataElement& data)
-                : _data(data)
-                , _transportStreamId(transportStreamId)
+            // The sections of an EIT are self contained, and the section numbers of a schedule have gaps
+            // between the segments. So an EIT is handled per section, not as a complete MPEG::Table.
+            EIT(const MPEG::Section& section)
+                : _data(section.Data())
+                , _serviceId(section.Extension())
+                , _tableId(section.TableId())
+                , _version(section.Version())
+                , _sectionNumber(section.SectionNumber())
             {
             }
             EIT(const EIT& copy)
                 : _data(copy._data)
-                , _transportStreamId(copy._transportStreamId)
+                , _serviceId(copy._serviceId)
+                , _tableId(copy._tableId)
+                , _version(copy._version)
+                , _sectionNumber(copy._sectionNumber)
             {
             }
             ~EIT() {}
@@ -148,33 +156,54 @@ namespace Broadcast {
             EIT& operator=(const EIT& rhs)
             {
                 _data = rhs._data;
-                _transportStreamId = rhs._transportStreamId;
+                _serviceId = rhs._serviceId;
+                _tableId = rhs._tableId;
+                _version = rhs._version;
+                _sectionNumber = rhs._sectionNumber;
                 return (*this);
             }
             bool operator==(const EIT& rhs) const
             {
-                return ((_transportStreamId == rhs._transportStreamId) && (_data == rhs._data));
+                return ((_serviceId == rhs._serviceId) && (_tableId == rhs._tableId) && (_sectionNumber == rhs._sectionNumber) && (_data == rhs._data));
             }
             bool operator!=(const EIT& rhs) const { return (!operator==(rhs)); }
 
         public:
             inline bool IsValid() const
             {
-                return ((_transportStreamId != static_cast<uint16_t>(~0)) && (_data.Size() >= 2));
+                return ((_serviceId != static_cast<uint16_t>(~0)) && (_tableId >= ACTUAL) && (_tableId <= SCHEDULE_LAST) && (_data.Size() >= 6));
+            }
+            inline bool IsActual() const
+            {
+                return ((_tableId == ACTUAL) || ((_tableId >= SCHEDULE_ACTUAL) && (_tableId < SCHEDULE_OTHER)));
+            }
+            inline bool IsPresentFollowing() const
+            {
+                return ((_tableId == ACTUAL) || (_tableId == OTHER));
+            }
+            inline uint16_t ServiceId() const { return (_serviceId); }
+            inline uint8_t TableId() const { return (_tableId); }
+            inline uint8_t Version() const { return (_version); }
+            inline uint8_t SectionNumber() const { return (_sectionNumber); }
+            uint16_t TransportStreamId() const
+            {
+                return (_data.GetNumber<uint16_t, Core::ENDIAN_BIG>(0));
             }
-            inline uint16_t TransportStreamId() const { return (_transportStreamId); }
             uint16_t OriginalNetworkId() const
             {
-                return (_data.GetNumber<uint16_t, Core::ENDIAN_BIG>(0) & 0x1FFF);
+                return (_data.GetNumber<uint16_t, Core::ENDIAN_BIG>(2));
             }
-            ServiceIterator Services() const
+            EventIterator Events() const
             {
-                return (ServiceIterator(Core::DataElement(_data, 3, _data.Size() - 3)));
+                return (EventIterator(Core::DataElement(_data, 6, _data.Size() - 6)));
             }
 
         private:
             Core::DataElement _data;
-            uint16_t _transportStreamId;
+            uint16_t _serviceId;
+            uint8_t _tableId;
+            uint8_t _version;
+            uint8_t _sectionNumber;
         };
 
     } // namespace DVB
@@ -0,0 +1,607 @@
+#include "EventStore.h"
+
+namespace WPEFramework {
+
+namespace Broadcast {
+
+    namespace {
+
+        constexpr uint32_t SnapshotMagic = 0x45504753; // "EPGS"
+        constexpr uint32_t SnapshotFormat = 1;
+
+        // The snapshot is the header, followed by the columns ordered on the size of their elements, so every
+        // column is aligned when the file is mapped:
+        //   uint64_t service[Rows], key[Sections]
+        //   uint32_t start[Rows], duration[Rows], language[Rows], title[Rows], text[Rows], events[Sections]
+        //   uint16_t eventId[Rows], owned[Owned]
+        //   uint8_t  flags[Rows], genre[Rows], version[Sections]
+        //   char     strings[Strings]
+        struct SnapshotHeader {
+            uint32_t Magic;
+            uint32_t Format;
+            uint32_t Rows;
+            uint32_t Sections;
+            uint32_t Owned;
+            uint32_t Strings;
+        };
+
+        uint64_t SnapshotSize(const SnapshotHeader& header)
+        {
+            return (sizeof(SnapshotHeader) + (static_cast<uint64_t>(header.Rows) * (8 + (5 * 4) + 2 + 1 + 1)) + (static_cast<uint64_t>(header.Sections) * (8 + 4 + 1)) + (static_cast<uint64_t>(header.Owned) * 2) + header.Strings);
+        }
+
+        template <typename TYPE>
+        void Write(uint8_t*& buffer, const TYPE& value)
+        {
+            ::memcpy(buffer, &value, sizeof(TYPE));
+            buffer += sizeof(TYPE);
+        }
+
+        template <typename TYPE>
+        void Write(uint8_t*& buffer, const std::vector<TYPE>& column)
+        {
+            if (column.empty() == false) {
+                ::memcpy(buffer, column.data(), column.size() * sizeof(TYPE));
+                buffer += column.size() * sizeof(TYPE);
+            }
+        }
+
+        template <typename TYPE>
+        void Write(uint8_t*& buffer, const std::vector<uint32_t>& rows, const std::vector<TYPE>& column)
+        {
+            for (const uint32_t row : rows) {
+                Write(buffer, column[row]);
+            }
+        }
+
+        template <typename TYPE>
+        void Read(const uint8_t*& buffer, std::vector<TYPE>& column, const uint32_t count)
+        {
+            column.resize(count);
+
+            if (count != 0) {
+                ::memcpy(column.data(), buffer, count * sizeof(TYPE));
+                buffer += count * sizeof(TYPE);
+            }
+        }
+    }
+
+    EventStore::EventStore()
+        : _service()
+        , _start()
+        , _duration()
+        , _language()
+        , _title()
+        , _text()
+        , _eventId()
+        , _flags()
+        , _genre()
+        , _owners()
+        , _free()
+        , _strings(1, '\0')
+        , _interned()
+        , _starts()
+        , _events()
+        , _sections()
+    {
+    }
+
+    EventStore::~EventStore()
+    {
+    }
+
+    bool EventStore::Load(const DVB::EIT& table)
+    {
+        if (table.IsValid() == false) {
+            return (false);
+        }
+
+        const uint64_t service = Service(table.OriginalNetworkId(), table.TransportStreamId(), table.ServiceId());
+
+        Sections::iterator section(_sections.find(Key(service, table.TableId(), table.SectionNumber())));
+
+        if ((section != _sections.end()) && (section->second.Version == table.Version())) {
+            return (false);
+        }
+
+        std::vector<uint16_t> previous;
+
+        if (section == _sections.end()) {
+            section = _sections.emplace(std::piecewise_construct,
+                                    std::forward_as_tuple(Key(service, table.TableId(), table.SectionNumber())),
+                                    std::forward_as_tuple())
+                          .first;
+        } else {
+            previous.swap(section->second.Events);
+        }
+
+        section->second.Version = table.Version();
+
+        std::vector<uint16_t>& owned(section->second.Events);
+        DVB::EIT::EventIterator events(table.Events());
+
+        while (events.Next() == true) {
+            const uint16_t eventId = events.EventId();
+
+            if (std::find(owned.begin(), owned.end(), eventId) != owned.end()) {
+                continue;
+            }
+
+            const uint32_t start = events.StartTime();
+            uint32_t language = 0;
+            uint32_t title = 0;
+            uint32_t text = 0;
+            uint8_t genre = 0;
+
+            MPEG::DescriptorIterator descriptors(events.Descriptors());
+
+            while (descriptors.Next() == true) {
+                const MPEG::Descriptor descriptor(descriptors.Current());
+
+                if ((descriptor.Tag() == DVB::Descriptors::ShortEvent::TAG) && (descriptor.Length() >= (2 + 5)) && (title == 0)) {
+                    DVB::Descriptors::ShortEvent info(descriptor);
+
+                    language = Intern(info.Language());
+                    title = Intern(info.Name());
+                    text = Intern(info.Text());
+                } else if ((descriptor.Tag() == DVB::Descriptors::Content::TAG) && (genre == 0)) {
+                    genre = DVB::Descriptors::Content(descriptor).Genre();
+                }
+            }
+
+            EventIndex::iterator entry(_events.find(std::pair<uint64_t, uint16_t>(service, eventId)));
+            uint32_t row;
+
+            if (entry != _events.end()) {
+                row = entry->second;
+
+                if (_start[row] != start) {
+                    std::pair<StartIndex::iterator, StartIndex::iterator> range(_starts.equal_range(std::pair<uint64_t, uint32_t>(service, _start[row])));
+
+                    while ((range.first != range.second) && (range.first->second != row)) {
+                        range.first++;
+                    }
+                    if (range.first != range.second) {
+                        _starts.erase(range.first);
+                    }
+                    _starts.emplace(std::pair<uint64_t, uint32_t>(service, start), row);
+                }
+
+                std::vector<uint16_t>::iterator index(std::find(previous.begin(), previous.end(), eventId));
+
+                if (index != previous.end()) {
+                    // This section owned it already.
+                    previous.erase(index);
+                } else {
+                    _owners[row]++;
+                }
+            } else {
+                if (_free.empty() == false) {
+                    row = _free.back();
+                    _free.pop_back();
+                } else {
+                    row = static_cast<uint32_t>(_service.size());
+
+                    _service.push_back(0);
+                    _start.push_back(0);
+                    _duration.push_back(0);
+                    _language.push_back(0);
+                    _title.push_back(0);
+                    _text.push_back(0);
+                    _eventId.push_back(0);
+                    _flags.push_back(0);
+                    _genre.push_back(0);
+                    _owners.push_back(0);
+                }
+
+                _service[row] = service;
+                _eventId[row] = eventId;
+                _owners[row] = 1;
+
+                _events.emplace(std::pair<uint64_t, uint16_t>(service, eventId), row);
+                _starts.emplace(std::pair<uint64_t, uint32_t>(service, start), row);
+            }
+
+            // The latest information on an event wins, whether it came from present/following or the schedule.
+            _start[row] = start;
+            _duration[row] = events.Duration();
+            _language[row] = language;
+            _title[row] = title;
+            _text[row] = text;
+            _flags[row] = (events.RunningMode() & 0x07) | (events.IsFreeToAir() == true ? 0x08 : 0x00);
+            _genre[row] = genre;
+
+            owned.push_back(eventId);
+        }
+
+        // Whatever the previous version carried and this one does not, is no longer owned by this section.
+        for (const uint16_t eventId : previous) {
+            Release(service, eventId);
+        }
+
+        return (true);
+    }
+
+    uint8_t EventStore::NowNext(const uint64_t service, const uint32_t time, Event& now, Event& next) const
+    {
+        uint8_t result = 0;
+        StartIndex::const_iterator index(_starts.upper_bound(std::pair<uint64_t, uint32_t>(service, time)));
+
+        if (index != _starts.begin()) {
+            StartIndex::const_iterator previous(std::prev(index));
+
+            if ((previous->first.first == service) && ((_start[previous->second] + _duration[previous->second]) > time)) {
+                Get(previous->second, now);
+                result |= NOW;
+            }
+        }
+
+        if ((index != _starts.end()) && (index->first.first == service)) {
+            Get(index->second, next);
+            result |= NEXT;
+        }
+
+        return (result);
+    }
+
+    uint32_t EventStore::Window(const uint64_t service, const uint32_t begin, const uint32_t end, Events& events) const
+    {
+        uint32_t count = 0;
+        StartIndex::const_iterator index(_starts.upper_bound(std::pair<uint64_t, uint32_t>(service, begin)));
+
+        if (index != _starts.begin()) {
+            StartIndex::const_iterator previous(std::prev(index));
+
+            // The event that started before the window, might still be running in it.
+            if ((previous->first.first == service) && ((_start[previous->second] + _duration[previous->second]) > begin)) {
+                index = previous;
+            }
+        }
+
+        while ((index != _starts.end()) && (index->first.first == service) && (index->first.second < end)) {
+            events.emplace_back();
+            Get(index->second, events.back());
+            count++;
+            index++;
+        }
+
+        return (count);
+    }
+
+    uint32_t EventStore::Window(const uint32_t begin, const uint32_t end, Events& events) const
+    {
+        uint32_t count = 0;
+        StartIndex::const_iterator index(_starts.begin());
+
+        while (index != _starts.end()) {
+            const uint64_t service = index->first.first;
+
+            count += Window(service, begin, end, events);
+
+            index = _starts.lower_bound(std::pair<uint64_t, uint32_t>(service + 1, 0));
+        }
+
+        return (count);
+    }
+
+    uint32_t EventStore::Expire(const uint32_t time)
+    {
+        std::vector<std::pair<uint64_t, uint16_t>> expired;
+
+        for (uint32_t row = 0; row < _owners.size(); row++) {
+            if ((_owners[row] != 0) && ((_start[row] + _duration[row]) < time)) {
+                expired.emplace_back(_service[row], _eventId[row]);
+                Free(row);
+            }
+        }
+
+        const uint32_t count = static_cast<uint32_t>(expired.size());
+
+        if (count != 0) {
+            std::sort(expired.begin(), expired.end());
+
+            // The sections no longer own what expired, else a next version of the section would release an event
+            // with the same id, that came in later.
+            for (std::pair<const SectionKey, Section>& entry : _sections) {
+                const uint64_t service = ServiceOf(entry.first);
+                std::vector<uint16_t>& events(entry.second.Events);
+
+                events.erase(std::remove_if(events.begin(), events.end(), [&](const uint16_t eventId) {
+                    return (std::binary_search(expired.begin(), expired.end(), std::pair<uint64_t, uint16_t>(service, eventId)));
+                }), events.end());
+            }
+
+            Compact();
+        }
+
+        return (count);
+    }
+
+    void EventStore::Clear()
+    {
+        _service.clear();
+        _start.clear();
+        _duration.clear();
+        _language.clear();
+        _title.clear();
+        _text.clear();
+        _eventId.clear();
+        _flags.clear();
+        _genre.clear();
+        _owners.clear();
+        _free.clear();
+        _strings.assign(1, '\0');
+        _interned.clear();
+        _starts.clear();
+        _events.clear();
+        _sections.clear();
+    }
+
+    uint32_t EventStore::Save(const string& fileName) const
+    {
+        SnapshotHeader header;
+
+        header.Magic = SnapshotMagic;
+        header.Format = SnapshotFormat;
+        header.Rows = static_cast<uint32_t>(_events.size());
+        header.Sections = static_cast<uint32_t>(_sections.size());
+        header.Owned = 0;
+        header.Strings = static_cast<uint32_t>(_strings.size());
+
+        for (const std::pair<const SectionKey, Section>& entry : _sections) {
+            header.Owned += static_cast<uint32_t>(entry.second.Events.size());
+        }
+
+        // Only the rows in use are saved, in the order of the event index.
+        std::vector<uint32_t> rows;
+        rows.reserve(header.Rows);
+
+        for (const std::pair<const std::pair<uint64_t, uint16_t>, uint32_t>& entry : _events) {
+            rows.push_back(entry.second);
+        }
+
+        const uint64_t size = SnapshotSize(header);
+        const string temporary(fileName + _T(".new"));
+
+        Core::File(temporary).Destroy();
+
+        uint32_t result = Core::ERROR_OPENING_FAILED;
+
+        {
+            Core::DataElementFile file(temporary, Core::DataElementFile::READABLE | Core::DataElementFile::WRITABLE | Core::DataElementFile::SHAREABLE | Core::DataElementFile::CREATE, static_cast<uint32_t>(size));
+
+            if ((file.IsValid() == true) && (file.Size() >= size)) {
+                uint8_t* buffer = file.Buffer();
+
+                Write(buffer, header);
+
+                Write(buffer, rows, _service);
+                for (const std::pair<const SectionKey, Section>& entry : _sections) {
+                    Write(buffer, entry.first);
+                }
+                Write(buffer, rows, _start);
+                Write(buffer, rows, _duration);
+                Write(buffer, rows, _language);
+                Write(buffer, rows, _title);
+                Write(buffer, rows, _text);
+                for (const std::pair<const SectionKey, Section>& entry : _sections) {
+                    Write(buffer, static_cast<uint32_t>(entry.second.Events.size()));
+                }
+                Write(buffer, rows, _eventId);
+                for (const std::pair<const SectionKey, Section>& entry : _sections) {
+                    Write(buffer, entry.second.Events);
+                }
+                Write(buffer, rows, _flags);
+                Write(buffer, rows, _genre);
+                for (const std::pair<const SectionKey, Section>& entry : _sections) {
+                    Write(buffer, entry.second.Version);
+                }
+                Write(buffer, _strings);
+
+                ASSERT(static_cast<uint64_t>(buffer - file.Buffer()) == size);
+
+                file.Sync();
+
+                result = Core::ERROR_NONE;
+            }
+        }
+
+        if (result == Core::ERROR_NONE) {
+            // Replace the previous snapshot only once the new one is complete.
+            if (Core::File(temporary).Move(fileName) == false) {
+                result = Core::ERROR_WRITE_ERROR;
+            }
+        } else {
+            TRACE_L1("Could not create the EPG snapshot %s", temporary.c_str());
+        }
+
+        return (result);
+    }
+
+    uint32_t EventStore::Restore(const string& fileName)
+    {
+        Core::DataElementFile file(fileName, Core::DataElementFile::READABLE);
+
+        if ((file.IsValid() == false) || (file.Size() < sizeof(SnapshotHeader))) {
+            return (Core::ERROR_UNAVAILABLE);
+        }
+
+        SnapshotHeader header;
+        const uint8_t* buffer = file.Buffer();
+
+        ::memcpy(&header, buffer, sizeof(header));
+        buffer += sizeof(header);
+
+        if ((header.Magic != SnapshotMagic) || (header.Format != SnapshotFormat) || (SnapshotSize(header) > file.Size()) || (header.Strings == 0)) {
+            TRACE_L1("EPG snapshot %s is not usable", fileName.c_str());
+            return (Core::ERROR_INVALID_SIGNATURE);
+        }
+
+        Clear();
+
+        std::vector<SectionKey> keys;
+        std::vector<uint32_t> counts;
+        std::vector<uint16_t> owned;
+        std::vector<uint8_t> versions;
+
+        Read(buffer, _service, header.Rows);
+        Read(buffer, keys, header.Sections);
+        Read(buffer, _start, header.Rows);
+        Read(buffer, _duration, header.Rows);
+        Read(buffer, _language, header.Rows);
+        Read(buffer, _title, header.Rows);
+        Read(buffer, _text, header.Rows);
+        Read(buffer, counts, header.Sections);
+        Read(buffer, _eventId, header.Rows);
+        Read(buffer, owned, header.Owned);
+        Read(buffer, _flags, header.Rows);
+        Read(buffer, _genre, header.Rows);
+        Read(buffer, versions, header.Sections);
+        Read(buffer, _strings, header.Strings);
+
+        // Never trust the string offsets to stay within the pool.
+        _strings.back() = '\0';
+
+        _owners.assign(header.Rows, 0);
+
+        for (uint32_t row = 0; row < header.Rows; row++) {
+            _language[row] = (_language[row] < header.Strings ? _language[row] : 0);
+            _title[row] = (_title[row] < header.Strings ? _title[row] : 0);
+            _text[row] = (_text[row] < header.Strings ? _text[row] : 0);
+
+            _events.emplace(std::pair<uint64_t, uint16_t>(_service[row], _eventId[row]), row);
+            _starts.emplace(std::pair<uint64_t, uint32_t>(_service[row], _start[row]), row);
+        }
+
+        uint32_t offset = 0;
+
+        for (uint32_t index = 0; index < header.Sections; index++) {
+            Section& section(_sections[keys[index]]);
+            const uint32_t count = std::min(counts[index], header.Owned - offset);
+
+            section.Version = versions[index];
+            section.Events.assign(owned.begin() + offset, owned.begin() + offset + count);
+            offset += count;
+
+            for (const uint16_t eventId : section.Events) {
+                EventIndex::const_iterator entry(_events.find(std::pair<uint64_t, uint16_t>(ServiceOf(keys[index]), eventId)));
+
+                if (entry != _events.end()) {
+                    _owners[entry->second]++;
+                }
+            }
+        }
+
+        // Events no section claims anymore, are not worth keeping.
+        for (uint32_t row = 0; row < header.Rows; row++) {
+            if (_owners[row] == 0) {
+                _owners[row] = 1;
+                Free(row);
+            }
+        }
+
+        uint32_t position = 1;
+
+        while (position < _strings.size()) {
+            const string text(&(_strings[position]));
+
+            _interned.emplace(text, position);
+            position += static_cast<uint32_t>(text.length()) + 1;
+        }
+
+        return (Core::ERROR_NONE);
+    }
+
+    uint32_t EventStore::Intern(const string& text)
+    {
+        uint32_t result = 0;
+
+        if (text.empty() == false) {
+            Interned::const_iterator index(_interned.find(text));
+
+            if (index != _interned.end()) {
+                result = index->second;
+            } else {
+                result = static_cast<uint32_t>(_strings.size());
+
+                _strings.insert(_strings.end(), text.begin(), text.end());
+                _strings.push_back('\0');
+
+                _interned.emplace(text, result);
+            }
+        }
+
+        return (result);
+    }
+
+    void EventStore::Get(const uint32_t row, Event& event) const
+    {
+        event.Service = _service[row];
+        event.EventId = _eventId[row];
+        event.Start = _start[row];
+        event.Duration = _duration[row];
+        event.Running = static_cast<DVB::EIT::running>(_flags[row] & 0x07);
+        event.FreeToAir = ((_flags[row] & 0x08) != 0);
+        event.Genre = _genre[row];
+        event.Language = Text(_language[row]);
+        event.Title = Text(_title[row]);
+        event.Text = Text(_text[row]);
+    }
+
+    void EventStore::Release(const uint64_t service, const uint16_t eventId)
+    {
+        EventIndex::iterator entry(_events.find(std::pair<uint64_t, uint16_t>(service, eventId)));
+
+        if (entry != _events.end()) {
+            const uint32_t row = entry->second;
+
+            ASSERT(_owners[row] != 0);
+
+            if (--_owners[row] == 0) {
+                _owners[row] = 1;
+                Free(row);
+            }
+        }
+    }
+
+    void EventStore::Free(const uint32_t row)
+    {
+        ASSERT(_owners[row] != 0);
+
+        std::pair<StartIndex::iterator, StartIndex::iterator> range(_starts.equal_range(std::pair<uint64_t, uint32_t>(_service[row], _start[row])));
+
+        while ((range.first != range.second) && (range.first->second != row)) {
+            range.first++;
+        }
+        if (range.first != range.second) {
+            _starts.erase(range.first);
+        }
+
+        _events.erase(std::pair<uint64_t, uint16_t>(_service[row], _eventId[row]));
+
+        _owners[row] = 0;
+        _language[row] = 0;
+        _title[row] = 0;
+        _text[row] = 0;
+        _free.push_back(row);
+    }
+
+    void EventStore::Compact()
+    {
+        // Strings of events that are gone are dropped, by interning the remaining ones in a new pool.
+        std::vector<char> strings(1, '\0');
+
+        strings.swap(_strings);
+        _interned.clear();
+
+        for (uint32_t row = 0; row < _owners.size(); row++) {
+            if (_owners[row] != 0) {
+                _language[row] = Intern(string(&(strings[_language[row]])));
+                _title[row] = Intern(string(&(strings[_title[row]])));
+                _text[row] = Intern(string(&(strings[_text[row]])));
+            }
+        }
+    }
+
+} // namespace Broadcast
+} // namespace WPEFramework
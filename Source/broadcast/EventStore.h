@@ -0,0 +1,152 @@
+#ifndef __EVENTSTORE_H
+#define __EVENTSTORE_H
+
+// ---- Include system wide include files ----
+
+// ---- Include local include files ----
+#include "Descriptors.h"
+#include "EIT.h"
+#include "Module.h"
+
+// ---- Referenced classes and types ----
+
+// ---- Helper types and constants ----
+
+// ---- Helper functions ----
+
+// ---- Class Definition ----
+
+namespace WPEFramework {
+namespace Broadcast {
+
+    // Storage for the events (EPG) received in EIT sections. The events are kept in columns, titles and
+    // texts in a pool of interned strings, so a full 7 day schedule of all services stays compact. Events
+    // are indexed by service and start time. A section that comes in with a new version replaces the
+    // events it delivered before. The store can be saved to and restored from a snapshot file, a flat
+    // image of the columns that is mapped in and copied, without any parsing.
+    // The store is not thread safe, the owner is expected to lock.
+    class EXTERNAL EventStore {
+    private:
+        EventStore(const EventStore&) = delete;
+        EventStore& operator=(const EventStore&) = delete;
+
+        // OriginalNetworkId(16)/TransportStreamId(16)/ServiceId(16)/TableId(8)/SectionNumber(8)
+        typedef uint64_t SectionKey;
+
+        struct Section {
+            uint8_t Version;
+            std::vector<uint16_t> Events;
+        };
+
+        typedef std::map<SectionKey, Section> Sections;
+        typedef std::multimap<std::pair<uint64_t, uint32_t>, uint32_t> StartIndex;
+        typedef std::map<std::pair<uint64_t, uint16_t>, uint32_t> EventIndex;
+        typedef std::map<string, uint32_t> Interned;
+
+    public:
+        enum found {
+            NOW = 0x01,
+            NEXT = 0x02
+        };
+
+        struct Event {
+            uint64_t Service;
+            uint16_t EventId;
+            // Seconds since the epoch (UTC).
+            uint32_t Start;
+            uint32_t Duration;
+            DVB::EIT::running Running;
+            bool FreeToAir;
+            // Content nibble level 1 (high) and level 2 (low), 0 if not classified.
+            uint8_t Genre;
+            string Language;
+            string Title;
+            string Text;
+        };
+
+        typedef std::vector<Event> Events;
+
+    public:
+        EventStore();
+        ~EventStore();
+
+    public:
+        // The key a service is stored with.
+        static inline uint64_t Service(const uint16_t originalNetworkId, const uint16_t transportStreamId, const uint16_t serviceId)
+        {
+            return ((static_cast<uint64_t>(originalNetworkId) << 32) | (static_cast<uint64_t>(transportStreamId) << 16) | serviceId);
+        }
+
+        // Returns true if the section changed the store, false if this version of the section is known already.
+        bool Load(const DVB::EIT& table);
+
+        // The event running at the given time, and the one after it. Returns which of the two are found.
+        uint8_t NowNext(const uint64_t service, const uint32_t time, Event& now, Event& next) const;
+        // All events of a service, or of all services, that overlap with [begin, end).
+        uint32_t Window(const uint64_t service, const uint32_t begin, const uint32_t end, Events& events) const;
+        uint32_t Window(const uint32_t begin, const uint32_t end, Events& events) const;
+
+        // Remove the events that ended before the given time.
+        uint32_t Expire(const uint32_t time);
+        void Clear();
+
+        inline uint32_t Count() const
+        {
+            return (static_cast<uint32_t>(_events.size()));
+        }
+        inline uint32_t StringPoolSize() const
+        {
+            return (static_cast<uint32_t>(_strings.size()));
+        }
+
+        uint32_t Save(const string& fileName) const;
+        uint32_t Restore(const string& fileName);
+
+    private:
+        static inline SectionKey Key(const uint64_t service, const uint8_t tableId, const uint8_t sectionNumber)
+        {
+            return ((service << 16) | (tableId << 8) | sectionNumber);
+        }
+        static inline uint64_t ServiceOf(const SectionKey key)
+        {
+            return (key >> 16);
+        }
+
+        uint32_t Intern(const string& text);
+        inline string Text(const uint32_t offset) const
+        {
+            return (string(&(_strings[offset])));
+        }
+        void Get(const uint32_t row, Event& event) const;
+        void Release(const uint64_t service, const uint16_t eventId);
+        void Free(const uint32_t row);
+        void Compact();
+
+    private:
+        // The columns, one entry per row. A row with no owners is free.
+        std::vector<uint64_t> _service;
+        std::vector<uint32_t> _start;
+        std::vector<uint32_t> _duration;
+        std::vector<uint32_t> _language;
+        std::vector<uint32_t> _title;
+        std::vector<uint32_t> _text;
+        std::vector<uint16_t> _eventId;
+        std::vector<uint8_t> _flags;
+        std::vector<uint8_t> _genre;
+        // The number of sections (present/following and schedule) that carry the event.
+        std::vector<uint8_t> _owners;
+        std::vector<uint32_t> _free;
+
+        // NUL terminated strings, offset 0 is the empty string.
+        std::vector<char> _strings;
+        Interned _interned;
+
+        StartIndex _starts;
+        EventIndex _events;
+        Sections _sections;
+    };
+
+} // namespace Broadcast
+} // namespace WPEFramework
+
+#endif // __EVENTSTORE_H
@@ -105,6 +105,127 @@ namespace Broadcast {
             Core::DataElement _section;
         };
 
+        // Remembers the sections received on a PID by table id, extension, section number, version and CRC.
+        // Carousels repeat unchanged sections every few seconds. A repeated section can then be dropped on its
+        // raw header, before the CRC is calculated and before it is offered to a Table again.
+        class EXTERNAL SectionCache {
+        private:
+            SectionCache(const SectionCache&) = delete;
+            SectionCache& operator=(const SectionCache&) = delete;
+
+            struct Entry {
+                uint32_t CRC;
+                // Version and current/next indicator, as they are in the section header.
+                uint8_t Version;
+            };
+
+            typedef std::map<uint32_t, Entry> Entries;
+
+        public:
+            SectionCache()
+                : _entries()
+                , _hits(0)
+                , _misses(0)
+            {
+            }
+            ~SectionCache() {}
+
+        public:
+            enum verdict {
+                ADMITTED,
+                REPEATED,
+                CORRUPTED
+            };
+
+        public:
+            // The path every backend takes, before a section is offered to a Table: a repeated section is dropped
+            // on its header, the others are CRC checked and, if valid, remembered.
+            inline verdict Admit(const Section& section, const uint8_t data[], const uint16_t length)
+            {
+                verdict result = REPEATED;
+
+                if (IsRepeated(data, length) == false) {
+                    if (section.IsValid() == false) {
+                        result = CORRUPTED;
+                    } else {
+                        Add(data, length);
+                        result = ADMITTED;
+                    }
+                }
+
+                return (result);
+            }
+            // Only sections with the section syntax can be cached, without it (TDT, TOT) the content changes
+            // with every transmission.
+            inline bool IsRepeated(const uint8_t section[], const uint16_t length)
+            {
+                bool result = false;
+
+                if (IsCachable(section, length) == true) {
+                    Entries::const_iterator index(_entries.find(Key(section)));
+
+                    result = ((index != _entries.end()) && (index->second.Version == section[5]) && (index->second.CRC == CRC(section, length)));
+
+                    if (result == true) {
+                        _hits++;
+                    } else {
+                        _misses++;
+                    }
+                }
+
+                return (result);
+            }
+            // Only add sections that passed the CRC check.
+            inline void Add(const uint8_t section[], const uint16_t length)
+            {
+                if (IsCachable(section, length) == true) {
+                    Entry& entry(_entries[Key(section)]);
+
+                    entry.CRC = CRC(section, length);
+                    entry.Version = section[5];
+                }
+            }
+            // Forget the sections of a table, so they are delivered again. A table id of 0 forgets all.
+            inline void Forget(const uint8_t tableId)
+            {
+                if (tableId == 0) {
+                    _entries.clear();
+                } else {
+                    Entries::iterator last(tableId == 0xFF ? _entries.end() : _entries.lower_bound(static_cast<uint32_t>(tableId + 1) << 24));
+
+                    _entries.erase(_entries.lower_bound(static_cast<uint32_t>(tableId) << 24), last);
+                }
+            }
+            inline uint64_t Hits() const
+            {
+                return (_hits);
+            }
+            inline uint64_t Misses() const
+            {
+                return (_misses);
+            }
+
+        private:
+            inline static bool IsCachable(const uint8_t section[], const uint16_t length)
+            {
+                return ((length >= 12) && ((section[1] & 0x80) != 0));
+            }
+            inline static uint32_t Key(const uint8_t section[])
+            {
+                // TableId(8)/Extension(16)/SectionNumber(8)
+                return ((static_cast<uint32_t>(section[0]) << 24) | (section[3] << 16) | (section[4] << 8) | section[6]);
+            }
+            inline static uint32_t CRC(const uint8_t section[], const uint16_t length)
+            {
+                return ((static_cast<uint32_t>(section[length - 4]) << 24) | (section[length - 3] << 16) | (section[length - 2] << 8) | section[length - 1]);
+            }
+
+        private:
+            Entries _entries;
+            uint64_t _hits;
+            uint64_t _misses;
+        };
+
         class EXTERNAL Table {
         private:
             Table() = delete;
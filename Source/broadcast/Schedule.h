@@ -4,6 +4,7 @@
 #include "Definitions.h"
 #include "Descriptors.h"
 #include "EIT.h"
+#include "EventStore.h"
 
 namespace WPEFramework {
 
@@ -56,8 +57,6 @@ namespace Broadcast {
             Parser(Schedules& parent, ITuner* source, const bool scan)
                 : _parent(parent)
                 , _source(source)
-                , _actual(Core::ProxyType<Core::DataStore>::Create(512))
-                , _others(Core::ProxyType<Core::DataStore>::Create(512))
             {
                 if (scan == true) {
                     Scan(true);
@@ -79,14 +78,8 @@ namespace Broadcast {
         public:
             void Scan(const bool scan)
             {
-                if (scan == true) {
-                    // Start loading the SDT info
-                    _source->Filter(0x11, DVB::EIT::ACTUAL, this);
-                    _source->Filter(0x11, DVB::EIT::OTHER, this);
-                } else {
-                    _source->Filter(0x11, DVB::EIT::OTHER, nullptr);
-                    _source->Filter(0x11, DVB::EIT::ACTUAL, nullptr);
-                }
+                // Start loading the EIT info, present/following and schedule, of all services.
+                _source->Filter(DVB::EIT::PID, 0, (scan == true ? this : nullptr));
             }
 
         private:
@@ -95,40 +88,43 @@ namespace Broadcast {
 
                 ASSERT(section.IsValid());
 
-                if (section.TableId() == DVB::EIT::ACTUAL) {
-                    _actual.AddSection(section);
-                    if (_actual.IsValid() == true) {
-                        _parent.Load(DVB::EIT(_actual));
-                    }
-                } else if (section.TableId() == DVB::EIT::OTHER) {
-                    _others.AddSection(section);
-                    if (_others.IsValid() == true) {
-                        _parent.Load(DVB::EIT(_others));
-                    }
+                // EIT sections are self contained, no need to collect them in a table first.
+                if ((section.TableId() >= DVB::EIT::ACTUAL) && (section.TableId() <= DVB::EIT::SCHEDULE_LAST)) {
+                    _parent.Load(DVB::EIT(section));
                 }
             }
 
         private:
             Schedules& _parent;
             ITuner* _source;
-            MPEG::Table _actual;
-            MPEG::Table _others;
         };
 
         typedef std::list<Parser> Scanners;
 
     public:
-        Schedules()
+        // With a storage location, the events are restored from it on construction and saved to it on destruction.
+        Schedules(const string& storage = string())
             : _adminLock()
             , _scanners()
             , _sink(*this)
             , _scan(true)
+            , _store()
+            , _storage(storage)
         {
+            if (_storage.empty() == false) {
+                _store.Restore(_storage);
+                _store.Expire(static_cast<uint32_t>(Core::Time::Now().Ticks() / Core::Time::TicksPerMillisecond / 1000));
+            }
+
             ITuner::Register(&_sink);
         }
         virtual ~Schedules()
         {
             ITuner::Unregister(&_sink);
+
+            if (_storage.empty() == false) {
+                _store.Save(_storage);
+            }
         }
 
     public:
@@ -147,6 +143,62 @@ namespace Broadcast {
             _adminLock.Unlock();
         }
 
+        // All times are in seconds since the epoch (UTC), services are identified by EventStore::Service().
+        uint8_t NowNext(const uint64_t service, const uint32_t time, EventStore::Event& now, EventStore::Event& next) const
+        {
+            _adminLock.Lock();
+
+            uint8_t result = _store.NowNext(service, time, now, next);
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        uint32_t Window(const uint64_t service, const uint32_t begin, const uint32_t end, EventStore::Events& events) const
+        {
+            _adminLock.Lock();
+
+            uint32_t result = _store.Window(service, begin, end, events);
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        uint32_t Window(const uint32_t begin, const uint32_t end, EventStore::Events& events) const
+        {
+            _adminLock.Lock();
+
+            uint32_t result = _store.Window(begin, end, events);
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        uint32_t Expire(const uint32_t time)
+        {
+            _adminLock.Lock();
+
+            uint32_t result = _store.Expire(time);
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        uint32_t Save() const
+        {
+            uint32_t result = Core::ERROR_UNAVAILABLE;
+
+            _adminLock.Lock();
+
+            if (_storage.empty() == false) {
+                result = _store.Save(_storage);
+            }
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+
     private:
         void Deactivated(ITuner* tuner)
         {
@@ -183,6 +235,8 @@ namespace Broadcast {
         {
             _adminLock.Lock();
 
+            _store.Load(table);
+
             _adminLock.Unlock();
         }
 
@@ -191,6 +245,8 @@ namespace Broadcast {
         Scanners _scanners;
         Sink _sink;
         bool _scan;
+        EventStore _store;
+        string _storage;
     };
 
 } // namespace Broadcast
@@ -0,0 +1,457 @@
+#include "TransportStream.h"
+
+namespace WPEFramework {
+namespace Broadcast {
+    namespace MPEG {
+
+        void Demultiplexer::Stream::Packet(const uint8_t packet[])
+        {
+            const uint8_t control = (packet[3] >> 4) & 0x03;
+            const uint8_t continuity = (packet[3] & 0x0F);
+
+            // Adaptation field only, nothing for us.
+            if ((control & 0x01) == 0) {
+                return;
+            }
+
+            if (_continuity != static_cast<uint8_t>(~0)) {
+                if (continuity == _continuity) {
+                    // A duplicate packet, we already have it.
+                    return;
+                } else if (continuity != ((_continuity + 1) & 0x0F)) {
+                    _parent._discontinuities++;
+                    _length = 0;
+                }
+            }
+
+            _continuity = continuity;
+
+            uint16_t offset = 4;
+
+            if ((control & 0x02) != 0) {
+                offset += 1 + packet[4];
+            }
+
+            if (offset >= PacketSize) {
+                return;
+            }
+
+            if ((packet[1] & 0x40) == 0) {
+                // Only the continuation of a section.
+                if (_length != 0) {
+                    Add(&(packet[offset]), PacketSize - offset, false);
+                }
+            } else {
+                const uint8_t pointer = packet[offset++];
+
+                // The end of the previous section comes before the first new one.
+                if ((_length != 0) && (pointer != 0) && ((offset + pointer) <= PacketSize)) {
+                    Add(&(packet[offset]), pointer, false);
+                }
+
+                _length = 0;
+                offset += pointer;
+
+                // Sections can follow each other in this packet, till the end or till the stuffing.
+                while (offset < PacketSize) {
+                    uint16_t used = Add(&(packet[offset]), PacketSize - offset, true);
+
+                    if (used == 0) {
+                        break;
+                    }
+
+                    offset += used;
+                }
+            }
+        }
+
+        uint16_t Demultiplexer::Stream::Add(const uint8_t data[], const uint16_t length, const bool start)
+        {
+            uint16_t used = 0;
+
+            if ((_length == 0) && ((start == false) || (data[0] == 0xFF))) {
+                // Not in a section, or only stuffing left.
+                return (0);
+            }
+
+            if (_length < 3) {
+                // The header tells the length of the section.
+                used = std::min(static_cast<uint16_t>(3 - _length), length);
+
+                ::memcpy(&(_buffer[_length]), data, used);
+                _length += used;
+
+                if (_length < 3) {
+                    return (used);
+                }
+
+                _expected = 3 + (((_buffer[1] & 0x0F) << 8) | _buffer[2]);
+
+                if (_expected > MaxSectionSize) {
+                    _parent._errors++;
+                    _length = 0;
+                    return (0);
+                }
+            }
+
+            uint16_t size = std::min(static_cast<uint16_t>(_expected - _length), static_cast<uint16_t>(length - used));
+
+            ::memcpy(&(_buffer[_length]), &(data[used]), size);
+            _length += size;
+            used += size;
+
+            if (_length == _expected) {
+                Completed();
+                _length = 0;
+            }
+
+            return (used);
+        }
+
+        void Demultiplexer::Stream::Completed()
+        {
+            const uint8_t tableId = _buffer[0];
+            const uint16_t extension = ((_buffer[1] & 0x80) != 0 ? ((_buffer[3] << 8) | _buffer[4]) : AnyExtension);
+
+            Filters::iterator index(_filters.begin());
+
+            while ((index != _filters.end()) && (((index->TableId != 0) && (index->TableId != tableId)) || ((index->Extension != AnyExtension) && (index->Extension != extension)))) {
+                index++;
+            }
+
+            // Nobody is interested.
+            if (index == _filters.end()) {
+                return;
+            }
+
+            const SectionCache::verdict verdict = _cache.Admit(Section(Core::DataElement(_expected, _buffer)), _buffer, _expected);
+
+            if (verdict == SectionCache::CORRUPTED) {
+                _parent._errors++;
+            } else if (verdict == SectionCache::ADMITTED) {
+                // One copy, for all callbacks that get this section.
+                const uint32_t offset = _parent.Store(_buffer, _expected);
+
+                _parent._sections++;
+
+                while (index != _filters.end()) {
+                    if (((index->TableId == 0) || (index->TableId == tableId)) && ((index->Extension == AnyExtension) || (index->Extension == extension))) {
+                        _parent.Schedule(_pid, *index, offset, _expected);
+                    }
+                    index++;
+                }
+            }
+        }
+
+        Demultiplexer::Demultiplexer()
+            : _dispatchLock()
+            , _adminLock()
+            , _carried(0)
+            , _packets(0)
+            , _sections(0)
+            , _errors(0)
+            , _discontinuities(0)
+            , _pending()
+            , _sectionData()
+        {
+            ::memset(_pids, 0, sizeof(_pids));
+            ::memset(_streams, 0, sizeof(_streams));
+        }
+
+        Demultiplexer::~Demultiplexer()
+        {
+            for (uint16_t pid = 0; pid <= MaxPid; pid++) {
+                if (_streams[pid] != nullptr) {
+                    delete _streams[pid];
+                }
+            }
+        }
+
+        uint32_t Demultiplexer::Filter(const uint16_t pid, const uint8_t tableId, ISection* callback)
+        {
+            return (Filter(pid, tableId, AnyExtension, callback));
+        }
+
+        uint32_t Demultiplexer::Filter(const uint16_t pid, const uint8_t tableId, const uint16_t extension, ISection* callback)
+        {
+            uint32_t result = Core::ERROR_UNKNOWN_KEY;
+
+            if (pid > MaxPid) {
+                return (Core::ERROR_INVALID_RANGE);
+            }
+
+            _dispatchLock.Lock();
+            _adminLock.Lock();
+
+            Stream* stream = _streams[pid];
+
+            if (callback != nullptr) {
+                if (stream == nullptr) {
+                    stream = new Stream(*this, pid);
+                    _streams[pid] = stream;
+                }
+
+                Stream::Filter filter;
+                filter.TableId = tableId;
+                filter.Extension = extension;
+                filter.Callback = callback;
+
+                stream->Subscribers().push_back(filter);
+                // A new subscriber needs the complete table, not just the changes.
+                stream->Cache().Forget(tableId);
+                _pids[pid >> 5] |= (1 << (pid & 0x1F));
+
+                result = Core::ERROR_NONE;
+            } else if (stream != nullptr) {
+                Stream::Filters& filters(stream->Subscribers());
+                Stream::Filters::iterator index(filters.begin());
+
+                while ((index != filters.end()) && ((index->TableId != tableId) || (index->Extension != extension))) {
+                    index++;
+                }
+
+                if (index != filters.end()) {
+                    // Sections collected for it, but not handed over yet, are not for it anymore.
+                    for (Pending& entry : _pending) {
+                        if ((entry.Callback == index->Callback) && (entry.Pid == pid) && (entry.TableId == tableId) && (entry.Extension == extension)) {
+                            entry.Callback = nullptr;
+                        }
+                    }
+
+                    filters.erase(index);
+                    result = Core::ERROR_NONE;
+
+                    if (filters.empty() == true) {
+                        _pids[pid >> 5] &= ~(1 << (pid & 0x1F));
+                        stream->Reset();
+                        stream->Cache().Forget(0);
+                    }
+                }
+            }
+
+            _adminLock.Unlock();
+            _dispatchLock.Unlock();
+
+            return (result);
+        }
+
+        void Demultiplexer::Deliver(const uint8_t stream[], const uint32_t length)
+        {
+            uint32_t offset = 0;
+
+            _dispatchLock.Lock();
+            _adminLock.Lock();
+
+            if (_carried != 0) {
+                // Complete the packet that was split over the previous and this chunk.
+                uint8_t size = static_cast<uint8_t>(std::min(static_cast<uint32_t>(PacketSize - _carried), length));
+
+                ::memcpy(&(_carry[_carried]), stream, size);
+                _carried += size;
+                offset = size;
+
+                if (_carried == PacketSize) {
+                    Packet(_carry);
+                    _carried = 0;
+                }
+            }
+
+            while ((offset + PacketSize) <= length) {
+                if (stream[offset] == SyncByte) {
+                    Packet(&(stream[offset]));
+                    offset += PacketSize;
+                } else {
+                    // Lost sync, look for the next sync byte.
+                    offset++;
+                }
+            }
+
+            if ((offset < length) && (stream[offset] == SyncByte)) {
+                _carried = static_cast<uint8_t>(length - offset);
+                ::memcpy(_carry, &(stream[offset]), _carried);
+            }
+
+            _adminLock.Unlock();
+
+            Dispatch();
+
+            _dispatchLock.Unlock();
+        }
+
+        void Demultiplexer::Reset()
+        {
+            _adminLock.Lock();
+
+            _carried = 0;
+
+            for (uint16_t pid = 0; pid <= MaxPid; pid++) {
+                if (_streams[pid] != nullptr) {
+                    _streams[pid]->Reset();
+                    _streams[pid]->Cache().Forget(0);
+                }
+            }
+
+            _adminLock.Unlock();
+        }
+
+        void Demultiplexer::Repeated(uint64_t& hits, uint64_t& misses) const
+        {
+            hits = 0;
+            misses = 0;
+
+            _adminLock.Lock();
+
+            for (uint16_t pid = 0; pid <= MaxPid; pid++) {
+                if (_streams[pid] != nullptr) {
+                    hits += _streams[pid]->Cache().Hits();
+                    misses += _streams[pid]->Cache().Misses();
+                }
+            }
+
+            _adminLock.Unlock();
+        }
+
+        uint32_t Demultiplexer::Store(const uint8_t section[], const uint16_t length)
+        {
+            const uint32_t offset = static_cast<uint32_t>(_sectionData.size());
+
+            _sectionData.insert(_sectionData.end(), section, section + length);
+
+            return (offset);
+        }
+
+        void Demultiplexer::Schedule(const uint16_t pid, const Stream::Filter& filter, const uint32_t offset, const uint16_t length)
+        {
+            Pending entry;
+
+            entry.Offset = offset;
+            entry.Callback = filter.Callback;
+            entry.Pid = pid;
+            entry.TableId = filter.TableId;
+            entry.Extension = filter.Extension;
+            entry.Length = length;
+
+            _pending.push_back(entry);
+        }
+
+        void Demultiplexer::Dispatch()
+        {
+            // By index, a callback that removes a filter clears its entries in between.
+            for (uint32_t index = 0; index < _pending.size(); index++) {
+                const Pending& entry(_pending[index]);
+
+                if (entry.Callback != nullptr) {
+                    const Section section(Core::DataElement(entry.Length, &(_sectionData[entry.Offset])));
+
+                    entry.Callback->Handle(section);
+                }
+            }
+
+            _pending.clear();
+            _sectionData.clear();
+        }
+
+        void Demultiplexer::Packet(const uint8_t packet[])
+        {
+            const uint16_t pid = ((packet[1] & 0x1F) << 8) | packet[2];
+
+            _packets++;
+
+            if (IsFiltered(pid) == true) {
+                if ((packet[1] & 0x80) != 0) {
+                    // Transport error indicator, whatever we were collecting is broken.
+                    _errors++;
+                    _streams[pid]->Reset();
+                } else {
+                    _streams[pid]->Packet(packet);
+                }
+            }
+        }
+
+        Feed::Feed(Demultiplexer& demultiplexer)
+            : Core::Thread(Core::Thread::DefaultStackSize(), _T("TransportStreamFeed"))
+            , _demultiplexer(demultiplexer)
+            , _descriptor(-1)
+            , _loop(false)
+            , _bytes(0)
+            , _end(false, true)
+        {
+        }
+
+        Feed::~Feed()
+        {
+            Close();
+        }
+
+        uint32_t Feed::Open(const string& source, const bool loop)
+        {
+            uint32_t result = Core::ERROR_ILLEGAL_STATE;
+
+            if (_descriptor == -1) {
+                _descriptor = ::open(source.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+
+                if (_descriptor == -1) {
+                    TRACE_L1("Could not open transport stream source %s, error: %d", source.c_str(), errno);
+                    result = Core::ERROR_OPENING_FAILED;
+                } else {
+                    _loop = loop;
+                    _bytes = 0;
+                    _end.ResetEvent();
+                    _demultiplexer.Reset();
+
+                    Run();
+
+                    result = Core::ERROR_NONE;
+                }
+            }
+
+            return (result);
+        }
+
+        uint32_t Feed::Close()
+        {
+            if (_descriptor != -1) {
+                Block();
+                Wait(Core::Thread::BLOCKED | Core::Thread::STOPPED, Core::infinite);
+
+                ::close(_descriptor);
+                _descriptor = -1;
+            }
+
+            return (Core::ERROR_NONE);
+        }
+
+        /* virtual */ uint32_t Feed::Worker()
+        {
+            uint32_t delay = 0;
+            struct pollfd slot;
+
+            slot.fd = _descriptor;
+            slot.events = POLLIN;
+            slot.revents = 0;
+
+            // Wake up now and then, to see if we should stop.
+            if (::poll(&slot, 1, 100) > 0) {
+                ssize_t size = ::read(_descriptor, _buffer, sizeof(_buffer));
+
+                if (size > 0) {
+                    _demultiplexer.Deliver(_buffer, static_cast<uint32_t>(size));
+                    _bytes += size;
+                } else if ((size == 0) || ((errno != EAGAIN) && (errno != EINTR) && (errno != EOVERFLOW))) {
+                    // EOVERFLOW: the dvr device could not keep up, we lost data but can continue.
+                    if ((size == 0) && (_loop == true) && (::lseek(_descriptor, 0, SEEK_SET) == 0)) {
+                        _demultiplexer.Reset();
+                    } else {
+                        Block();
+                        _end.SetEvent();
+                        delay = Core::infinite;
+                    }
+                }
+            }
+
+            return (delay);
+        }
+
+    } // namespace MPEG
+} // namespace Broadcast
+} // namespace WPEFramework
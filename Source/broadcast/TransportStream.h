@@ -0,0 +1,229 @@
+#ifndef __TRANSPORTSTREAM_H
+#define __TRANSPORTSTREAM_H
+
+// ---- Include system wide include files ----
+
+// ---- Include local include files ----
+#include "Definitions.h"
+#include "MPEGSection.h"
+#include "Module.h"
+
+// ---- Referenced classes and types ----
+
+// ---- Helper types and constants ----
+
+// ---- Helper functions ----
+
+// ---- Class Definition ----
+
+namespace WPEFramework {
+namespace Broadcast {
+    namespace MPEG {
+
+        // Software demultiplexer for PSI/SI. Transport stream packets are offered in chunks of any size,
+        // packets of PIDs that are not filtered are dropped after a single bit test. Sections are
+        // reassembled over the packets of their PID and handed, if the CRC is correct, to the callbacks
+        // with a matching table id and table id extension. Sections that are repeated unchanged are
+        // only handed over once.
+        // The callbacks are called once the offered chunk is demultiplexed, without the administration
+        // locked, so they can change the filters. Once a filter is removed, its callback is not called
+        // anymore. A callback should not offer stream data itself.
+        class EXTERNAL Demultiplexer {
+        private:
+            Demultiplexer(const Demultiplexer&) = delete;
+            Demultiplexer& operator=(const Demultiplexer&) = delete;
+
+        public:
+            static constexpr uint8_t PacketSize = 188;
+            static constexpr uint8_t SyncByte = 0x47;
+            static constexpr uint16_t MaxPid = 0x1FFF;
+            static constexpr uint16_t MaxSectionSize = 4096;
+            // Extension value that matches all sections of a table.
+            static constexpr uint16_t AnyExtension = NUMBER_MAX_UNSIGNED(uint16_t);
+
+        private:
+            class Stream {
+            private:
+                Stream() = delete;
+                Stream(const Stream&) = delete;
+                Stream& operator=(const Stream&) = delete;
+
+            public:
+                struct Filter {
+                    uint8_t TableId;
+                    uint16_t Extension;
+                    ISection* Callback;
+                };
+
+                typedef std::list<Filter> Filters;
+
+            public:
+                Stream(Demultiplexer& parent, const uint16_t pid)
+                    : _parent(parent)
+                    , _pid(pid)
+                    , _filters()
+                    , _cache()
+                    , _continuity(static_cast<uint8_t>(~0))
+                    , _length(0)
+                    , _expected(0)
+                {
+                }
+                ~Stream()
+                {
+                }
+
+            public:
+                inline Filters& Subscribers()
+                {
+                    return (_filters);
+                }
+                inline SectionCache& Cache()
+                {
+                    return (_cache);
+                }
+                inline void Reset()
+                {
+                    _continuity = static_cast<uint8_t>(~0);
+                    _length = 0;
+                }
+                void Packet(const uint8_t packet[]);
+
+            private:
+                // Returns the number of bytes used.
+                uint16_t Add(const uint8_t data[], const uint16_t length, const bool start);
+                void Completed();
+
+            private:
+                Demultiplexer& _parent;
+                const uint16_t _pid;
+                Filters _filters;
+                SectionCache _cache;
+                uint8_t _continuity;
+                uint16_t _length;
+                uint16_t _expected;
+                uint8_t _buffer[MaxSectionSize];
+            };
+
+            // A section for a callback, collected while demultiplexing.
+            struct Pending {
+                ISection* Callback;
+                uint16_t Pid;
+                uint8_t TableId;
+                uint16_t Extension;
+                uint32_t Offset;
+                uint16_t Length;
+            };
+
+        public:
+            Demultiplexer();
+            ~Demultiplexer();
+
+        public:
+            // A table id of 0 receives all tables on the PID, a nullptr callback removes the filter.
+            uint32_t Filter(const uint16_t pid, const uint8_t tableId, ISection* callback);
+            uint32_t Filter(const uint16_t pid, const uint8_t tableId, const uint16_t extension, ISection* callback);
+
+            inline bool IsFiltered(const uint16_t pid) const
+            {
+                return ((_pids[(pid & MaxPid) >> 5] & (1 << (pid & 0x1F))) != 0);
+            }
+
+            // Offer a part of a transport stream, packets may be split over consecutive calls.
+            void Deliver(const uint8_t stream[], const uint32_t length);
+
+            // Forget all partially received packets and sections, e.g. after a retune or a seek.
+            void Reset();
+
+            inline uint64_t Packets() const
+            {
+                return (_packets);
+            }
+            inline uint64_t Sections() const
+            {
+                return (_sections);
+            }
+            // Sections with a wrong CRC or packets flagged with a transport error.
+            inline uint64_t Errors() const
+            {
+                return (_errors);
+            }
+            inline uint64_t Discontinuities() const
+            {
+                return (_discontinuities);
+            }
+            // Sections that were dropped as they were received before (hits), or checked and handed over (misses).
+            void Repeated(uint64_t& hits, uint64_t& misses) const;
+
+        private:
+            void Packet(const uint8_t packet[]);
+            uint32_t Store(const uint8_t section[], const uint16_t length);
+            void Schedule(const uint16_t pid, const Stream::Filter& filter, const uint32_t offset, const uint16_t length);
+            void Dispatch();
+
+        private:
+            // Taken before the _adminLock, held while the callbacks are called.
+            Core::CriticalSection _dispatchLock;
+            mutable Core::CriticalSection _adminLock;
+            uint32_t _pids[(MaxPid + 1) / 32];
+            Stream* _streams[MaxPid + 1];
+            uint8_t _carry[PacketSize];
+            uint8_t _carried;
+            uint64_t _packets;
+            uint64_t _sections;
+            uint64_t _errors;
+            uint64_t _discontinuities;
+            std::vector<Pending> _pending;
+            std::vector<uint8_t> _sectionData;
+        };
+
+        // Reads a transport stream from a file descriptor into a demultiplexer: a DVB dvr device, a pipe or a
+        // file. A file is read as fast as possible, so captures can be replayed to test and benchmark the SI
+        // handling offline.
+        class EXTERNAL Feed : public Core::Thread {
+        private:
+            Feed() = delete;
+            Feed(const Feed&) = delete;
+            Feed& operator=(const Feed&) = delete;
+
+            static constexpr uint32_t ReadSize = (Demultiplexer::PacketSize * 348);
+
+        public:
+            Feed(Demultiplexer& demultiplexer);
+            ~Feed();
+
+        public:
+            // A looping source starts from the beginning again, once it is completely read.
+            uint32_t Open(const string& source, const bool loop = false);
+            uint32_t Close();
+
+            inline bool IsOpen() const
+            {
+                return (_descriptor != -1);
+            }
+            inline uint64_t Bytes() const
+            {
+                return (_bytes);
+            }
+            // Wait till a source that does not loop is completely read.
+            bool Completed(const uint32_t waitTime)
+            {
+                return (_end.Lock(waitTime) == Core::ERROR_NONE);
+            }
+
+        private:
+            virtual uint32_t Worker() override;
+
+        private:
+            Demultiplexer& _demultiplexer;
+            int _descriptor;
+            bool _loop;
+            std::atomic<uint64_t> _bytes;
+            Core::Event _end;
+            uint8_t _buffer[ReadSize];
+        };
+
+    } // namespace MPEG
+} // namespace Broadcast
+} // namespace WPEFramework
+
+#endif // __TRANSPORTSTREAM_H
@@ -5,6 +5,7 @@
 
 #include "Definitions.h"
 #include "Descriptors.h"
+#include "EventStore.h"
 #include "MPEGDescriptor.h"
 #include "MPEGSection.h"
 #include "MPEGTable.h"
@@ -15,6 +16,7 @@
 #include "Services.h"
 #include "TDT.h"
 #include "TimeDate.h"
+#include "TransportStream.h"
 
 #ifdef __WIN32__
 #pragma comment(lib, "broadcast.lib")
@@ -1,7 +1,9 @@
 #include "Definitions.h"
 #include "ProgramTable.h"
+#include "TransportStream.h"
 #include "TunerAdministrator.h"
 
+#include <linux/dvb/dmx.h>
 #include <linux/dvb/frontend.h>
 
 // --------------------------------------------------------------------
@@ -167,6 +169,8 @@ static constexpr conversion_entry _tableRollOff[] = {
                     , Modus(ITuner::Terrestrial)
                     , Scan(false)
                     , Callsign("Streamer")
+                    , Replay()
+                    , Loop(false)
                 {
                     Add(_T("frontends"), &Frontends);
                     Add(_T("decoders"), &Decoders);
@@ -175,6 +179,8 @@ static constexpr conversion_entry _tableRollOff[] = {
                     Add(_T("modus"), &Modus); 
                     Add(_T("scan"), &Scan);
                     Add(_T("callsign"), &Callsign);
+                    Add(_T("replay"), &Replay);
+                    Add(_T("loop"), &Loop);
                 }
                 ~Config()
                 {
@@ -188,6 +194,9 @@ static constexpr conversion_entry _tableRollOff[] = {
                 Core::JSON::EnumType<ITuner::modus> Modus; 
                 Core::JSON::Boolean Scan;
                 Core::JSON::String Callsign;
+                // Tune to a recorded transport stream (file or pipe), instead of a frontend.
+                Core::JSON::String Replay;
+                Core::JSON::Boolean Loop;
             };
 
             Information()
@@ -197,6 +206,8 @@ static constexpr conversion_entry _tableRollOff[] = {
                 , _modus()
                 , _type()
                 , _scan(false)
+                , _replay()
+                , _loop(false)
             {
             }
 
@@ -220,6 +231,8 @@ static constexpr conversion_entry _tableRollOff[] = {
                 _annex = config.Annex.Value();
                 _scan = config.Scan.Value();
                 _modus = config.Modus.Value();
+                _replay = config.Replay.Value();
+                _loop = config.Loop.Value();
 
                 _type = Convert(_tableSystemType, _standard | _modus | _annex, SYS_UNDEFINED);
 
@@ -252,6 +265,18 @@ static constexpr conversion_entry _tableRollOff[] = {
             {
                 return (_scan);
             }
+            inline bool IsReplay() const
+            {
+                return (_replay.empty() == false);
+            }
+            inline const string& Replay() const
+            {
+                return (_replay);
+            }
+            inline bool Loop() const
+            {
+                return (_loop);
+            }
 
         private:
             uint8_t _frontends;
@@ -260,6 +285,8 @@ static constexpr conversion_entry _tableRollOff[] = {
             ITuner::modus _modus;
             int _type;
             bool _scan;
+            string _replay;
+            bool _loop;
 
             static Information _instance;
         };
@@ -273,13 +300,19 @@ static constexpr conversion_entry _tableRollOff[] = {
             , _hierarchy()
             , _info({ 0 })
             , _callback(nullptr)
+            , _device(IndexToFrontend(index))
+            , _demultiplexer()
+            , _feed(_demultiplexer)
+            , _pids()
         {
             _callback = TunerAdministrator::Instance().Announce(this);
 printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
-            if (Tuner::Information::Instance().Type() != SYS_UNDEFINED) {
+            if (Tuner::Information::Instance().IsReplay() == true) {
+                ::strncpy(_info.name, "Replay", sizeof(_info.name));
+            } else if (Tuner::Information::Instance().Type() != SYS_UNDEFINED) {
                 char deviceName[32];
 
-                uint16_t info = IndexToFrontend(index);
+                uint16_t info = _device;
 
                 ::snprintf(deviceName, sizeof(deviceName), "/dev/dvb/adapter%d/frontend%d", (info >> 8), (info & 0xFF));
 
@@ -316,6 +349,13 @@ printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
 
             Detach(0);
 
+            _feed.Close();
+
+            for (std::pair<const uint16_t, int>& entry : _pids) {
+                close(entry.second);
+            }
+            _pids.clear();
+
             if (_frontend != -1) {
                 close(_frontend);
             }
@@ -346,7 +386,7 @@ printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
     public:
         bool IsValid() const
         {
-            return (_frontend != -1);
+            return ((_frontend != -1) || (Tuner::Information::Instance().IsReplay() == true));
         }
         const char* Name() const
         {
@@ -393,6 +433,21 @@ printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
         virtual uint32_t Tune(const uint16_t frequency, const Modulation modulation, const uint32_t symbolRate, const uint16_t fec, const SpectralInversion inversion) override
         {
             printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
+
+            if (Tuner::Information::Instance().IsReplay() == true) {
+                // Whatever is requested, the recording is what we are locked on to.
+                _feed.Close();
+
+                uint32_t result = _feed.Open(Tuner::Information::Instance().Replay(), Tuner::Information::Instance().Loop());
+
+                if (result == Core::ERROR_NONE) {
+                    _state = LOCKED;
+                    _callback->StateChange(this);
+                }
+
+                return (result);
+            }
+
             uint8_t propertyCount;
             
             struct dtv_property props[16];
@@ -428,6 +483,17 @@ printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
                 perror("ioctl");
             } else {
                 TRACE_L1("Tuning request send out !!!\n");
+
+                // Sections are taken from the dvr device, for the PIDs that are filtered.
+                if (_feed.IsOpen() == false) {
+                    char deviceName[32];
+
+                    ::snprintf(deviceName, sizeof(deviceName), "/dev/dvb/adapter%d/dvr0", (_device >> 8));
+
+                    _feed.Open(deviceName);
+                } else {
+                    _demultiplexer.Reset();
+                }
             }
 
             printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
@@ -449,7 +515,53 @@ printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
         virtual uint32_t Filter(const uint16_t pid, const uint8_t tableId, ISection* callback) override
         {
             printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
-            return 0;
+
+            uint32_t result = _demultiplexer.Filter(pid, tableId, callback);
+
+            if ((result == Core::ERROR_NONE) && (Tuner::Information::Instance().IsReplay() == false)) {
+                std::map<uint16_t, int>::iterator index(_pids.find(pid));
+
+                if (_demultiplexer.IsFiltered(pid) == false) {
+                    if (index != _pids.end()) {
+                        close(index->second);
+                        _pids.erase(index);
+                    }
+                } else if (index == _pids.end()) {
+                    // Have the demux device pass the packets of this PID to the dvr device.
+                    char deviceName[32];
+
+                    ::snprintf(deviceName, sizeof(deviceName), "/dev/dvb/adapter%d/demux0", (_device >> 8));
+
+                    int descriptor = open(deviceName, O_RDWR | O_CLOEXEC);
+
+                    if (descriptor == -1) {
+                        TRACE_L1("Can not open demux %s error: %d.", deviceName, errno);
+                    } else {
+                        struct dmx_pes_filter_params settings;
+
+                        ::memset(&settings, 0, sizeof(settings));
+                        settings.pid = pid;
+                        settings.input = DMX_IN_FRONTEND;
+                        settings.output = DMX_OUT_TS_TAP;
+                        settings.pes_type = DMX_PES_OTHER;
+                        settings.flags = DMX_IMMEDIATE_START;
+
+                        if (ioctl(descriptor, DMX_SET_PES_FILTER, &settings) == -1) {
+                            TRACE_L1("Can not set the filter for PID %d error: %d.", pid, errno);
+                            close(descriptor);
+                        } else {
+                            _pids.emplace(pid, descriptor);
+                        }
+                    }
+                }
+            }
+
+            return (result);
+        }
+
+        virtual void Repeated(uint64_t& hits, uint64_t& misses) const override
+        {
+            _demultiplexer.Repeated(hits, misses);
         }
 
         // Using the next two methods, the frontends will be hooked up to decoders or file, and be removed from a decoder or file.
@@ -472,6 +584,10 @@ printf("%s:%d %s\n", __FILE__, __LINE__, __FUNCTION__);
         int _hierarchy;
         struct dvb_frontend_info _info;
         TunerAdministrator::ICallback* _callback;
+        uint16_t _device;
+        MPEG::Demultiplexer _demultiplexer;
+        MPEG::Feed _feed;
+        std::map<uint16_t, int> _pids;
     };
 
     /* static */ Tuner::Information Tuner::Information::_instance;
@@ -431,6 +431,7 @@ namespace Broadcast {
                 , _pidChannel(nullptr)
                 , _messages(nullptr)
                 , _callback(nullptr)
+                , _cache()
             {
                 NEXUS_MessageSettings openSettings;
 
@@ -497,6 +498,14 @@ namespace Broadcast {
                 }
                 _adminLock.Lock();
                 _callback = nullptr;
+                _cache.Forget(0);
+                _adminLock.Unlock();
+            }
+            void Repeated(uint64_t& hits, uint64_t& misses) const
+            {
+                _adminLock.Lock();
+                hits += _cache.Hits();
+                misses += _cache.Misses();
                 _adminLock.Unlock();
             }
 
@@ -523,13 +532,17 @@ namespace Broadcast {
                         // Looks like the sections are rounded to 32 bits boundaries.
                         size_t sectionLength = ((newSection.Length() + 3) & (static_cast<size_t>(~0) ^ 0x03));
 
-                        if (newSection.IsValid() == true) {
-                            _adminLock.Lock();
-                            if (_callback != nullptr) {
-                                _callback->Handle(newSection);
-                            }
-                            _adminLock.Unlock();
-                        } else {
+                        _adminLock.Lock();
+
+                        MPEG::SectionCache::verdict verdict = _cache.Admit(newSection, &(data[handled]), static_cast<uint16_t>(std::min(static_cast<size_t>(newSection.Length()), sectionSize - handled)));
+
+                        if ((verdict == MPEG::SectionCache::ADMITTED) && (_callback != nullptr)) {
+                            _callback->Handle(newSection);
+                        }
+
+                        _adminLock.Unlock();
+
+                        if (verdict == MPEG::SectionCache::CORRUPTED) {
                             TRACE_L1("Invalid frame (%d - %d)!!!!\n", (sectionSize - handled), sectionLength);
                             DumpData(&(data[handled]), sectionSize - handled);
                         }
@@ -542,10 +555,11 @@ namespace Broadcast {
             }
 
         private:
-            Core::CriticalSection _adminLock;
+            mutable Core::CriticalSection _adminLock;
             NEXUS_PidChannelHandle _pidChannel;
             NEXUS_MessageHandle _messages;
             ISection* _callback;
+            MPEG::SectionCache _cache;
         };
 
         class Collector : public IMonitor, public ISection {
@@ -927,6 +941,16 @@ namespace Broadcast {
             return (result);
         }
 
+        virtual void Repeated(uint64_t& hits, uint64_t& misses) const override
+        {
+            hits = 0;
+            misses = 0;
+
+            for (Sections::const_iterator index(_sections.begin()); index != _sections.end(); index++) {
+                index->second.Repeated(hits, misses);
+            }
+        }
+
         // Using the next two methods, the frontends will be hooked up to decoders or file, and be removed from a decoder or file.
         virtual uint32_t Attach(const uint8_t index) override
         {
@@ -16,13 +16,16 @@ void printHelp(){
 
 int main(int argc, const char* argv[])
 {
+    // An optional recorded transport stream is replayed, instead of tuning a frontend.
+    const string replay = (argc > 1 ? string(", replay: \"") + argv[1] + "\"" : string());
+
     const string configuration = "{ \
         frontends:1, \
         decoders:1, \
         standard: \"DVB\" \
         annex: \"A\"\
         scan:true \
-        modus: \"Terrestrial\" \
+        modus: \"Terrestrial\"" + replay + " \
     }";
 
     const string information = "0";
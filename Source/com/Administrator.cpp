@@ -5,10 +5,12 @@ namespace WPEFramework {
 namespace RPC {
     Administrator::Administrator()
         : _adminLock()
-        , _stubs()
-        , _proxy()
+        , _interfaces()
+        , _overflow()
         , _factory(8)
-        , _channelProxyMap()
+        , _stripes()
+        , _channelReferenceMap()
+        , _roundTrips()
     {
     }
 
@@ -23,13 +25,49 @@ namespace RPC {
         return (systemAdministrator);
     }
 
+    void Administrator::Announce(const uint32_t id, ProxyStub::UnknownStub* stub, IMetadata* proxy)
+    {
+        _adminLock.Lock();
+
+        InterfaceEntry& entry(id < InterfaceSlots ? _interfaces[id] : _overflow[id]);
+
+        if (entry.Stub == nullptr) {
+            entry.Proxy = proxy;
+            entry.Stub = stub;
+        } else {
+            // The first announcement of an interface stays, as it did in the maps.
+            TRACE_L1("Interface 0x%X is announced more than once.", id);
+            delete stub;
+            delete proxy;
+        }
+
+        _adminLock.Unlock();
+    }
+
+    Administrator::InterfaceEntry Administrator::Overflow(const uint32_t id)
+    {
+        InterfaceEntry result = { nullptr, nullptr };
+
+        _adminLock.Lock();
+
+        std::map<uint32_t, InterfaceEntry>::const_iterator index(_overflow.find(id));
+
+        if (index != _overflow.end()) {
+            result = index->second;
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+
     void Administrator::AddRef(void* impl, const uint32_t interfaceId)
     {
         // stub are loaded before any action is taken and destructed if the process closes down, so no need to lock..
-        std::map<uint32_t, ProxyStub::UnknownStub*>::iterator index(_stubs.find(interfaceId));
+        ProxyStub::UnknownStub* stub(Stub(interfaceId));
 
-        if (index != _stubs.end()) {
-            Core::IUnknown* implementation(index->second->Convert(impl));
+        if (stub != nullptr) {
+            Core::IUnknown* implementation(stub->Convert(impl));
 
             ASSERT(implementation != nullptr);
 
@@ -45,10 +83,10 @@ namespace RPC {
     void Administrator::Release(void* impl, const uint32_t interfaceId)
     {
         // stub are loaded before any action is taken and destructed if the process closes down, so no need to lock..
-        std::map<uint32_t, ProxyStub::UnknownStub*>::iterator index(_stubs.find(interfaceId));
+        ProxyStub::UnknownStub* stub(Stub(interfaceId));
 
-        if (index != _stubs.end()) {
-            Core::IUnknown* implementation(index->second->Convert(impl));
+        if (stub != nullptr) {
+            Core::IUnknown* implementation(stub->Convert(impl));
 
             ASSERT(implementation != nullptr);
 
@@ -78,57 +116,110 @@ namespace RPC {
         uint32_t interfaceId(message->Parameters().InterfaceId());
 
         // stub are loaded before any action is taken and destructed if the process closes down, so no need to lock..
-        std::map<uint32_t, ProxyStub::UnknownStub*>::iterator index(_stubs.find(interfaceId));
+        ProxyStub::UnknownStub* stub(Stub(interfaceId));
 
-        if (index != _stubs.end()) {
-            uint32_t methodId(message->Parameters().MethodId());
-            index->second->Handle(methodId, channel, message);
+        if (message->Parameters().IsTraced() == false) {
+            if (stub != nullptr) {
+                uint32_t methodId(message->Parameters().MethodId());
+                stub->Handle(methodId, channel, message);
+            } else {
+                // Oops this is an unknown interface, Do not think this could happen.
+                TRACE_L1("Unknown interface. %d", interfaceId);
+            }
         } else {
-            // Oops this is an unknown interface, Do not think this could happen.
-            TRACE_L1("Unknown interface. %d", interfaceId);
+            uint32_t traceId;
+            uint64_t sent;
+            uint64_t received = CallTracer::Timestamp();
+
+            message->Parameters().Untrace(traceId, sent);
+
+            if (stub != nullptr) {
+                uint32_t methodId(message->Parameters().MethodId());
+                stub->Handle(methodId, channel, message);
+            } else {
+                TRACE_L1("Unknown interface. %d", interfaceId);
+            }
+
+            // The caller expects the timestamps, even if there was nothing to call.
+            message->Response().Trace(received, CallTracer::Timestamp(), CallTracer::ProcessId(), CallTracer::ThreadId());
         }
     }
 
-    void Administrator::RegisterProxy(ProxyStub::UnknownProxy& proxy)
+    void Administrator::DeleteChannel(const Core::IPCChannel* channel, std::list<ProxyStub::UnknownProxy*>& pendingProxies, std::list<ExposedInterface>& usedInterfaces)
     {
-        const Core::IPCChannel* channel = proxy.Channel().operator->();
+        ChannelStripe& stripe(Stripe(channel));
+
+        stripe.Lock.Lock();
+
+        ChannelMap::iterator index(stripe.Channels.find(channel));
+
+        if (index != stripe.Channels.end()) {
+            for (const ProxyTable::value_type& entry : index->second) {
+                pendingProxies.push_back(entry.second);
+            }
+            stripe.Channels.erase(index);
+        }
+
+        stripe.Lock.Unlock();
 
         _adminLock.Lock();
 
-        ChannelMap::iterator index(_channelProxyMap.find(channel));
+        ReferenceMap::iterator remotes(_channelReferenceMap.find(channel));
 
-        if (index == _channelProxyMap.end()) {
-            auto slot = _channelProxyMap.emplace(std::piecewise_construct,
-                std::forward_as_tuple(channel),
-                std::forward_as_tuple());
-            slot.first->second.push_back(&proxy);
+        if (remotes != _channelReferenceMap.end()) {
+            std::list<ExternalReference>::iterator loop(remotes->second.begin());
+            while (loop != remotes->second.end()) {
+                usedInterfaces.emplace_back(loop->Source(), loop->RefCount());
+                loop++;
+            }
+            _channelReferenceMap.erase(remotes);
+        }
 
-        } else {
-            ASSERT(std::find(index->second.begin(), index->second.end(), &proxy) == index->second.end());
+        _adminLock.Unlock();
+    }
+
+    void Administrator::RegisterProxy(ProxyStub::UnknownProxy& proxy)
+    {
+        const Core::IPCChannel* channel = proxy.Channel().operator->();
+        ChannelStripe& stripe(Stripe(channel));
+
+        stripe.Lock.Lock();
 
-            index->second.push_back(&proxy);
+        ProxyTable& table(stripe.Channels[channel]);
+
+#ifdef __DEBUG__
+        std::pair<ProxyTable::iterator, ProxyTable::iterator> range(table.equal_range(ProxyKey(proxy.Implementation(), proxy.InterfaceId())));
+        while ((range.first != range.second) && (range.first->second != &proxy)) {
+            range.first++;
         }
+        ASSERT(range.first == range.second);
+#endif
+
+        table.emplace(ProxyKey(proxy.Implementation(), proxy.InterfaceId()), &proxy);
 
         Core::InterlockedIncrement(proxy._refCount);
 
-        _adminLock.Unlock();
+        stripe.Lock.Unlock();
     }
     void Administrator::UnregisterProxy(ProxyStub::UnknownProxy& proxy)
     {
-        _adminLock.Lock();
+        const Core::IPCChannel* channel = proxy.Channel().operator->();
+        ChannelStripe& stripe(Stripe(channel));
+
+        stripe.Lock.Lock();
 
-        ChannelMap::iterator index(_channelProxyMap.find(proxy.Channel().operator->()));
+        ChannelMap::iterator index(stripe.Channels.find(channel));
 
-        if (index != _channelProxyMap.end()) {
-            ProxyList::iterator entry(index->second.begin());
-            while ((entry != index->second.end()) && ((*entry) != &proxy)) {
-                entry++;
+        if (index != stripe.Channels.end()) {
+            std::pair<ProxyTable::iterator, ProxyTable::iterator> range(index->second.equal_range(ProxyKey(proxy.Implementation(), proxy.InterfaceId())));
+            while ((range.first != range.second) && (range.first->second != &proxy)) {
+                range.first++;
             }
-            if (entry != index->second.end()) {
-                index->second.erase(entry);
+            if (range.first != range.second) {
+                index->second.erase(range.first);
                 Core::InterlockedDecrement(proxy._refCount);
                 if (index->second.size() == 0) {
-                    _channelProxyMap.erase(index);
+                    stripe.Channels.erase(index);
                 }
             } else {
                 TRACE_L1("Could not find the Proxy entry to be unregistered in the channel list.");
@@ -137,27 +228,26 @@ namespace RPC {
             TRACE_L1("Could not find the Proxy entry to be unregistered from a channel perspective.");
         }
 
-        _adminLock.Unlock();
+        stripe.Lock.Unlock();
     }
     void* Administrator::ProxyFind(const Core::ProxyType<Core::IPCChannel>& channel, void* impl, const uint32_t id, const uint32_t interfaceId)
     {
         void* result = nullptr;
+        ChannelStripe& stripe(Stripe(channel.operator->()));
 
-        _adminLock.Lock();
+        stripe.Lock.Lock();
 
-        ChannelMap::iterator index(_channelProxyMap.find(channel.operator->()));
+        ChannelMap::iterator index(stripe.Channels.find(channel.operator->()));
+
+        if (index != stripe.Channels.end()) {
+            ProxyTable::iterator entry(index->second.find(ProxyKey(impl, id)));
 
-        if (index != _channelProxyMap.end()) {
-            ProxyList::iterator entry(index->second.begin());
-            while ((entry != index->second.end()) && (((*entry)->InterfaceId() != id) || ((*entry)->Implementation() != impl))) {
-                entry++;
-            }
             if (entry != index->second.end()) {
-                result = (*entry)->QueryInterface(interfaceId);
+                result = entry->second->QueryInterface(interfaceId);
             }
         }
 
-        _adminLock.Unlock();
+        stripe.Lock.Unlock();
 
         return (result);
     }
@@ -167,21 +257,20 @@ namespace RPC {
         ProxyStub::UnknownProxy* result = nullptr;
 
         if (impl != nullptr) {
+            ChannelStripe& stripe(Stripe(channel.operator->()));
 
-            _adminLock.Lock();
+            stripe.Lock.Lock();
 
-            ChannelMap::iterator index(_channelProxyMap.find(channel.operator->()));
+            ChannelMap::iterator index(stripe.Channels.find(channel.operator->()));
+
+            if (index != stripe.Channels.end()) {
+                ProxyTable::iterator entry(index->second.find(ProxyKey(impl, id)));
 
-            if (index != _channelProxyMap.end()) {
-                ProxyList::iterator entry(index->second.begin());
-                while ((entry != index->second.end()) && (((*entry)->InterfaceId() != id) || ((*entry)->Implementation() != impl))) {
-                    entry++;
-                }
                 if (entry != index->second.end()) {
-                    result = (*entry);
+                    result = entry->second;
 
                     if (refCounted == true) {
-                        (*entry)->AddRefCachedCount();
+                        result->AddRefCachedCount();
                     }
 
                     if (piggyBack == true) {
@@ -193,17 +282,17 @@ namespace RPC {
             }
 
             if (result == nullptr) {
-                std::map<uint32_t, IMetadata*>::iterator index(_proxy.find(id));
+                IMetadata* factory(ProxyFactory(id));
 
-                if (index != _proxy.end()) {
+                if (factory != nullptr) {
 
-                    result = index->second->CreateProxy(channel, impl, refCounted);
+                    result = factory->CreateProxy(channel, impl, refCounted);
 
                     ASSERT(result != nullptr);
 
                     if (refCounted == true) {
                         // Register it as it is remotely registered :-)
-                        _channelProxyMap[channel.operator->()].push_back(result);
+                        stripe.Channels[channel.operator->()].emplace(ProxyKey(impl, id), result);
                     } else if (piggyBack == true) {
                         // Reference counting can be cached on this on object for now. This is a request
                         // from an incoming interface of which the lifetime is guaranteed by the callee.
@@ -214,7 +303,7 @@ namespace RPC {
                 }
             }
 
-            _adminLock.Unlock();
+            stripe.Lock.Unlock();
         }
 
         return (result);
@@ -260,8 +349,8 @@ namespace RPC {
 
     Core::IUnknown* Administrator::Convert(void* rawImplementation, const uint32_t id) 
     {
-        std::map<uint32_t, ProxyStub::UnknownStub*>::const_iterator index (_stubs.find(id));
-        return(index != _stubs.end() ? index->second->Convert(rawImplementation) : nullptr);
+        ProxyStub::UnknownStub* stub(Stub(id));
+        return(stub != nullptr ? stub->Convert(rawImplementation) : nullptr);
     }
 }
 } // namespace Core
@@ -1,9 +1,12 @@
 #ifndef __COM_ADMINISTRATOR_H
 #define __COM_ADMINISTRATOR_H
 
+#include "CallTracer.h"
 #include "Messages.h"
 #include "Module.h"
 
+#include <unordered_map>
+
 namespace WPEFramework {
 
 namespace ProxyStub {
@@ -83,10 +86,28 @@ namespace RPC {
             std::atomic<uint32_t> _refCount;
         };
 
-        typedef std::list<ProxyStub::UnknownProxy*> ProxyList;
-        typedef std::map<const Core::IPCChannel*, ProxyList> ChannelMap;
+        // Proxies are looked up for every interface pointer that passes a channel, so the proxies of a channel
+        // are hashed on the implementation they stand for and its interface. The channels themselves are
+        // spread over a number of stripes, each with its own lock, so lookups on different channels do not
+        // wait for each other.
+        typedef std::pair<const void*, uint32_t> ProxyKey;
+        struct ProxyKeyHash {
+            size_t operator()(const ProxyKey& key) const
+            {
+                return (std::hash<const void*>()(key.first) ^ (static_cast<size_t>(key.second) * 2654435761U));
+            }
+        };
+        typedef std::unordered_multimap<ProxyKey, ProxyStub::UnknownProxy*, ProxyKeyHash> ProxyTable;
+        typedef std::unordered_map<const Core::IPCChannel*, ProxyTable> ChannelMap;
         typedef std::map<const Core::IPCChannel*, std::list<ExternalReference>> ReferenceMap;
 
+        static constexpr uint8_t ChannelStripes = 16;
+
+        struct ChannelStripe {
+            Core::CriticalSection Lock;
+            ChannelMap Channels;
+        };
+
         struct EXTERNAL IMetadata {
             virtual ~IMetadata(){};
 
@@ -114,6 +135,15 @@ namespace RPC {
             }
         };
 
+        // The stubs and proxy factories are found on every invoke. The interface IDs handed out are small
+        // numbers, so they index a flat table, only IDs beyond it go to a map.
+        static constexpr uint32_t InterfaceSlots = 0x400;
+
+        struct InterfaceEntry {
+            ProxyStub::UnknownStub* Stub;
+            IMetadata* Proxy;
+        };
+
     public:
         virtual ~Administrator();
 
@@ -123,12 +153,7 @@ namespace RPC {
         template <typename ACTUALINTERFACE, typename PROXY, typename STUB>
         void Announce()
         {
-            _adminLock.Lock();
-
-            _stubs.insert(std::pair<uint32_t, ProxyStub::UnknownStub*>(ACTUALINTERFACE::ID, new STUB()));
-            _proxy.insert(std::pair<uint32_t, IMetadata*>(ACTUALINTERFACE::ID, new ProxyType<PROXY>()));
-
-            _adminLock.Unlock();
+            Announce(ACTUALINTERFACE::ID, new STUB(), new ProxyType<PROXY>());
         }
 
         Core::ProxyType<InvokeMessage> Message()
@@ -136,34 +161,18 @@ namespace RPC {
             return (_factory.Element());
         }
 
-        void DeleteChannel(const Core::IPCChannel* channel, std::list<ProxyStub::UnknownProxy*>& pendingProxies, std::list<ExposedInterface>& usedInterfaces)
+        // Round trip times of the invokes through the proxies in this process, in microseconds.
+        inline void Invoked(const uint64_t duration)
         {
-            _adminLock.Lock();
-
-            ChannelMap::iterator index(_channelProxyMap.find(channel));
-
-            if (index != _channelProxyMap.end()) {
-                ProxyList::iterator loop(index->second.begin());
-                while (loop != index->second.end()) {
-                    pendingProxies.push_back(*loop);
-                    loop++;
-                }
-                _channelProxyMap.erase(index);
-            }
-            ReferenceMap::iterator remotes(_channelReferenceMap.find(channel));
-
-            if (remotes != _channelReferenceMap.end()) {
-                std::list<ExternalReference>::iterator loop(remotes->second.begin());
-                while (loop != remotes->second.end()) {
-                    usedInterfaces.emplace_back(loop->Source(), loop->RefCount());
-                    loop++;
-                }
-                _channelReferenceMap.erase(remotes);
-            }
-
-            _adminLock.Unlock();
+            _roundTrips.Set(duration);
+        }
+        inline void RoundTrips(Core::Histogram::Snapshot& snapshot) const
+        {
+            _roundTrips.Merge(snapshot);
         }
 
+        void DeleteChannel(const Core::IPCChannel* channel, std::list<ProxyStub::UnknownProxy*>& pendingProxies, std::list<ExposedInterface>& usedInterfaces);
+
         template <typename ACTUALINTERFACE>
         ACTUALINTERFACE* ProxyFind(const Core::ProxyType<Core::IPCChannel>& channel, void* impl)
         {
@@ -222,6 +231,21 @@ namespace RPC {
         }
 
     private:
+        inline ChannelStripe& Stripe(const Core::IPCChannel* channel)
+        {
+            return (_stripes[(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(channel) >> 4) * 2654435761U) >> 28]);
+        }
+        inline ProxyStub::UnknownStub* Stub(const uint32_t id)
+        {
+            return (id < InterfaceSlots ? _interfaces[id].Stub : Overflow(id).Stub);
+        }
+        inline IMetadata* ProxyFactory(const uint32_t id)
+        {
+            return (id < InterfaceSlots ? _interfaces[id].Proxy : Overflow(id).Proxy);
+        }
+
+        void Announce(const uint32_t id, ProxyStub::UnknownStub* stub, IMetadata* proxy);
+        InterfaceEntry Overflow(const uint32_t id);
         Core::IUnknown* Convert(void* rawImplementation, const uint32_t id);
         void* ProxyFind(const Core::ProxyType<Core::IPCChannel>& channel, void* impl, const uint32_t id, const uint32_t interfaceId);
         void* ProxyInstanceQuery(const Core::ProxyType<Core::IPCChannel>& channel, void* impl, const uint32_t id, const bool refCounted, const uint32_t interfaceId, const bool piggyBack);
@@ -230,11 +254,12 @@ namespace RPC {
     private:
         // Seems like we have enough information, open up the Process communcication Channel.
         Core::CriticalSection _adminLock;
-        std::map<uint32_t, ProxyStub::UnknownStub*> _stubs;
-        std::map<uint32_t, IMetadata*> _proxy;
+        InterfaceEntry _interfaces[InterfaceSlots];
+        std::map<uint32_t, InterfaceEntry> _overflow;
         Core::ProxyPoolType<InvokeMessage> _factory;
-        ChannelMap _channelProxyMap;
+        ChannelStripe _stripes[ChannelStripes];
         ReferenceMap _channelReferenceMap;
+        Core::Histogram _roundTrips;
     };
 
     struct IHandler {
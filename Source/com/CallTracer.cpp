@@ -0,0 +1,282 @@
+#include "CallTracer.h"
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+#include <sys/syscall.h>
+#endif
+
+namespace WPEFramework {
+namespace RPC {
+
+    static_assert(sizeof(CallTracer::Span) == 64, "A span record should be exactly 64 bytes");
+
+    CallTracer::SpanBuffer::SpanBuffer(const string& fileName, const uint32_t size)
+        : Core::CyclicBuffer(fileName, size, true)
+    {
+    }
+
+    CallTracer::SpanBuffer::~SpanBuffer()
+    {
+    }
+
+    /* virtual */ uint32_t CallTracer::SpanBuffer::GetOverwriteSize(Cursor& cursor)
+    {
+        // Only drop complete spans, so the tail always points to the start of a record.
+        while (cursor.Offset() < cursor.Size()) {
+            cursor.Forward(sizeof(Span));
+        }
+
+        return cursor.Offset();
+    }
+
+    CallTracer::CallTracer()
+        : _adminLock()
+        , _interval(0)
+        , _calls(0)
+        , _sequence(1)
+        , _buffer(nullptr)
+        , _fileName()
+        , _aggregates()
+    {
+        string interval;
+        string directory;
+
+        // Out-of-process hosts inherit the tracing from the environment set up by their parent.
+        if ((Core::SystemInfo::GetEnvironment(COMRPC_TRACE_ENVIRONMENT, interval) == true) && (Core::SystemInfo::GetEnvironment(TRACE_CYCLIC_BUFFER_ENVIRONMENT, directory) == true)) {
+            uint32_t value = Core::NumberType<uint32_t>(Core::TextFragment(interval)).Value();
+
+            if (value != 0) {
+                Open(directory, value);
+            }
+        }
+    }
+
+    CallTracer::~CallTracer()
+    {
+        Close();
+    }
+
+    /* static */ CallTracer& CallTracer::Instance()
+    {
+        static CallTracer callTracer;
+
+        return (callTracer);
+    }
+
+    uint32_t CallTracer::Open(const string& directory, const uint32_t interval, const uint32_t size)
+    {
+        uint32_t result = Core::ERROR_ILLEGAL_STATE;
+
+        ASSERT(interval != 0);
+
+        _adminLock.Lock();
+
+        if (_buffer == nullptr) {
+            // Whole spans only, and at least a few of them.
+            const uint32_t length = ((size > MinimumSize ? size : static_cast<uint32_t>(MinimumSize)) / sizeof(Span)) * sizeof(Span);
+
+            _fileName = Core::Directory::Normalize(directory) + COMRPC_TRACE_PREFIX + '.' + Core::NumberType<uint32_t>(ProcessId()).Text();
+            _buffer = new SpanBuffer(_fileName, length);
+
+            if (_buffer->IsValid() == true) {
+                _interval.store(interval, std::memory_order_relaxed);
+                result = Core::ERROR_NONE;
+            } else {
+                delete _buffer;
+                _buffer = nullptr;
+                Core::File(_fileName).Destroy();
+                result = Core::ERROR_OPENING_FAILED;
+            }
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+
+    uint32_t CallTracer::Close()
+    {
+        _adminLock.Lock();
+
+        _interval.store(0, std::memory_order_relaxed);
+
+        if (_buffer != nullptr) {
+            delete _buffer;
+            _buffer = nullptr;
+
+            // A buffer of a process that stopped tracing should not end up in a later export.
+            Core::File(_fileName).Destroy();
+        }
+
+        _adminLock.Unlock();
+
+        return (Core::ERROR_NONE);
+    }
+
+    void CallTracer::Record(Span& span)
+    {
+        span.Length = sizeof(Span);
+        span.ProxyProcess = ProcessId();
+        span.ProxyThread = ThreadId();
+        span.Reserved = 0;
+        span.Padding = 0;
+
+        uint64_t roundTrip = (span.Completed - span.Sent) / 1000;
+        uint64_t dispatch = (span.Returned >= span.Received ? (span.Returned - span.Received) / 1000 : 0);
+
+        _adminLock.Lock();
+
+        if (_buffer != nullptr) {
+            _buffer->Write(reinterpret_cast<const uint8_t*>(&span), sizeof(Span));
+        }
+
+        Aggregate& aggregate(_aggregates[std::pair<uint32_t, uint8_t>(span.InterfaceId, span.MethodId)]);
+
+        aggregate.RoundTrip.Set(roundTrip);
+        aggregate.Dispatch.Set(dispatch);
+        aggregate.Transit.Set(roundTrip > dispatch ? roundTrip - dispatch : 0);
+
+        _adminLock.Unlock();
+    }
+
+    void CallTracer::Statistics(MethodStatistics& statistics) const
+    {
+        _adminLock.Lock();
+
+        for (const std::pair<const std::pair<uint32_t, uint8_t>, Aggregate>& entry : _aggregates) {
+            Latencies& info(statistics[entry.first]);
+
+            entry.second.RoundTrip.Merge(info.RoundTrip);
+            entry.second.Dispatch.Merge(info.Dispatch);
+            entry.second.Transit.Merge(info.Transit);
+        }
+
+        _adminLock.Unlock();
+    }
+
+    void CallTracer::Reset()
+    {
+        _adminLock.Lock();
+
+        _aggregates.clear();
+
+        if (_buffer != nullptr) {
+            _buffer->Flush();
+        }
+
+        _adminLock.Unlock();
+    }
+
+    /* static */ uint32_t CallTracer::Export(const string& directory, string& json)
+    {
+        uint32_t result = Core::ERROR_UNAVAILABLE;
+        Core::Directory index(Core::Directory::Normalize(directory).c_str(), COMRPC_TRACE_PREFIX _T(".*"));
+
+        json = _T("{\"traceEvents\":[");
+
+        while (index.Next() == true) {
+            const string name(Core::File::FileNameExtended(index.Current()));
+
+            // Only the buffers, named after the process that traced into them.
+            if ((name.length() <= (sizeof(COMRPC_TRACE_PREFIX) / sizeof(TCHAR))) || (name.find_first_not_of(_T("0123456789"), (sizeof(COMRPC_TRACE_PREFIX) / sizeof(TCHAR))) != string::npos)) {
+                continue;
+            }
+
+            // Open the existing buffer, as it is left by the process that traced into it.
+            SpanBuffer buffer(index.Current(), 0);
+
+            if (buffer.IsValid() == true) {
+                std::vector<uint8_t> data(buffer.Used());
+                uint32_t length = (data.empty() == true ? 0 : buffer.Peek(data.data(), static_cast<uint32_t>(data.size())));
+                uint32_t offset = 0;
+
+                while ((offset + sizeof(Span)) <= length) {
+                    Span span;
+
+                    ::memcpy(&span, &(data[offset]), sizeof(Span));
+
+                    if (span.Length == sizeof(Span)) {
+                        Export(span, json);
+                    }
+
+                    offset += sizeof(Span);
+                }
+
+                result = Core::ERROR_NONE;
+            }
+        }
+
+        if (json.back() == ',') {
+            json.pop_back();
+        }
+
+        json += _T("],\"displayTimeUnit\":\"ns\"}");
+
+        return (result);
+    }
+
+    /* static */ void CallTracer::Export(const Span& span, string& json)
+    {
+        // Chrome expects microseconds, the nanoseconds are kept as the fraction.
+        const double sent = static_cast<double>(span.Sent) / 1000.0;
+        const double received = static_cast<double>(span.Received) / 1000.0;
+        const double completed = static_cast<double>(span.Completed) / 1000.0;
+        const double dispatch = static_cast<double>(span.Returned >= span.Received ? span.Returned - span.Received : 0) / 1000.0;
+
+        // The complete call as seen by the caller, with the transport times in both directions.
+        json += Trace::Format(_T("{\"name\":\"0x%X:%u\",\"cat\":\"comrpc\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"trace\":%u,\"request\":%.3f,\"response\":%.3f}},"),
+            span.InterfaceId, span.MethodId, span.ProxyProcess, span.ProxyThread, sent, (completed - sent),
+            span.TraceId, (received - sent), ((static_cast<double>(span.Completed) - static_cast<double>(span.Returned)) / 1000.0));
+
+        // The dispatch in the process that implements the interface.
+        json += Trace::Format(_T("{\"name\":\"0x%X:%u\",\"cat\":\"comrpc\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"trace\":%u}},"),
+            span.InterfaceId, span.MethodId, span.StubProcess, span.StubThread, received, dispatch, span.TraceId);
+
+        // A flow from the caller to the callee and back. Trace ids are unique within the calling process.
+        json += Trace::Format(_T("{\"name\":\"comrpc\",\"cat\":\"comrpc\",\"ph\":\"s\",\"id\":\"0x%08X%08X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f},"),
+            span.ProxyProcess, span.TraceId, span.ProxyProcess, span.ProxyThread, sent);
+        json += Trace::Format(_T("{\"name\":\"comrpc\",\"cat\":\"comrpc\",\"ph\":\"t\",\"id\":\"0x%08X%08X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f},"),
+            span.ProxyProcess, span.TraceId, span.StubProcess, span.StubThread, received);
+        json += Trace::Format(_T("{\"name\":\"comrpc\",\"cat\":\"comrpc\",\"ph\":\"f\",\"bp\":\"e\",\"id\":\"0x%08X%08X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f},"),
+            span.ProxyProcess, span.TraceId, span.ProxyProcess, span.ProxyThread, completed);
+    }
+
+    /* static */ uint64_t CallTracer::Timestamp()
+    {
+#ifdef __WIN32__
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER counter;
+
+        ::QueryPerformanceFrequency(&frequency);
+        ::QueryPerformanceCounter(&counter);
+
+        return (static_cast<uint64_t>((counter.QuadPart / frequency.QuadPart) * 1000000000ULL) + static_cast<uint64_t>(((counter.QuadPart % frequency.QuadPart) * 1000000000ULL) / frequency.QuadPart));
+#else
+        struct timespec now;
+
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return ((static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(now.tv_nsec));
+#endif
+    }
+
+    /* static */ uint32_t CallTracer::ProcessId()
+    {
+#ifdef __WIN32__
+        return (static_cast<uint32_t>(::GetCurrentProcessId()));
+#else
+        return (static_cast<uint32_t>(::getpid()));
+#endif
+    }
+
+    /* static */ uint32_t CallTracer::ThreadId()
+    {
+#ifdef __WIN32__
+        return (static_cast<uint32_t>(::GetCurrentThreadId()));
+#elif defined(__LINUX__) && !defined(__APPLE__)
+        return (static_cast<uint32_t>(::syscall(SYS_gettid)));
+#else
+        return (static_cast<uint32_t>(reinterpret_cast<uintptr_t>(::pthread_self())));
+#endif
+    }
+}
+}
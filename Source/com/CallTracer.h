@@ -0,0 +1,170 @@
+#ifndef __COM_CALLTRACER_H
+#define __COM_CALLTRACER_H
+
+#include "Module.h"
+
+// Set this variable to N, to trace one out of every N COM-RPC calls made through the proxies of a process.
+// The spans are stored in a cyclic buffer in the directory set by TRACE_CYCLIC_BUFFER_ENVIRONMENT.
+#define COMRPC_TRACE_ENVIRONMENT _T("COMRPC_TRACE")
+#define COMRPC_TRACE_PREFIX _T("comrpctrace")
+
+namespace WPEFramework {
+namespace RPC {
+
+    // Rationale:
+    // A sampled call is stamped, with a monotonic clock that is shared by all processes on the system, when the
+    // proxy sends it, when the stub receives it, when the implementation returns and when the proxy receives the
+    // answer. The proxy side writes the complete span as a binary record to a cyclic buffer, so the latest spans
+    // are always available without the tracing growing memory. The buffers of all processes can be exported as
+    // a single Chrome trace-event JSON file (chrome://tracing, Perfetto).
+    class EXTERNAL CallTracer {
+    public:
+        struct Span {
+            uint64_t Sent;
+            uint64_t Received;
+            uint64_t Returned;
+            uint64_t Completed;
+            uint32_t TraceId;
+            uint32_t InterfaceId;
+            uint32_t ProxyProcess;
+            uint32_t ProxyThread;
+            uint32_t StubProcess;
+            uint32_t StubThread;
+            uint16_t Length;
+            uint8_t MethodId;
+            uint8_t Reserved;
+            uint32_t Padding;
+        };
+
+        // Latencies in microseconds, of the sampled calls of a single method.
+        class Latencies {
+        public:
+            Latencies()
+                : RoundTrip()
+                , Dispatch()
+                , Transit()
+            {
+            }
+            Latencies(const Latencies& copy)
+                : RoundTrip(copy.RoundTrip)
+                , Dispatch(copy.Dispatch)
+                , Transit(copy.Transit)
+            {
+            }
+            ~Latencies()
+            {
+            }
+
+        public:
+            // Proxy send to proxy receive.
+            Core::Histogram::Snapshot RoundTrip;
+            // Stub receive to implementation return.
+            Core::Histogram::Snapshot Dispatch;
+            // What is left of the round trip: serialization and the transport in both directions.
+            Core::Histogram::Snapshot Transit;
+        };
+
+        // Keyed on the interface and method id.
+        typedef std::map<std::pair<uint32_t, uint8_t>, Latencies> MethodStatistics;
+
+        static constexpr uint32_t MinimumSize = 16 * sizeof(Span);
+
+    private:
+        class SpanBuffer : public Core::CyclicBuffer {
+        private:
+            SpanBuffer() = delete;
+            SpanBuffer(const SpanBuffer&) = delete;
+            SpanBuffer& operator=(const SpanBuffer&) = delete;
+
+        public:
+            SpanBuffer(const string& fileName, const uint32_t size);
+            ~SpanBuffer();
+
+        private:
+            virtual uint32_t GetOverwriteSize(Cursor& cursor) override;
+        };
+
+        class Aggregate {
+        private:
+            Aggregate(const Aggregate&) = delete;
+            Aggregate& operator=(const Aggregate&) = delete;
+
+        public:
+            Aggregate()
+                : RoundTrip(1)
+                , Dispatch(1)
+                , Transit(1)
+            {
+            }
+            ~Aggregate()
+            {
+            }
+
+        public:
+            Core::Histogram RoundTrip;
+            Core::Histogram Dispatch;
+            Core::Histogram Transit;
+        };
+
+        typedef std::map<std::pair<uint32_t, uint8_t>, Aggregate> AggregateMap;
+
+        CallTracer();
+        CallTracer(const CallTracer&) = delete;
+        CallTracer& operator=(const CallTracer&) = delete;
+
+    public:
+        ~CallTracer();
+
+        static CallTracer& Instance();
+
+    public:
+        // Trace one out of every interval calls, spans go to a buffer of the given size (at least MinimumSize)
+        // in the given directory. Closing removes the buffer.
+        uint32_t Open(const string& directory, const uint32_t interval, const uint32_t size = (64 * 1024));
+        uint32_t Close();
+
+        inline bool IsActive() const
+        {
+            return (_interval.load(std::memory_order_relaxed) != 0);
+        }
+        // Returns the trace id for the call to be made, or 0 if this call is not sampled.
+        inline uint32_t Sample()
+        {
+            uint32_t result = 0;
+            uint32_t interval = _interval.load(std::memory_order_relaxed);
+
+            if ((interval != 0) && ((_calls.fetch_add(1, std::memory_order_relaxed) % interval) == 0)) {
+                while ((result = _sequence.fetch_add(1, std::memory_order_relaxed)) == 0) {
+                }
+            }
+
+            return (result);
+        }
+        void Record(Span& span);
+        void Statistics(MethodStatistics& statistics) const;
+        void Reset();
+
+        // Converts the spans of all processes that trace into the given directory, into Chrome trace-event JSON.
+        static uint32_t Export(const string& directory, string& json);
+
+        // Monotonic time in nanoseconds, comparable between processes.
+        static uint64_t Timestamp();
+        static uint32_t ProcessId();
+        static uint32_t ThreadId();
+
+    private:
+        static void Export(const Span& span, string& json);
+
+    private:
+        mutable Core::CriticalSection _adminLock;
+        std::atomic<uint32_t> _interval;
+        std::atomic<uint32_t> _calls;
+        std::atomic<uint32_t> _sequence;
+        SpanBuffer* _buffer;
+        string _fileName;
+        AggregateMap _aggregates;
+    };
+}
+}
+
+#endif // __COM_CALLTRACER_H
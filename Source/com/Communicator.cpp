@@ -54,6 +54,7 @@ class ClosingInfo {
 
 static constexpr uint32_t DestructionStackSize = 64 * 1024;
 static Core::ProxyPoolType<RPC::AnnounceMessage> AnnounceMessageFactory(2);
+static Core::ProxyPoolType<RPC::HandoverMessage> HandoverMessageFactory(1);
 static Core::TimerType<ClosingInfo>& _destructor = Core::SingletonType < Core::TimerType<ClosingInfo> >::Instance(DestructionStackSize, "ProcessDestructor");
 
 /* static */ std::atomic<uint32_t> Communicator::RemoteConnection::_sequenceId(1);
@@ -130,6 +131,31 @@ static void LoadProxyStubs(const string& pathName)
     }
 }
 
+void* Communicator::RemoteProcess::Handover(const Object& instance, const Config& config, const uint32_t waitTime)
+{
+    void* result(nullptr);
+
+    if (IsOperational() == true) {
+        Core::ProxyType<RPC::HandoverMessage> message(HandoverMessageFactory.Element());
+        RPC::Data::Frame::Writer writer(message->Parameters().Writer());
+
+        writer.Text(instance.Locator());
+        writer.Text(instance.ClassName());
+        writer.Number<uint32_t>(instance.Interface());
+        writer.Number<uint32_t>(instance.Version());
+        writer.Text(config.PersistentPath());
+        writer.Text(config.DataPath());
+
+        if (Channel()->Invoke(message, waitTime) == Core::ERROR_NONE) {
+            RPC::Data::Frame::Reader reader(message->Response().Reader());
+
+            result = reader.Number<void*>();
+        }
+    }
+
+    return (result);
+}
+
 /* virtual */ void Communicator::RemoteProcess::Terminate()
 {
 	// Time to shoot the application, it will trigger a close by definition of the channel, if it is still standing..
@@ -251,7 +277,8 @@ uint32_t CommunicatorClient::Close(const uint32_t waitTime)
         } else {
             RPC::Data::Init& setupFrame(_announceMessage->Parameters());
 
-            if (setupFrame.IsRequested() == true) {
+            // A standby host has nothing to offer yet, it waits for a plugin to be handed over.
+            if ((setupFrame.IsRequested() == true) && (setupFrame.Implementation() != nullptr)) {
                 Core::ProxyType<Core::IPCChannel> refChannel(dynamic_cast<Core::IReferenceCounted*>(this), this);
 
                 ASSERT(refChannel.IsValid());
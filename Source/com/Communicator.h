@@ -292,6 +292,8 @@ namespace RPC {
         private:
             RemoteProcess()
                 : RemoteConnection()
+                , _id(0)
+                , _launched(0)
             {
             }
 
@@ -305,20 +307,13 @@ namespace RPC {
             inline void Launch(const Object& instance, const Config& config)
             {
                 Core::Process::Options options(config.HostApplication());
-                uint32_t loggingSettings = (Logging::LoggingType<Logging::Startup>::IsEnabled()      ? 0x01 : 0) | 
-					                       (Logging::LoggingType<Logging::Shutdown>::IsEnabled()     ? 0x02 : 0) | 
-					                       (Logging::LoggingType<Logging::Notification>::IsEnabled() ? 0x04 : 0);
 
                 ASSERT(instance.Locator().empty() == false);
                 ASSERT(instance.ClassName().empty() == false);
-                ASSERT(config.Connector().empty() == false);
 
                 options[_T("-l")] = instance.Locator();
                 options[_T("-c")] = instance.ClassName();
-                options[_T("-r")] = config.Connector();
                 options[_T("-i")] = Core::NumberType<uint32_t>(instance.Interface()).Text();
-                options[_T("-e")] = Core::NumberType<uint32_t>(loggingSettings).Text();
-                options[_T("-x")] = Core::NumberType<uint32_t>(Id()).Text();
 
                 if (instance.Version() != static_cast<uint32_t>(~0)) {
                     options[_T("-v")] = Core::NumberType<uint32_t>(instance.Version()).Text();
@@ -332,32 +327,69 @@ namespace RPC {
                 if (config.PersistentPath().empty() == false) {
                     options[_T("-p")] = config.PersistentPath();
                 }
-                if (config.SystemPath().empty() == false) {
-                    options[_T("-s")] = config.SystemPath();
-                }
                 if (config.DataPath().empty() == false) {
                     options[_T("-d")] = config.DataPath();
                 }
+                if (instance.Threads() > 1) {
+                    options[_T("-t")] = Core::NumberType<uint8_t>(instance.Threads()).Text();
+                }
+
+                Launch(options, config);
+            }
+            // Start a host without a plugin. It loads the proxy stubs, announces itself and waits till a plugin
+            // is handed over to it.
+            inline void Standby(const Config& config)
+            {
+                Core::Process::Options options(config.HostApplication());
+
+                options.Set(_T("-w"));
+
+                Launch(options, config);
+            }
+            void* Handover(const Object& instance, const Config& config, const uint32_t waitTime);
+
+            virtual void Terminate() override;
+
+            // The moment the process was started, on the Core::Time::Monotonic() clock.
+            inline uint64_t Launched() const
+            {
+                return (_launched);
+            }
+
+        private:
+            void Launch(Core::Process::Options& options, const Config& config)
+            {
+                uint32_t loggingSettings = (Logging::LoggingType<Logging::Startup>::IsEnabled()      ? 0x01 : 0) | 
+					                       (Logging::LoggingType<Logging::Shutdown>::IsEnabled()     ? 0x02 : 0) | 
+					                       (Logging::LoggingType<Logging::Notification>::IsEnabled() ? 0x04 : 0);
+
+                ASSERT(config.Connector().empty() == false);
+
+                options[_T("-r")] = config.Connector();
+                options[_T("-e")] = Core::NumberType<uint32_t>(loggingSettings).Text();
+                options[_T("-x")] = Core::NumberType<uint32_t>(Id()).Text();
+
+                if (config.SystemPath().empty() == false) {
+                    options[_T("-s")] = config.SystemPath();
+                }
                 if (config.ApplicationPath().empty() == false) {
                     options[_T("-a")] = config.ApplicationPath();
                 }
                 if (config.ProxyStubPath().empty() == false) {
                     options[_T("-m")] = config.ProxyStubPath();
                 }
-                if (instance.Threads() > 1) {
-                    options[_T("-t")] = Core::NumberType<uint8_t>(instance.Threads()).Text();
-                }
 
                 // Start the external process launch..
                 Core::Process fork(false);
 
+                _launched = Core::Time::Monotonic();
+
                 fork.Launch(options, &_id);
             }
 
-            virtual void Terminate() override;
-
         private:
             uint32_t _id;
+            uint64_t _launched;
         };
         class EXTERNAL RemoteConnectionMap {
         private:
@@ -369,6 +401,8 @@ namespace RPC {
                 : _adminLock()
                 , _announcements()
                 , _connections()
+                , _standby()
+                , _handovers()
                 , _parent(parent)
             {
             }
@@ -382,6 +416,16 @@ namespace RPC {
                     _observers.pop_front();
                 }
 
+                // The standby hosts are ours, nobody else will end them.
+                while (_standby.size() != 0) {
+                    RemoteProcess* host = _standby.front();
+
+                    _standby.pop_front();
+                    _connections.erase(host->Id());
+                    host->Terminate();
+                    host->Release();
+                }
+
                 // All connections must be terminated if we end up here :-)
                 ASSERT(_connections.size() == 0);
 
@@ -437,62 +481,51 @@ namespace RPC {
             }
             inline void* Create(uint32_t& id, const Object& instance, const Config& config, const uint32_t waitTime)
             {
-                void* interfaceReturned = nullptr;
+                const uint64_t start = Core::Time::Monotonic();
 
-                _adminLock.Lock();
-
-                Communicator::RemoteProcess* result = Core::Service<RemoteProcess>::Create<RemoteProcess>();
-
-                ASSERT(result != nullptr);
-
-                if (result != nullptr) {
+                // A standby host runs as we do, so it can only take a plugin that does not ask for another user
+                // or group, or for more threads.
+                void* interfaceReturned = ((instance.User().empty() == true) && (instance.Group().empty() == true) && (instance.Threads() <= 1) ? Handover(id, instance, config, waitTime) : nullptr);
 
-                    Core::Event trigger(false, true);
-
-                    // A reference for putting it in the list...
-                    result->AddRef();
-
-                    // We expect an announce interface message now...
-                    _connections.insert(std::pair<uint32_t, RemoteConnection*>(result->Id(), result));
-                    auto locator = _announcements.emplace(std::piecewise_construct,
-                        std::forward_as_tuple(result->Id()),
-                        std::forward_as_tuple(std::pair<Core::Event&, void*>(trigger, nullptr)));
-
-                    id = result->Id();
-
-                    _adminLock.Unlock();
-
-                    // Start the process, and....
-                    result->Launch(instance, config);
-
-                    // wait for the announce message to be exchanged
-                    if (trigger.Lock(waitTime) == Core::ERROR_NONE) {
+                if (interfaceReturned != nullptr) {
+                    SYSLOG(Logging::Startup, (_T("Handed %s over to standby host %d in %d us."), instance.ClassName().c_str(), id, static_cast<uint32_t>(Core::Time::Monotonic() - start)));
+                } else {
+                    interfaceReturned = Launch(id, instance, config, waitTime);
 
-                        uint32_t interfaceId = instance.Interface();
+                    if (interfaceReturned != nullptr) {
+                        SYSLOG(Logging::Startup, (_T("Launched host %d for %s in %d us."), id, instance.ClassName().c_str(), static_cast<uint32_t>(Core::Time::Monotonic() - start)));
+                    }
+                }
 
-                        _adminLock.Lock();
+                return (interfaceReturned);
+            }
+            // Start hosts upfront, so a plugin can be handed over to a host that is already up and running, has
+            // its libraries linked and its proxy stubs loaded, instead of waiting for a new host to start. Every
+            // host taken is replaced by a new one.
+            inline void Standby(const Config& config, const uint8_t count)
+            {
+                std::list<RemoteProcess*> hosts;
 
-                        // Get the interface pointer that was stored during the triggering of the event...
-                        // It is reference counted so it has to be dereferenced by the caller.
-                        ProxyStub::UnknownProxy* proxyStub = RPC::Administrator::Instance().ProxyInstance(result->Channel(), locator.first->second.second, interfaceId, true, interfaceId, false);
+                _adminLock.Lock();
 
-                        if (proxyStub != nullptr) {
-                            interfaceReturned = proxyStub->QueryInterface(interfaceId);
-                        }
+                for (uint8_t index = 0; index < count; index++) {
+                    RemoteProcess* host = Core::Service<RemoteProcess>::Create<RemoteProcess>();
 
-                    } else {
-                        _adminLock.Lock();
+                    ASSERT(host != nullptr);
 
-                        // Seems we could not start the application. Cleanout
-                        result->Terminate();
+                    if (host != nullptr) {
+                        // The connection is completed once the host announces itself.
+                        _connections.insert(std::pair<uint32_t, RemoteConnection*>(host->Id(), host));
+                        _standby.push_back(host);
+                        hosts.push_back(host);
                     }
-
-                    // Kill the Event registration. We are no longer interested in what will be hapening..
-                    _announcements.erase(locator.first);
                 }
+
                 _adminLock.Unlock();
 
-                return (interfaceReturned);
+                for (RemoteProcess* host : hosts) {
+                    host->Standby(config);
+                }
             }
             inline void Closed(const uint32_t id)
             {
@@ -510,11 +543,23 @@ namespace RPC {
                     Core::IPCChannel* destructed = index->second->Channel().operator->();
                     index->second->Close();
 
-                    std::list<RPC::IRemoteConnection::INotification*>::iterator observer(_observers.begin());
+                    std::list<RemoteProcess*>::iterator host(std::find(_standby.begin(), _standby.end(), index->second));
+
+                    if (host != _standby.end()) {
+                        // A standby host was never activated, so nobody needs to know. Without a channel it
+                        // will not get a plugin anymore either.
+                        (*host)->Terminate();
+                        _standby.erase(host);
+                    } else if (std::find(_handovers.begin(), _handovers.end(), index->second) != _handovers.end()) {
+                        // A standby host that is taking a plugin, it is not activated yet. Handover() finds
+                        // it gone and cleans up.
+                    } else {
+                        std::list<RPC::IRemoteConnection::INotification*>::iterator observer(_observers.begin());
 
-                    while (observer != _observers.end()) {
-                        (*observer)->Deactivated(index->second);
-                        observer++;
+                        while (observer != _observers.end()) {
+                            (*observer)->Deactivated(index->second);
+                            observer++;
+                        }
                     }
 
                     // Release this entry, do not wait till it get's overwritten.
@@ -547,6 +592,9 @@ namespace RPC {
                 // First do an activity check on all processes registered.
                 _adminLock.Lock();
 
+                _standby.clear();
+                _handovers.clear();
+
                 while (_connections.size() > 0) {
                     _connections.begin()->second->Terminate();
                     _connections.erase(_connections.begin());
@@ -604,32 +652,199 @@ namespace RPC {
             }
 
         private:
-            void Request(Core::ProxyType<Core::IPCChannelType<Core::SocketPort, ChannelLink>>& channel, const Data::Init& info)
+            void* Launch(uint32_t& id, const Object& instance, const Config& config, const uint32_t waitTime)
             {
-                void* result = info.Implementation();
+                void* interfaceReturned = nullptr;
+
+                _adminLock.Lock();
+
+                Communicator::RemoteProcess* result = Core::Service<RemoteProcess>::Create<RemoteProcess>();
 
                 ASSERT(result != nullptr);
 
-                std::map<uint32_t, Communicator::RemoteConnection*>::iterator index(_connections.find(info.ExchangeId()));
+                if (result != nullptr) {
+
+                    Core::Event trigger(false, true);
+
+                    // A reference for putting it in the list...
+                    result->AddRef();
+
+                    // We expect an announce interface message now...
+                    _connections.insert(std::pair<uint32_t, RemoteConnection*>(result->Id(), result));
+                    auto locator = _announcements.emplace(std::piecewise_construct,
+                        std::forward_as_tuple(result->Id()),
+                        std::forward_as_tuple(std::pair<Core::Event&, void*>(trigger, nullptr)));
+
+                    id = result->Id();
+
+                    _adminLock.Unlock();
+
+                    // Start the process, and....
+                    result->Launch(instance, config);
+
+                    // wait for the announce message to be exchanged
+                    if (trigger.Lock(waitTime) == Core::ERROR_NONE) {
+
+                        uint32_t interfaceId = instance.Interface();
+
+                        _adminLock.Lock();
+
+                        // Get the interface pointer that was stored during the triggering of the event...
+                        // It is reference counted so it has to be dereferenced by the caller.
+                        ProxyStub::UnknownProxy* proxyStub = RPC::Administrator::Instance().ProxyInstance(result->Channel(), locator.first->second.second, interfaceId, true, interfaceId, false);
+
+                        if (proxyStub != nullptr) {
+                            interfaceReturned = proxyStub->QueryInterface(interfaceId);
+                        }
+
+                    } else {
+                        _adminLock.Lock();
+
+                        // Seems we could not start the application. Cleanout
+                        result->Terminate();
+                    }
+
+                    // Kill the Event registration. We are no longer interested in what will be hapening..
+                    _announcements.erase(locator.first);
+                }
+                _adminLock.Unlock();
+
+                return (interfaceReturned);
+            }
+            void* Handover(uint32_t& id, const Object& instance, const Config& config, const uint32_t waitTime)
+            {
+                void* interfaceReturned = nullptr;
+
+                _adminLock.Lock();
+
+                Expire(waitTime);
+
+                std::list<RemoteProcess*>::iterator index(_standby.begin());
+
+                // Only a host that announced itself can take a plugin.
+                while ((index != _standby.end()) && ((*index)->IsOperational() == false)) {
+                    index++;
+                }
+
+                if (index == _standby.end()) {
+                    _adminLock.Unlock();
+                } else {
+                    RemoteProcess* host = *index;
 
-                ASSERT(index != _connections.end());
-                ASSERT(index->second->IsOperational() == false)
+                    _standby.erase(index);
+                    _handovers.push_back(host);
+                    host->AddRef();
 
-                // This is when we requested this interface/object to be created, there must be already an
-                // administration, it is just not complete.... yet!!!!
-                index->second->Open(channel);
-                channel->Extension().Link(*this, index->second->Id());
+                    _adminLock.Unlock();
+
+                    void* implementation = host->Handover(instance, config, waitTime);
+
+                    _adminLock.Lock();
 
-                Activated(index->second);
+                    _handovers.remove(host);
 
-                auto processConnection = _announcements.find(index->second->Id());
+                    // If the channel closed during the handover, Closed() removed the host already.
+                    std::map<uint32_t, Communicator::RemoteConnection*>::iterator connection(_connections.find(host->Id()));
 
-                if (processConnection != _announcements.end()) {
-                    processConnection->second.second = result;
-                    processConnection->second.first.SetEvent();
+                    if ((implementation != nullptr) && (connection != _connections.end()) && (host->IsOperational() == true)) {
+                        uint32_t interfaceId = instance.Interface();
+
+                        id = host->Id();
+
+                        Activated(host);
+
+                        ProxyStub::UnknownProxy* proxyStub = RPC::Administrator::Instance().ProxyInstance(host->Channel(), implementation, interfaceId, true, interfaceId, false);
+
+                        if (proxyStub != nullptr) {
+                            interfaceReturned = proxyStub->QueryInterface(interfaceId);
+                        }
+                    } else {
+                        // It was never activated, so it is not reported as deactivated either once it is gone.
+                        if (connection != _connections.end()) {
+                            connection->second->Release();
+                            _connections.erase(connection);
+                        }
+
+                        host->Terminate();
+                    }
+
+                    _adminLock.Unlock();
+
+                    host->Release();
+
+                    // Replace the host that was taken.
+                    Standby(config, 1);
+                }
+
+                return (interfaceReturned);
+            }
+            // Standby hosts that did not announce themselves within the time a launched host gets to announce
+            // itself, will not do so anymore. They are not replaced, whatever keeps them from starting would
+            // most likely keep their replacements from starting as well.
+            void Expire(const uint32_t waitTime)
+            {
+                if (waitTime != Core::infinite) {
+                    // The monotonic clock starts at boot, now minus the wait could wrap.
+                    const uint64_t now = Core::Time::Monotonic();
+                    const uint64_t grace = static_cast<uint64_t>(waitTime) * Core::Time::TicksPerMillisecond;
+                    std::list<RemoteProcess*>::iterator index(_standby.begin());
+
+                    while (index != _standby.end()) {
+                        RemoteProcess* host = *index;
+
+                        if ((host->IsOperational() == true) || ((host->Launched() + grace) > now)) {
+                            index++;
+                        } else {
+                            TRACE_L1("Standby host %d did not announce itself, terminating it.", host->Id());
+
+                            index = _standby.erase(index);
+
+                            std::map<uint32_t, Communicator::RemoteConnection*>::iterator connection(_connections.find(host->Id()));
+
+                            host->Terminate();
+
+                            if (connection != _connections.end()) {
+                                connection->second->Release();
+                                _connections.erase(connection);
+                            }
+                        }
+                    }
+                }
+            }
+
+            void Request(Core::ProxyType<Core::IPCChannelType<Core::SocketPort, ChannelLink>>& channel, const Data::Init& info)
+            {
+                void* result = info.Implementation();
+
+                std::map<uint32_t, Communicator::RemoteConnection*>::iterator index(_connections.find(info.ExchangeId()));
+
+                if (index == _connections.end()) {
+                    // A standby host that announced itself after it expired, it is terminated already.
+                    ASSERT(result == nullptr);
                 } else {
-                    // No one picks it up, release it..
-                    // TODO: Release an object that will never be used...
+                    ASSERT(index->second->IsOperational() == false)
+
+                    // This is when we requested this interface/object to be created, there must be already an
+                    // administration, it is just not complete.... yet!!!!
+                    index->second->Open(channel);
+                    channel->Extension().Link(*this, index->second->Id());
+
+                    if (result == nullptr) {
+                        // A standby host, without a plugin. It is activated once a plugin is handed over to it.
+                        ASSERT(std::find(_standby.begin(), _standby.end(), index->second) != _standby.end());
+                    } else {
+                        Activated(index->second);
+
+                        auto processConnection = _announcements.find(index->second->Id());
+
+                        if (processConnection != _announcements.end()) {
+                            processConnection->second.second = result;
+                            processConnection->second.first.SetEvent();
+                        } else {
+                            // No one picks it up, release it..
+                            // TODO: Release an object that will never be used...
+                        }
+                    }
                 }
             }
 
@@ -680,6 +895,10 @@ namespace RPC {
             mutable Core::CriticalSection _adminLock;
             std::map<uint32_t, std::pair<Core::Event&, void*>> _announcements;
             std::map<uint32_t, Communicator::RemoteConnection*> _connections;
+            // Hosts started upfront, that wait for a plugin to be handed over.
+            std::list<RemoteProcess*> _standby;
+            // Standby hosts that are being handed a plugin.
+            std::list<RemoteProcess*> _handovers;
             std::list<RPC::IRemoteConnection::INotification*> _observers;
             Communicator& _parent;
         };
@@ -878,6 +1097,11 @@ namespace RPC {
         {
             return (_connectionMap.Create(pid, instance, config, waitTime));
         }
+        // Keep a number of hosts, for the given configuration, up and running for plugins to be handed over to.
+        inline void Standby(const Config& config, const uint8_t count)
+        {
+            _connectionMap.Standby(config, count);
+        }
         void Destroy()
         {
             _connectionMap.Destroy();
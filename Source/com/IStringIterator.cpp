@@ -5,6 +5,11 @@
 namespace WPEFramework {
 namespace ProxyStub {
 
+    // Elements are shipped in batches of at most this many bytes or elements, so enumerating a small
+    // iterator takes a single round trip.
+    static constexpr uint32_t IteratorBatchSize = 4096;
+    static constexpr uint32_t IteratorBatchCount = 64;
+
     // -------------------------------------------------------------------------------------------
     // STUB
     // -------------------------------------------------------------------------------------------
@@ -64,6 +69,59 @@ namespace ProxyStub {
 
             response.Text(message->Parameters().Implementation<RPC::IStringIterator>()->Current());
         },
+        [](Core::ProxyType<Core::IPCChannel>& channel VARIABLE_IS_NOT_USED, Core::ProxyType<RPC::InvokeMessage>& message) {
+            // Not on the interface, used by the proxy to fetch a batch of elements in a single call, starting
+            // at the given position and moving forward or backward. The proxy tells where it left the cursor of
+            // the implementation, so a walk through the elements continues from there and only a jump resets it.
+            RPC::Data::Frame::Reader parameters(message->Parameters().Reader());
+            RPC::Data::Frame::Writer response(message->Response().Writer());
+
+            const uint32_t position(parameters.Number<uint32_t>());
+            const bool forward(parameters.Boolean());
+            uint32_t cursor(parameters.Number<uint32_t>());
+
+            RPC::IStringIterator* implementation = message->Parameters().Implementation<RPC::IStringIterator>();
+            const uint32_t count = implementation->Count();
+
+            std::list<string> batch;
+
+            if ((position > 0) && (position <= count)) {
+                const uint32_t start = (forward == true ? position - 1 : position + 1);
+                uint32_t size = 0;
+                bool valid = true;
+                string element;
+
+                if (cursor != start) {
+                    implementation->Reset(start);
+                }
+
+                cursor = start;
+
+                while ((valid == true) && (size < IteratorBatchSize) && (batch.size() < IteratorBatchCount)) {
+                    valid = (forward == true ? implementation->Next(element) : implementation->Previous(element));
+                    cursor = (forward == true ? cursor + 1 : cursor - 1);
+
+                    if (valid == true) {
+                        size += static_cast<uint32_t>(element.length()) + sizeof(uint16_t);
+
+                        if (forward == true) {
+                            batch.push_back(element);
+                        } else {
+                            batch.push_front(element);
+                        }
+                    }
+                }
+            }
+
+            response.Number<uint32_t>(count);
+            response.Number<uint32_t>(cursor);
+            response.Number<uint32_t>(forward == true ? position : position - static_cast<uint32_t>(batch.size()) + 1);
+            response.Number<uint16_t>(static_cast<uint16_t>(batch.size()));
+
+            for (const string& element : batch) {
+                response.Text(element);
+            }
+        },
         nullptr
     };
 
@@ -76,6 +134,11 @@ namespace ProxyStub {
     public:
         StringIteratorProxy(const Core::ProxyType<Core::IPCChannel>& channel, void* implementation, const bool otherSideInformed)
             : BaseClass(channel, implementation, otherSideInformed)
+            , _count(~0)
+            , _index(0)
+            , _first(0)
+            , _cursor(~0)
+            , _batch()
         {
             TRACE_L1("Constructed StringIteratorProxy: %p", this);
         }
@@ -85,84 +148,111 @@ namespace ProxyStub {
         }
 
     public:
+        // The position is kept on this side, the elements are fetched in batches and only when they are not
+        // here yet. So moving through the iterator does not cost a call per element. The count is a snapshot,
+        // taken with the first batch and taken again on every Reset().
         virtual bool Next(string& result) override
         {
-            bool valid = false;
-
-            IPCMessage newMessage(BaseClass::Message(0));
+            if (_index <= Count()) {
+                _index++;
 
-            if (Invoke(newMessage) == Core::ERROR_NONE) {
-
-                RPC::Data::Frame::Reader reader = newMessage->Response().Reader();
-                valid = reader.Boolean();
-
-                if (valid == true) {
-                    result = reader.Text();
+                if (_index <= Count()) {
+                    result = Element(_index, true);
                 }
             }
 
-            return (valid);
+            return (IsValid());
         }
         virtual bool Previous(string& result) override
         {
-            bool valid = false;
-            IPCMessage newMessage(BaseClass::Message(1));
+            if (_index != 0) {
+                _index = std::min(_index, Count() + 1) - 1;
 
-            if (Invoke(newMessage) == Core::ERROR_NONE) {
-
-                RPC::Data::Frame::Reader reader = newMessage->Response().Reader();
-                valid = reader.Boolean();
-
-                if (valid == true) {
-                    result = reader.Text();
+                if (_index > 0) {
+                    result = Element(_index, false);
                 }
             }
 
-            return (valid);
+            return (IsValid());
         }
         virtual void Reset(const uint32_t position) override
         {
-            IPCMessage newMessage(BaseClass::Message(2));
-            RPC::Data::Frame::Writer writer(newMessage->Parameters().Writer());
-            writer.Number(position);
+            // A fresh count, and the elements from the new position on, in a single call.
+            Fetch((position == 0 ? 1 : position), true);
 
-            Invoke(newMessage);
+            _index = std::min(position, Count() + 1);
         }
         virtual bool IsValid() const override
         {
-            bool result = false;
-            IPCMessage newMessage(BaseClass::Message(3));
-
-            if (Invoke(newMessage) == Core::ERROR_NONE) {
-                result = newMessage->Response().Reader().Boolean();
+            return ((_index > 0) && (_index <= Count()));
+        }
+        virtual uint32_t Count() const override
+        {
+            if (_count == static_cast<uint32_t>(~0)) {
+                // The first batch tells the size as well.
+                Fetch(1, true);
             }
 
-            return (result);
+            return (_count == static_cast<uint32_t>(~0) ? 0 : _count);
         }
-        virtual uint32_t Count() const override
+        virtual string Current() const override
         {
-            uint32_t result = 0;
-            IPCMessage newMessage(BaseClass::Message(4));
+            ASSERT(IsValid());
 
-            if (Invoke(newMessage) == Core::ERROR_NONE) {
-                result = newMessage->Response().Reader().Number<uint32_t>();
+            return (IsValid() == true ? Element(_index, true) : string());
+        }
+
+    private:
+        const string& Element(const uint32_t position, const bool forward) const
+        {
+            if ((position < _first) || (position >= (_first + _batch.size()))) {
+                Fetch(position, forward);
             }
 
-            return (result);
+            return ((position >= _first) && (position < (_first + _batch.size())) ? _batch[position - _first] : _default);
         }
-        virtual string Current() const override
+        void Fetch(const uint32_t position, const bool forward) const
         {
-            string result;
-            IPCMessage newMessage(BaseClass::Message(5));
+            IPCMessage newMessage(BaseClass::Message(6));
+            RPC::Data::Frame::Writer writer(newMessage->Parameters().Writer());
+            writer.Number<uint32_t>(position);
+            writer.Boolean(forward);
+            writer.Number<uint32_t>(_cursor);
+
+            _batch.clear();
+            _first = 0;
+            _cursor = ~0;
 
             if (Invoke(newMessage) == Core::ERROR_NONE) {
-                result = newMessage->Response().Reader().Text();
-            }
+                RPC::Data::Frame::Reader reader = newMessage->Response().Reader();
+
+                _count = reader.Number<uint32_t>();
+                _cursor = reader.Number<uint32_t>();
+                _first = reader.Number<uint32_t>();
+
+                uint16_t elements = reader.Number<uint16_t>();
 
-            return (result);
+                _batch.reserve(elements);
+
+                while (elements-- != 0) {
+                    _batch.push_back(reader.Text());
+                }
+            }
         }
+
+    private:
+        mutable uint32_t _count;
+        uint32_t _index;
+        // Position of the first element in the batch, and of the cursor of the implementation.
+        mutable uint32_t _first;
+        mutable uint32_t _cursor;
+        mutable std::vector<string> _batch;
+
+        static const string _default;
     };
 
+    /* static */ const string StringIteratorProxy::_default;
+
     // -------------------------------------------------------------------------------------------
     // Registration
     // -------------------------------------------------------------------------------------------
@@ -144,9 +144,34 @@ namespace ProxyStub {
         {
             ASSERT(_channel.IsValid() == true);
 
+            uint64_t start = Core::Time::Monotonic();
+            uint32_t traceId = RPC::CallTracer::Instance().Sample();
+            RPC::CallTracer::Span span;
+
+            if (traceId != 0) {
+                span.TraceId = traceId;
+                span.InterfaceId = message->Parameters().InterfaceId();
+                span.MethodId = message->Parameters().MethodId();
+                span.Sent = RPC::CallTracer::Timestamp();
+                message->Parameters().Trace(traceId, span.Sent);
+            }
+
             uint32_t result = _channel->Invoke(message, waitTime);
 
+            RPC::Administrator::Instance().Invoked(Core::Time::Monotonic() - start);
+
+            if ((traceId != 0) && (result == Core::ERROR_NONE)) {
+                span.Completed = RPC::CallTracer::Timestamp();
+
+                if (message->Response().Untrace(span.Received, span.Returned, span.StubProcess, span.StubThread) == true) {
+                    RPC::CallTracer::Instance().Record(span);
+                }
+            }
+
             if (result != Core::ERROR_NONE) {
+                // The parameters might still go out, while the buffers they refer to are gone with the caller.
+                message->Parameters().Detach();
+
                 // Oops something failed on the communication. Report it.
                 TRACE_L1("IPC method invokation failed for 0x%X", message->Parameters().InterfaceId());
                 TRACE_L1("IPC method invoke failed with error %d", result);
@@ -11,11 +11,72 @@ namespace RPC {
 
         class Frame : public Core::FrameType<IPC_BLOCK_SIZE> {
         private:
+            typedef Core::FrameType<IPC_BLOCK_SIZE> BaseClass;
+
             Frame(Frame&) = delete;
             Frame& operator=(const Frame&) = delete;
 
+            // Buffers smaller than this are cheaper to copy than to gather.
+            static constexpr uint32_t GatherThreshold = 1024;
+            static constexpr uint8_t MaxSegments = 4;
+
+            // A buffer that is not copied into the frame, but sent from where it is, as if it were in the
+            // frame at the given offset.
+            struct Segment {
+                uint32_t Offset;
+                uint32_t Length;
+                const uint8_t* Buffer;
+            };
+
         public:
-            Frame()
+            class Writer : public BaseClass::Writer {
+            public:
+                Writer()
+                    : BaseClass::Writer()
+                    , _frame(nullptr)
+                {
+                }
+                Writer(Frame& data, const uint32_t offset)
+                    : BaseClass::Writer(data, offset)
+                    , _frame(&data)
+                {
+                }
+                Writer(const Writer& copy)
+                    : BaseClass::Writer(copy)
+                    , _frame(copy._frame)
+                {
+                }
+                ~Writer()
+                {
+                }
+
+            public:
+                // As Buffer(), but a large buffer is sent from the memory of the caller, without copying it into
+                // the frame. So it must stay valid and unchanged until the call returns. The receiver gets the
+                // same as with Buffer().
+                template <typename TYPENAME>
+                void Reference(const TYPENAME length, const uint8_t buffer[])
+                {
+                    ASSERT(_frame != nullptr);
+
+                    if ((length >= GatherThreshold) && (_frame->Gather(Offset() + sizeof(TYPENAME), length, buffer) == true)) {
+                        Number<TYPENAME>(length);
+                    } else {
+                        Buffer<TYPENAME>(length, buffer);
+                    }
+                }
+
+            private:
+                Frame* _frame;
+            };
+
+        public:
+            explicit Frame(const bool gather = false)
+                : BaseClass()
+                , _lock()
+                , _gather(gather)
+                , _segments(0)
+                , _gathered(0)
             {
             }
             ~Frame()
@@ -27,15 +88,49 @@ namespace RPC {
             friend class Output;
             friend class ObjectInterface;
 
-            uint16_t Serialize(const uint16_t offset, uint8_t stream[], const uint16_t maxLength) const
+            inline void Clear()
             {
-                uint16_t copiedBytes((Size() - offset) > maxLength ? maxLength : (Size() - offset));
+                _segments = 0;
+                _gathered = 0;
+
+                BaseClass::Clear();
+            }
+            // The size on the wire, including the gathered buffers.
+            inline uint32_t Length() const
+            {
+                return (Size() + _gathered);
+            }
+            uint16_t Serialize(const uint32_t offset, uint8_t stream[], const uint16_t maxLength) const
+            {
+                uint16_t copiedBytes = 0;
+
+                if (_segments == 0) {
+                    copiedBytes = static_cast<uint16_t>(std::min(Size() - offset, static_cast<uint32_t>(maxLength)));
+
+                    ::memcpy(stream, &(operator[](offset)), copiedBytes);
+                } else {
+                    _lock.Lock();
+
+                    uint32_t position = 0;
+                    uint32_t internal = 0;
+
+                    for (uint8_t index = 0; index < _segments; index++) {
+                        const Segment& segment(_list[index]);
+
+                        Copy(position, offset, stream, maxLength, copiedBytes, (segment.Offset > internal ? &(operator[](internal)) : nullptr), segment.Offset - internal);
+                        Copy(position, offset, stream, maxLength, copiedBytes, segment.Buffer, segment.Length);
+
+                        internal = segment.Offset;
+                    }
+
+                    Copy(position, offset, stream, maxLength, copiedBytes, (Size() > internal ? &(operator[](internal)) : nullptr), Size() - internal);
 
-                ::memcpy(stream, &(operator[](offset)), copiedBytes);
+                    _lock.Unlock();
+                }
 
                 return (copiedBytes);
             }
-            uint16_t Deserialize(const uint16_t offset, const uint8_t stream[], const uint16_t maxLength)
+            uint16_t Deserialize(const uint32_t offset, const uint8_t stream[], const uint16_t maxLength)
             {
                 Size(offset + maxLength);
 
@@ -43,6 +138,78 @@ namespace RPC {
 
                 return (maxLength);
             }
+            // Copy the gathered buffers into the frame, the memory of the caller is not used anymore. Needed if
+            // the call did not complete, the frame might still be sent after the caller is gone.
+            void Detach()
+            {
+                if (_segments != 0) {
+                    _lock.Lock();
+
+                    uint32_t end = Size();
+                    uint32_t shift = _gathered;
+
+                    Size(Size() + _gathered);
+
+                    // Work from the back, so nothing is overwritten before it is moved.
+                    for (uint8_t index = _segments; index > 0; index--) {
+                        const Segment& segment(_list[index - 1]);
+
+                        shift -= segment.Length;
+
+                        if (end > segment.Offset) {
+                            ::memmove(&(operator[](segment.Offset + shift + segment.Length)), &(operator[](segment.Offset)), end - segment.Offset);
+                        }
+                        ::memcpy(&(operator[](segment.Offset + shift)), segment.Buffer, segment.Length);
+
+                        end = segment.Offset;
+                    }
+
+                    _gathered = 0;
+                    _segments = 0;
+
+                    _lock.Unlock();
+                }
+            }
+
+        private:
+            bool Gather(const uint32_t offset, const uint32_t length, const uint8_t buffer[])
+            {
+                bool result = ((_gather == true) && (_segments < MaxSegments));
+
+                if (result == true) {
+                    ASSERT((_segments == 0) || (_list[_segments - 1].Offset <= offset));
+
+                    _list[_segments].Offset = offset;
+                    _list[_segments].Length = length;
+                    _list[_segments].Buffer = buffer;
+                    _gathered += length;
+                    _segments++;
+                }
+
+                return (result);
+            }
+            static void Copy(uint32_t& position, const uint32_t offset, uint8_t stream[], const uint16_t maxLength, uint16_t& copiedBytes, const uint8_t source[], const uint32_t length)
+            {
+                // The part of this piece, that is the next to go out, if any.
+                const uint32_t next = offset + copiedBytes;
+
+                if ((copiedBytes < maxLength) && (next >= position) && (next < (position + length))) {
+                    const uint16_t size = static_cast<uint16_t>(std::min((position + length) - next, static_cast<uint32_t>(maxLength - copiedBytes)));
+
+                    ::memcpy(&(stream[copiedBytes]), &(source[next - position]), size);
+
+                    copiedBytes += size;
+                }
+
+                position += length;
+            }
+
+        private:
+            mutable Core::CriticalSection _lock;
+            const bool _gather;
+            std::atomic<uint8_t> _segments;
+            uint32_t _gathered;
+            Segment _list[MaxSegments];
         };
 
         class Input {
@@ -50,9 +217,20 @@ namespace RPC {
             Input(const Input&) = delete;
             Input& operator=(const Input&) = delete;
 
+            static constexpr uint16_t MethodOffset = sizeof(void*) + sizeof(uint32_t);
+
+            // Closes the trace information of a call. It is mixed with the trace id and the time, so
+            // parameters that happen to end in the same bytes are not taken for a trace.
+            static constexpr uint32_t TraceMagic = 0x54524143; // "TRAC"
+
+        public:
+            // A traced call carries the trace id and the time it was sent behind the parameters. Stubs
+            // read their parameters from the front, so one that does not know about tracing ignores it.
+            static constexpr uint16_t TraceSize = (2 * sizeof(uint32_t)) + sizeof(uint64_t);
+
         public:
             Input()
-                : _data()
+                : _data(true)
             {
             }
             ~Input()
@@ -66,7 +244,7 @@ namespace RPC {
             }
             void Set(void* implementation, const uint32_t interfaceId, const uint8_t methodId)
             {
-                uint16_t result = _data.SetNumber<void*>(0, implementation);
+                uint32_t result = _data.SetNumber<void*>(0, implementation);
                 result += _data.SetNumber<uint32_t>(result, interfaceId);
                 _data.SetNumber(result, methodId);
             }
@@ -91,13 +269,57 @@ namespace RPC {
             {
                 uint8_t result = 0;
 
-                _data.GetNumber(sizeof(void*) + sizeof(uint32_t), result);
+                _data.GetNumber(MethodOffset, result);
 
                 return (result);
             }
+            bool IsTraced() const
+            {
+                bool result = false;
+
+                if (_data.Size() >= (MethodOffset + sizeof(uint8_t) + TraceSize)) {
+                    const uint32_t offset = _data.Size() - TraceSize;
+                    uint32_t traceId = 0;
+                    uint64_t sent = 0;
+                    uint32_t check = 0;
+
+                    _data.GetNumber<uint32_t>(offset, traceId);
+                    _data.GetNumber<uint64_t>(offset + sizeof(uint32_t), sent);
+                    _data.GetNumber<uint32_t>(offset + sizeof(uint32_t) + sizeof(uint64_t), check);
+
+                    result = (check == Check(traceId, sent));
+                }
+
+                return (result);
+            }
+            // Only after all parameters are written.
+            void Trace(const uint32_t traceId, const uint64_t sent)
+            {
+                uint32_t offset = _data.Size();
+
+                offset += _data.SetNumber<uint32_t>(offset, traceId);
+                offset += _data.SetNumber<uint64_t>(offset, sent);
+                _data.SetNumber<uint32_t>(offset, Check(traceId, sent));
+            }
+            // Takes the trace information off, before the stub reads the parameters.
+            void Untrace(uint32_t& traceId, uint64_t& sent)
+            {
+                ASSERT(IsTraced() == true);
+
+                uint32_t offset = _data.Size() - TraceSize;
+
+                _data.GetNumber<uint32_t>(offset, traceId);
+                _data.GetNumber<uint64_t>(offset + sizeof(uint32_t), sent);
+                _data.Size(offset);
+            }
             uint32_t Length() const
             {
-                return (_data.Size());
+                return (_data.Length());
+            }
+            // See Frame::Detach.
+            inline void Detach()
+            {
+                _data.Detach();
             }
             inline Frame::Writer Writer()
             {
@@ -109,11 +331,17 @@ namespace RPC {
             }
             uint16_t Serialize(uint8_t stream[], const uint16_t maxLength, const uint32_t offset) const
             {
-                return (_data.Serialize(static_cast<uint16_t>(offset), stream, maxLength));
+                return (_data.Serialize(offset, stream, maxLength));
             }
             uint16_t Deserialize(const uint8_t stream[], const uint16_t maxLength, const uint32_t offset)
             {
-                return (_data.Deserialize(static_cast<uint16_t>(offset), stream, maxLength));
+                return (_data.Deserialize(offset, stream, maxLength));
+            }
+
+        private:
+            static inline uint32_t Check(const uint32_t traceId, const uint64_t sent)
+            {
+                return (TraceMagic ^ traceId ^ static_cast<uint32_t>(sent) ^ static_cast<uint32_t>(sent >> 32));
             }
 
         private:
@@ -125,6 +353,12 @@ namespace RPC {
             Output(const Output&) = delete;
             Output& operator=(const Output&) = delete;
 
+            // Closes the trace information of an answer, so an answer without it is never taken apart.
+            static constexpr uint32_t TraceMagic = 0x54524143; // "TRAC"
+
+        public:
+            static constexpr uint16_t TraceSize = (2 * sizeof(uint64_t)) + (3 * sizeof(uint32_t));
+
         public:
             Output()
                 : _data()
@@ -152,17 +386,46 @@ namespace RPC {
                 _data.SetNumber<void*>(_data.Size(), implementation);
                 _data.SetNumber<uint32_t>(_data.Size(), id);
             }
+            // The answer to a traced call carries the stub side timestamps and the thread that handled it
+            // behind the results. Only the proxy that traced the call knows to take them off.
+            inline void Trace(const uint64_t received, const uint64_t returned, const uint32_t process, const uint32_t thread)
+            {
+                _data.SetNumber<uint64_t>(_data.Size(), received);
+                _data.SetNumber<uint64_t>(_data.Size(), returned);
+                _data.SetNumber<uint32_t>(_data.Size(), process);
+                _data.SetNumber<uint32_t>(_data.Size(), thread);
+                _data.SetNumber<uint32_t>(_data.Size(), TraceMagic);
+            }
+            // Leaves the answer as it is, if the stub side did not add the trace information.
+            inline bool Untrace(uint64_t& received, uint64_t& returned, uint32_t& process, uint32_t& thread)
+            {
+                uint32_t magic = 0;
+                bool result = ((_data.Size() >= TraceSize) && (_data.GetNumber<uint32_t>(_data.Size() - sizeof(uint32_t), magic) == sizeof(uint32_t)) && (magic == TraceMagic));
+
+                if (result == true) {
+                    const uint32_t length = _data.Size() - TraceSize;
+                    uint32_t offset = length;
+
+                    offset += _data.GetNumber<uint64_t>(offset, received);
+                    offset += _data.GetNumber<uint64_t>(offset, returned);
+                    offset += _data.GetNumber<uint32_t>(offset, process);
+                    _data.GetNumber<uint32_t>(offset, thread);
+                    _data.Size(length);
+                }
+
+                return (result);
+            }
             inline uint32_t Length() const
             {
                 return (static_cast<uint32_t>(_data.Size()));
             }
             inline uint16_t Serialize(uint8_t stream[], const uint16_t maxLength, const uint32_t offset) const
             {
-                return (_data.Serialize(static_cast<uint16_t>(offset), stream, maxLength));
+                return (_data.Serialize(offset, stream, maxLength));
             }
             inline uint16_t Deserialize(const uint8_t stream[], const uint16_t maxLength, const uint32_t offset)
             {
-                return (_data.Deserialize(static_cast<uint16_t>(offset), stream, maxLength));
+                return (_data.Deserialize(offset, stream, maxLength));
             }
 
         private:
@@ -299,7 +562,7 @@ namespace RPC {
             void Set(void* implementation, const string& proxyStubPath, const string& traceCategories)
             {
                 _data.SetNumber<void*>(0, implementation);
-                uint16_t length = _data.SetText(sizeof(void*), proxyStubPath);
+                uint32_t length = _data.SetText(sizeof(void*), proxyStubPath);
                 _data.SetText(sizeof(void*) + length, traceCategories);
             }
 			inline bool IsSet() const {
@@ -337,11 +600,11 @@ namespace RPC {
             }
             uint16_t Serialize(uint8_t stream[], const uint16_t maxLength, const uint32_t offset) const
             {
-                return (_data.Serialize(static_cast<uint16_t>(offset), stream, maxLength));
+                return (_data.Serialize(offset, stream, maxLength));
             }
             uint16_t Deserialize(const uint8_t stream[], const uint16_t maxLength, const uint32_t offset)
             {
-                return (_data.Deserialize(static_cast<uint16_t>(offset), stream, maxLength));
+                return (_data.Deserialize(offset, stream, maxLength));
             }
 
         private:
@@ -351,6 +614,10 @@ namespace RPC {
 
     typedef Core::IPCMessageType<1, Data::Init, Data::Setup> AnnounceMessage;
     typedef Core::IPCMessageType<2, Data::Input, Data::Output> InvokeMessage;
+    // Hands a plugin to a host process that was started upfront and is waiting for one (see
+    // Communicator::Standby). Locator, class name, interface, version, persistent and data path go in,
+    // the implementation comes back.
+    typedef Core::IPCMessageType<3, Data::Output, Data::Output> HandoverMessage;
 }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Administrator.h"
+#include "CallTracer.h"
 #include "Communicator.h"
 #include "IStringIterator.h"
 #include "ITracing.h"
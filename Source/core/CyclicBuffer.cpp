@@ -1,17 +1,79 @@
 #include "CyclicBuffer.h"
 #include "ProcessInfo.h"
 
+#if defined(__LINUX__) && !defined(__APPLE__)
+#include <climits>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
 namespace WPEFramework {
 namespace Core {
 
-    CyclicBuffer::CyclicBuffer(const string& fileName, const uint32_t bufferSize, const bool overwrite)
+#if defined(__LINUX__) && !defined(__APPLE__)
+    // The administration is shared between processes, so the non-private futex operations are used.
+    template <typename TYPE>
+    static int FutexWait(std::atomic<TYPE>& word, const TYPE expected, const uint32_t waitTime)
+    {
+        static_assert(sizeof(std::atomic<TYPE>) == sizeof(int), "Futexes operate on 32 bit words");
+
+        struct timespec timeout;
+
+        if (waitTime != Core::infinite) {
+            timeout.tv_sec = waitTime / 1000;
+            timeout.tv_nsec = (waitTime % 1000) * 1000 * 1000;
+        }
+
+        return (::syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT, static_cast<int>(expected), (waitTime != Core::infinite ? &timeout : nullptr), nullptr, 0));
+    }
+
+    template <typename TYPE>
+    static void FutexWake(std::atomic<TYPE>& word, const int count)
+    {
+        ::syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+    }
+
+    // How long a producer waits for a reservation, before it checks if its owner is still alive.
+    static constexpr uint32_t ReservationCheck = 100; // ms
+
+    // The leases are locks on the bytes following the futex words, one byte per lease.
+    static constexpr uint32_t MaxLeases = 1024;
+
+    static int LeaseLock(const int descriptor, const short type, const off_t offset)
+    {
+        struct flock lock;
+
+        ::memset(&lock, 0, sizeof(lock));
+        lock.l_type = type;
+        lock.l_whence = SEEK_SET;
+        lock.l_start = offset;
+        lock.l_len = 1;
+
+        return (::fcntl(descriptor, F_OFD_SETLK, &lock));
+    }
+#endif
+
+    // The futex words follow the data, aligned on a 32 bits boundary.
+    static inline uint32_t FutexOffset(const uint32_t bufferSize)
+    {
+        return (sizeof(CyclicBuffer::control) + ((bufferSize + 3) & (~3)));
+    }
+
+    CyclicBuffer::CyclicBuffer(const string& fileName, const uint32_t bufferSize, const bool overwrite, const bool lockFree, const DataElementFile::Mapping& mapping)
         : _buffer(
               fileName,
-              static_cast<DataElementFile::FileState>(DataElementFile::WRITABLE | DataElementFile::READABLE | DataElementFile::SHAREABLE | (bufferSize > 0 ? DataElementFile::CREATE : 0)),
-              (bufferSize == 0 ? 0 : (bufferSize + sizeof(const control))))
+              static_cast<DataElementFile::FileState>(DataElementFile::WRITABLE | DataElementFile::READABLE | DataElementFile::SHAREABLE | (bufferSize > 0 ? DataElementFile::CREATE : 0) | mapping.Options()),
+              (bufferSize == 0 ? 0 : (FutexOffset(bufferSize) + sizeof(futexes))))
         , _realBuffer(&(_buffer.Buffer()[sizeof(struct control)]))
         , _alert(false)
+#if defined(__LINUX__) && !defined(__APPLE__)
+        , _leases(-1)
+        , _lease(0)
+#endif
         , _administration(_buffer.IsValid() ? reinterpret_cast<struct control*>(_buffer.Buffer()) : nullptr)
+        , _futexes(nullptr)
     {
 
         if (_buffer.IsValid() != true) {
@@ -28,14 +90,32 @@ namespace Core {
             if (bufferSize != 0) {
 
 #ifndef __WIN32__
-                (_administration)->_signal = PTHREAD_COND_INITIALIZER;
-                (_administration)->_mutex = PTHREAD_MUTEX_INITIALIZER;
+                pthread_mutexattr_t mutexAttr;
+                pthread_mutexattr_init(&mutexAttr);
+                pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+                pthread_mutex_init(&(_administration->_mutex), &mutexAttr);
+                pthread_mutexattr_destroy(&mutexAttr);
+
+                pthread_condattr_t condAttr;
+                pthread_condattr_init(&condAttr);
+                pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+                pthread_cond_init(&(_administration->_signal), &condAttr);
+                pthread_condattr_destroy(&condAttr);
+#endif
+#if defined(__LINUX__) && !defined(__APPLE__)
+                _futexes = reinterpret_cast<futexes*>(&(_buffer.Buffer()[FutexOffset(bufferSize)]));
+                _futexes->_lock.store(0);
+                _futexes->_sequence.store(0);
+                _futexes->_producers.store(0);
+#else
+                // The futex based administration is only available on linux.
+                ASSERT(lockFree == false);
 #endif
 
                 _administration->_head.store(0);
                 _administration->_tail.store(0);
                 _administration->_agents.store(0);
-                _administration->_state.store(state::UNLOCKED /* state::EMPTY */ | (overwrite ? state::OVERWRITE : 0));
+                _administration->_state.store(state::UNLOCKED /* state::EMPTY */ | (overwrite ? state::OVERWRITE : 0) | (lockFree ? state::LOCKFREE : 0));
                 _administration->_lockPID = 0;
                 _administration->_size = bufferSize;
 
@@ -52,16 +132,121 @@ namespace Core {
             }
 
             _maxSize = _administration->_size;
+
+            // A buffer created by a process that predates the futex words, does not have them (nor uses them).
+            if ((_futexes == nullptr) && (_buffer.Size() >= (FutexOffset(_maxSize) + sizeof(futexes)))) {
+                _futexes = reinterpret_cast<futexes*>(&(_buffer.Buffer()[FutexOffset(_maxSize)]));
+            }
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+            if (IsLockFree() == true) {
+                Lease();
+            }
+#endif
         }
     }
 
     CyclicBuffer::~CyclicBuffer()
     {
+#if defined(__LINUX__) && !defined(__APPLE__)
+        if (_leases != -1) {
+            // Closing the file description releases the lease.
+            ::close(_leases);
+        }
+#endif
+    }
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+    void CyclicBuffer::Lease()
+    {
+        // The lease must be held on a file description of its own, a dup of the one of the mapping would share it.
+        _leases = ::open(_buffer.Name().c_str(), O_RDWR | O_CLOEXEC);
+
+        if (_leases == -1) {
+            TRACE_L1("Could not open a lease on CyclicBuffer: %s, error: %d", _buffer.Name().c_str(), errno);
+        } else {
+            off_t base = FutexOffset(_maxSize) + sizeof(futexes);
+            uint32_t slot = 0;
+
+            while ((slot < MaxLeases) && (LeaseLock(_leases, F_WRLCK, base + slot) != 0)) {
+                slot++;
+            }
+
+            if (slot == MaxLeases) {
+                TRACE_L1("No lease available on CyclicBuffer: %s", _buffer.Name().c_str());
+            } else {
+                _lease = static_cast<pid_t>(slot + 1);
+
+                // If the previous holder of this lease died halfway its reservation, nobody else will see it die
+                // anymore, we hold its lease now, so drop its reservation here.
+                pid_t expected = _lease;
+
+                if (atomic_compare_exchange_strong(&(_administration->_reservedPID), &expected, static_cast<pid_t>(0)) == true) {
+                    TRACE_L1("Dropping the reservation of lease %d, its owner is gone.", _lease);
+                    FutexWake(_administration->_reservedPID, 1);
+                }
+            }
+        }
+    }
+
+    // The owner of a lease that can be taken, is gone. While we hold it, no new owner can take it and
+    // make a reservation with it, so the reservation can be dropped safely. Our own lease is always held,
+    // on our own file description the lock would be granted, so it is never reclaimed here.
+    void CyclicBuffer::Reclaim(const pid_t lease)
+    {
+        if ((_leases != -1) && (lease != _lease) && (lease > 0) && (static_cast<uint32_t>(lease) <= MaxLeases)) {
+            off_t offset = FutexOffset(_maxSize) + sizeof(futexes) + (lease - 1);
+
+            if (LeaseLock(_leases, F_WRLCK, offset) == 0) {
+                pid_t expected = lease;
+
+                if (atomic_compare_exchange_strong(&(_administration->_reservedPID), &expected, static_cast<pid_t>(0)) == true) {
+                    TRACE_L1("Dropping the reservation of lease %d, its owner is gone.", lease);
+                    FutexWake(_administration->_reservedPID, 1);
+                }
+
+                LeaseLock(_leases, F_UNLCK, offset);
+            }
+        }
+    }
+#endif
+
+#ifdef __WIN32__
+    DWORD CyclicBuffer::Producer() const
+    {
+        return (::GetCurrentProcessId());
+    }
+#else
+    pid_t CyclicBuffer::Producer() const
+    {
+#if defined(__LINUX__) && !defined(__APPLE__)
+        return ((IsLockFree() == true) && (_lease != 0) ? _lease : ::getpid());
+#else
+        return (::getpid());
+#endif
     }
+#endif
 
     void CyclicBuffer::AdminLock()
     {
 #ifdef __POSIX__
+#if defined(__LINUX__) && !defined(__APPLE__)
+        if (IsLockFree() == true) {
+            uint32_t value = 0;
+
+            if (std::atomic_compare_exchange_strong(&(_futexes->_lock), &value, static_cast<uint32_t>(1)) == false) {
+                // Contended, mark it as such, so the owner knows it has to wake us.
+                if (value != 2) {
+                    value = _futexes->_lock.exchange(2);
+                }
+                while (value != 0) {
+                    FutexWait<uint32_t>(_futexes->_lock, 2, Core::infinite);
+                    value = _futexes->_lock.exchange(2);
+                }
+            }
+            return;
+        }
+#endif
         pthread_mutex_lock(&(_administration->_mutex));
 #else
 #ifdef __DEBUG__
@@ -88,21 +273,20 @@ namespace Core {
             clock_gettime(CLOCK_REALTIME, &structTime);
 
             structTime.tv_nsec += ((waitTime % 1000) * 1000 * 1000); /* remainder, milliseconds to nanoseconds */
-            structTime.tv_sec += (waitTime / 1000); // + (structTime.tv_nsec / 1000000000); /* milliseconds to seconds */
+            structTime.tv_sec += (waitTime / 1000) + (structTime.tv_nsec / 1000000000); /* milliseconds to seconds */
             structTime.tv_nsec = structTime.tv_nsec % 1000000000;
 
             if (pthread_cond_timedwait(&(_administration->_signal), &(_administration->_mutex), &structTime) != 0) {
+                // Timed out, no time left.
+                result = 0;
+            } else {
                 struct timespec nowTime;
 
                 clock_gettime(CLOCK_REALTIME, &nowTime);
-                if (nowTime.tv_nsec > structTime.tv_nsec) {
 
-                    result = (nowTime.tv_sec - structTime.tv_sec) * 1000 + ((nowTime.tv_nsec - structTime.tv_nsec) / 1000000);
-                } else {
+                int64_t left = ((static_cast<int64_t>(structTime.tv_sec) - nowTime.tv_sec) * 1000) + ((static_cast<int64_t>(structTime.tv_nsec) - nowTime.tv_nsec) / 1000000);
 
-                    result = (nowTime.tv_sec - structTime.tv_sec - 1) * 1000 + ((1000000000 - (structTime.tv_nsec - nowTime.tv_nsec)) / 1000000);
-                }
-                printf("End wait. %d\n", result);
+                result = (left <= 0 ? 0 : (left > waitTime ? waitTime : static_cast<uint32_t>(left)));
             }
 #else
             if (::WaitForSingleObjectEx(_signal, waitTime, FALSE) == WAIT_OBJECT_0) {
@@ -124,9 +308,41 @@ namespace Core {
         return (result);
     }
 
+#if defined(__LINUX__) && !defined(__APPLE__)
+    // This is in MS, the sequence is the value of the signal word before the admin lock was released.
+    uint32_t CyclicBuffer::SignalLock(const uint32_t sequence, const uint32_t waitTime)
+    {
+        uint32_t result = waitTime;
+
+        if (waitTime != Core::infinite) {
+            uint64_t start = Core::Time::Now().Ticks();
+
+            FutexWait<uint32_t>(_futexes->_sequence, sequence, waitTime);
+
+            uint32_t elapsed = static_cast<uint32_t>((Core::Time::Now().Ticks() - start) / Core::Time::TicksPerMillisecond);
+
+            result = (elapsed >= waitTime ? 0 : waitTime - elapsed);
+        } else {
+            FutexWait<uint32_t>(_futexes->_sequence, sequence, Core::infinite);
+        }
+
+        return (result);
+    }
+#endif
+
     void CyclicBuffer::AdminUnlock()
     {
 #ifdef __POSIX__
+#if defined(__LINUX__) && !defined(__APPLE__)
+        if (IsLockFree() == true) {
+            if (_futexes->_lock.fetch_sub(1) != 1) {
+                // There are waiters, release it completely and wake one.
+                _futexes->_lock.store(0);
+                FutexWake<uint32_t>(_futexes->_lock, 1);
+            }
+            return;
+        }
+#endif
         pthread_mutex_unlock(&(_administration->_mutex));
 #else
         ReleaseSemaphore(_mutex, 1, nullptr);
@@ -138,22 +354,33 @@ namespace Core {
 
     void CyclicBuffer::Reevaluate()
     {
+#if defined(__LINUX__) && !defined(__APPLE__)
+        if (IsLockFree() == true) {
+            // The agents compare the sequence they sampled with the current one, so no trigger is lost
+            // and there is no need to wait till they have all seen it.
+            _futexes->_sequence++;
+
+            if (_administration->_agents.load() > 0) {
+                FutexWake<uint32_t>(_futexes->_sequence, INT_MAX);
+            }
+            return;
+        }
+#endif
 
         // See if we need to have some interested actor reevaluate its state..
         if (_administration->_agents.load() > 0) {
 
 #ifdef __POSIX__
-            for (int index = _administration->_agents.load(); index != 0; index--) {
-                pthread_cond_signal(&(_administration->_signal));
-            }
+            // The agents wait with the admin lock taken, which we hold now, so they will all see it.
+            pthread_cond_broadcast(&(_administration->_signal));
 #else
             ReleaseSemaphore(_signal, _administration->_agents.load(), nullptr);
-#endif
 
             // Wait till all waiters have seen the trigger..
             while (_administration->_agents.load() > 0) {
                 SleepMs(0);
             }
+#endif
         }
     }
 
@@ -196,29 +423,56 @@ namespace Core {
                 return 0;
             }
 
-            foundData = true;
+            CopyOut(offset, buffer, result);
 
-            uint32_t roundCount = oldTail / (1 + _administration->_tailIndexMask);
-            if ((offset + result) < _maxSize) {
-                memcpy(buffer, _realBuffer + offset, result);
+            // The tail, including the round count, after the data we just read.
+            uint32_t newTail = cursor.GetCompleteTail(result);
 
-                uint32_t newTail = offset + result + roundCount * (1 + _administration->_tailIndexMask);
-                if (!std::atomic_compare_exchange_weak(&(_administration->_tail), &oldTail, newTail)) {
-                    foundData = false;
-                }
+            foundData = std::atomic_compare_exchange_weak(&(_administration->_tail), &oldTail, newTail);
+        }
+
+        return (result);
+    }
+
+    uint32_t CyclicBuffer::Claim(const uint32_t length, Span& span)
+    {
+        ASSERT(length <= _maxSize);
+
+        uint32_t result = 0;
+        uint32_t oldTail = _administration->_tail;
+        uint32_t offset = oldTail & _administration->_tailIndexMask;
+
+        span = Span();
+
+        if (Used(_administration->_head, offset) > 0) {
+
+            Cursor cursor(*this, oldTail, length);
+            result = GetReadSize(cursor);
+
+            if ((result == 0) || (result > length)) {
+                // No data, or too much, nothing to claim.
+                result = 0;
             } else {
-                uint32_t part1(_maxSize - offset);
-                uint32_t part2(result - part1);
+                span.Set(_realBuffer, _maxSize, offset, result);
+                span._tail = oldTail;
+            }
+        }
 
-                memcpy(buffer, _realBuffer + offset, part1);
-                memcpy(buffer + part1, _realBuffer, part2);
+        return (result);
+    }
 
-                // Add one round, but prevent overflow.
-                roundCount = (roundCount + 1) % _administration->_roundCountModulo;
-                uint32_t newTail = part2 + roundCount * (1 + _administration->_tailIndexMask);
-                if (!std::atomic_compare_exchange_weak(&(_administration->_tail), &oldTail, newTail)) {
-                    foundData = false;
-                }
+    uint32_t CyclicBuffer::Release(const Span& span)
+    {
+        uint32_t result = 0;
+
+        if (span.Size() > 0) {
+            uint32_t oldTail = span._tail;
+            Cursor cursor(*this, oldTail, span.Size());
+            uint32_t newTail = cursor.GetCompleteTail(span.Size());
+
+            // If the tail moved, a writer overwrote (part of) the claimed region.
+            if (std::atomic_compare_exchange_strong(&(_administration->_tail), &oldTail, newTail) == true) {
+                result = span.Size();
             }
         }
 
@@ -226,6 +480,21 @@ namespace Core {
     }
 
     uint32_t CyclicBuffer::Write(const uint8_t buffer[], const uint32_t length)
+    {
+        ASSERT(buffer != nullptr);
+
+        return (Produce(buffer, length));
+    }
+
+    uint32_t CyclicBuffer::Commit(const uint32_t length)
+    {
+        // The data is already in place, it was written through the span handed out on Reserve.
+        ASSERT(_administration->_reservedPID != 0);
+
+        return (Produce(nullptr, length));
+    }
+
+    uint32_t CyclicBuffer::Produce(const uint8_t buffer[], const uint32_t length)
     {
         ASSERT(length < _maxSize);
 
@@ -233,15 +502,11 @@ namespace Core {
         bool startingEmpty = (Used() == 0);
         uint32_t writeStart = head;
         bool shouldMoveHead = true;
+        bool completedReservation = false;
 
         if (_administration->_reservedPID != 0) {
-#ifdef __WIN32__
             // We are writing because of reservation.
-            ASSERT(_administration->_reservedPID == ::GetCurrentProcessId());
-#else
-            // We are writing because of reservation.
-            ASSERT(_administration->_reservedPID == ::getpid());
-#endif
+            ASSERT(_administration->_reservedPID == Producer());
 
             // Check if we are not writing more than reserved.
             uint32_t newReservedWritten = _administration->_reservedWritten + length;
@@ -254,8 +519,8 @@ namespace Core {
             _administration->_reservedWritten = newReservedWritten;
 
             if (newReservedWritten == _administration->_reserved) {
-                // We have all the data that was reserved for, clear reserving PID.
-                _administration->_reservedPID = 0;
+                // We have all the data that was reserved for, clear reserving PID once the head is moved.
+                completedReservation = true;
             } else {
                 // Not yet all data, hold off with moving head.
                 shouldMoveHead = false;
@@ -268,31 +533,39 @@ namespace Core {
             writeStart = head;
         }
 
-        // Perform actual copy.
+        // Perform actual copy, if it is not already in place.
         uint32_t writeEnd = (writeStart + length) % _maxSize;
-        if (writeEnd > writeStart) {
-            // Easy case: one pass.
-            memcpy(_realBuffer + writeStart, buffer, length);
-        } else {
-            // Copying beyond end of buffer, do in two passes.
-            uint32_t firstLength = _maxSize - writeStart;
-            uint32_t secondLength = length - firstLength;
 
-            memcpy(_realBuffer + writeStart, buffer, firstLength);
-            memcpy(_realBuffer, buffer + firstLength, secondLength);
+        if (buffer != nullptr) {
+            CopyIn(writeStart, buffer, length);
         }
 
         if (shouldMoveHead) {
             _administration->_head = writeEnd;
 
+            if (completedReservation == true) {
+                _administration->_reservedPID = 0;
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+                if ((IsLockFree() == true) && (_futexes->_producers.load() > 0)) {
+                    FutexWake(_administration->_reservedPID, 1);
+                }
+#endif
+            }
+
             if (startingEmpty) {
                 // Was empty before, tell observers about new data.
-                AdminLock();
+                if (IsLockFree() == true) {
+                    Reevaluate();
+                    DataAvailable();
+                } else {
+                    AdminLock();
 
-                Reevaluate();
-                DataAvailable();
+                    Reevaluate();
+                    DataAvailable();
 
-                AdminUnlock();
+                    AdminUnlock();
+                }
             }
         }
 
@@ -328,15 +601,38 @@ namespace Core {
 
     uint32_t CyclicBuffer::Reserve(const uint32_t length)
     {
+        return (Reserve(Producer(), length));
+    }
+
 #ifdef __WIN32__
-        DWORD processId = GetCurrentProcessId();
+    uint32_t CyclicBuffer::Reserve(const DWORD processId, const uint32_t length)
+    {
         DWORD expectedProcessId = static_cast<DWORD>(0);
 #else
-        pid_t processId = ::getpid();
+    uint32_t CyclicBuffer::Reserve(const pid_t processId, const uint32_t length)
+    {
         pid_t expectedProcessId = static_cast<pid_t>(0);
 #endif
 
         bool noOtherReservation = atomic_compare_exchange_strong(&(_administration->_reservedPID), &expectedProcessId, processId);
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+        // With multiple producers, wait till the reservation in progress is written.
+        while ((noOtherReservation == false) && (IsLockFree() == true)) {
+            _futexes->_producers++;
+
+            if ((FutexWait(_administration->_reservedPID, expectedProcessId, ReservationCheck) != 0) && (errno == ETIMEDOUT)) {
+                // If the owner died halfway its reservation, the head never moved, so what it reserved is dropped.
+                Reclaim(expectedProcessId);
+            }
+
+            _futexes->_producers--;
+
+            expectedProcessId = 0;
+            noOtherReservation = atomic_compare_exchange_strong(&(_administration->_reservedPID), &expectedProcessId, processId);
+        }
+#endif
+
         ASSERT(noOtherReservation);
 
         if (!noOtherReservation)
@@ -357,6 +653,24 @@ namespace Core {
         return actualLength;
     }
 
+    uint32_t CyclicBuffer::Reserve(const uint32_t length, Span& span)
+    {
+#ifdef __WIN32__
+        DWORD processId = Producer();
+#else
+        pid_t processId = Producer();
+#endif
+        uint32_t result = Reserve(processId, length);
+
+        if (_administration->_reservedPID == processId) {
+            span.Set(_realBuffer, _maxSize, _administration->_head, _administration->_reserved);
+        } else {
+            span = Span();
+        }
+
+        return (result);
+    }
+
     uint32_t CyclicBuffer::Lock(const bool dataPresent, const uint32_t waitTime)
     {
         uint32_t result = Core::ERROR_TIMEDOUT;
@@ -370,7 +684,7 @@ namespace Core {
 
         do {
 
-            if ((((_administration->_state.load()) & state::LOCKED) != state::LOCKED) && ((dataPresent == false) || (Used() > 0))) {
+            if (IsAvailable(dataPresent) == true) {
                 std::atomic_fetch_or(&(_administration->_state), static_cast<uint16_t>(state::LOCKED));
 
                 // Remember that we, as a process, took the lock
@@ -380,13 +694,39 @@ namespace Core {
 
                 _administration->_agents++;
 
-                AdminUnlock();
+#if defined(__LINUX__) && !defined(__APPLE__)
+                if (IsLockFree() == true) {
+                    uint32_t sequence = _futexes->_sequence.load();
 
-                timeLeft = SignalLock(timeLeft);
+                    // A write into an empty buffer does not take the admin lock in this mode, so check
+                    // again after we announced ourselves, a write before this point is not signalled.
+                    if (IsAvailable(dataPresent) == false) {
+                        AdminUnlock();
 
-                _administration->_agents--;
+                        timeLeft = SignalLock(sequence, timeLeft);
+
+                        AdminLock();
+                    }
+
+                    _administration->_agents--;
+                } else
+#endif
+                {
+#ifdef __POSIX__
+                    // The condition variable releases the admin lock while waiting.
+                    timeLeft = SignalLock(timeLeft);
+
+                    _administration->_agents--;
+#else
+                    AdminUnlock();
 
-                AdminLock();
+                    timeLeft = SignalLock(timeLeft);
+
+                    _administration->_agents--;
+
+                    AdminLock();
+#endif
+                }
 
                 if (_alert == true) {
                     _alert = false;
@@ -401,6 +741,11 @@ namespace Core {
         return (result);
     }
 
+    bool CyclicBuffer::IsAvailable(const bool dataPresent) const
+    {
+        return ((((_administration->_state.load()) & state::LOCKED) != state::LOCKED) && ((dataPresent == false) || (Used() > 0)));
+    }
+
     uint32_t CyclicBuffer::Unlock()
     {
 
@@ -439,7 +784,7 @@ namespace Core {
         while (!foundData) {
             uint32_t oldTail = _administration->_tail;
             uint32_t tail = oldTail & _administration->_tailIndexMask;
-            result = Used(_administration->_head, oldTail);
+            result = Used(_administration->_head, tail);
 
             if (result == 0) {
                 // No data.
@@ -451,19 +796,7 @@ namespace Core {
                 result = length;
             }
 
-            uint32_t readEnd = tail + result;
-
-            if (readEnd < _maxSize) {
-                // Can be done in one pass.
-                memcpy(buffer, _realBuffer + tail, result);
-            } else {
-                // Needs to be done in two passes.
-                uint32_t firstLength = _maxSize - tail;
-                uint32_t secondLength = length - firstLength;
-
-                memcpy(buffer, _realBuffer + tail, firstLength);
-                memcpy(buffer + firstLength, _realBuffer, secondLength);
-            }
+            CopyOut(tail, buffer, result);
 
             // We found valid data if the tail is still where it was when we started.
             foundData = (_administration->_tail == oldTail);
@@ -23,6 +23,15 @@ namespace Core {
     // This class allows to share data over process boundaries. Private access can be arranged by taking a lock.
     // The lock is also Process Wide.
     // Whoever holds the lock, can privately read or write from the buffer.
+    // In lockFree mode (Linux only, selected by the creator of the buffer) the process wide lock and the signal
+    // are futexes on words in the shared administration. A write into an empty buffer no longer takes the lock,
+    // it only wakes the waiting agents, if any. Multiple producers are allowed if all writes go through Reserve,
+    // a producer that finds a reservation in progress waits for it to complete.
+    // A reservation in this mode is not made by a PID, PIDs of processes in different PID namespaces can not be
+    // compared. Each buffer holds a lease instead, a lock on a byte beyond the data of the backing file, taken
+    // on its own open file description. The kernel releases it when the process is gone, whatever namespace it
+    // runs in, so a producer that can take the lease of the reservation owner, knows the owner died. A forked
+    // child shares the leases of the buffers it inherited, it should open the buffer again to produce into it.
 
     class EXTERNAL CyclicBuffer {
     private:
@@ -31,7 +40,8 @@ namespace Core {
         CyclicBuffer& operator=(const CyclicBuffer&) = delete;
 
     public:
-        CyclicBuffer(const string& fileName, const uint32_t bufferSize = 0, const bool overwrite = false);
+        // The mapping holds DataElementFile mapping flags (PREFAULT, HUGEPAGES, ...) applied to this side's mapping.
+        CyclicBuffer(const string& fileName, const uint32_t bufferSize = 0, const bool overwrite = false, const bool lockFree = false, const DataElementFile::Mapping& mapping = DataElementFile::Mapping());
         virtual ~CyclicBuffer();
 
     protected:
@@ -52,12 +62,7 @@ namespace Core {
                 startIndex += _Offset;
                 startIndex %= _Parent._maxSize;
 
-                uint8_t* bytePtr = reinterpret_cast<uint8_t*>(&buffer);
-
-                for (uint32_t i = 0; i < sizeof(buffer); i++) {
-                    uint32_t index = (startIndex + i) % _Parent._maxSize;
-                    bytePtr[i] = _Parent._realBuffer[index];
-                }
+                _Parent.CopyOut(startIndex, reinterpret_cast<uint8_t*>(&buffer), sizeof(buffer));
             }
 
             uint32_t Size() const
@@ -122,6 +127,82 @@ namespace Core {
             return result;
         }
 
+        // Copy from/to the buffer starting at offset, wrapping around at the end in (at most) two memcpy's.
+        inline void CopyOut(const uint32_t offset, uint8_t buffer[], const uint32_t length) const
+        {
+            uint32_t firstLength = (_maxSize - offset);
+
+            if (length <= firstLength) {
+                memcpy(buffer, _realBuffer + offset, length);
+            } else {
+                memcpy(buffer, _realBuffer + offset, firstLength);
+                memcpy(buffer + firstLength, _realBuffer, length - firstLength);
+            }
+        }
+        inline void CopyIn(const uint32_t offset, const uint8_t buffer[], const uint32_t length)
+        {
+            uint32_t firstLength = (_maxSize - offset);
+
+            if (length <= firstLength) {
+                memcpy(_realBuffer + offset, buffer, length);
+            } else {
+                memcpy(_realBuffer + offset, buffer, firstLength);
+                memcpy(_realBuffer, buffer + firstLength, length - firstLength);
+            }
+        }
+
+    public:
+        // A region of the mapped buffer, handed out for zero-copy access. If the region wraps around the end
+        // of the buffer it consists of two segments, otherwise the second segment is empty.
+        class Span {
+        public:
+            Span()
+                : _tail(0)
+                , _size(0)
+            {
+                _data[0] = nullptr;
+                _data[1] = nullptr;
+                _length[0] = 0;
+                _length[1] = 0;
+            }
+            ~Span()
+            {
+            }
+
+        public:
+            inline uint32_t Size() const
+            {
+                return (_size);
+            }
+            inline uint8_t* Data(const uint8_t segment) const
+            {
+                ASSERT(segment < 2);
+                return (_data[segment]);
+            }
+            inline uint32_t Length(const uint8_t segment) const
+            {
+                ASSERT(segment < 2);
+                return (_length[segment]);
+            }
+
+        private:
+            friend class CyclicBuffer;
+
+            void Set(uint8_t* buffer, const uint32_t maxSize, const uint32_t offset, const uint32_t length)
+            {
+                _size = length;
+                _data[0] = buffer + offset;
+                _length[0] = std::min(length, maxSize - offset);
+                _data[1] = (_length[0] < length ? buffer : nullptr);
+                _length[1] = length - _length[0];
+            }
+
+            uint32_t _tail;
+            uint32_t _size;
+            uint8_t* _data[2];
+            uint32_t _length[2];
+        };
+
     public:
         inline void Flush()
         {
@@ -156,6 +237,10 @@ namespace Core {
         {
             return ((std::atomic_load(&(_administration->_state)) & OVERWRITE) == OVERWRITE);
         }
+        inline bool IsLockFree() const
+        {
+            return ((_futexes != nullptr) && ((std::atomic_load(&(_administration->_state)) & LOCKFREE) == LOCKFREE));
+        }
         inline bool IsValid() const
         {
             return (_buffer.IsValid());
@@ -213,6 +298,18 @@ namespace Core {
         //    readers seeing incomplete data.
         uint32_t Reserve(const uint32_t length);
 
+        // Zero-copy production. Reserve as above, but also hand out the reserved region of the buffer
+        // so it can be filled in place. Commit reports how much of the reservation is filled, the head
+        // is moved once the complete reservation is committed.
+        uint32_t Reserve(const uint32_t length, Span& span);
+        uint32_t Commit(const uint32_t length);
+
+        // Zero-copy consumption. Claim hands out the region that a Read of "length" would return, without
+        // moving the tail. Release moves the tail past the claimed region. If the region got overwritten in
+        // the mean time, Release returns 0 and the content of the span should be discarded.
+        uint32_t Claim(const uint32_t length, Span& span);
+        uint32_t Release(const Span& span);
+
         virtual void DataAvailable();
 
     private:
@@ -226,17 +323,38 @@ namespace Core {
         // Makes sure "required" is available. If not, tail is moved in a smart way.
         void AssureFreeSpace(const uint32_t required);
 
+        uint32_t Produce(const uint8_t buffer[], const uint32_t length);
+#if defined(__LINUX__) && !defined(__APPLE__)
+        void Lease();
+        void Reclaim(const pid_t lease);
+#endif
+#ifdef __WIN32__
+        uint32_t Reserve(const DWORD processId, const uint32_t length);
+#else
+        uint32_t Reserve(const pid_t processId, const uint32_t length);
+#endif
+#ifdef __WIN32__
+        DWORD Producer() const;
+#else
+        pid_t Producer() const;
+#endif
+
         void AdminLock();
         void AdminUnlock();
         void Reevaluate();
         uint32_t SignalLock(const uint32_t waitTime);
+#if defined(__LINUX__) && !defined(__APPLE__)
+        uint32_t SignalLock(const uint32_t sequence, const uint32_t waitTime);
+#endif
+        bool IsAvailable(const bool dataPresent) const;
 
     private:
         enum state {
             UNLOCKED = 0x00,
             LOCKED = 0x01,
             OVERWRITE = 0x02,
-            OVERWRITTEN = 0x04
+            OVERWRITTEN = 0x04,
+            LOCKFREE = 0x08
         };
 
         Core::DataElementFile _buffer;
@@ -250,6 +368,10 @@ namespace Core {
         HANDLE _signal;
         HANDLE _event;
 #endif
+#if defined(__LINUX__) && !defined(__APPLE__)
+        int _leases; // Own open file description of the backing file, the lease is locked on it.
+        pid_t _lease; // In lockFree mode, reservations are made with this lease (slot + 1) instead of the PID.
+#endif
 
     public:
         // Shared data over the processes...
@@ -273,12 +395,20 @@ namespace Core {
             uint32_t _reserved; // How much reserved in total.
             uint32_t _reservedWritten; // How much has already been written.
 #ifndef __WIN32__
-            std::atomic<pid_t> _reservedPID; // What process made the reservation.
+            std::atomic<pid_t> _reservedPID; // What process made the reservation, its lease in lockFree mode.
 #else
             std::atomic<DWORD> _reservedPID; // What process made the reservation.
 #endif
 
         } * _administration;
+
+        // Futex words, used in LOCKFREE mode instead of the _mutex/_signal. They follow the data, so the
+        // administration and the data are where processes built before this mode expect them.
+        struct futexes {
+            std::atomic<uint32_t> _lock; // 0 = free, 1 = taken, 2 = taken and contended.
+            std::atomic<uint32_t> _sequence; // Bumped on every reevaluate, agents wait for it to change.
+            std::atomic<uint32_t> _producers; // Producers waiting for a reservation to complete.
+        } * _futexes;
     };
 }
 } // Core
@@ -8,6 +8,11 @@
 #define INVALID_HANDLE_VALUE nullptr
 #endif
 
+#if defined(__LINUX__) && !defined(__APPLE__)
+#include <linux/magic.h>
+#include <sys/vfs.h>
+#endif
+
 #ifdef __WIN32__
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -50,7 +55,15 @@ namespace Core {
 
         if (IsValid()) {
             if ((requestedSize != 0) && (requestedSize > m_File.Size())) {
-                m_File.SetSize(requestedSize);
+                uint64_t fileSize = requestedSize;
+
+                if ((type & HUGETLB) != 0) {
+                    // hugetlbfs refuses sizes that are not a multiple of its page size.
+                    uint32_t pageSize = PageSize();
+                    fileSize = ((((fileSize - 1) / pageSize) + 1) * pageSize);
+                }
+
+                m_File.SetSize(fileSize);
                 OpenMemoryMappedFile(requestedSize);
             } else {
                 OpenMemoryMappedFile(static_cast<uint32_t>(m_File.Size()));
@@ -140,6 +153,19 @@ namespace Core {
         }
     }
 
+    uint32_t DataElementFile::PageSize() const
+    {
+        SYSTEM_INFO systemInfo;
+        ::GetSystemInfo(&systemInfo);
+
+        return (systemInfo.dwPageSize);
+    }
+
+    void DataElementFile::Advise(void* /* buffer */, const uint64_t /* size */) const
+    {
+        // The mapping options are not supported on this platform.
+    }
+
     void DataElementFile::Sync()
     {
         if ((m_Flags & SHAREABLE) != 0) {
@@ -154,17 +180,26 @@ namespace Core {
     void DataElementFile::OpenMemoryMappedFile(uint32_t requiredSize)
     {
         if (requiredSize > 0) {
-            int pageSize = getpagesize();
+            uint32_t pageSize = PageSize();
             uint64_t mapSize = ((((requiredSize - 1) / pageSize) + 1) * pageSize);
             int flags = (((m_Flags & READABLE) != 0 ? PROT_READ : 0) | ((m_Flags & WRITABLE) != 0 ? PROT_WRITE : 0));
+            int mode = ((m_Flags & SHAREABLE) != 0 ? MAP_SHARED : MAP_PRIVATE);
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+            if ((m_Flags & PREFAULT) != 0) {
+                mode |= MAP_POPULATE;
+            }
+#endif
 
             // Open the file in MM mode as one element.
-            m_MemoryMappedFile = mmap(nullptr, mapSize, flags, ((m_Flags & SHAREABLE) != 0 ? MAP_SHARED : MAP_PRIVATE), m_File, 0);
+            m_MemoryMappedFile = mmap(nullptr, mapSize, flags, mode, m_File, 0);
 
             if (m_MemoryMappedFile == MAP_FAILED) {
                 m_File.Close();
                 m_MemoryMappedFile = nullptr;
             } else {
+                Advise(m_MemoryMappedFile, mapSize);
+
                 // Seems like everything succeeded. Lets map it.
                 UpdateCache(0, static_cast<uint8_t*>(m_MemoryMappedFile), requiredSize, mapSize);
             }
@@ -196,7 +231,7 @@ namespace Core {
     /* virtual */ void DataElementFile::Reallocation(const uint64_t size)
     {
         if (IsValid()) {
-            int pageSize = getpagesize();
+            uint32_t pageSize = PageSize();
             uint64_t requestedSize = ((size / pageSize) * pageSize) + pageSize;
 
             m_File.SetSize(requestedSize);
@@ -219,12 +254,49 @@ namespace Core {
 
                 UpdateCache(0, nullptr, 0, 0);
             } else {
+                // The advice does not carry over to the pages added by mremap.
+                Advise(m_MemoryMappedFile, requestedSize);
+
                 // Seems we upgraded, set the caches
                 UpdateCache(0, static_cast<uint8_t*>(m_MemoryMappedFile), size, requestedSize);
             }
         }
     }
 
+    uint32_t DataElementFile::PageSize() const
+    {
+        uint32_t result = getpagesize();
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+        struct statfs info;
+
+        if (((m_Flags & HUGETLB) != 0) && (fstatfs(m_File, &info) == 0) && (info.f_type == HUGETLBFS_MAGIC)) {
+            result = static_cast<uint32_t>(info.f_bsize);
+        }
+#endif
+
+        return (result);
+    }
+
+    void DataElementFile::Advise(void* buffer, const uint64_t size) const
+    {
+#if defined(__LINUX__) && !defined(__APPLE__)
+        // Advice is only a hint, a kernel that does not support it (e.g. no transparent huge pages for shared
+        // memory) leaves the mapping as it is, so the result is deliberately ignored.
+        if ((m_Flags & SEQUENTIAL) != 0) {
+            madvise(buffer, size, MADV_SEQUENTIAL);
+        }
+        if ((m_Flags & WILLNEED) != 0) {
+            madvise(buffer, size, MADV_WILLNEED);
+        }
+#ifdef MADV_HUGEPAGE
+        if ((m_Flags & HUGEPAGES) != 0) {
+            madvise(buffer, size, MADV_HUGEPAGE);
+        }
+#endif
+#endif
+    }
+
     void DataElementFile::Sync()
     {
         if ((m_Flags & SHAREABLE) != 0) {
@@ -32,7 +32,40 @@ namespace Core {
             READABLE = 0x01,
             WRITABLE = 0x02,
             SHAREABLE = 0x04,
-            CREATE = 0x08
+            CREATE = 0x08,
+
+            // Mapping options, honoured on Linux only and ignored elsewhere. PREFAULT populates the page tables
+            // while mapping, so the first access does not take a page fault. SEQUENTIAL, WILLNEED and HUGEPAGES are
+            // passed on to madvise(). HUGETLB is for files created on a hugetlbfs mount, it aligns the file and
+            // mapping sizes to the huge page size of that mount.
+            PREFAULT = 0x10,
+            SEQUENTIAL = 0x20,
+            WILLNEED = 0x40,
+            HUGEPAGES = 0x80,
+            HUGETLB = 0x100
+        };
+
+        // The buffers built on a DataElementFile take their mapping options wrapped in this type, so they can
+        // not be mistaken for a size.
+        class Mapping {
+        public:
+            Mapping()
+                : _options(0)
+            {
+            }
+            explicit Mapping(const uint32_t options)
+                : _options(options)
+            {
+            }
+
+        public:
+            inline uint32_t Options() const
+            {
+                return (_options);
+            }
+
+        private:
+            uint32_t _options;
         };
 
         DataElementFile(File& fileName, const uint32_t type = READABLE);
@@ -60,8 +93,15 @@ namespace Core {
         {
             m_File.LoadFileInfo();
         }
+        inline uint32_t Flags() const
+        {
+            return (m_Flags);
+        }
         void Sync();
 
+        // The granularity of the mapping, the huge page size for HUGETLB files on a hugetlbfs mount.
+        uint32_t PageSize() const;
+
     protected:
         virtual void Reallocation(const uint64_t size);
 
@@ -69,6 +109,7 @@ namespace Core {
 
     private:
         void OpenMemoryMappedFile(uint32_t requiredSize);
+        void Advise(void* buffer, const uint64_t size) const;
 
     private:
 #ifdef __WIN32__
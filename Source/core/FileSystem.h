@@ -414,6 +414,22 @@ namespace Core {
 #endif
 #ifdef __WIN32__
             return (::SetFilePointer(_handle, offset, nullptr, (relative ? FILE_CURRENT : FILE_BEGIN)) != INVALID_SET_FILE_POINTER);
+#endif
+        }
+        // Absolute position from the start of the file, for files beyond the reach of a 32 bits offset.
+        bool Seek(const uint64_t offset)
+        {
+            // Only call these methods if the file is open.
+            ASSERT(IsOpen());
+
+#ifdef __POSIX__
+            // Without large file support off_t is 32 bits, rather fail than land somewhere else.
+            return ((static_cast<off_t>(offset) >= 0) && (static_cast<uint64_t>(static_cast<off_t>(offset)) == offset) && (lseek(_handle, static_cast<off_t>(offset), SEEK_SET) != -1));
+#endif
+#ifdef __WIN32__
+            LARGE_INTEGER position;
+            position.QuadPart = static_cast<LONGLONG>(offset);
+            return (::SetFilePointerEx(_handle, position, nullptr, FILE_BEGIN) != 0);
 #endif
         }
         int32_t Position() const
@@ -428,7 +444,7 @@ namespace Core {
                     result = 0;
                 }
 
-                ASSERT(result > 0);
+                ASSERT(result >= 0);
 #endif
 #ifdef __WIN32__
                 DWORD newPos = ::SetFilePointer(_handle, 0, nullptr, FILE_CURRENT);
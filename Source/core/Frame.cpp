@@ -0,0 +1,116 @@
+#include "Frame.h"
+
+#include <atomic>
+#include <thread>
+
+namespace WPEFramework {
+namespace Core {
+
+    namespace {
+
+        // 512 bytes up to 1MB.
+        static constexpr uint8_t SmallestClass = 9;
+        static constexpr uint8_t Classes = 12;
+        static constexpr uint8_t MaxCachedBlocks = 64;
+        static constexpr uint32_t MaxCachedBytes = 1024 * 1024;
+
+        static_assert((1u << SmallestClass) == FrameStorage::SmallestBlock, "The smallest class should hold the smallest block");
+        static_assert((1u << (SmallestClass + Classes - 1)) == FrameStorage::LargestBlock, "The largest class should hold the largest block");
+
+        // Plain data, so it is there before any frame is constructed and after the last one is gone. The
+        // lock is held for a handful of instructions, spinning on it is cheaper than a system call.
+        struct SizeClass {
+            std::atomic<bool> Locked;
+            uint8_t Count;
+            uint8_t* Blocks[MaxCachedBlocks];
+        };
+
+        SizeClass g_classes[Classes];
+
+        inline uint8_t Class(const uint32_t size)
+        {
+            uint8_t result = 0;
+
+            while ((static_cast<uint32_t>(FrameStorage::SmallestBlock) << result) < size) {
+                result++;
+            }
+
+            return (result);
+        }
+        inline uint8_t Cached(const uint8_t sizeClass)
+        {
+            const uint32_t blocks = (MaxCachedBytes / (static_cast<uint32_t>(FrameStorage::SmallestBlock) << sizeClass));
+
+            return (static_cast<uint8_t>(std::max(static_cast<uint32_t>(1), std::min(blocks, static_cast<uint32_t>(MaxCachedBlocks)))));
+        }
+        inline void Lock(SizeClass& sizeClass)
+        {
+            while (sizeClass.Locked.exchange(true, std::memory_order_acquire) == true) {
+                std::this_thread::yield();
+            }
+        }
+        inline void Unlock(SizeClass& sizeClass)
+        {
+            sizeClass.Locked.store(false, std::memory_order_release);
+        }
+    }
+
+    /* static */ uint8_t* FrameStorage::Allocate(uint32_t& size)
+    {
+        uint8_t* result = nullptr;
+
+        if (size > LargestBlock) {
+            result = reinterpret_cast<uint8_t*>(::malloc(size));
+        } else {
+            const uint8_t index = Class(size);
+            SizeClass& sizeClass(g_classes[index]);
+
+            size = (SmallestBlock << index);
+
+            Lock(sizeClass);
+
+            if (sizeClass.Count > 0) {
+                sizeClass.Count--;
+                result = sizeClass.Blocks[sizeClass.Count];
+            }
+
+            Unlock(sizeClass);
+
+            if (result == nullptr) {
+                result = reinterpret_cast<uint8_t*>(::malloc(size));
+            }
+        }
+
+        ASSERT(result != nullptr);
+
+        return (result);
+    }
+
+    /* static */ void FrameStorage::Release(uint8_t* block, const uint32_t size)
+    {
+        ASSERT(block != nullptr);
+
+        if (size <= LargestBlock) {
+            const uint8_t index = Class(size);
+            SizeClass& sizeClass(g_classes[index]);
+
+            // Only blocks that came from here, have the exact size of their class.
+            if ((SmallestBlock << index) == size) {
+                Lock(sizeClass);
+
+                if (sizeClass.Count < Cached(index)) {
+                    sizeClass.Blocks[sizeClass.Count] = block;
+                    sizeClass.Count++;
+                    block = nullptr;
+                }
+
+                Unlock(sizeClass);
+            }
+        }
+
+        if (block != nullptr) {
+            ::free(block);
+        }
+    }
+}
+}
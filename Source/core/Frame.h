@@ -2,10 +2,35 @@
 #define __GENERICS_FRAME_H
 
 #include "Module.h"
+#include "Portability.h"
+#include "Serialization.h"
+#include "Trace.h"
 
 namespace WPEFramework {
 namespace Core {
 
+    // Rationale:
+    // Frames that outgrow their initial block were grown with realloc, in steps of that block, so a
+    // frame carrying a few hundred kilobytes was reallocated (and copied) over and over. The frames take
+    // their blocks from this storage instead: blocks come in power of 2 size classes and released blocks
+    // are kept per class (up to about 1MB per class), for the next frame that needs one. Blocks larger
+    // than the largest class are plain heap allocations.
+    class EXTERNAL FrameStorage {
+    private:
+        FrameStorage() = delete;
+        FrameStorage(const FrameStorage&) = delete;
+        FrameStorage& operator=(const FrameStorage&) = delete;
+
+    public:
+        static constexpr uint32_t SmallestBlock = 512;
+        static constexpr uint32_t LargestBlock = 1024 * 1024;
+
+    public:
+        // The size is rounded up to what the block can actually hold.
+        static uint8_t* Allocate(uint32_t& size);
+        static void Release(uint8_t* block, const uint32_t size);
+    };
+
     template <const uint16_t BLOCKSIZE>
     class FrameType {
     private:
@@ -17,17 +42,17 @@ namespace Core {
         public:
             AllocatorType()
                 : _bufferSize(STARTSIZE)
-                , _data(reinterpret_cast<uint8_t*>(::malloc(_bufferSize)))
+                , _data(FrameStorage::Allocate(_bufferSize))
             {
                 static_assert(STARTSIZE != 0, "This method can only be called if you specify an initial blocksize");
             }
             AllocatorType(const AllocatorType<STARTSIZE>& copy)
                 : _bufferSize(copy._bufferSize)
-                , _data(STARTSIZE == 0 ? copy._data : reinterpret_cast<uint8_t*>(::malloc(_bufferSize)))
+                , _data(STARTSIZE == 0 ? copy._data : FrameStorage::Allocate(_bufferSize))
             {
 
                 if (STARTSIZE != 0) {
-                    ::memcpy(_data, copy._data, _bufferSize);
+                    ::memcpy(_data, copy._data, copy._bufferSize);
                 }
             }
             AllocatorType(uint8_t buffer[], const uint32_t length)
@@ -39,47 +64,71 @@ namespace Core {
             ~AllocatorType()
             {
                 if ((STARTSIZE != 0) && (_data != nullptr)) {
-                    ::free(_data);
+                    FrameStorage::Release(_data, _bufferSize);
                 }
             }
 
         public:
-            inline uint8_t& operator[](const uint16_t index)
+            inline uint8_t& operator[](const uint32_t index)
             {
                 ASSERT(_data != nullptr);
                 ASSERT(index < _bufferSize);
                 return (_data[index]);
             }
-            inline const uint8_t& operator[](const uint16_t index) const
+            inline const uint8_t& operator[](const uint32_t index) const
             {
                 ASSERT(_data != nullptr);
                 ASSERT(index < _bufferSize);
                 return (_data[index]);
             }
-            inline void Allocate(uint32_t requiredSize)
+            // Only the first used bytes are kept, if a larger block is needed.
+            inline void Allocate(const uint32_t requiredSize, const uint32_t used)
+            {
+                RealAllocate<STARTSIZE>(requiredSize, used, TemplateIntToType<STARTSIZE>());
+            }
+            // Hand a block that grew beyond what is worth keeping back to the storage.
+            inline void Shrink()
             {
-                RealAllocate<STARTSIZE>(requiredSize, TemplateIntToType<STARTSIZE>());
+                RealShrink<STARTSIZE>(TemplateIntToType<STARTSIZE>());
             }
 
         private:
             template <const uint16_t NONZEROSIZE>
-            inline void RealAllocate(const uint32_t requiredSize, const TemplateIntToType<NONZEROSIZE>& /* For compile time diffrentiation */)
+            inline void RealAllocate(const uint32_t requiredSize, const uint32_t used, const TemplateIntToType<NONZEROSIZE>& /* For compile time diffrentiation */)
             {
                 if (requiredSize > _bufferSize) {
 
-                    _bufferSize = static_cast<uint16_t>(((requiredSize / (STARTSIZE ? STARTSIZE : 1)) + 1) * STARTSIZE);
+                    // Grow at least by doubling, a frame that is being filled does not come back for every parameter.
+                    uint32_t size = std::max(requiredSize, 2 * _bufferSize);
+                    uint8_t* data = FrameStorage::Allocate(size);
 
-                    // oops we need to "reallocate".
-                    _data = reinterpret_cast<uint8_t*>(::realloc(_data, _bufferSize));
+                    ::memcpy(data, _data, std::min(used, _bufferSize));
+                    FrameStorage::Release(_data, _bufferSize);
+
+                    _data = data;
+                    _bufferSize = size;
                 }
             }
-            inline void RealAllocate(const uint32_t requiredSize, const TemplateIntToType<0>& /* For compile time diffrentiation */)
+            inline void RealAllocate(const uint32_t requiredSize, const uint32_t /* used */, const TemplateIntToType<0>& /* For compile time diffrentiation */)
             {
                 ASSERT(requiredSize <= _bufferSize);
             }
+            template <const uint16_t NONZEROSIZE>
+            inline void RealShrink(const TemplateIntToType<NONZEROSIZE>& /* For compile time diffrentiation */)
+            {
+                if (_bufferSize > (64 * 1024)) {
+                    FrameStorage::Release(_data, _bufferSize);
+
+                    _bufferSize = STARTSIZE;
+                    _data = FrameStorage::Allocate(_bufferSize);
+                }
+            }
+            inline void RealShrink(const TemplateIntToType<0>& /* For compile time diffrentiation */)
+            {
+            }
 
         private:
-            uint16_t _bufferSize;
+            uint32_t _bufferSize;
             uint8_t* _data;
         };
 
@@ -97,7 +146,7 @@ namespace Core {
                 , _container(nullptr)
             {
             }
-            Reader(const FrameType& data, const uint16_t offset)
+            Reader(const FrameType& data, const uint32_t offset)
                 : _offset(offset)
                 , _container(&data)
             {
@@ -116,7 +165,7 @@ namespace Core {
             {
                 return ((_container != nullptr) && (_offset < _container->Size()));
             }
-            inline uint16_t Length() const
+            inline uint32_t Length() const
             {
                 return (_container == nullptr ? 0 : _container->Size() - _offset);
             }
@@ -142,7 +191,7 @@ namespace Core {
             template <typename TYPENAME>
             TYPENAME Buffer(const TYPENAME maxLength, uint8_t buffer[]) const
             {
-                uint16_t result;
+                uint32_t result;
 
                 ASSERT(_container != nullptr);
 
@@ -151,7 +200,7 @@ namespace Core {
 
                 return (static_cast<TYPENAME>(result - sizeof(TYPENAME)));
             }
-            void Copy(const uint16_t length, uint8_t buffer[]) const
+            void Copy(const uint32_t length, uint8_t buffer[]) const
             {
                 ASSERT(_container != nullptr);
 
@@ -206,7 +255,7 @@ namespace Core {
 #endif
 
         private:
-            mutable uint16_t _offset;
+            mutable uint32_t _offset;
             const FrameType* _container;
         };
         class Writer {
@@ -220,7 +269,7 @@ namespace Core {
             {
             }
             // TODO: should we make offset 0 by default?
-            Writer(FrameType& data, const uint16_t offset)
+            Writer(FrameType& data, const uint32_t offset)
                 : _offset(offset)
                 , _container(&data)
             {
@@ -235,7 +284,7 @@ namespace Core {
             }
 
         public:
-            inline uint16_t Offset() const
+            inline uint32_t Offset() const
             {
                 return (_offset);
             }
@@ -246,7 +295,7 @@ namespace Core {
 
                 _offset += _container->SetBuffer<TYPENAME>(_offset, length, buffer);
             }
-            void Copy(const uint16_t length, const uint8_t buffer[])
+            void Copy(const uint32_t length, const uint8_t buffer[])
             {
                 ASSERT(_container != nullptr);
 
@@ -279,7 +328,7 @@ namespace Core {
             }
 
         private:
-            uint16_t _offset;
+            uint32_t _offset;
             FrameType* _container;
         };
 
@@ -309,22 +358,23 @@ namespace Core {
         inline void Clear()
         {
             _size = 0;
+            _data.Shrink();
         }
         inline uint32_t Size() const
         {
             return (_size);
         }
-        inline uint8_t& operator[](const uint16_t index)
+        inline uint8_t& operator[](const uint32_t index)
         {
             return _data[index];
         }
-        inline const uint8_t& operator[](const uint16_t index) const
+        inline const uint8_t& operator[](const uint32_t index) const
         {
             return _data[index];
         }
-        void Size(uint16_t size)
+        void Size(uint32_t size)
         {
-            _data.Allocate(size);
+            _data.Allocate(size, _size);
 
             _size = size;
         }
@@ -333,7 +383,7 @@ namespace Core {
         {
             static const TCHAR character[] = "0123456789ABCDEF";
             string info;
-            uint16_t index = offset;
+            uint32_t index = offset;
 
             while (index < _size) {
                 if (info.empty() == false) {
@@ -351,9 +401,9 @@ namespace Core {
         friend class Writer;
 
         template <typename TYPENAME>
-        uint16_t SetBuffer(const uint16_t offset, const TYPENAME& length, const uint8_t buffer[])
+        uint32_t SetBuffer(const uint32_t offset, const TYPENAME& length, const uint8_t buffer[])
         {
-            uint16_t requiredLength(static_cast<uint16_t>(sizeof(TYPENAME) + length));
+            uint32_t requiredLength(static_cast<uint32_t>(sizeof(TYPENAME) + length));
 
             if ((offset + requiredLength) >= _size) {
                 Size(offset + requiredLength);
@@ -365,7 +415,7 @@ namespace Core {
             return (requiredLength);
         }
 
-        uint16_t Copy(const uint16_t offset, const uint16_t length, uint8_t buffer[]) const
+        uint32_t Copy(const uint32_t offset, const uint32_t length, uint8_t buffer[]) const
         {
             ASSERT(offset + length <= _size);
 
@@ -373,7 +423,7 @@ namespace Core {
 
             return (length);
         }
-        uint16_t Copy(const uint16_t offset, const uint16_t length, const uint8_t buffer[])
+        uint32_t Copy(const uint32_t offset, const uint32_t length, const uint8_t buffer[])
         {
             Size(offset + length);
 
@@ -381,16 +431,16 @@ namespace Core {
 
             return (length);
         }
-        uint16_t SetText(const uint16_t offset, const string& value)
+        uint32_t SetText(const uint32_t offset, const string& value)
         {
             std::string convertedText(Core::ToString(value));
             return (SetBuffer<uint16_t>(offset, static_cast<uint16_t>(convertedText.length()), reinterpret_cast<const uint8_t*>(convertedText.c_str())));
         }
 
-        uint16_t SetNullTerminatedText(const uint16_t offset, const string& value)
+        uint32_t SetNullTerminatedText(const uint32_t offset, const string& value)
         {
             std::string convertedText(Core::ToString(value));
-            uint16_t requiredLength(convertedText.length() + 1);
+            uint32_t requiredLength(convertedText.length() + 1);
 
             if ((offset + requiredLength) >= _size) {
                 Size(offset + requiredLength);
@@ -402,7 +452,7 @@ namespace Core {
         }
 
         template <typename TYPENAME>
-        uint16_t GetBuffer(const uint16_t offset, const TYPENAME length, uint8_t buffer[]) const
+        uint32_t GetBuffer(const uint32_t offset, const TYPENAME length, uint8_t buffer[]) const
         {
             TYPENAME textLength;
 
@@ -413,15 +463,15 @@ namespace Core {
             ASSERT((textLength + offset + sizeof(TYPENAME)) <= _size);
 
             if ((textLength + offset + sizeof(TYPENAME)) > _size) {
-                textLength = (_size - (offset + static_cast<uint16_t>(sizeof(TYPENAME))));
+                textLength = (_size - (offset + static_cast<uint32_t>(sizeof(TYPENAME))));
             }
 
             memcpy(buffer, &(_data[offset + sizeof(TYPENAME)]), (textLength > length ? length : textLength));
 
-            return (static_cast<uint16_t>(sizeof(TYPENAME) + textLength));
+            return (static_cast<uint32_t>(sizeof(TYPENAME) + textLength));
         }
 
-        uint16_t GetText(const uint16_t offset, string& result) const
+        uint32_t GetText(const uint32_t offset, string& result) const
         {
             uint16_t textLength;
             ASSERT((offset + sizeof(uint16_t)) <= _size);
@@ -441,14 +491,14 @@ namespace Core {
             return (sizeof(uint16_t) + textLength);
         }
 
-        uint16_t GetNullTerminatedText(const uint16_t offset, string& result) const
+        uint32_t GetNullTerminatedText(const uint32_t offset, string& result) const
         {
             const char* text = reinterpret_cast<const char*>(&(_data[offset]));
             result = text;
             return (result.length() + 1);
         }
 
-        uint16_t SetBoolean(const uint16_t offset, const bool value)
+        uint32_t SetBoolean(const uint32_t offset, const bool value)
         {
             if ((offset + 1) >= _size) {
                 Size(offset + 1);
@@ -459,7 +509,7 @@ namespace Core {
             return (1);
         }
 
-        uint16_t GetBoolean(const uint16_t offset, bool& value) const
+        uint32_t GetBoolean(const uint32_t offset, bool& value) const
         {
             ASSERT(offset < _size);
 
@@ -469,20 +519,20 @@ namespace Core {
         }
 
         template <typename TYPENAME>
-        inline uint16_t SetNumber(const uint16_t offset, const TYPENAME number)
+        inline uint32_t SetNumber(const uint32_t offset, const TYPENAME number)
         {
             return (SetNumber(offset, number, TemplateIntToType<sizeof(TYPENAME) == 1>()));
         }
 
         template <typename TYPENAME>
-        inline uint16_t GetNumber(const uint16_t offset, TYPENAME& number) const
+        inline uint32_t GetNumber(const uint32_t offset, TYPENAME& number) const
         {
             return (GetNumber(offset, number, TemplateIntToType<sizeof(TYPENAME) == 1>()));
         }
 
     private:
         template <typename TYPENAME>
-        uint16_t SetNumber(const uint16_t offset, const TYPENAME number, const TemplateIntToType<true>&)
+        uint32_t SetNumber(const uint32_t offset, const TYPENAME number, const TemplateIntToType<true>&)
         {
             if ((offset + 1) >= _size) {
                 Size(offset + 1);
@@ -494,7 +544,7 @@ namespace Core {
         }
 
         template <typename TYPENAME>
-        uint16_t SetNumber(const uint16_t offset, const TYPENAME number, const TemplateIntToType<false>&)
+        uint32_t SetNumber(const uint32_t offset, const TYPENAME number, const TemplateIntToType<false>&)
         {
             if ((offset + sizeof(TYPENAME)) >= _size) {
                 Size(offset + sizeof(TYPENAME));
@@ -546,7 +596,7 @@ namespace Core {
         }
 
         template <typename TYPENAME>
-        uint16_t GetNumber(const uint16_t offset, TYPENAME& number, const TemplateIntToType<true>&) const
+        uint32_t GetNumber(const uint32_t offset, TYPENAME& number, const TemplateIntToType<true>&) const
         {
             // Only on package level allowed to pass the boundaries!!!
             ASSERT((offset + sizeof(TYPENAME)) <= _size);
@@ -557,7 +607,7 @@ namespace Core {
         }
 
         template <typename TYPENAME>
-        inline uint16_t GetNumber(const uint16_t offset, TYPENAME& value, const TemplateIntToType<false>&) const
+        inline uint32_t GetNumber(const uint32_t offset, TYPENAME& value, const TemplateIntToType<false>&) const
         {
             TYPENAME result;
 
@@ -613,7 +663,7 @@ namespace Core {
         }
 
     private:
-        mutable uint16_t _size;
+        mutable uint32_t _size;
         AllocatorType<BLOCKSIZE> _data;
     };
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "JSON.h"
+#include "Measurement.h"
 #include "Module.h"
+#include "Time.h"
 #include "TypeTraits.h"
 
 #include <cctype>
@@ -278,10 +280,162 @@ namespace Core {
         };
 
         class EXTERNAL Handler {
+        public:
+            // What a single method went through, since the last reset.
+            class Report {
+            public:
+                Report()
+                    : _latency()
+                    , _errors(0)
+                    , _received(0)
+                    , _sent(0)
+                {
+                }
+                Report(const Report& copy)
+                    : _latency(copy._latency)
+                    , _errors(copy._errors)
+                    , _received(copy._received)
+                    , _sent(copy._sent)
+                {
+                }
+                ~Report()
+                {
+                }
+
+                Report& operator=(const Report& RHS)
+                {
+                    _latency = RHS._latency;
+                    _errors = RHS._errors;
+                    _received = RHS._received;
+                    _sent = RHS._sent;
+
+                    return (*this);
+                }
+
+            public:
+                void Merge(const Report& other)
+                {
+                    _latency.Merge(other._latency);
+                    _errors += other._errors;
+                    _received += other._received;
+                    _sent += other._sent;
+                }
+                // Every call is timed, the latency count is the call count.
+                inline uint64_t Calls() const
+                {
+                    return (_latency.Count());
+                }
+                inline uint64_t Errors() const
+                {
+                    return (_errors);
+                }
+                inline uint64_t Received() const
+                {
+                    return (_received);
+                }
+                inline uint64_t Sent() const
+                {
+                    return (_sent);
+                }
+                inline const Histogram::Snapshot& Latency() const
+                {
+                    return (_latency);
+                }
+
+            private:
+                friend class Handler;
+
+                Histogram::Snapshot _latency;
+                uint64_t _errors;
+                uint64_t _received;
+                uint64_t _sent;
+            };
+
+            typedef std::map<string, Report> Reports;
+
         private:
             typedef std::function<void(const Connection& channel, const string& parameters)> CallbackFunction;
             typedef std::function<uint32_t(const string& method, const string& parameters, string& result)> InvokeFunction;
 
+            // Recorded from the calling threads without locking. The counters are spread over a few
+            // cache lines, picked by a hash of the thread, threads that share one count atomically.
+            // A reset keeps a baseline, so the recorders are never interrupted.
+            class Recorder {
+            private:
+                static constexpr uint8_t Slots = 4;
+
+                struct Counters {
+                    std::atomic<uint64_t> _errors;
+                    std::atomic<uint64_t> _received;
+                    std::atomic<uint64_t> _sent;
+                    uint8_t _padding[64 - (3 * sizeof(std::atomic<uint64_t>))];
+                };
+
+                Recorder(const Recorder&) = delete;
+                Recorder& operator=(const Recorder&) = delete;
+
+            public:
+                Recorder()
+                    : _latency(Slots)
+                    , _baseline()
+                {
+                    for (uint8_t index = 0; index < Slots; index++) {
+                        _counters[index]._errors.store(0, std::memory_order_relaxed);
+                        _counters[index]._received.store(0, std::memory_order_relaxed);
+                        _counters[index]._sent.store(0, std::memory_order_relaxed);
+                    }
+                }
+                ~Recorder()
+                {
+                }
+
+            public:
+                void Set(const uint64_t duration, const uint32_t received, const uint32_t sent, const bool failed)
+                {
+                    Counters& counters(_counters[Histogram::Slot(Slots)]);
+
+                    if (failed == true) {
+                        counters._errors.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    counters._received.fetch_add(received, std::memory_order_relaxed);
+                    counters._sent.fetch_add(sent, std::memory_order_relaxed);
+                    _latency.Set(duration);
+                }
+                void Get(Report& report) const
+                {
+                    Current(report);
+
+                    report._latency.Subtract(_baseline._latency);
+                    report._errors -= _baseline._errors;
+                    report._received -= _baseline._received;
+                    report._sent -= _baseline._sent;
+                }
+                void Reset()
+                {
+                    Report current;
+
+                    Current(current);
+
+                    _baseline = current;
+                }
+
+            private:
+                void Current(Report& report) const
+                {
+                    for (uint8_t index = 0; index < Slots; index++) {
+                        report._errors += _counters[index]._errors.load(std::memory_order_relaxed);
+                        report._received += _counters[index]._received.load(std::memory_order_relaxed);
+                        report._sent += _counters[index]._sent.load(std::memory_order_relaxed);
+                    }
+                    _latency.Merge(report._latency);
+                }
+
+            private:
+                Histogram _latency;
+                Counters _counters[Slots];
+                Report _baseline;
+            };
+
             class Entry {
             private:
                 Entry() = delete;
@@ -316,20 +470,25 @@ namespace Core {
                 Entry(const CallbackFunction& callback)
                     : _asynchronous(true)
                     , _info(callback)
+                    , _statistics(nullptr)
                 {
                 }
                 Entry(const InvokeFunction& callback)
                     : _asynchronous(false)
                     , _info(callback)
+                    , _statistics(nullptr)
                 {
                 }
                 Entry(const Entry& copy)
                     : _asynchronous(copy._asynchronous)
                     , _info(copy._info, copy._asynchronous)
+                    , _statistics(nullptr)
                 {
                 }
                 ~Entry()
                 {
+                    delete _statistics.load(std::memory_order_relaxed);
+
                     if (_asynchronous == true) {
                         _info._callback.~CallbackFunction();
                     } else {
@@ -348,10 +507,36 @@ namespace Core {
                     }
                     return (result);
                 }
+                // Only methods that are called while instrumented, get their statistics allocated.
+                void Record(const uint64_t duration, const uint32_t received, const uint32_t sent, const bool failed)
+                {
+                    Recorder* statistics = _statistics.load(std::memory_order_acquire);
+
+                    if (statistics == nullptr) {
+                        Recorder* created = new Recorder();
+
+                        if (_statistics.compare_exchange_strong(statistics, created, std::memory_order_acq_rel) == true) {
+                            statistics = created;
+                        } else {
+                            delete created;
+                        }
+                    }
+
+                    statistics->Set(duration, received, sent, failed);
+                }
+                const Recorder* Recorded() const
+                {
+                    return (_statistics.load(std::memory_order_acquire));
+                }
+                Recorder* Recorded()
+                {
+                    return (_statistics.load(std::memory_order_acquire));
+                }
 
             private:
                 bool _asynchronous;
                 Functions _info;
+                std::atomic<Recorder*> _statistics;
             };
 
             class Observer {
@@ -409,6 +594,7 @@ namespace Core {
                 , _observers()
                 , _notificationFunction(notificationFunction)
                 , _versions(versions)
+                , _instrumented(false)
             {
             }
             Handler(const NotificationFunction& notificationFunction, const std::vector<uint8_t>& versions, const Handler& copy)
@@ -417,6 +603,7 @@ namespace Core {
                 , _observers()
                 , _notificationFunction(notificationFunction)
                 , _versions(versions)
+                , _instrumented(copy.IsInstrumented())
             {
             }
             ~Handler()
@@ -556,10 +743,64 @@ namespace Core {
 
                 HandlerMap::iterator index = _handlers.find(Message::Method(method));
                 if (index != _handlers.end()) {
-                    result = index->second.Invoke(connection, method, parameters, response);
+                    if (_instrumented.load(std::memory_order_relaxed) == false) {
+                        result = index->second.Invoke(connection, method, parameters, response);
+                    } else {
+                        uint64_t start = Core::Time::Monotonic();
+
+                        result = index->second.Invoke(connection, method, parameters, response);
+
+                        // Asynchronous methods report ~0, their outcome is not known yet.
+                        index->second.Record(Core::Time::Monotonic() - start,
+                            static_cast<uint32_t>(parameters.length()),
+                            static_cast<uint32_t>(response.length()),
+                            ((result != Core::ERROR_NONE) && (result != static_cast<uint32_t>(~0))));
+                    }
                 }
                 return (result);
             }
+            // Recording per method statistics is off by default, it costs two clock reads per call.
+            void Instrumentation(const bool enabled)
+            {
+                _instrumented.store(enabled, std::memory_order_relaxed);
+            }
+            bool IsInstrumented() const
+            {
+                return (_instrumented.load(std::memory_order_relaxed));
+            }
+            // Adds the statistics of the methods that were called, to what is already reported.
+            void Statistics(Reports& reports) const
+            {
+                _adminLock.Lock();
+
+                for (const std::pair<const string, Entry>& entry : _handlers) {
+                    const Recorder* statistics = entry.second.Recorded();
+
+                    if (statistics != nullptr) {
+                        Report report;
+
+                        statistics->Get(report);
+
+                        reports[entry.first].Merge(report);
+                    }
+                }
+
+                _adminLock.Unlock();
+            }
+            void ResetStatistics()
+            {
+                _adminLock.Lock();
+
+                for (std::pair<const string, Entry>& entry : _handlers) {
+                    Recorder* statistics = entry.second.Recorded();
+
+                    if (statistics != nullptr) {
+                        statistics->Reset();
+                    }
+                }
+
+                _adminLock.Unlock();
+            }
             void Subscribe(const uint32_t id, const string& eventId, const string& callsign, Core::JSONRPC::Message& response)
             {
                 _adminLock.Lock();
@@ -959,11 +1200,12 @@ namespace Core {
             }
 
         private:
-            Core::CriticalSection _adminLock;
+            mutable Core::CriticalSection _adminLock;
             HandlerMap _handlers;
             ObserverMap _observers;
             NotificationFunction _notificationFunction;
             const std::vector<uint8_t> _versions;
+            std::atomic<bool> _instrumented;
         };
 
         using Error = Message::Info;
@@ -5,6 +5,8 @@
 #include "Number.h"
 #include "Portability.h"
 
+#include <atomic>
+
 namespace WPEFramework {
 namespace Core {
     template <typename TYPE>
@@ -92,6 +94,274 @@ namespace Core {
         TYPE _average;
         uint32_t _measurements;
     };
+
+    // A latency histogram in the spirit of HdrHistogram. Every power of two gets its own range of
+    // SubBuckets linear buckets, so any value reported, e.g. a percentile, is less than 1/SubBuckets
+    // off from what was recorded, from 0 up to 2^32-1 (larger values are counted as 2^32-1).
+    // Recording is lock free. Each thread counts in one of the shards, picked by its thread id, so
+    // threads recording at the same time do not fight over the same cache lines. A Snapshot adds up
+    // the shards and can be merged with the snapshots of other histograms.
+    class Histogram {
+    public:
+        static constexpr uint8_t Precision = 4;
+        static constexpr uint32_t SubBuckets = (1 << Precision);
+        static constexpr uint16_t Buckets = ((32 - Precision) + 1) * SubBuckets;
+
+        class Snapshot {
+        public:
+            Snapshot()
+            {
+                Reset();
+            }
+            Snapshot(const Snapshot& copy)
+            {
+                ::memcpy(this, &copy, sizeof(Snapshot));
+            }
+            ~Snapshot()
+            {
+            }
+
+            Snapshot& operator=(const Snapshot& RHS)
+            {
+                ::memcpy(this, &RHS, sizeof(Snapshot));
+
+                return (*this);
+            }
+
+        public:
+            void Reset()
+            {
+                ::memset(_counts, 0, sizeof(_counts));
+                _count = 0;
+                _sum = 0;
+                _min = ~0;
+                _max = 0;
+            }
+            void Merge(const Snapshot& other)
+            {
+                for (uint16_t index = 0; index < Buckets; index++) {
+                    _counts[index] += other._counts[index];
+                }
+                _count += other._count;
+                _sum += other._sum;
+                _min = (other._min < _min ? other._min : _min);
+                _max = (other._max > _max ? other._max : _max);
+            }
+            // Removes an earlier snapshot of the same histogram, what is left is recorded since.
+            void Subtract(const Snapshot& earlier)
+            {
+                uint16_t first = Buckets;
+                uint16_t last = 0;
+
+                for (uint16_t index = 0; index < Buckets; index++) {
+                    _counts[index] -= earlier._counts[index];
+
+                    if (_counts[index] != 0) {
+                        first = (first == Buckets ? index : first);
+                        last = index;
+                    }
+                }
+                _count -= earlier._count;
+                _sum -= earlier._sum;
+
+                if (first == Buckets) {
+                    _min = ~0;
+                    _max = 0;
+                } else {
+                    // The exact extremes are gone, narrow them down to the buckets that are left.
+                    uint32_t lowest = (first == 0 ? 0 : Histogram::Value(first - 1) + 1);
+                    uint32_t highest = Histogram::Value(last);
+
+                    _min = (_min > lowest ? _min : lowest);
+                    _max = (_max < highest ? _max : highest);
+                }
+            }
+            inline uint64_t Count() const
+            {
+                return (_count);
+            }
+            inline uint32_t Min() const
+            {
+                return (_count == 0 ? 0 : _min);
+            }
+            inline uint32_t Max() const
+            {
+                return (_max);
+            }
+            inline uint32_t Average() const
+            {
+                return (_count == 0 ? 0 : static_cast<uint32_t>(_sum / _count));
+            }
+            // The value below which the given percentage [0-100] of the recordings fall.
+            uint32_t Percentile(const double percentage) const
+            {
+                uint32_t result = 0;
+
+                if (_count != 0) {
+                    uint64_t rank = static_cast<uint64_t>(((percentage * _count) / 100.0) + 0.5);
+                    uint64_t seen = 0;
+                    uint16_t index = 0;
+
+                    rank = (rank == 0 ? 1 : (rank > _count ? _count : rank));
+
+                    while ((index < (Buckets - 1)) && ((seen += _counts[index]) < rank)) {
+                        index++;
+                    }
+
+                    result = Histogram::Value(index);
+                    result = (result > _max ? _max : (result < _min ? _min : result));
+                }
+
+                return (result);
+            }
+
+        private:
+            friend class Histogram;
+
+            uint64_t _counts[Buckets];
+            uint64_t _count;
+            uint64_t _sum;
+            uint32_t _min;
+            uint32_t _max;
+        };
+
+    private:
+        struct Shard {
+            std::atomic<uint64_t> _counts[Buckets];
+            std::atomic<uint64_t> _sum;
+            std::atomic<uint32_t> _min;
+            std::atomic<uint32_t> _max;
+
+            // The next shard starts on its own cache line.
+            uint8_t _padding[64 - ((sizeof(std::atomic<uint64_t>) * (Buckets + 1) + (2 * sizeof(std::atomic<uint32_t>))) % 64)];
+        };
+
+        Histogram(const Histogram&) = delete;
+        Histogram& operator=(const Histogram&) = delete;
+
+    public:
+        Histogram(const uint8_t shards = 4)
+            : _shards(new Shard[shards == 0 ? 1 : shards])
+            , _count(shards == 0 ? 1 : shards)
+        {
+            Reset();
+        }
+        ~Histogram()
+        {
+            delete[] _shards;
+        }
+
+    public:
+        void Set(const uint64_t value)
+        {
+            uint32_t actual = (value > static_cast<uint32_t>(~0) ? static_cast<uint32_t>(~0) : static_cast<uint32_t>(value));
+            Shard& shard(_shards[Slot(_count)]);
+
+            shard._counts[Index(actual)].fetch_add(1, std::memory_order_relaxed);
+            shard._sum.fetch_add(actual, std::memory_order_relaxed);
+
+            uint32_t current = shard._min.load(std::memory_order_relaxed);
+            while ((actual < current) && (shard._min.compare_exchange_weak(current, actual, std::memory_order_relaxed) == false)) {
+            }
+            current = shard._max.load(std::memory_order_relaxed);
+            while ((actual > current) && (shard._max.compare_exchange_weak(current, actual, std::memory_order_relaxed) == false)) {
+            }
+        }
+        // Recordings that happen while resetting, may or may not survive it.
+        void Reset()
+        {
+            for (uint8_t index = 0; index < _count; index++) {
+                Shard& shard(_shards[index]);
+
+                for (uint16_t bucket = 0; bucket < Buckets; bucket++) {
+                    shard._counts[bucket].store(0, std::memory_order_relaxed);
+                }
+                shard._sum.store(0, std::memory_order_relaxed);
+                shard._min.store(~0, std::memory_order_relaxed);
+                shard._max.store(0, std::memory_order_relaxed);
+            }
+        }
+        // Adds what was recorded to the snapshot.
+        void Merge(Snapshot& snapshot) const
+        {
+            for (uint8_t index = 0; index < _count; index++) {
+                const Shard& shard(_shards[index]);
+
+                for (uint16_t bucket = 0; bucket < Buckets; bucket++) {
+                    uint64_t count = shard._counts[bucket].load(std::memory_order_relaxed);
+
+                    snapshot._counts[bucket] += count;
+                    snapshot._count += count;
+                }
+
+                uint32_t min = shard._min.load(std::memory_order_relaxed);
+                uint32_t max = shard._max.load(std::memory_order_relaxed);
+
+                snapshot._sum += shard._sum.load(std::memory_order_relaxed);
+                snapshot._min = (min < snapshot._min ? min : snapshot._min);
+                snapshot._max = (max > snapshot._max ? max : snapshot._max);
+            }
+        }
+
+        static uint16_t Index(const uint32_t value)
+        {
+            uint16_t result = static_cast<uint16_t>(value);
+
+            if (value >= SubBuckets) {
+                // Keep the Precision + 1 most significant bits, the shift tells the power of two.
+                uint8_t shift = static_cast<uint8_t>(MostSignificantBit(value) - Precision);
+
+                result = static_cast<uint16_t>((shift * SubBuckets) + (value >> shift));
+            }
+
+            return (result);
+        }
+        // The highest value that is counted in the bucket.
+        static uint32_t Value(const uint16_t index)
+        {
+            uint32_t result = index;
+
+            if (index >= (2 * SubBuckets)) {
+                uint8_t shift = static_cast<uint8_t>((index / SubBuckets) - 1);
+                uint32_t lowest = static_cast<uint32_t>(index - (shift * SubBuckets)) << shift;
+
+                result = lowest + ((1 << shift) - 1);
+            }
+
+            return (result);
+        }
+        // Picks one of the slots for the calling thread, the same thread always gets the same one.
+        static uint8_t Slot(const uint8_t slots)
+        {
+#ifdef __WIN32__
+            uint64_t id = static_cast<uint64_t>(::GetCurrentThreadId());
+#else
+            uint64_t id = (uint64_t)(::pthread_self());
+#endif
+            // Thread ids are often addresses, spread at a fixed distance. Mix the bits before picking.
+            return (static_cast<uint8_t>(static_cast<uint32_t>((id * 0x9E3779B97F4A7C15ULL) >> 32) % slots));
+        }
+
+    private:
+        static uint8_t MostSignificantBit(const uint32_t value)
+        {
+#ifdef __GNUC__
+            return (static_cast<uint8_t>(31 - __builtin_clz(value)));
+#else
+            uint8_t result = 0;
+            uint32_t remainder = value;
+
+            while ((remainder >>= 1) != 0) {
+                result++;
+            }
+
+            return (result);
+#endif
+        }
+    private:
+        Shard* _shards;
+        const uint8_t _count;
+    };
 }
 }
 
@@ -200,6 +200,7 @@ typedef std::string string;
 #include <pthread.h>
 #include <sched.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -648,7 +649,8 @@ namespace Core {
         ERROR_CODE(ERROR_INVALID_SIGNATURE, 38) \
         ERROR_CODE(ERROR_READ_ERROR, 39) \
         ERROR_CODE(ERROR_WRITE_ERROR, 40) \
-        ERROR_CODE(ERROR_INVALID_DESIGNATOR, 41)
+        ERROR_CODE(ERROR_INVALID_DESIGNATOR, 41) \
+        ERROR_CODE(ERROR_INVALID_RANGE, 42)
 
     #define ERROR_CODE(CODE, VALUE) CODE = VALUE,
 
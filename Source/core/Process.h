@@ -508,37 +508,42 @@ namespace Core {
                     }
                 }
 
-                if ((*pid = fork()) == 0) {
-                    char** actualParameters = reinterpret_cast<char**>(_parameters);
-                    if (_stdin == -1) {
-                        /* Close STDIN and STDOUT as we will redirect them. */
-                        close(0);
-                        close(1);
-                        close(2);
+                // posix_spawn does not copy the page tables of this process, as fork does. The host process can
+                // have a lot of memory mapped, so this is what keeps launching a process cheap.
+                char** actualParameters = reinterpret_cast<char**>(_parameters);
+                posix_spawn_file_actions_t actions;
+                posix_spawn_file_actions_init(&actions);
+
+                if (_stdin == -1) {
+                    /* Close master end of pipe */
+                    posix_spawn_file_actions_addclose(&actions, stdinfd[1]);
+                    posix_spawn_file_actions_addclose(&actions, stdoutfd[0]);
+                    posix_spawn_file_actions_addclose(&actions, stderrfd[0]);
+
+                    /* Make stdin into a readable end, stdout and stderr into writable ends */
+                    posix_spawn_file_actions_adddup2(&actions, stdinfd[0], 0);
+                    posix_spawn_file_actions_adddup2(&actions, stdoutfd[1], 1);
+                    posix_spawn_file_actions_adddup2(&actions, stderrfd[1], 2);
+                }
 
-                        /* Close master end of pipe */
-                        close(stdinfd[1]);
-                        close(stdoutfd[0]);
-                        close(stderrfd[0]);
+                pid_t child;
+                int result = posix_spawnp(&child, *actualParameters, &actions, nullptr, actualParameters, environ);
 
-                        /* Make stdin into a readable end */
-                        dup2(stdinfd[0], 0);
+                posix_spawn_file_actions_destroy(&actions);
 
-                        /* Make stdout into writable end */
-                        dup2(stdoutfd[1], 1);
+                if (result != 0) {
+                    TRACE_L1("Failed to start process: %s, error: %d.", *actualParameters, result);
+                    error = (result == ENOENT ? Core::ERROR_UNAVAILABLE : Core::ERROR_GENERAL);
+                    *pid = 0;
 
-                        /* Make stdout into writable end */
-                        dup2(stderrfd[1], 2);
-                    }
-                    /* fork a child process           */
-                    if (execvp(*actualParameters, actualParameters) < 0) {
-                        // TRACE_L1("Failed to start process: %s.", explain_execvp(*actualParameters, actualParameters));
-                        int result = errno;
-                        TRACE_L1("Failed to start process: %d - %d.", getpid(), result);
-                        // No glory, so lets quit our selves, avoid the _atexit handlers they should not be there yet...
-                        _exit(result);
+                    if (_stdin == -1) {
+                        _stdin = 0;
+                        _stdout = 0;
+                        _stderr = 0;
                     }
-                } else if (static_cast<int>(_PID) != -1) {
+                } else {
+                    *pid = static_cast<uint32_t>(child);
+
                     /* Parent process... */
                     if (_stdin == -1) {
                         close(stdinfd[0]);
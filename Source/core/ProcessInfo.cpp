@@ -135,6 +135,52 @@ namespace Core {
         }
     }
 
+    // Resolving the executable of a process is the expensive part of a scan. The names are kept
+    // per pid, together with the start time and the comm of the process: the start time changes if
+    // the pid is reused, the comm if the process executes another program.
+    struct CachedName {
+        uint64_t Start;
+        string Comm;
+        string Name;
+    };
+    typedef std::map<uint32_t, CachedName> NameCache;
+
+    static Core::CriticalSection _nameLock;
+    static NameCache _names;
+
+    static bool ProcessIdentity(const uint32_t pid, uint64_t& start, string& comm)
+    {
+        bool result = false;
+        char procpath[48];
+        int fd;
+
+        snprintf(procpath, sizeof(procpath), "/proc/%u/stat", pid);
+
+        if ((fd = open(procpath, O_RDONLY)) > 0) {
+            char buffer[512];
+            ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+
+            if (size > 0) {
+                buffer[size] = '\0';
+
+                // The comm is between parentheses, and might hold them itself.
+                const char* begin = strchr(buffer, '(');
+                const char* end = strrchr(buffer, ')');
+                unsigned long long value = 0;
+
+                if ((begin != nullptr) && (end != nullptr) && (begin < end) && (sscanf(end, ") %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu", &value) == 1)) {
+                    comm.assign(begin + 1, end - begin - 1);
+                    start = value;
+                    result = true;
+                }
+            }
+
+            close(fd);
+        }
+
+        return (result);
+    }
+
     // Iterate over Processes
     static void FindPid(const string& item, const bool exact, std::list<uint32_t>& pids)
     {
@@ -148,33 +194,156 @@ namespace Core {
 
         dp = opendir("/proc");
         if (dp != nullptr) {
+            NameCache names;
+
+            _nameLock.Lock();
+
             while (nullptr != (ep = readdir(dp))) {
                 int pid;
                 char* endptr;
+                uint64_t start;
+                string comm;
 
                 pid = strtol(ep->d_name, &endptr, 10);
 
-                if ('\0' == endptr[0]) {
-                    // We have a valid PID, Find, the parent of this process..
-                    TCHAR buffer[512];
-                    ProcessName(pid, buffer, sizeof(buffer));
+                // A process that is gone by now, is not reported.
+                if (('\0' == endptr[0]) && (ProcessIdentity(pid, start, comm) == true)) {
+                    NameCache::iterator entry(_names.find(pid));
+
+                    if ((entry == _names.end()) || (entry->second.Start != start) || (entry->second.Comm != comm)) {
+                        TCHAR buffer[512];
+                        ProcessName(pid, buffer, sizeof(buffer));
+
+                        entry = names.emplace(pid, CachedName { start, comm, string(buffer) }).first;
+                    } else {
+                        entry = names.emplace(pid, std::move(entry->second)).first;
+                    }
+
+                    const string& name(entry->second.Name);
 
                     if (fullMatch == true) {
-                        if (item == buffer) {
+                        if (item == name) {
                             pids.push_back(pid);
                         }
                     } else {
-                        if (fileName == Core::File::FileNameExtended(string(buffer))) {
+                        if (fileName == Core::File::FileNameExtended(name)) {
                             pids.push_back(pid);
                         }
                     }
                 }
             }
 
+            // Processes that are gone, are gone from the cache as well.
+            _names.swap(names);
+
+            _nameLock.Unlock();
+
             (void)closedir(dp);
         }
     }
 
+    // Reads a /proc file from the start, through a descriptor that is kept open.
+    static ssize_t ReadFile(const int fd, char buffer[], const uint32_t length)
+    {
+        ssize_t size = ::pread(fd, buffer, length - 1, 0);
+
+        buffer[size > 0 ? size : 0] = '\0';
+
+        return (size);
+    }
+
+    static void SkipField(const char*& text)
+    {
+        while (*text == ' ') {
+            text++;
+        }
+        while ((*text != ' ') && (*text != '\0')) {
+            text++;
+        }
+    }
+
+    static uint64_t NextNumber(const char*& text)
+    {
+        uint64_t result = 0;
+
+        while (*text == ' ') {
+            text++;
+        }
+        while ((*text >= '0') && (*text <= '9')) {
+            result = (result * 10) + (*text - '0');
+            text++;
+        }
+
+        return (result);
+    }
+
+    // The fields of /proc/<pid>/stat, after the command name. The name is between parentheses
+    // but can contain spaces and parentheses itself, so start at the last closing one.
+    static bool ParseStat(const char buffer[], ProcessInfo::Sampler::Snapshot& snapshot)
+    {
+        const char* text = ::strrchr(buffer, ')');
+
+        if (text != nullptr) {
+            text++;
+
+            while (*text == ' ') {
+                text++;
+            }
+
+            snapshot.State = *text++;
+            snapshot.Parent = static_cast<uint32_t>(NextNumber(text));
+
+            // pgrp, session, tty_nr, tpgid, flags, minflt, cminflt, majflt and cmajflt.
+            for (uint8_t index = 0; index < 9; index++) {
+                SkipField(text);
+            }
+
+            snapshot.User = NextNumber(text);
+            snapshot.System = NextNumber(text);
+
+            // cutime, cstime, priority and nice.
+            for (uint8_t index = 0; index < 4; index++) {
+                SkipField(text);
+            }
+
+            snapshot.Threads = static_cast<uint32_t>(NextNumber(text));
+
+            // itrealvalue
+            SkipField(text);
+
+            snapshot.Started = NextNumber(text);
+        }
+
+        return (text != nullptr);
+    }
+
+    static void ParseStatm(const char buffer[], uint64_t& allocated, uint64_t& resident, uint64_t& shared)
+    {
+        const char* text = buffer;
+
+        allocated = NextNumber(text) * PageSize;
+        resident = NextNumber(text) * PageSize;
+        shared = NextNumber(text) * PageSize;
+    }
+
+    static bool MemoryUsage(const uint32_t pid, uint64_t& allocated, uint64_t& resident, uint64_t& shared)
+    {
+        bool result = false;
+        TCHAR buffer[128];
+        int fd;
+
+        snprintf(buffer, sizeof(buffer), "/proc/%u/statm", pid);
+        if ((fd = open(buffer, O_RDONLY)) > 0) {
+            if (ReadFile(fd, buffer, sizeof(buffer)) > 0) {
+                ParseStatm(buffer, allocated, resident, shared);
+                result = true;
+            }
+            close(fd);
+        }
+
+        return (result);
+    }
+
 #endif
 
     // Get the Processes with this name.
@@ -290,17 +459,10 @@ namespace Core {
             }
         }
 #else
-        int fd;
-        TCHAR buffer[128];
-        int VmSize = 0;
+        uint64_t allocated, resident, shared;
 
-        snprintf(buffer, sizeof(buffer), "/proc/%d/statm", _pid);
-        if ((fd = open(buffer, O_RDONLY)) > 0) {
-            if (read(fd, buffer, sizeof(buffer)) > 0) {
-                sscanf(buffer, "%d", &VmSize);
-                result = VmSize * PageSize;
-            }
-            close(fd);
+        if (MemoryUsage(_pid, allocated, resident, shared) == true) {
+            result = allocated;
         }
 #endif
 
@@ -318,17 +480,10 @@ namespace Core {
             }
         }
 #else
-        int fd;
-        TCHAR buffer[128];
-        int VmRSS = 0;
+        uint64_t allocated, resident, shared;
 
-        snprintf(buffer, sizeof(buffer), "/proc/%d/statm", _pid);
-        if ((fd = open(buffer, O_RDONLY)) > 0) {
-            if (read(fd, buffer, sizeof(buffer)) > 0) {
-                sscanf(buffer, "%*d %d", &VmRSS);
-                result = VmRSS * PageSize;
-            }
-            close(fd);
+        if (MemoryUsage(_pid, allocated, resident, shared) == true) {
+            result = resident;
         }
 #endif
 
@@ -346,17 +501,10 @@ namespace Core {
             }
         }
 #else
-        int fd;
-        TCHAR buffer[128];
-        int Share = 0;
+        uint64_t allocated, resident, shared;
 
-        snprintf(buffer, sizeof(buffer), "/proc/%d/statm", _pid);
-        if ((fd = open(buffer, O_RDONLY)) > 0) {
-            if (read(fd, buffer, sizeof(buffer)) > 0) {
-                sscanf(buffer, "%*d %*d %d", &Share);
-                result = Share * PageSize;
-            }
-            close(fd);
+        if (MemoryUsage(_pid, allocated, resident, shared) == true) {
+            result = shared;
         }
 #endif
 
@@ -428,5 +576,261 @@ namespace Core {
 #endif
         return (result);
     }
+
+    ProcessInfo::Sampler::Source::Source(const uint32_t pid)
+        : _pid(pid)
+        , _name(ProcessInfo(pid).Executable())
+#ifndef __WIN32__
+        , _stat(-1)
+        , _statm(-1)
+#endif
+    {
+#ifndef __WIN32__
+        TCHAR fileName[48];
+
+        snprintf(fileName, sizeof(fileName), "/proc/%u/stat", pid);
+        _stat = ::open(fileName, O_RDONLY | O_CLOEXEC);
+
+        snprintf(fileName, sizeof(fileName), "/proc/%u/statm", pid);
+        _statm = ::open(fileName, O_RDONLY | O_CLOEXEC);
+#endif
+    }
+
+    ProcessInfo::Sampler::Source::~Source()
+    {
+#ifndef __WIN32__
+        if (_stat != -1) {
+            ::close(_stat);
+        }
+        if (_statm != -1) {
+            ::close(_statm);
+        }
+#endif
+    }
+
+    bool ProcessInfo::Sampler::Source::Read(Snapshot& snapshot)
+    {
+        bool result = false;
+
+        snapshot.Id = _pid;
+
+#ifdef __WIN32__
+        ProcessInfo info(_pid);
+
+        if (info.IsActive() == true) {
+            snapshot.Parent = 0;
+            snapshot.Threads = 0;
+            snapshot.State = 'R';
+            snapshot.Allocated = info.Allocated();
+            snapshot.Resident = info.Resident();
+            snapshot.Shared = info.Shared();
+            snapshot.User = 0;
+            snapshot.System = 0;
+            snapshot.Started = 0;
+            result = true;
+        }
+#else
+        // Once the process is gone, the descriptors stay invalid, even if the pid gets reused.
+        if ((ReadFile(_stat, _buffer, sizeof(_buffer)) > 0) && (ParseStat(_buffer, snapshot) == true)) {
+            if (ReadFile(_statm, _buffer, sizeof(_buffer)) > 0) {
+                ParseStatm(_buffer, snapshot.Allocated, snapshot.Resident, snapshot.Shared);
+                result = true;
+            }
+        }
+#endif
+
+        if (result == true) {
+            snapshot.Name = _name;
+        }
+
+        return (result);
+    }
+
+    ProcessInfo::Sampler::Sampler()
+        : _adminLock()
+        , _sampleLock()
+        , _sources()
+        , _current()
+        , _pending()
+        , _total(0)
+        , _idle(0)
+        , _cycle(0)
+#ifndef __WIN32__
+        , _stat(::open("/proc/stat", O_RDONLY | O_CLOEXEC))
+#endif
+    {
+    }
+
+    ProcessInfo::Sampler::~Sampler()
+    {
+        for (std::pair<const uint32_t, Source*>& entry : _sources) {
+            delete entry.second;
+        }
+        _sources.clear();
+
+#ifndef __WIN32__
+        if (_stat != -1) {
+            ::close(_stat);
+        }
+#endif
+    }
+
+    uint32_t ProcessInfo::Sampler::Add(const uint32_t pid)
+    {
+        uint32_t result = ERROR_DUPLICATE_KEY;
+
+        _sampleLock.Lock();
+
+        if (_sources.find(pid) == _sources.end()) {
+            Source* source = new Source(pid);
+
+            if (source->IsValid() == true) {
+                _sources.emplace(pid, source);
+                result = ERROR_NONE;
+            } else {
+                delete source;
+                result = ERROR_UNAVAILABLE;
+            }
+        }
+
+        _sampleLock.Unlock();
+
+        return (result);
+    }
+
+    uint32_t ProcessInfo::Sampler::Add(const string& name, const bool exact)
+    {
+        uint32_t result = ERROR_UNAVAILABLE;
+        Iterator index(name, exact);
+
+        while (index.Next() == true) {
+            if (Add(index.Current().Id()) != ERROR_UNAVAILABLE) {
+                result = ERROR_NONE;
+            }
+        }
+
+        return (result);
+    }
+
+    uint32_t ProcessInfo::Sampler::Remove(const uint32_t pid)
+    {
+        uint32_t result = ERROR_UNKNOWN_KEY;
+
+        _sampleLock.Lock();
+
+        Sources::iterator index(_sources.find(pid));
+
+        if (index != _sources.end()) {
+            delete index->second;
+            _sources.erase(index);
+            result = ERROR_NONE;
+        }
+
+        _sampleLock.Unlock();
+
+        return (result);
+    }
+
+    uint32_t ProcessInfo::Sampler::Sample()
+    {
+        uint64_t total = 0;
+        uint64_t idle = 0;
+        uint32_t count = 0;
+
+        _sampleLock.Lock();
+
+        SystemTicks(total, idle);
+
+        // The pending snapshots are the ones of two cycles ago, overwriting them reuses their storage.
+        Sources::iterator index(_sources.begin());
+
+        while (index != _sources.end()) {
+            if (count == _pending.size()) {
+                _pending.emplace_back();
+            }
+
+            if (index->second->Read(_pending[count]) == true) {
+                count++;
+                index++;
+            } else {
+                delete index->second;
+                index = _sources.erase(index);
+            }
+        }
+
+        _pending.resize(count);
+
+        _adminLock.Lock();
+
+        _current.swap(_pending);
+        _total = total;
+        _idle = idle;
+        _cycle++;
+
+        _adminLock.Unlock();
+
+        _sampleLock.Unlock();
+
+        return (count);
+    }
+
+    bool ProcessInfo::Sampler::Get(const uint32_t pid, Snapshot& snapshot) const
+    {
+        bool result = false;
+
+        _adminLock.Lock();
+
+        // The snapshots are in pid order, as the sources they are read from.
+        Snapshots::const_iterator index(std::lower_bound(_current.begin(), _current.end(), pid,
+            [](const Snapshot& element, const uint32_t id) { return (element.Id < id); }));
+
+        if ((index != _current.end()) && (index->Id == pid)) {
+            snapshot = *index;
+            result = true;
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+
+    void ProcessInfo::Sampler::Get(Snapshots& snapshots) const
+    {
+        _adminLock.Lock();
+
+        snapshots = _current;
+
+        _adminLock.Unlock();
+    }
+
+    void ProcessInfo::Sampler::SystemTicks(uint64_t& total, uint64_t& idle)
+    {
+#ifdef __WIN32__
+        FILETIME idleTime, kernelTime, userTime;
+
+        if (::GetSystemTimes(&idleTime, &kernelTime, &userTime) != FALSE) {
+            // Kernel time includes the idle time.
+            idle = (static_cast<uint64_t>(idleTime.dwHighDateTime) << 32) | idleTime.dwLowDateTime;
+            total = ((static_cast<uint64_t>(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime) + ((static_cast<uint64_t>(userTime.dwHighDateTime) << 32) | userTime.dwLowDateTime);
+        }
+#else
+        // Only the first line is needed: "cpu user nice system idle iowait irq softirq steal ..."
+        char buffer[256];
+
+        if ((_stat != -1) && (ReadFile(_stat, buffer, sizeof(buffer)) > 0) && (::strncmp(buffer, "cpu ", 4) == 0)) {
+            const char* text = &(buffer[4]);
+            uint64_t fields[8];
+
+            total = 0;
+
+            for (uint8_t index = 0; index < (sizeof(fields) / sizeof(uint64_t)); index++) {
+                fields[index] = NextNumber(text);
+                total += fields[index];
+            }
+
+            idle = fields[3] + fields[4];
+        }
+#endif
+    }
 }
 }
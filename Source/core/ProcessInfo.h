@@ -2,10 +2,13 @@
 #define __PROCESSINFO_H
 
 #include <list>
+#include <map>
+#include <vector>
 
 #include "IIterator.h"
 #include "Module.h"
 #include "Portability.h"
+#include "Sync.h"
 
 namespace WPEFramework {
 namespace Core {
@@ -100,6 +103,124 @@ namespace Core {
             uint32_t _index;
         };
 
+        // Samples a set of processes in one cycle. The /proc files of every process are opened
+        // once and kept open, each cycle reads them into fixed buffers and parses all fields in a
+        // single pass. Callers always get the results of one complete cycle.
+        class EXTERNAL Sampler {
+        public:
+            struct Snapshot {
+                uint32_t Id;
+                uint32_t Parent;
+                uint32_t Threads;
+                char State;
+                // In bytes.
+                uint64_t Allocated;
+                uint64_t Resident;
+                uint64_t Shared;
+                // In clock ticks, see sysconf(_SC_CLK_TCK).
+                uint64_t User;
+                uint64_t System;
+                uint64_t Started;
+                string Name;
+            };
+
+            typedef std::vector<Snapshot> Snapshots;
+
+        private:
+            Sampler(const Sampler&) = delete;
+            Sampler& operator=(const Sampler&) = delete;
+
+            class Source {
+            private:
+                Source() = delete;
+                Source(const Source&) = delete;
+                Source& operator=(const Source&) = delete;
+
+            public:
+                Source(const uint32_t pid);
+                ~Source();
+
+            public:
+                inline uint32_t Id() const
+                {
+                    return (_pid);
+                }
+                inline bool IsValid() const
+                {
+#ifdef __WIN32__
+                    return (true);
+#else
+                    return ((_stat != -1) && (_statm != -1));
+#endif
+                }
+                inline const string& Name() const
+                {
+                    return (_name);
+                }
+                bool Read(Snapshot& snapshot);
+
+            private:
+                uint32_t _pid;
+                string _name;
+#ifndef __WIN32__
+                int _stat;
+                int _statm;
+                char _buffer[512];
+#endif
+            };
+
+            typedef std::map<uint32_t, Source*> Sources;
+
+        public:
+            Sampler();
+            ~Sampler();
+
+        public:
+            uint32_t Add(const uint32_t pid);
+            uint32_t Remove(const uint32_t pid);
+            // Add all running processes with this name.
+            uint32_t Add(const string& name, const bool exact);
+
+            // Read all processes, processes that are gone are dropped. Returns the number of processes sampled.
+            uint32_t Sample();
+
+            // Incremented on every completed cycle.
+            inline uint32_t Cycle() const
+            {
+                _adminLock.Lock();
+                uint32_t result = _cycle;
+                _adminLock.Unlock();
+
+                return (result);
+            }
+            // System wide CPU ticks of the last cycle, all and idle only.
+            inline void Ticks(uint64_t& total, uint64_t& idle) const
+            {
+                _adminLock.Lock();
+                total = _total;
+                idle = _idle;
+                _adminLock.Unlock();
+            }
+            bool Get(const uint32_t pid, Snapshot& snapshot) const;
+            void Get(Snapshots& snapshots) const;
+
+        private:
+            void SystemTicks(uint64_t& total, uint64_t& idle);
+
+        private:
+            mutable Core::CriticalSection _adminLock;
+            Core::CriticalSection _sampleLock;
+            Sources _sources;
+            Snapshots _current;
+            Snapshots _pending;
+            uint64_t _total;
+            uint64_t _idle;
+            uint32_t _cycle;
+#ifndef __WIN32__
+            int _stat;
+#endif
+        };
+
     public:
         // Current Process Information
         ProcessInfo();
@@ -104,7 +104,11 @@ namespace Core {
     }
 
     SharedBuffer::SharedBuffer(const TCHAR name[])
-        : DataElementFile(name, READABLE | WRITABLE | SHAREABLE)
+        : SharedBuffer(name, Mapping())
+    {
+    }
+    SharedBuffer::SharedBuffer(const TCHAR name[], const DataElementFile::Mapping& mapping)
+        : DataElementFile(name, READABLE | WRITABLE | SHAREABLE | mapping.Options())
         , _administrationBuffer((string(name) + ".admin"), READABLE | WRITABLE | SHAREABLE)
         , _administration(reinterpret_cast<Administration*>(PointerAlign(_administrationBuffer.Buffer())))
 #ifdef __WIN32__
@@ -119,7 +123,11 @@ namespace Core {
         Align<uint64_t>();
     }
     SharedBuffer::SharedBuffer(const TCHAR name[], const uint32_t bufferSize, const uint16_t administratorSize)
-        : DataElementFile(name, READABLE | WRITABLE | SHAREABLE | CREATE, bufferSize)
+        : SharedBuffer(name, bufferSize, administratorSize, Mapping())
+    {
+    }
+    SharedBuffer::SharedBuffer(const TCHAR name[], const uint32_t bufferSize, const uint16_t administratorSize, const DataElementFile::Mapping& mapping)
+        : DataElementFile(name, READABLE | WRITABLE | SHAREABLE | CREATE | mapping.Options(), bufferSize)
         , _administrationBuffer((string(name) + ".admin"), READABLE | WRITABLE | SHAREABLE | CREATE, administratorSize + sizeof(Administration) + (2 * sizeof(void*)) + 8 /* Align buffer on 64 bits boundary */)
         , _administration(reinterpret_cast<Administration*>(PointerAlign(_administrationBuffer.Buffer())))
 #ifdef __WIN32__
@@ -89,12 +89,15 @@ namespace Core {
 
         // This is the consumer constructor. It should always take place, after, the producer
         // construct. The producer will create the Administration area, and the shared buffer,
-        // default size.
+        // default size. The mapping options (DataElementFile::PREFAULT, HUGEPAGES, ...) are
+        // per side, a consumer might want to prefault a buffer the producer does not touch.
         SharedBuffer(const TCHAR name[]);
+        SharedBuffer(const TCHAR name[], const DataElementFile::Mapping& mapping);
 
         // This is the Producer constructor. It sets up all the information and locks the
         // Semaphore by default.
         SharedBuffer(const TCHAR name[], const uint32_t bufferSize, const uint16_t administrationSize);
+        SharedBuffer(const TCHAR name[], const uint32_t bufferSize, const uint16_t administrationSize, const DataElementFile::Mapping& mapping);
 
         inline uint32_t RequestProduce(const uint32_t waitTime)
         {
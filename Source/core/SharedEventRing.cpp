@@ -0,0 +1,220 @@
+#include "SharedEventRing.h"
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace WPEFramework {
+
+namespace Core {
+
+    static constexpr uint32_t EventRingMagic = 0x52494E47; // "RING"
+
+    /* static */ uint32_t SharedEventRing::Events(const uint32_t events)
+    {
+        uint32_t result = 2;
+
+        // A power of 2, so the slot of an event follows from its sequence number.
+        while (result < events) {
+            result <<= 1;
+        }
+
+        return (result);
+    }
+
+    SharedEventRing::SharedEventRing(const string& name, const uint64_t sequence)
+        : _buffer(name, DataElementFile::READABLE | DataElementFile::WRITABLE | DataElementFile::SHAREABLE)
+        , _administration(nullptr)
+        , _data(nullptr)
+        , _next(0)
+        , _dropped(0)
+        , _interrupted(false)
+    {
+        if ((_buffer.IsValid() == true) && (_buffer.Size() >= sizeof(Administration))) {
+            Administration* administration = reinterpret_cast<Administration*>(_buffer.Buffer());
+
+            if ((administration->_magic == EventRingMagic) && (_buffer.Size() >= (Stride(sizeof(Administration)) + (static_cast<uint64_t>(administration->_events) * administration->_stride)))) {
+                _administration = administration;
+                _data = &(_buffer.Buffer()[Stride(sizeof(Administration))]);
+
+                // Only what is produced from now on is ours, or from the sequence we were handed. If that
+                // one is overwritten already, the first Consume reports what we missed in Dropped().
+                _next = _administration->_produced.load(std::memory_order_acquire);
+
+                if (sequence < _next) {
+                    _next = sequence;
+                }
+            }
+        }
+
+        if (_administration == nullptr) {
+            TRACE_L1("Could not open a SharedEventRing: %s", name.c_str());
+        }
+    }
+
+    SharedEventRing::SharedEventRing(const string& name, const uint32_t events, const uint16_t eventSize)
+        : _buffer(name, DataElementFile::READABLE | DataElementFile::WRITABLE | DataElementFile::SHAREABLE | DataElementFile::CREATE,
+              Stride(sizeof(Administration)) + (Events(events) * Stride(sizeof(Slot) + eventSize)))
+        , _administration(nullptr)
+        , _data(nullptr)
+        , _next(0)
+        , _dropped(0)
+        , _interrupted(false)
+    {
+        if (_buffer.IsValid() == true) {
+            _administration = reinterpret_cast<Administration*>(_buffer.Buffer());
+            _data = &(_buffer.Buffer()[Stride(sizeof(Administration))]);
+
+            memset(_buffer.Buffer(), 0, static_cast<size_t>(_buffer.Size()));
+
+            _administration->_eventSize = eventSize;
+            _administration->_stride = Stride(sizeof(Slot) + eventSize);
+            _administration->_events = Events(events);
+
+            // Only now the consumers may take the ring for valid.
+            std::atomic_thread_fence(std::memory_order_release);
+            _administration->_magic = EventRingMagic;
+        } else {
+            TRACE_L1("Could not create a SharedEventRing: %s", name.c_str());
+        }
+    }
+
+    SharedEventRing::~SharedEventRing()
+    {
+    }
+
+    uint32_t SharedEventRing::Produce(const uint8_t data[], const uint16_t length)
+    {
+        uint32_t result = ERROR_UNAVAILABLE;
+
+        if (IsValid() == true) {
+            ASSERT(length <= _administration->_eventSize);
+
+            // There is only one producer, nobody else moves the sequence.
+            const uint64_t sequence = _administration->_produced.load(std::memory_order_relaxed);
+            Slot& slot = SlotInfo(sequence);
+
+            // Consumers that are reading the old event in this slot, see it changed under their hands.
+            slot._sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            slot._timestamp = Now();
+            slot._length = std::min(length, static_cast<uint16_t>(_administration->_eventSize));
+            ::memcpy(SlotData(slot), data, slot._length);
+
+            slot._sequence.store(sequence + 1, std::memory_order_release);
+            _administration->_produced.store(sequence + 1, std::memory_order_release);
+
+            Signal();
+
+            result = ERROR_NONE;
+        }
+
+        return (result);
+    }
+
+    uint32_t SharedEventRing::Consume(uint8_t data[], uint16_t& length, uint64_t& timestamp, const uint32_t waitTime)
+    {
+        uint32_t result = (IsValid() == true ? ERROR_TIMEDOUT : ERROR_UNAVAILABLE);
+        uint64_t deadline = (waitTime == Core::infinite ? 0 : Time::Now().Ticks() + (static_cast<uint64_t>(waitTime) * Time::TicksPerMillisecond));
+
+        while (result == ERROR_TIMEDOUT) {
+            // Sample the change counter before looking, so a change after the look wakes us.
+            uint32_t changes = _administration->_changes.load(std::memory_order_acquire);
+            uint64_t produced = _administration->_produced.load(std::memory_order_acquire);
+
+            if (_interrupted.exchange(false) == true) {
+                result = ERROR_ASYNC_ABORTED;
+            } else if (_next != produced) {
+                if ((produced - _next) > _administration->_events) {
+                    // We are more than a ring behind, the oldest ones are gone.
+                    _dropped += (produced - _next - _administration->_events);
+                    _next = produced - _administration->_events;
+                }
+
+                Slot& slot = SlotInfo(_next);
+                uint64_t before = slot._sequence.load(std::memory_order_acquire);
+
+                length = slot._length;
+                timestamp = slot._timestamp;
+                ::memcpy(data, SlotData(slot), std::min(length, static_cast<uint16_t>(_administration->_eventSize)));
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if ((before == (_next + 1)) && (slot._sequence.load(std::memory_order_relaxed) == before)) {
+                    result = ERROR_NONE;
+                } else {
+                    // Overwritten while we read it, the producer lapped us.
+                    _dropped++;
+                }
+
+                _next++;
+            } else {
+                uint32_t timeLeft = Core::infinite;
+
+                if (waitTime != Core::infinite) {
+                    uint64_t now = Time::Now().Ticks();
+
+                    if ((waitTime == 0) || (now >= deadline)) {
+                        break;
+                    }
+                    timeLeft = static_cast<uint32_t>(((deadline - now) + Time::TicksPerMillisecond - 1) / Time::TicksPerMillisecond);
+                }
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+                struct timespec timeout;
+
+                timeout.tv_sec = timeLeft / 1000;
+                timeout.tv_nsec = (timeLeft % 1000) * 1000 * 1000;
+
+                _administration->_waiters.fetch_add(1, std::memory_order_seq_cst);
+                ::syscall(SYS_futex, reinterpret_cast<int*>(&(_administration->_changes)), FUTEX_WAIT, static_cast<int>(changes), (timeLeft != Core::infinite ? &timeout : nullptr), nullptr, 0);
+                _administration->_waiters.fetch_sub(1, std::memory_order_relaxed);
+#else
+                DEBUG_VARIABLE(changes);
+                ::SleepMs(std::min(timeLeft, static_cast<uint32_t>(1)));
+#endif
+            }
+        }
+
+        return (result);
+    }
+
+    void SharedEventRing::Interrupt()
+    {
+        _interrupted.store(true);
+
+        // Wakes the other consumers as well, they will find nothing new and sleep again.
+        if (IsValid() == true) {
+            Signal();
+        }
+    }
+
+    /* static */ uint64_t SharedEventRing::Now()
+    {
+#if defined(__LINUX__) && !defined(__APPLE__)
+        struct timespec now;
+
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return ((static_cast<uint64_t>(now.tv_sec) * 1000000) + (now.tv_nsec / 1000));
+#else
+        return (Time::Now().Ticks());
+#endif
+    }
+
+    void SharedEventRing::Signal()
+    {
+        _administration->_changes.fetch_add(1, std::memory_order_seq_cst);
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+        // The system call is only needed if a consumer is (about to go) asleep.
+        if (_administration->_waiters.load(std::memory_order_seq_cst) != 0) {
+            ::syscall(SYS_futex, reinterpret_cast<int*>(&(_administration->_changes)), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+#endif
+    }
+}
+}
@@ -0,0 +1,139 @@
+#ifndef __SHARED_EVENT_RING_H
+#define __SHARED_EVENT_RING_H
+
+// ---- Include system wide include files ----
+#include <atomic>
+
+// ---- Include local include files ----
+#include "DataElementFile.h"
+#include "Module.h"
+
+// ---- Referenced classes and types ----
+
+// ---- Helper types and constants ----
+
+namespace WPEFramework {
+
+namespace Core {
+    // Rationale:
+    // Small events (keys, pointer moves) sent as an IPC request per event, to every client, have the
+    // producer wait for the response of each client, so one slow client delays the events for all of
+    // them. The SharedEventRing is a ring of fixed size events in a shared memory file, written by a
+    // single producer and read by any number of consumers, each at its own pace. The producer never
+    // waits: if a consumer falls more than a ring behind, it loses the oldest events and can tell how
+    // many from Dropped(). Every event is stamped with the monotonic time it was produced, so consumers
+    // can measure how long it took to reach them. Consumers waiting for an event are woken with a single
+    // futex wake (Linux), no matter how many there are.
+    // The producer creates the ring and decides on the number (rounded up to a power of 2) and the size
+    // of the events. Consumers open it by name and receive the events produced from then on, or from a
+    // sequence number the producer handed out, see Produced().
+    class EXTERNAL SharedEventRing {
+    private:
+        SharedEventRing() = delete;
+        SharedEventRing(const SharedEventRing&) = delete;
+        SharedEventRing& operator=(const SharedEventRing&) = delete;
+
+        static constexpr uint32_t CacheLine = 64;
+
+        struct Slot {
+            // The sequence number of the event in the slot plus one, 0 while it is written.
+            std::atomic<uint64_t> _sequence;
+            uint64_t _timestamp;
+            uint16_t _length;
+        };
+
+        struct Administration {
+            uint32_t _magic;
+            uint32_t _eventSize;
+            uint32_t _stride;
+            uint32_t _events;
+            std::atomic<uint32_t> _changes;
+            std::atomic<uint32_t> _waiters;
+            std::atomic<uint64_t> _produced;
+        };
+
+    public:
+        // This is the consumer constructor, the producer needs to have created the ring. The first event
+        // consumed is the one with the given sequence number, by default the next one produced.
+        SharedEventRing(const string& name, const uint64_t sequence = ~0);
+
+        // This is the producer constructor, it creates (or recreates) the ring.
+        SharedEventRing(const string& name, const uint32_t events, const uint16_t eventSize);
+
+        ~SharedEventRing();
+
+    public:
+        inline bool IsValid() const
+        {
+            return (_administration != nullptr);
+        }
+        inline const string& Name() const
+        {
+            return (_buffer.Name());
+        }
+        inline uint32_t Events() const
+        {
+            return (_administration->_events);
+        }
+        inline uint16_t EventSize() const
+        {
+            return (static_cast<uint16_t>(_administration->_eventSize));
+        }
+        // The sequence number the next event produced gets.
+        inline uint64_t Produced() const
+        {
+            return (_administration->_produced.load(std::memory_order_relaxed));
+        }
+
+        // Producer side, never blocks.
+        uint32_t Produce(const uint8_t data[], const uint16_t length);
+
+        // Consumer side. On success the event is copied to data (which must hold EventSize() bytes) and
+        // timestamp is the Now() at which it was produced.
+        uint32_t Consume(uint8_t data[], uint16_t& length, uint64_t& timestamp, const uint32_t waitTime);
+        // The sequence number of the event this consumer reads next, one past the one it just consumed.
+        inline uint64_t Next() const
+        {
+            return (_next);
+        }
+        // Events this consumer lost, as it was more than a ring behind.
+        inline uint64_t Dropped() const
+        {
+            return (_dropped);
+        }
+        // Have a Consume of this consumer that waits, or the next one, return ERROR_ASYNC_ABORTED.
+        void Interrupt();
+
+        // Monotonic time, in microseconds, comparable between processes.
+        static uint64_t Now();
+
+    private:
+        static inline uint32_t Stride(const uint32_t size)
+        {
+            return (((size + CacheLine - 1) / CacheLine) * CacheLine);
+        }
+        static uint32_t Events(const uint32_t events);
+
+        inline Slot& SlotInfo(const uint64_t sequence) const
+        {
+            return (*reinterpret_cast<Slot*>(&(_data[(sequence & (_administration->_events - 1)) * _administration->_stride])));
+        }
+        inline uint8_t* SlotData(Slot& slot) const
+        {
+            return (&(reinterpret_cast<uint8_t*>(&slot)[sizeof(Slot)]));
+        }
+
+        void Signal();
+
+    private:
+        DataElementFile _buffer;
+        Administration* _administration;
+        uint8_t* _data;
+        uint64_t _next;
+        uint64_t _dropped;
+        std::atomic<bool> _interrupted;
+    };
+}
+}
+
+#endif // __SHARED_EVENT_RING_H
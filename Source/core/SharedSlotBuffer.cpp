@@ -0,0 +1,309 @@
+#include "SharedSlotBuffer.h"
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace WPEFramework {
+
+namespace Core {
+
+    static constexpr uint32_t SlotBufferMagic = 0x534C4F54; // "SLOT"
+
+    /* static */ uint32_t SharedSlotBuffer::AdministrationSize(const uint8_t slots)
+    {
+        // Keep the administration and the first slot on different cache lines.
+        return (Stride(sizeof(Administration) + (slots * sizeof(Slot))));
+    }
+
+    SharedSlotBuffer::SharedSlotBuffer(const string& name, const DataElementFile::Mapping& mapping)
+        : _buffer(name, DataElementFile::READABLE | DataElementFile::WRITABLE | DataElementFile::SHAREABLE | mapping.Options())
+        , _administration(nullptr)
+        , _data(nullptr)
+        , _produce(NoSlot)
+        , _consume(NoSlot)
+        , _sequence(0)
+        , _skipped(0)
+    {
+        if ((_buffer.IsValid() == true) && (_buffer.Size() >= sizeof(Administration))) {
+            Administration* administration = reinterpret_cast<Administration*>(_buffer.Buffer());
+
+            if ((administration->_magic == SlotBufferMagic) && (_buffer.Size() >= (AdministrationSize(administration->_slots) + (administration->_slots * administration->_stride)))) {
+                _administration = administration;
+                _data = &(_buffer.Buffer()[AdministrationSize(administration->_slots)]);
+            }
+        }
+
+        if (_administration == nullptr) {
+            TRACE_L1("Could not open a SharedSlotBuffer: %s", name.c_str());
+        }
+    }
+
+    SharedSlotBuffer::SharedSlotBuffer(const string& name, const uint8_t slots, const uint32_t slotSize, const mode type, const DataElementFile::Mapping& mapping)
+        : _buffer(name, DataElementFile::READABLE | DataElementFile::WRITABLE | DataElementFile::SHAREABLE | DataElementFile::CREATE | mapping.Options(),
+              AdministrationSize(slots) + (slots * Stride(slotSize)))
+        , _administration(nullptr)
+        , _data(nullptr)
+        , _produce(NoSlot)
+        , _consume(NoSlot)
+        , _sequence(0)
+        , _skipped(0)
+    {
+        // The consumer needs at least one slot, the producer another one.
+        ASSERT((slots >= 2) && (slots < NoSlot));
+
+        if (_buffer.IsValid() == true) {
+            _administration = reinterpret_cast<Administration*>(_buffer.Buffer());
+            _data = &(_buffer.Buffer()[AdministrationSize(slots)]);
+
+            memset(static_cast<void*>(_administration), 0, AdministrationSize(slots));
+
+            _administration->_slotSize = slotSize;
+            _administration->_stride = Stride(slotSize);
+            _administration->_slots = slots;
+            _administration->_mode = type;
+
+            for (uint8_t index = 0; index < slots; index++) {
+                SlotInfo(index)._state.store(FREE, std::memory_order_relaxed);
+            }
+
+            // Only now the consumers may take the buffer for valid.
+            std::atomic_thread_fence(std::memory_order_release);
+            _administration->_magic = SlotBufferMagic;
+        } else {
+            TRACE_L1("Could not create a SharedSlotBuffer: %s", name.c_str());
+        }
+    }
+
+    SharedSlotBuffer::~SharedSlotBuffer()
+    {
+        // Do not leave the other side waiting for a slot we hold.
+        if (_produce != NoSlot) {
+            SlotInfo(_produce)._state.store(FREE, std::memory_order_release);
+            Signal();
+        }
+        if (_consume != NoSlot) {
+            Consumed();
+        }
+    }
+
+    uint32_t SharedSlotBuffer::RequestProduce(const uint32_t waitTime)
+    {
+        uint32_t result = ERROR_UNAVAILABLE;
+
+        if (IsValid() == true) {
+            if (_produce != NoSlot) {
+                result = ERROR_ILLEGAL_STATE;
+            } else {
+                result = Wait(waitTime, true);
+            }
+        }
+
+        return (result);
+    }
+
+    uint32_t SharedSlotBuffer::Produced(const uint32_t length)
+    {
+        uint32_t result = ERROR_ILLEGAL_STATE;
+
+        if (_produce != NoSlot) {
+            Slot& slot = SlotInfo(_produce);
+
+            ASSERT(length <= _administration->_slotSize);
+
+            slot._length = std::min(length, _administration->_slotSize);
+            slot._sequence.store(_administration->_produced.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            slot._state.store(READY, std::memory_order_release);
+
+            _produce = NoSlot;
+
+            Signal();
+
+            result = ERROR_NONE;
+        }
+
+        return (result);
+    }
+
+    uint32_t SharedSlotBuffer::RequestConsume(const uint32_t waitTime)
+    {
+        uint32_t result = ERROR_UNAVAILABLE;
+
+        if (IsValid() == true) {
+            if (_consume != NoSlot) {
+                result = ERROR_ILLEGAL_STATE;
+            } else {
+                result = Wait(waitTime, false);
+            }
+        }
+
+        return (result);
+    }
+
+    uint32_t SharedSlotBuffer::Consumed()
+    {
+        uint32_t result = ERROR_ILLEGAL_STATE;
+
+        if (_consume != NoSlot) {
+            SlotInfo(_consume)._state.store(FREE, std::memory_order_release);
+
+            _consume = NoSlot;
+
+            Signal();
+
+            result = ERROR_NONE;
+        }
+
+        return (result);
+    }
+
+    uint8_t SharedSlotBuffer::AcquireProduce()
+    {
+        uint8_t result = NoSlot;
+        uint8_t oldest = NoSlot;
+        uint64_t oldestSequence = ~0ULL;
+
+        for (uint8_t index = 0; (index < _administration->_slots) && (result == NoSlot); index++) {
+            Slot& slot = SlotInfo(index);
+            uint32_t expected = FREE;
+
+            if (slot._state.compare_exchange_strong(expected, WRITING, std::memory_order_acquire) == true) {
+                result = index;
+            } else if ((expected == READY) && (slot._sequence.load(std::memory_order_relaxed) < oldestSequence)) {
+                oldest = index;
+                oldestSequence = slot._sequence.load(std::memory_order_relaxed);
+            }
+        }
+
+        if ((result == NoSlot) && (oldest != NoSlot) && (_administration->_mode == LATEST)) {
+            // Nothing free, recycle the oldest frame the consumer did not pick up. If the consumer
+            // claimed it in the mean time, we just wait for the next change.
+            uint32_t expected = READY;
+
+            if (SlotInfo(oldest)._state.compare_exchange_strong(expected, WRITING, std::memory_order_acquire) == true) {
+                result = oldest;
+            }
+        }
+
+        return (result);
+    }
+
+    uint8_t SharedSlotBuffer::AcquireConsume()
+    {
+        uint8_t result = NoSlot;
+
+        while (result == NoSlot) {
+            uint8_t candidate = NoSlot;
+            uint64_t candidateSequence = 0;
+
+            for (uint8_t index = 0; index < _administration->_slots; index++) {
+                Slot& slot = SlotInfo(index);
+
+                if (slot._state.load(std::memory_order_acquire) == READY) {
+                    uint64_t sequence = slot._sequence.load(std::memory_order_relaxed);
+
+                    if ((candidate == NoSlot) || ((_administration->_mode == LATEST) ? (sequence > candidateSequence) : (sequence < candidateSequence))) {
+                        candidate = index;
+                        candidateSequence = sequence;
+                    }
+                }
+            }
+
+            if (candidate == NoSlot) {
+                break;
+            }
+
+            uint32_t expected = READY;
+
+            // If the producer recycled the slot we were about to take, pick again.
+            if (SlotInfo(candidate)._state.compare_exchange_strong(expected, READING, std::memory_order_acquire) == true) {
+                result = candidate;
+            }
+        }
+
+        if ((result != NoSlot) && (_administration->_mode == LATEST)) {
+            uint64_t sequence = SlotInfo(result)._sequence.load(std::memory_order_relaxed);
+
+            // Everything older than the frame we got is stale, give it back to the producer.
+            for (uint8_t index = 0; index < _administration->_slots; index++) {
+                Slot& slot = SlotInfo(index);
+
+                if ((index != result) && (slot._state.load(std::memory_order_relaxed) == READY) && (slot._sequence.load(std::memory_order_relaxed) < sequence)) {
+                    uint32_t expected = READY;
+                    slot._state.compare_exchange_strong(expected, FREE, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        return (result);
+    }
+
+    uint32_t SharedSlotBuffer::Wait(const uint32_t waitTime, const bool producer)
+    {
+        uint32_t result = ERROR_TIMEDOUT;
+        uint64_t deadline = (waitTime == Core::infinite ? 0 : Time::Now().Ticks() + (static_cast<uint64_t>(waitTime) * Time::TicksPerMillisecond));
+
+        while (result == ERROR_TIMEDOUT) {
+            // Sample the change counter before looking, so a change after the look wakes us.
+            uint32_t changes = _administration->_changes.load(std::memory_order_acquire);
+            uint8_t slot = (producer == true ? AcquireProduce() : AcquireConsume());
+
+            if (slot != NoSlot) {
+                if (producer == true) {
+                    _produce = slot;
+                } else {
+                    uint64_t sequence = SlotInfo(slot)._sequence.load(std::memory_order_relaxed);
+
+                    if (sequence > (_sequence + 1)) {
+                        _skipped += (sequence - _sequence - 1);
+                    }
+                    _sequence = sequence;
+                    _consume = slot;
+                }
+                result = ERROR_NONE;
+            } else {
+                uint32_t timeLeft = Core::infinite;
+
+                if (waitTime != Core::infinite) {
+                    uint64_t now = Time::Now().Ticks();
+
+                    if ((waitTime == 0) || (now >= deadline)) {
+                        break;
+                    }
+                    timeLeft = static_cast<uint32_t>(((deadline - now) + Time::TicksPerMillisecond - 1) / Time::TicksPerMillisecond);
+                }
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+                struct timespec timeout;
+
+                timeout.tv_sec = timeLeft / 1000;
+                timeout.tv_nsec = (timeLeft % 1000) * 1000 * 1000;
+
+                _administration->_waiters.fetch_add(1, std::memory_order_seq_cst);
+                ::syscall(SYS_futex, reinterpret_cast<int*>(&(_administration->_changes)), FUTEX_WAIT, static_cast<int>(changes), (timeLeft != Core::infinite ? &timeout : nullptr), nullptr, 0);
+                _administration->_waiters.fetch_sub(1, std::memory_order_relaxed);
+#else
+                DEBUG_VARIABLE(changes);
+                ::SleepMs(std::min(timeLeft, static_cast<uint32_t>(1)));
+#endif
+            }
+        }
+
+        return (result);
+    }
+
+    void SharedSlotBuffer::Signal()
+    {
+        _administration->_changes.fetch_add(1, std::memory_order_seq_cst);
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+        // The system call is only needed if the other side is (about to go) asleep.
+        if (_administration->_waiters.load(std::memory_order_seq_cst) != 0) {
+            ::syscall(SYS_futex, reinterpret_cast<int*>(&(_administration->_changes)), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+#endif
+    }
+}
+}
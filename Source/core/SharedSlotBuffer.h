@@ -0,0 +1,178 @@
+#ifndef __SHARED_SLOT_BUFFER_H
+#define __SHARED_SLOT_BUFFER_H
+
+// ---- Include system wide include files ----
+#include <atomic>
+
+// ---- Include local include files ----
+#include "DataElementFile.h"
+#include "Module.h"
+
+// ---- Referenced classes and types ----
+
+// ---- Helper types and constants ----
+
+namespace WPEFramework {
+
+namespace Core {
+    // Rationale:
+    // The SharedBuffer hands one buffer back and forth between a producer and a consumer, so the
+    // producer can only start on the next frame once the consumer released the previous one. The
+    // SharedSlotBuffer spreads the exchange over N slots (double buffering for 2, triple buffering
+    // for 3, ...) in one shared memory file, so the producer fills a slot while the consumer is still
+    // working on another one. Data is produced and consumed in place, nothing is copied.
+    // Every published slot carries a sequence number, assigned in publishing order. In QUEUE mode the
+    // consumer receives all frames, in order, and the producer has to wait for a free slot. In LATEST
+    // mode (display-style consumers) the producer never waits for the consumer with 3 or more slots,
+    // it recycles the oldest frame that was not picked up yet, and the consumer always receives the
+    // most recent frame. Frames that were skipped can be derived from the gaps in the sequence numbers.
+    // The producer creates the buffer and decides on the mode, the number and the size of the slots.
+    // The consumer opens it by name. Both sides can wait (futex based on Linux) or just try.
+    class EXTERNAL SharedSlotBuffer {
+    public:
+        enum mode : uint8_t {
+            QUEUE = 0,
+            LATEST = 1
+        };
+
+    private:
+        SharedSlotBuffer() = delete;
+        SharedSlotBuffer(const SharedSlotBuffer&) = delete;
+        SharedSlotBuffer& operator=(const SharedSlotBuffer&) = delete;
+
+        enum state : uint32_t {
+            FREE = 0,
+            WRITING = 1,
+            READY = 2,
+            READING = 3
+        };
+
+        static constexpr uint8_t NoSlot = 0xFF;
+        static constexpr uint32_t CacheLine = 64;
+
+        struct Slot {
+            std::atomic<uint32_t> _state;
+            uint32_t _length;
+            std::atomic<uint64_t> _sequence;
+        };
+
+        struct Administration {
+            uint32_t _magic;
+            uint32_t _slotSize;
+            uint32_t _stride;
+            uint8_t _slots;
+            uint8_t _mode;
+            std::atomic<uint32_t> _changes;
+            std::atomic<uint32_t> _waiters;
+            std::atomic<uint64_t> _produced;
+        };
+
+    public:
+        // This is the consumer constructor, the producer needs to have created the buffer.
+        SharedSlotBuffer(const string& name, const DataElementFile::Mapping& mapping = DataElementFile::Mapping());
+
+        // This is the producer constructor, it creates (or recreates) the buffer.
+        SharedSlotBuffer(const string& name, const uint8_t slots, const uint32_t slotSize, const mode type, const DataElementFile::Mapping& mapping = DataElementFile::Mapping());
+
+        ~SharedSlotBuffer();
+
+    public:
+        inline bool IsValid() const
+        {
+            return (_administration != nullptr);
+        }
+        inline const string& Name() const
+        {
+            return (_buffer.Name());
+        }
+        inline uint8_t Slots() const
+        {
+            return (_administration->_slots);
+        }
+        inline uint32_t SlotSize() const
+        {
+            return (_administration->_slotSize);
+        }
+        inline mode Mode() const
+        {
+            return (static_cast<mode>(_administration->_mode));
+        }
+
+        // Producer side. On success the producer owns a slot until it calls Produced, Buffer() points to it.
+        uint32_t RequestProduce(const uint32_t waitTime);
+        inline uint32_t TryProduce()
+        {
+            return (RequestProduce(0));
+        }
+        inline uint8_t* Buffer()
+        {
+            ASSERT(_produce != NoSlot);
+
+            return (SlotData(_produce));
+        }
+        uint32_t Produced(const uint32_t length);
+
+        // Consumer side. On success the consumer owns a slot until it calls Consumed, Data(), Length()
+        // and Sequence() describe the frame in it.
+        uint32_t RequestConsume(const uint32_t waitTime);
+        inline uint32_t TryConsume()
+        {
+            return (RequestConsume(0));
+        }
+        inline const uint8_t* Data() const
+        {
+            ASSERT(_consume != NoSlot);
+
+            return (SlotData(_consume));
+        }
+        inline uint32_t Length() const
+        {
+            ASSERT(_consume != NoSlot);
+
+            return (SlotInfo(_consume)._length);
+        }
+        inline uint64_t Sequence() const
+        {
+            return (_sequence);
+        }
+        // Frames this consumer never received, as they were replaced by newer ones (LATEST mode only).
+        inline uint64_t Skipped() const
+        {
+            return (_skipped);
+        }
+        uint32_t Consumed();
+
+    private:
+        static inline uint32_t Stride(const uint32_t size)
+        {
+            return (((size + CacheLine - 1) / CacheLine) * CacheLine);
+        }
+        static uint32_t AdministrationSize(const uint8_t slots);
+
+        inline Slot& SlotInfo(const uint8_t index) const
+        {
+            return (reinterpret_cast<Slot*>(&(reinterpret_cast<uint8_t*>(_administration)[sizeof(Administration)]))[index]);
+        }
+        inline uint8_t* SlotData(const uint8_t index) const
+        {
+            return (&(_data[index * _administration->_stride]));
+        }
+
+        uint8_t AcquireProduce();
+        uint8_t AcquireConsume();
+        uint32_t Wait(const uint32_t waitTime, const bool producer);
+        void Signal();
+
+    private:
+        DataElementFile _buffer;
+        Administration* _administration;
+        uint8_t* _data;
+        uint8_t _produce;
+        uint8_t _consume;
+        uint64_t _sequence;
+        uint64_t _skipped;
+    };
+}
+}
+
+#endif // __SHARED_SLOT_BUFFER_H
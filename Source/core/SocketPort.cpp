@@ -465,6 +465,13 @@ namespace Core {
             TRACE_L1("Error could not set Send buffer size (%d).", sendBuffer);
         }
 
+        // A port that is opened again, gets its buffers again.
+        if (m_SendBuffer != nullptr) {
+            ::free(m_SendBuffer);
+            m_SendBuffer = nullptr;
+            m_ReceiveBuffer = nullptr;
+        }
+
         if ((receiveBuffer != 0) || (sendBuffer != 0)) {
             uint8_t* allocatedMemory = static_cast<uint8_t*>(::malloc(sendBuffer + receiveBuffer));
             if (sendBuffer != 0) {
@@ -203,6 +203,8 @@ namespace Core {
         m_uptime = info.uptime;
         m_totalram = info.totalram;
         m_freeram = info.freeram;
+
+        m_cpuStatDescriptor = open(_T("/proc/stat"), O_RDONLY | O_CLOEXEC);
 #endif
 #endif
 
@@ -216,6 +218,11 @@ namespace Core {
 
     SystemInfo::~SystemInfo()
     {
+#if defined(__LINUX__) && !defined(__APPLE__)
+        if (m_cpuStatDescriptor != -1) {
+            close(m_cpuStatDescriptor);
+        }
+#endif
     }
 
     void SystemInfo::UpdateCpuStats() const
@@ -253,18 +260,22 @@ namespace Core {
 
         // Update once a second to limit file system reads.
         if (difftime(time(nullptr), m_lastUpdateCpuStats) >= RefreshInterval) {
-            FILE* input = fopen(_T("/proc/stat"), _T("r"));
-
-            ASSERT(input && "ERROR: Unable to open /proc/stat");
+            ASSERT((m_cpuStatDescriptor != -1) && "ERROR: Unable to open /proc/stat");
 
             // First line of /proc/stat contains the overall CPU information
-            unsigned long long CpuFields[4];
+            char buffer[256];
+            unsigned long long CpuFields[4] = { 0, 0, 0, 0 };
+            int numFields = 0;
+
+            ssize_t length = pread(m_cpuStatDescriptor, buffer, sizeof(buffer) - 1, 0);
 
-            int numFields = fscanf(input, _T("cpu %llu %llu %llu %llu"),
-                &CpuFields[0], &CpuFields[1],
-                &CpuFields[2], &CpuFields[3]);
+            if (length > 0) {
+                buffer[length] = '\0';
 
-            fclose(input);
+                numFields = sscanf(buffer, _T("cpu %llu %llu %llu %llu"),
+                    &CpuFields[0], &CpuFields[1],
+                    &CpuFields[2], &CpuFields[3]);
+            }
 
             ASSERT((numFields >= 4) && "ERROR: Read invalid CPU information.");
 
@@ -236,6 +236,9 @@ namespace Core {
         mutable uint64_t m_prevCpuSystemTicks;
         mutable uint64_t m_prevCpuUserTicks;
         mutable uint64_t m_prevCpuIdleTicks;
+#elif defined(__LINUX__)
+        // Kept open, /proc/stat is read again from the start on every update.
+        int m_cpuStatDescriptor;
 #endif
     }; // class SystemInfo
 } // namespace Core
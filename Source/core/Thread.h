@@ -24,6 +24,7 @@
 #include <sstream>
 
 #include "IAction.h"
+#include "Measurement.h"
 #include "Module.h"
 #include "Proxy.h"
 #include "Queue.h"
@@ -599,6 +600,553 @@ namespace Core {
         std::vector<ThreadUnitType<CONTEXT>> _units;
     };
 
+    // The DynamicThreadPoolType offers the same interface as the ThreadPoolType, but the amount of threads
+    // is not fixed at compile time. It runs between a minimum and a maximum amount of threads. If work is
+    // pending and no thread is available, or if jobs have been waiting longer than the configured latency
+    // in the queue, a thread is added. Threads that have been idle for the configured idle time are reaped,
+    // as long as the minimum amount of threads is still available.
+    template <typename CONTEXT, const uint32_t QUEUESIZE = 0x7FFFFFFF>
+    class DynamicThreadPoolType {
+    public:
+        // Queue wait times are collected in buckets, bucket N holds all jobs that waited less than 2^N ms.
+        // The last bucket holds everything that did not fit in the previous ones.
+        static constexpr uint8_t Buckets = 12;
+
+        struct Statistics {
+            uint16_t Threads;
+            uint16_t Peak;
+            uint16_t Active;
+            uint32_t Pending;
+            uint32_t Created;
+            uint32_t Reaped;
+            uint8_t Utilization;
+            uint32_t QueueWait[Buckets];
+        };
+
+    private:
+        class Entry {
+        public:
+            Entry()
+                : _context()
+                , _queued(0)
+            {
+            }
+            Entry(const CONTEXT& context, const uint64_t queued)
+                : _context(context)
+                , _queued(queued)
+            {
+            }
+            Entry(const Entry& copy)
+                : _context(copy._context)
+                , _queued(copy._queued)
+            {
+            }
+            ~Entry()
+            {
+            }
+
+            Entry& operator=(const Entry& RHS)
+            {
+                _context = RHS._context;
+                _queued = RHS._queued;
+
+                return (*this);
+            }
+            inline bool operator==(const Entry& RHS) const
+            {
+                return (_context == RHS._context);
+            }
+            inline bool operator!=(const Entry& RHS) const
+            {
+                return (!operator==(RHS));
+            }
+
+        public:
+            inline CONTEXT& Context()
+            {
+                return (_context);
+            }
+            inline uint64_t Queued() const
+            {
+                return (_queued);
+            }
+
+        private:
+            CONTEXT _context;
+            uint64_t _queued;
+        };
+
+        class ThreadUnit : public Thread {
+        private:
+            ThreadUnit() = delete;
+            ThreadUnit(const ThreadUnit&) = delete;
+            ThreadUnit& operator=(const ThreadUnit&) = delete;
+
+        public:
+            ThreadUnit(DynamicThreadPoolType<CONTEXT, QUEUESIZE>& parent, const uint32_t stackSize, const TCHAR* threadName)
+                : Thread(stackSize, threadName)
+                , _parent(parent)
+                , _executing()
+                , _run(0)
+                , _active(false)
+                , _signal(false, false)
+            {
+                Run();
+            }
+            ~ThreadUnit()
+            {
+            }
+
+        public:
+            inline bool IsActive() const
+            {
+                return (_active);
+            }
+            inline uint32_t Runs() const
+            {
+                return (_run);
+            }
+            uint32_t Executing(const CONTEXT& thisElement, const uint32_t waitTime) const
+            {
+                uint32_t result = Core::ERROR_UNAVAILABLE;
+
+                if (thisElement == _executing) {
+
+                    TRACE_L1("Revoking object is currently running [%d].", _run);
+
+                    // You can not wait on yourself to actually remove yourself. This will deadlock !!!
+                    ASSERT(Thread::Id() != Thread::ThreadId());
+
+                    result = _signal.Lock(waitTime);
+                }
+
+                return (result);
+            }
+
+        private:
+            virtual uint32_t Worker()
+            {
+                Entry entry;
+
+                _signal.PulseEvent();
+
+                if (_parent._queue.Extract(entry, _parent._idleTime) == true) {
+
+                    uint64_t started = Time::Monotonic();
+
+                    _executing = entry.Context();
+                    _active = true;
+
+                    _parent.Started(started - entry.Queued());
+
+                    // Seems like we have work...
+                    _executing.Dispatch();
+
+                    // Clear it out, we processed it.
+                    _executing = CONTEXT();
+
+                    _active = false;
+                    _run++;
+
+                    _parent.Completed(Time::Monotonic() - started);
+
+                    // Yield the processor, just to make sure that the gap, between the comparison
+                    // of the Executing(.....) ended up in the lock, before we pulse it :-)
+                    ::SleepMs(0);
+                } else if (_parent.Retire(*this) == true) {
+                    // We have been idle for too long and we are not needed, step out.
+                    Block();
+
+                    return (Core::infinite);
+                } else if (_parent.IsBlocked() == true) {
+                    // Oops queue disabled, wait for the pool to start us again..
+                    return (Core::infinite);
+                }
+
+                // Do not wait keep on processing !!!
+                return (0);
+            }
+
+        private:
+            DynamicThreadPoolType<CONTEXT, QUEUESIZE>& _parent;
+            CONTEXT _executing;
+            uint32_t _run;
+            bool _active;
+            mutable Core::Event _signal;
+        };
+
+        typedef std::list<ThreadUnit*> Units;
+
+    private:
+        DynamicThreadPoolType() = delete;
+        DynamicThreadPoolType(const DynamicThreadPoolType&) = delete;
+        DynamicThreadPoolType& operator=(const DynamicThreadPoolType&) = delete;
+
+    public:
+        // idleTime and latency are in milliseconds.
+        DynamicThreadPoolType(const uint16_t minimum, const uint16_t maximum, const uint32_t stackSize, const uint32_t idleTime, const uint32_t latency, const TCHAR* poolName = nullptr)
+            : _adminLock()
+            , _queue(QUEUESIZE)
+            , _units()
+            , _retired()
+            , _minimum(minimum == 0 ? 1 : minimum)
+            , _maximum(maximum < _minimum ? _minimum : maximum)
+            , _stackSize(stackSize)
+            , _idleTime(idleTime == 0 ? Core::infinite : idleTime)
+            , _latency(static_cast<uint64_t>(latency) * Time::TicksPerMillisecond)
+            , _poolName(poolName == nullptr ? _T("") : poolName)
+            , _blocked(false)
+            , _referenced(0)
+            , _active(0)
+            , _peak(0)
+            , _created(0)
+            , _reaped(0)
+            , _lastWait(0)
+            , _busy(0)
+            , _window(Time::Monotonic())
+            , _waitTime()
+            , _runTime()
+        {
+            ::memset(_queueWait, 0, sizeof(_queueWait));
+
+            _adminLock.Lock();
+
+            while (_units.size() < _minimum) {
+                Create();
+            }
+
+            _adminLock.Unlock();
+        }
+        ~DynamicThreadPoolType()
+        {
+            // Stop all threads...
+            Block();
+
+            _queue.Flush();
+
+            // Wait till all threads have reached completion
+            Wait(Thread::BLOCKED | Thread::STOPPED, Core::infinite);
+
+            _retired.splice(_retired.end(), _units);
+
+            while (_retired.empty() == false) {
+                delete _retired.front();
+                _retired.pop_front();
+            }
+        }
+
+    public:
+        inline uint16_t Minimum() const
+        {
+            return (_minimum);
+        }
+        inline uint16_t Maximum() const
+        {
+            return (_maximum);
+        }
+        inline uint16_t Count() const
+        {
+            return (static_cast<uint16_t>(_units.size()));
+        }
+        inline uint32_t Pending() const
+        {
+            return (_queue.Length());
+        }
+        inline uint32_t Active() const
+        {
+            return (_active);
+        }
+        void Submit(const CONTEXT& data, const uint32_t waitTime)
+        {
+            Entry entry(data, Time::Monotonic());
+
+            if (QUEUESIZE == ~0) {
+                _queue.Post(entry);
+            } else {
+                _queue.Insert(entry, waitTime);
+            }
+
+            _adminLock.Lock();
+
+            uint32_t available = static_cast<uint32_t>(_units.size()) - _active;
+
+            // If there are more jobs waiting than there are threads to pick them up, or if the
+            // last job had to wait too long in the queue, it is time to scale up.
+            if ((_blocked == false) && (_units.size() < _maximum) && ((_queue.Length() > available) || (_lastWait > _latency))) {
+                Create();
+                _lastWait = 0;
+            }
+
+            _adminLock.Unlock();
+
+            Reap();
+        }
+        uint32_t Revoke(const CONTEXT& data, const uint32_t waitTime = Core::infinite)
+        {
+            uint32_t result = Core::ERROR_NONE;
+
+            if (_queue.Remove(Entry(data, 0)) == false) {
+                std::vector<ThreadUnit*> units;
+
+                Acquire(units);
+
+                typename std::vector<ThreadUnit*>::iterator index(units.begin());
+
+                // Check if it is currently being executed and wait till it is done.
+                while ((index != units.end()) && ((result = (*index)->Executing(data, waitTime)) == Core::ERROR_UNAVAILABLE)) {
+                    index++;
+                }
+
+                Relinquish();
+
+                if (result == Core::ERROR_UNAVAILABLE) {
+                    result = Core::ERROR_NONE;
+                }
+            } else {
+                TRACE_L1("Found the revoking object in the queue: %d", waitTime);
+            }
+
+            return (result);
+        }
+        bool Wait(const unsigned int enumState, unsigned int nTime = Core::infinite) const
+        {
+            bool result = true;
+            std::vector<ThreadUnit*> units;
+
+            Acquire(units);
+
+            typename std::vector<ThreadUnit*>::const_iterator index(units.begin());
+
+            while ((index != units.end()) && ((result = (*index)->Wait(enumState, nTime)) == true)) {
+                index++;
+            }
+
+            Relinquish();
+
+            return (result);
+        }
+        void Block()
+        {
+            _adminLock.Lock();
+
+            _blocked = true;
+
+            for (typename Units::iterator index(_units.begin()); index != _units.end(); index++) {
+                (*index)->Block();
+            }
+
+            _adminLock.Unlock();
+
+            _queue.Disable();
+        }
+        void Run()
+        {
+            _queue.Enable();
+
+            _adminLock.Lock();
+
+            _blocked = false;
+
+            for (typename Units::iterator index(_units.begin()); index != _units.end(); index++) {
+                (*index)->Run();
+            }
+
+            _adminLock.Unlock();
+        }
+        ::ThreadId ThreadId(const uint8_t index) const
+        {
+            ::ThreadId result = 0;
+
+            _adminLock.Lock();
+
+            if (index < _units.size()) {
+                typename Units::const_iterator entry(_units.begin());
+                std::advance(entry, index);
+                result = (*entry)->Id();
+            }
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        // Reports the runs per thread. The utilization is calculated over the time elapsed since the
+        // previous call, collecting it starts a new measurement window.
+        void Collect(Statistics& statistics, std::list<uint32_t>& runs) const
+        {
+            _adminLock.Lock();
+
+            uint64_t now = Time::Monotonic();
+            uint64_t capacity = (now - _window) * _units.size();
+
+            statistics.Threads = static_cast<uint16_t>(_units.size());
+            statistics.Peak = _peak;
+            statistics.Active = static_cast<uint16_t>(_active);
+            statistics.Pending = _queue.Length();
+            statistics.Created = _created;
+            statistics.Reaped = _reaped;
+            statistics.Utilization = (capacity == 0 ? 0 : static_cast<uint8_t>(std::min(static_cast<uint64_t>(100), (_busy * 100) / capacity)));
+            ::memcpy(statistics.QueueWait, _queueWait, sizeof(_queueWait));
+
+            for (typename Units::const_iterator index(_units.begin()); index != _units.end(); index++) {
+                runs.push_back((*index)->Runs());
+            }
+
+            _busy = 0;
+            _window = now;
+
+            _adminLock.Unlock();
+        }
+        // Adds the queue wait and execution times of all jobs so far, in microseconds.
+        void Latencies(Histogram::Snapshot& wait, Histogram::Snapshot& run) const
+        {
+            _waitTime.Merge(wait);
+            _runTime.Merge(run);
+        }
+
+    private:
+        // While threads are waited for, outside of the lock, they should not be reaped.
+        void Acquire(std::vector<ThreadUnit*>& units) const
+        {
+            _adminLock.Lock();
+
+            units.assign(_units.begin(), _units.end());
+            _referenced++;
+
+            _adminLock.Unlock();
+        }
+        void Relinquish() const
+        {
+            _adminLock.Lock();
+
+            ASSERT(_referenced > 0);
+            _referenced--;
+
+            _adminLock.Unlock();
+        }
+        // Must be called with the _adminLock taken.
+        void Create()
+        {
+            _units.push_back(new ThreadUnit(*this, _stackSize, (_poolName.empty() ? nullptr : _poolName.c_str())));
+            _created++;
+
+            if (_units.size() > _peak) {
+                _peak = static_cast<uint16_t>(_units.size());
+            }
+        }
+        void Started(const uint64_t waited)
+        {
+            uint8_t bucket = 0;
+            uint64_t limit = Time::TicksPerMillisecond;
+
+            while ((bucket < (Buckets - 1)) && (waited >= limit)) {
+                limit <<= 1;
+                bucket++;
+            }
+
+            _waitTime.Set(waited);
+
+            _adminLock.Lock();
+
+            _active++;
+            _lastWait = waited;
+            _queueWait[bucket]++;
+
+            _adminLock.Unlock();
+        }
+        void Completed(const uint64_t duration)
+        {
+            _runTime.Set(duration);
+
+            _adminLock.Lock();
+
+            _active--;
+            _busy += duration;
+
+            _adminLock.Unlock();
+        }
+        bool IsBlocked() const
+        {
+            _adminLock.Lock();
+
+            bool result = _blocked;
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        bool Retire(ThreadUnit& unit)
+        {
+            bool result = false;
+
+            _adminLock.Lock();
+
+            if ((_blocked == false) && (_units.size() > _minimum)) {
+                typename Units::iterator index(std::find(_units.begin(), _units.end(), &unit));
+
+                ASSERT(index != _units.end());
+
+                _retired.splice(_retired.end(), _units, index);
+                result = true;
+            }
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        // Clean up the threads that stepped out. A thread can not destruct itself, so this is done
+        // on the next submit.
+        void Reap()
+        {
+            Units reapable;
+
+            _adminLock.Lock();
+
+            typename Units::iterator index(_retired.begin());
+
+            while ((_referenced == 0) && (index != _retired.end())) {
+                if (((*index)->State() & (Thread::BLOCKED | Thread::STOPPED)) != 0) {
+                    typename Units::iterator current(index++);
+                    reapable.splice(reapable.end(), _retired, current);
+                    _reaped++;
+                } else {
+                    index++;
+                }
+            }
+
+            _adminLock.Unlock();
+
+            while (reapable.empty() == false) {
+                delete reapable.front();
+                reapable.pop_front();
+            }
+        }
+
+    private:
+        mutable CriticalSection _adminLock;
+        QueueType<Entry> _queue;
+        Units _units;
+        Units _retired;
+        const uint16_t _minimum;
+        const uint16_t _maximum;
+        const uint32_t _stackSize;
+        const uint32_t _idleTime;
+        const uint64_t _latency;
+        const string _poolName;
+        bool _blocked;
+        mutable uint32_t _referenced;
+        uint32_t _active;
+        uint16_t _peak;
+        uint32_t _created;
+        uint32_t _reaped;
+        uint64_t _lastWait;
+        // The measurement window of the utilization, Collect starts a new one.
+        mutable uint64_t _busy;
+        mutable uint64_t _window;
+        uint32_t _queueWait[Buckets];
+        Histogram _waitTime;
+        Histogram _runTime;
+    };
+
     // template <typename CONTEXT, const uint16_t THREADCOUNT, const uint32_t QUEUESIZE>
     // CONTEXT typename ThreadPoolType<CONTEXT,THREADCOUNT,QUEUESIZE>::s_EmptyContext;
 }
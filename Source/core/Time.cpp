@@ -712,6 +712,17 @@ namespace Core {
         return (systemTime);
     }
 
+    /* static */ uint64_t Time::Monotonic()
+    {
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER counter;
+
+        ::QueryPerformanceFrequency(&frequency);
+        ::QueryPerformanceCounter(&counter);
+
+        return (static_cast<uint64_t>((counter.QuadPart / frequency.QuadPart) * MicroSecondsPerSecond) + static_cast<uint64_t>(((counter.QuadPart % frequency.QuadPart) * MicroSecondsPerSecond) / frequency.QuadPart));
+    }
+
 #endif
 
 #ifdef __POSIX__
@@ -908,6 +919,15 @@ namespace Core {
         return (Time(currentTime));
     }
 
+    /* static */ uint64_t Time::Monotonic()
+    {
+        struct timespec now;
+
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return ((static_cast<uint64_t>(now.tv_sec) * MicroSecondsPerSecond) + (now.tv_nsec / NanoSecondsPerMicroSecond));
+    }
+
 #endif
 
     string Time::ToRFC1123() const
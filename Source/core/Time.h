@@ -202,6 +202,9 @@ namespace Core {
         string ToISO8601(const bool localTime) const;
 
         static Time Now();
+        // Microseconds since an unspecified moment, not affected by setting the wall clock. Meant for
+        // durations and deadlines, Ticks() of Now() is for points in time.
+        static uint64_t Monotonic();
         inline static bool FromString(const string& buffer, const bool localTime, Time& element)
         {
             return (element.FromString(buffer, localTime));
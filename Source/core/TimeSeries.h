@@ -0,0 +1,532 @@
+#ifndef __TIMESERIES_H
+#define __TIMESERIES_H
+
+// ---- Include system wide include files ----
+#include <functional>
+#include <list>
+#include <map>
+#include <vector>
+
+// ---- Include local include files ----
+#include "FileSystem.h"
+#include "Module.h"
+#include "Number.h"
+#include "Proxy.h"
+#include "Sync.h"
+#include "Time.h"
+#include "ValueRecorder.h"
+
+// ---- Class Definition ----
+namespace WPEFramework {
+namespace Core {
+    // An on-device store for multiple series of samples. Every series is kept at three resolutions:
+    // the samples as recorded, and their average per minute and per hour. Each resolution is a
+    // RecorderType, so it is stored delta compressed in files of BLOCKSIZE KB.
+    // Every file that is completed is added to an index, with its time range, its ids and the minimum
+    // and maximum value in it. A range is found with a binary search over the index and a summary does
+    // not need to read the files that are completely within the range. Once the files of a resolution
+    // take more than the configured size, the oldest are removed.
+    //
+    // Layout on disk:
+    // <directory>/<series>/<resolution>.<n>    The files written by the RecorderType.
+    // <directory>/<series>/<resolution>.index  The index of these files.
+    template <typename STOREVALUE, const unsigned int BLOCKSIZE>
+    class TimeSeriesType {
+    public:
+        typedef RecorderType<STOREVALUE, BLOCKSIZE> Recorder;
+
+        enum resolution : uint8_t {
+            SAMPLE = 0,
+            MINUTE = 1,
+            HOUR = 2
+        };
+
+        struct Point {
+            uint64_t Time;
+            STOREVALUE Value;
+        };
+
+        typedef std::vector<Point> Points;
+
+        struct Summary {
+            uint32_t Count;
+            STOREVALUE Minimum;
+            STOREVALUE Maximum;
+        };
+
+    private:
+        TimeSeriesType() = delete;
+        TimeSeriesType(const TimeSeriesType<STOREVALUE, BLOCKSIZE>&) = delete;
+        TimeSeriesType<STOREVALUE, BLOCKSIZE>& operator=(const TimeSeriesType<STOREVALUE, BLOCKSIZE>&) = delete;
+
+        static constexpr uint8_t Resolutions = 3;
+
+        typedef typename std::conditional<std::is_signed<STOREVALUE>::value, int64_t, uint64_t>::type Sum;
+        typedef std::function<void(const uint64_t time, const STOREVALUE value)> Handler;
+
+        // Written as is to the index file.
+        struct Block {
+            uint64_t StartTime;
+            uint64_t EndTime;
+            uint32_t FileId;
+            uint32_t StartId;
+            uint32_t EndId;
+            uint32_t Size;
+            STOREVALUE Minimum;
+            STOREVALUE Maximum;
+        };
+
+        class Level {
+        private:
+            Level() = delete;
+            Level(const Level&) = delete;
+            Level& operator=(const Level&) = delete;
+
+        public:
+            Level(const string& storageName, const uint64_t period, const uint64_t limit)
+                : _storageName(storageName)
+                , _period(period)
+                , _limit(limit)
+                , _writer()
+                , _blocks()
+                , _size(0)
+                , _recording(false)
+                , _last(0)
+                , _bucket(0)
+                , _sum(0)
+                , _count(0)
+            {
+                ::memset(&_current, 0, sizeof(_current));
+
+                LoadIndex();
+
+                _writer = Recorder::Writer::Create(_storageName);
+            }
+            ~Level()
+            {
+                // A bucket that is not complete yet, is lost.
+                Flush();
+            }
+
+        public:
+            // Bucket the values, if this is not the level that keeps all samples.
+            void Add(const uint64_t time, const STOREVALUE value)
+            {
+                if (_period == 0) {
+                    Store(time, value);
+                } else {
+                    const uint64_t bucket = time - (time % _period);
+
+                    if ((_count != 0) && (bucket != _bucket)) {
+                        Store(_bucket, static_cast<STOREVALUE>(_sum / static_cast<Sum>(_count)));
+                        _count = 0;
+                    }
+                    if (_count == 0) {
+                        _bucket = bucket;
+                        _sum = 0;
+                    }
+
+                    _sum += static_cast<Sum>(value);
+                    _count++;
+                }
+            }
+            inline uint64_t Last() const
+            {
+                return (_last);
+            }
+            void Flush()
+            {
+                if (_recording == true) {
+                    const uint32_t fileId = _writer->FileId();
+
+                    _writer->Save();
+
+                    if (_writer->FileId() != fileId) {
+                        Seal(fileId);
+                    }
+                }
+            }
+            void Range(const uint64_t from, const uint64_t to, Points& points) const
+            {
+                Read(Find(from), static_cast<uint32_t>(~0), from, to, [&points](const uint64_t time, const STOREVALUE value) {
+                    Point point;
+                    point.Time = time;
+                    point.Value = value;
+                    points.push_back(point);
+                });
+            }
+            void Summarize(const uint64_t from, const uint64_t to, Summary& summary) const
+            {
+                Handler handler([&summary](const uint64_t, const STOREVALUE value) {
+                    Merge(summary, 1, value, value);
+                });
+
+                typename std::vector<Block>::const_iterator index(_blocks.begin() + Find(from));
+
+                while ((index != _blocks.end()) && (index->StartTime <= to)) {
+                    if ((index->StartTime >= from) && (index->EndTime <= to)) {
+                        // Completely in the range, the index has all we need.
+                        Merge(summary, (index->EndId - index->StartId) + 1, index->Minimum, index->Maximum);
+                    } else {
+                        Read(static_cast<uint32_t>(index - _blocks.begin()), index->EndId, from, to, handler);
+                    }
+                    index++;
+                }
+
+                if ((index == _blocks.end()) && (_recording == true)) {
+                    Read(static_cast<uint32_t>(_blocks.size()), static_cast<uint32_t>(~0), from, to, handler);
+                }
+            }
+
+        private:
+            static void Merge(Summary& summary, const uint32_t count, const STOREVALUE minimum, const STOREVALUE maximum)
+            {
+                if (summary.Count == 0) {
+                    summary.Minimum = minimum;
+                    summary.Maximum = maximum;
+                } else {
+                    if (minimum < summary.Minimum) {
+                        summary.Minimum = minimum;
+                    }
+                    if (maximum > summary.Maximum) {
+                        summary.Maximum = maximum;
+                    }
+                }
+                summary.Count += count;
+            }
+            // The first block that ends at or after the given time, _blocks.size() if that is the one being recorded.
+            uint32_t Find(const uint64_t time) const
+            {
+                return (static_cast<uint32_t>(std::lower_bound(_blocks.begin(), _blocks.end(), time,
+                    [](const Block& element, const uint64_t value) { return (element.EndTime < value); }) - _blocks.begin()));
+            }
+            void Read(const uint32_t block, const uint32_t endId, const uint64_t from, const uint64_t to, const Handler& handler) const
+            {
+                uint32_t fileId;
+                uint32_t startId;
+
+                if (block < _blocks.size()) {
+                    fileId = _blocks[block].FileId;
+                    startId = _blocks[block].StartId;
+                } else if ((_recording == true) && (_current.EndTime >= from)) {
+                    fileId = _writer->FileId();
+                    startId = _current.StartId;
+                } else {
+                    return;
+                }
+
+                // The reader holds a complete block, do not put it on the stack.
+                typename Recorder::Reader* reader = new typename Recorder::Reader(_writer, startId, fileId);
+
+                while ((reader->IsValid() == true) && (reader->Id() <= endId) && (reader->Time() <= to)) {
+                    if (reader->Time() >= from) {
+                        handler(reader->Time(), reader->Value());
+                    }
+                    reader->Next();
+                }
+
+                delete reader;
+            }
+            void Store(const uint64_t time, const STOREVALUE value)
+            {
+                const uint32_t fileId = _writer->FileId();
+
+                _writer->Record(time, value);
+
+                if (_recording == false) {
+                    _current.StartTime = _writer->Time();
+                    _current.StartId = _writer->Id();
+                    _current.Minimum = value;
+                    _current.Maximum = value;
+                    _recording = true;
+                } else if (value < _current.Minimum) {
+                    _current.Minimum = value;
+                } else if (value > _current.Maximum) {
+                    _current.Maximum = value;
+                }
+
+                _current.EndTime = _writer->Time();
+                _current.EndId = _writer->Id();
+                _last = time;
+
+                // The writer saves a full block by itself.
+                if (_writer->FileId() != fileId) {
+                    Seal(fileId);
+                }
+            }
+            void Seal(const uint32_t fileId)
+            {
+                Core::File file(_storageName + '.' + NumberType<uint32_t>(fileId).Text());
+
+                _current.FileId = fileId;
+                _current.Size = static_cast<uint32_t>(file.Size());
+                _recording = false;
+
+                _blocks.push_back(_current);
+                _size += _current.Size;
+
+                ::memset(&_current, 0, sizeof(_current));
+
+                // Rotate, but always keep the latest block.
+                bool rotated = false;
+
+                while ((_size > _limit) && (_blocks.size() > 1)) {
+                    Core::File oldest(_storageName + '.' + NumberType<uint32_t>(_blocks.front().FileId).Text());
+
+                    oldest.Destroy();
+                    _size -= _blocks.front().Size;
+                    _blocks.erase(_blocks.begin());
+                    rotated = true;
+                }
+
+                SaveIndex(rotated == false);
+            }
+            void LoadIndex()
+            {
+                Core::File index(_storageName + _T(".index"));
+                bool missing = false;
+
+                if (index.Open(true) == true) {
+                    Block block;
+
+                    while (index.Read(reinterpret_cast<uint8_t*>(&block), sizeof(Block)) == sizeof(Block)) {
+                        if (Core::File(_storageName + '.' + NumberType<uint32_t>(block.FileId).Text()).Exists() == true) {
+                            _blocks.push_back(block);
+                            _size += block.Size;
+                            _last = block.EndTime;
+                        } else {
+                            missing = true;
+                        }
+                    }
+
+                    index.Close();
+                }
+
+                if (missing == true) {
+                    SaveIndex(false);
+                }
+            }
+            void SaveIndex(const bool append)
+            {
+                Core::File index(_storageName + _T(".index"));
+
+                if (append == true) {
+                    if (index.Append() == true) {
+                        index.Write(reinterpret_cast<const uint8_t*>(&(_blocks.back())), sizeof(Block));
+                        index.Close();
+                    }
+                } else {
+                    index.Destroy();
+
+                    if (index.Create() == true) {
+                        for (const Block& block : _blocks) {
+                            index.Write(reinterpret_cast<const uint8_t*>(&block), sizeof(Block));
+                        }
+                        index.Close();
+                    }
+                }
+            }
+
+        private:
+            const string _storageName;
+            const uint64_t _period;
+            const uint64_t _limit;
+            ProxyType<typename Recorder::Writer> _writer;
+            std::vector<Block> _blocks;
+            uint64_t _size;
+
+            // The block the writer is working on.
+            Block _current;
+            bool _recording;
+            uint64_t _last;
+
+            // The bucket being averaged.
+            uint64_t _bucket;
+            Sum _sum;
+            uint32_t _count;
+        };
+
+        class Track {
+        private:
+            Track() = delete;
+            Track(const Track&) = delete;
+            Track& operator=(const Track&) = delete;
+
+        public:
+            Track(const string& path, const uint64_t limit)
+                : _sample(path + _T("sample"), 0, limit)
+                , _minute(path + _T("minute"), Core::Time::TicksPerMillisecond * 1000 * 60, limit)
+                , _hour(path + _T("hour"), Core::Time::TicksPerMillisecond * 1000 * 60 * 60, limit)
+            {
+            }
+            ~Track()
+            {
+            }
+
+        public:
+            inline Level& operator[](const resolution which)
+            {
+                return (which == SAMPLE ? _sample : (which == MINUTE ? _minute : _hour));
+            }
+            void Add(const uint64_t time, const STOREVALUE value)
+            {
+                _sample.Add(time, value);
+                _minute.Add(time, value);
+                _hour.Add(time, value);
+            }
+            void Flush()
+            {
+                _sample.Flush();
+                _minute.Flush();
+                _hour.Flush();
+            }
+
+        private:
+            Level _sample;
+            Level _minute;
+            Level _hour;
+        };
+
+        typedef std::map<string, Track*> Tracks;
+
+    public:
+        // The limit is the size, in bytes, each resolution of each series is allowed to take.
+        TimeSeriesType(const string& directory, const uint64_t limit)
+            : _adminLock()
+            , _directory(Core::Directory::Normalize(directory))
+            , _limit(limit)
+            , _tracks()
+        {
+            Core::Directory(_directory.c_str()).CreatePath();
+        }
+        ~TimeSeriesType()
+        {
+            for (std::pair<const string, Track*>& entry : _tracks) {
+                delete entry.second;
+            }
+            _tracks.clear();
+        }
+
+    public:
+        inline const string& Location() const
+        {
+            return (_directory);
+        }
+        uint32_t Record(const string& series, const STOREVALUE value)
+        {
+            return (Record(series, Core::Time::Now().Ticks(), value));
+        }
+        // Time in ticks, samples of a series should be recorded in order.
+        uint32_t Record(const string& series, const uint64_t time, const STOREVALUE value)
+        {
+            uint32_t result = ERROR_BAD_REQUEST;
+
+            _adminLock.Lock();
+
+            Track* track = Find(series, true);
+
+            if ((track != nullptr) && (time >= (*track)[SAMPLE].Last())) {
+                track->Add(time, value);
+                result = ERROR_NONE;
+            }
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        // All samples, at the given resolution, with a time in [from, to].
+        uint32_t Range(const string& series, const resolution which, const uint64_t from, const uint64_t to, Points& points)
+        {
+            uint32_t result = ERROR_UNKNOWN_KEY;
+
+            _adminLock.Lock();
+
+            Track* track = Find(series, false);
+
+            if (track != nullptr) {
+                (*track)[which].Range(from, to, points);
+                result = ERROR_NONE;
+            }
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        uint32_t Summarize(const string& series, const resolution which, const uint64_t from, const uint64_t to, Summary& summary)
+        {
+            uint32_t result = ERROR_UNKNOWN_KEY;
+
+            summary.Count = 0;
+            summary.Minimum = 0;
+            summary.Maximum = 0;
+
+            _adminLock.Lock();
+
+            Track* track = Find(series, false);
+
+            if (track != nullptr) {
+                (*track)[which].Summarize(from, to, summary);
+                result = ERROR_NONE;
+            }
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        // All series, also the ones only on disk.
+        void Series(std::list<string>& names) const
+        {
+            Core::Directory index(_directory.c_str(), _T("*"));
+
+            while (index.Next() == true) {
+                const string name(index.Name());
+
+                if ((index.IsDirectory() == true) && (name != _T(".")) && (name != _T(".."))) {
+                    names.push_back(name);
+                }
+            }
+        }
+        // Write what is recorded so far, the averages that are still being calculated are not.
+        void Flush()
+        {
+            _adminLock.Lock();
+
+            for (std::pair<const string, Track*>& entry : _tracks) {
+                entry.second->Flush();
+            }
+
+            _adminLock.Unlock();
+        }
+
+    private:
+        Track* Find(const string& series, const bool create)
+        {
+            Track* result = nullptr;
+
+            typename Tracks::iterator index(_tracks.find(series));
+
+            if (index != _tracks.end()) {
+                result = index->second;
+            } else if ((series.empty() == false) && (series[0] != '.') && (series.find_first_of(_T("/\\")) == string::npos)) {
+                const string path(_directory + series + '/');
+                Core::Directory location(path.c_str());
+
+                if ((create == true) ? (location.CreatePath() == true) : (Core::File(_directory + series).Exists() == true)) {
+                    result = new Track(path, _limit);
+                    _tracks.emplace(series, result);
+                }
+            }
+
+            return (result);
+        }
+
+    private:
+        Core::CriticalSection _adminLock;
+        const string _directory;
+        const uint64_t _limit;
+        Tracks _tracks;
+    };
+}
+} // namespace Core
+
+#endif // __TIMESERIES_H
@@ -76,6 +76,8 @@ namespace Core {
 
         public:
             static uint32_t constexpr CaptureSize = ((BLOCKSIZE * 1024) - (2 * sizeof(Absolute)));
+            // The start and end point, as they are stored in front of each file.
+            static uint32_t constexpr HeaderSize = (2 * (sizeof(uint32_t) + sizeof(STOREVALUE) + sizeof(uint64_t)));
 
             inline const Absolute& Start() const
             {
@@ -117,9 +119,12 @@ namespace Core {
                     ASSERT((_currentId != 0) && (_currentId != static_cast<uint32_t>(~0)));
 
                     // This is the first recording !!!
+                    // After a Save, the start is already moved past the last recording.
                     _start._time = time;
                     _start._value = value;
-                    _start._id = _currentId;
+                    _currentId = _start._id;
+
+                    _currentTime = time;
                 } else {
                     _currentId++;
 
@@ -136,6 +141,10 @@ namespace Core {
                         _currentDelta = delta;
                     }
 
+                    // Continue from the time as a reader will reconstruct it, so the rounding
+                    // of the deltas to milliseconds does not add up over the block.
+                    _currentTime += (static_cast<uint64_t>(delta) * 1000);
+
                     // Now store the actual value...
                     bool negative = (_currentValue > value);
 
@@ -143,7 +152,6 @@ namespace Core {
                 }
 
                 _currentValue = value;
-                _currentTime = time;
 
                 return (_index);
             }
@@ -262,7 +270,7 @@ namespace Core {
             {
                 uint32_t fileSize = static_cast<uint32_t>(file.Size());
 
-                if (file.Size() <= (2 * sizeof(Absolute))) {
+                if (file.Size() <= HeaderSize) {
                     ClearData();
                 } else {
                     LoadScalar<uint32_t>(file, _start._id);
@@ -338,6 +346,7 @@ namespace Core {
                 _start._id = (_currentId + 1);
                 _start._value = 0;
                 _index = 0;
+                _currentDelta = 0;
             }
 
             void ClearData()
@@ -468,6 +477,37 @@ namespace Core {
         RecorderType(const RecorderType<STOREVALUE, BLOCKSIZE>&);
         RecorderType<STOREVALUE, BLOCKSIZE> operator=(const RecorderType<STOREVALUE, BLOCKSIZE>&);
 
+    public:
+        // Find the range of file numbers in use for this storage. Files in front might
+        // have been removed, so do not assume the numbering starts at 0.
+        static bool Blocks(const string& storageName, uint32_t& first, uint32_t& last)
+        {
+            const string path(File::PathName(storageName));
+            const string prefix(File::FileNameExtended(storageName) + '.');
+            Directory index((path.empty() == true ? _T(".") : path.c_str()), (prefix + '*').c_str());
+            bool result = false;
+
+            while (index.Next() == true) {
+                const string name(index.Name());
+
+                if ((name.length() > prefix.length()) && (name.compare(0, prefix.length(), prefix) == 0) && (name.find_first_not_of(_T("0123456789"), prefix.length()) == string::npos)) {
+                    uint32_t number = NumberType<uint32_t>(TextFragment(name, static_cast<uint32_t>(prefix.length()), static_cast<uint32_t>(name.length() - prefix.length()))).Value();
+
+                    if (result == false) {
+                        first = number;
+                        last = number;
+                        result = true;
+                    } else if (number < first) {
+                        first = number;
+                    } else if (number > last) {
+                        last = number;
+                    }
+                }
+            }
+
+            return (result);
+        }
+
     public:
         class Writer : public BaseRecorder {
         private:
@@ -482,27 +522,19 @@ namespace Core {
                 , _fileId(static_cast<uint32_t>(~0))
                 , _storageName(fileName)
             {
-                uint32_t startPoint = 0;
-
-                //Find out the start ID fo the record ID and the file ID.
-                NumberType<uint32_t> number(0);
-
-                Core::File file(_storageName + "." + number.Text());
-
-                while (file.Exists() == true) {
-                    _fileId = number.Value();
-                    number += 1;
-
-                    file = _storageName + "." + number.Text();
-                }
+                uint32_t startPoint = 1;
+                uint32_t first;
+                uint32_t last;
 
-                if (_fileId == static_cast<uint32_t>(~0)) {
+                // Find out the start ID fo the record ID and the file ID.
+                if (RecorderType<STOREVALUE, BLOCKSIZE>::Blocks(_storageName, first, last) == false) {
                     _fileId = 0;
-                    startPoint = 1;
                 } else {
                     typename BaseRecorder::Absolute end;
-                    number = _fileId;
-                    file = _storageName + "." + number.Text();
+                    NumberType<uint32_t> number(last);
+                    Core::File file(_storageName + "." + number.Text());
+
+                    end._id = 0;
 
                     if (file.Open(true) == true) {
                         // Find the last possible ID
@@ -510,7 +542,7 @@ namespace Core {
                         startPoint = (end._id + 1);
                     }
 
-                    _fileId++;
+                    _fileId = last + 1;
                 }
 
                 BaseRecorder::Start(startPoint);
@@ -535,11 +567,19 @@ namespace Core {
             {
                 return (_storageName);
             }
+            // The number of the file the next Save() will write.
+            inline uint32_t FileId() const
+            {
+                return (_fileId);
+            }
             void Record(const STOREVALUE value)
             {
                 // First do the time tracking so it is as close as possible to the "log time"
-                uint64_t time = Core::Time::Now().Ticks();
-
+                Record(Core::Time::Now().Ticks(), value);
+            }
+            // Time in ticks, it should not be before the time of the previous recording.
+            void Record(const uint64_t time, const STOREVALUE value)
+            {
                 _lock.Lock();
 
                 uint32_t size = BaseRecorder::Store(time, value);
@@ -563,17 +603,19 @@ namespace Core {
             {
                 _lock.Lock();
 
-                // Save the whole shebang and move on..
-                NumberType<uint32_t> number(_fileId);
+                // Save the whole shebang and move on, if there is anything to save.
+                if (BaseRecorder::Start()._time != 0) {
+                    NumberType<uint32_t> number(_fileId);
 
-                Core::File file(_storageName + "." + number.Text());
+                    Core::File file(_storageName + "." + number.Text());
 
-                if (file.Create()) {
+                    if (file.Create()) {
 
-                    BaseRecorder::Save(file);
-                    file.Close();
+                        BaseRecorder::Save(file);
+                        file.Close();
 
-                    _fileId++;
+                        _fileId++;
+                    }
                 }
 
                 _lock.Unlock();
@@ -592,21 +634,21 @@ namespace Core {
             Reader& operator=(const Reader& copy);
 
         public:
-            Reader(const ProxyType<Writer>& recorder, const uint32_t id = static_cast<uint32_t>(~0))
+            Reader(const ProxyType<Writer>& recorder, const uint32_t id = static_cast<uint32_t>(~0), const uint32_t fileId = 0)
                 : BaseRecorder()
                 , _storageName(recorder->Source())
                 , _currentSet(recorder)
             {
                 BaseRecorder::SetBuffer(_buffer);
-                Reset(id);
+                Reset(id, fileId);
             }
-            Reader(const string& fileName, const uint32_t id = 0)
+            Reader(const string& fileName, const uint32_t id = 0, const uint32_t fileId = 0)
                 : BaseRecorder()
                 , _storageName(fileName)
                 , _currentSet()
             {
                 BaseRecorder::SetBuffer(_buffer);
-                Reset(id);
+                Reset(id, fileId);
             }
             ~Reader()
             {
@@ -629,14 +671,22 @@ namespace Core {
             {
                 return ((BaseRecorder::Id() >= BaseRecorder::Start()._id) && (BaseRecorder::Id() <= _end._id));
             }
-            void Reset(const uint32_t id)
+            // If it is known which file holds the id, start looking from there.
+            void Reset(const uint32_t id, const uint32_t fileId = 0)
             {
-                _fileId = static_cast<uint32_t>(~0);
+                uint32_t first = fileId;
+                uint32_t last;
+
+                if ((first == 0) && (RecorderType<STOREVALUE, BLOCKSIZE>::Blocks(_storageName, first, last) == false)) {
+                    first = 0;
+                }
+
+                _fileId = first - 1;
 
                 bool correctFile = false;
 
                 // Now create the storage space.
-                NumberType<uint32_t> number(0);
+                NumberType<uint32_t> number(first);
 
                 Core::File file(_storageName + '.' + number.Text());
 
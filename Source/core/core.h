@@ -56,6 +56,8 @@
 #include "Serialization.h"
 #include "Services.h"
 #include "SharedBuffer.h"
+#include "SharedEventRing.h"
+#include "SharedSlotBuffer.h"
 #include "Singleton.h"
 #include "SocketPort.h"
 #include "SocketServer.h"
@@ -72,6 +74,7 @@
 #include "TextReader.h"
 #include "Thread.h"
 #include "Time.h"
+#include "TimeSeries.h"
 #include "Timer.h"
 #include "Trace.h"
 #include "TriState.h"
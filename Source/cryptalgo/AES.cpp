@@ -5,8 +5,10 @@ namespace Crypto {
 
     AESEncryption::AESEncryption(const aesType type)
         : _type(type)
+        , _offset(0)
     {
         ::memset(_iv, 0, sizeof(_iv));
+        ::memset(_streamBlock, 0, sizeof(_streamBlock));
     }
 
     AESEncryption::~AESEncryption()
@@ -27,13 +29,11 @@ namespace Crypto {
 
         switch (Type()) {
         case AES_ECB: {
-            uint32_t offset = 0;
             uint32_t blockSize = ((length / 16) * 16);
 
-            while (offset < blockSize) {
+            if (blockSize > 0) {
                 // First encrypt the whole blocks. No padding needed, yet
-                result = mbedtls_aes_crypt_ecb(&_context, MBEDTLS_AES_ENCRYPT, &(input[offset]), &(output[offset]));
-                offset += 16;
+                result = mbedtls_aes_crypt_ecb_blocks(&_context, MBEDTLS_AES_ENCRYPT, blockSize, input, output);
             }
 
             if (blockSize < length) {
@@ -151,6 +151,16 @@ namespace Crypto {
         }
             result = mbedtls_aes_crypt_ofb(&_context, length, &_offset, _iv, input, output);
             break;
+#endif
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+        case AES_CTR: {
+            // A stream mode, no padding needed. The IV is the counter block, encryption
+            // and decryption are the same operation.
+            uint32_t offset = static_cast<uint32_t>(_offset);
+            result = mbedtls_aes_crypt_ctr(&_context, length, &offset, _iv, _streamBlock, input, output);
+            _offset = offset;
+            break;
+        }
 #endif
         default:
             ASSERT(false);
@@ -165,6 +175,7 @@ namespace Crypto {
         , _offset(0)
     {
         ::memset(_iv, 0, sizeof(_iv));
+        ::memset(_streamBlock, 0, sizeof(_streamBlock));
     }
 
     AESDecryption::~AESDecryption()
@@ -191,13 +202,11 @@ namespace Crypto {
 
         switch (Type()) {
         case AES_ECB: {
-            uint32_t offset = 0;
             uint32_t blockSize = ((length / 16) * 16);
 
-            while (offset < blockSize) {
+            if (blockSize > 0) {
                 // First encrypt the whole blocks. No padding needed, yet
-                result = mbedtls_aes_crypt_ecb(&_context, MBEDTLS_AES_DECRYPT, &(input[offset]), &(output[offset]));
-                offset += 16;
+                result = mbedtls_aes_crypt_ecb_blocks(&_context, MBEDTLS_AES_DECRYPT, blockSize, input, output);
             }
 
             if (blockSize < length) {
@@ -313,6 +322,16 @@ namespace Crypto {
             }
             break;
         }
+#endif
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+        case AES_CTR: {
+            // A stream mode, no padding needed. The IV is the counter block, encryption
+            // and decryption are the same operation.
+            uint32_t offset = static_cast<uint32_t>(_offset);
+            result = mbedtls_aes_crypt_ctr(&_context, length, &offset, _iv, _streamBlock, input, output);
+            _offset = offset;
+            break;
+        }
 #endif
         default:
             ASSERT(false);
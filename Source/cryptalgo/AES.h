@@ -12,7 +12,8 @@ namespace Crypto {
         AES_CBC,
         AES_CFB8,
         AES_CFB128,
-        AES_OFB
+        AES_OFB,
+        AES_CTR
     };
 
     enum bitLength {
@@ -21,6 +22,10 @@ namespace Crypto {
         BITLENGTH_256 = 256
     };
 
+    // The modes run on AES-NI (x86) or the ARMv8 Cryptography Extensions if the CPU has them, and on a
+    // table based software implementation otherwise. Only the former is constant time, the software
+    // fallback leaks key dependent cache timing, see mbedtls_aes_hw_support().
+
     class EXTERNAL AESEncryption {
     private:
         AESEncryption() = delete;
@@ -53,6 +58,7 @@ namespace Crypto {
         aesType _type;
         mbedtls_aes_context _context;
         uint8_t _iv[16];
+        uint8_t _streamBlock[16];
         size_t _offset;
     };
 
@@ -90,6 +96,7 @@ namespace Crypto {
         aesType _type;
         mbedtls_aes_context _context;
         uint8_t _iv[16];
+        uint8_t _streamBlock[16];
         size_t _offset;
     };
 }
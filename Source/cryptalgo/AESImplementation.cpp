@@ -26,8 +26,30 @@
 */
 
 #include "AESImplementation.h"
+#include <atomic>
 #include <stdio.h>
 #include <string.h>
+
+/*
+* Hardware acceleration, selected at run time: AES-NI on x86 and the
+* Cryptography Extensions on ARMv8 (little endian). The functions using the
+* instructions are compiled for them with a target attribute, so the rest of
+* the library does not require them.
+*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MBEDTLS_AES_HW_X86
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define MBEDTLS_AES_HW_ARMV8
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+#endif
+
 extern "C" {
 #define mbedtls_printf printf
 
@@ -726,6 +748,428 @@ void mbedtls_aes_decrypt(mbedtls_aes_context* ctx,
 }
 #endif /* !MBEDTLS_AES_DECRYPT_ALT */
 
+#if defined(MBEDTLS_AES_HW_X86) || defined(MBEDTLS_AES_HW_ARMV8)
+#define MBEDTLS_AES_HW
+#endif
+
+/* -1: not probed yet, 0: software only, 1: hardware, 2: hardware present, but disabled */
+static std::atomic<int> aes_hw_support(-1);
+
+static int aes_hw_probe(void)
+{
+    int result = 0;
+
+#if defined(MBEDTLS_AES_HW_X86)
+    unsigned int eax, ebx, ecx, edx;
+
+    if ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) && ((ecx & bit_AES) != 0))
+        result = 1;
+#elif defined(MBEDTLS_AES_HW_ARMV8)
+    if ((getauxval(AT_HWCAP) & HWCAP_AES) != 0)
+        result = 1;
+#endif
+
+    return (result);
+}
+
+static inline int aes_hw_has_support(void)
+{
+    int state = aes_hw_support.load(std::memory_order_acquire);
+
+    if (state == -1) {
+        /* Any thread may probe, they all find the same, only the first one stores it. */
+        int probed = aes_hw_probe();
+
+        if (aes_hw_support.compare_exchange_strong(state, probed, std::memory_order_acq_rel) == true)
+            state = probed;
+    }
+
+    return (state == 1);
+}
+
+int mbedtls_aes_hw_support(int enable)
+{
+    int present = (aes_hw_has_support() != 0) || (aes_hw_support.load() == 2);
+
+    if ((enable != -1) && (present != 0))
+        aes_hw_support.store(enable != 0 ? 1 : 2, std::memory_order_release);
+
+    return (aes_hw_has_support());
+}
+
+#if defined(MBEDTLS_AES_HW)
+
+/*
+* Both instruction sets work on the round keys as produced by the software
+* key schedule, as the words are stored little endian, their bytes are the
+* round keys of FIPS-197. The decryption schedule of mbedtls_aes_setkey_dec()
+* is the "equivalent inverse cipher" schedule, with InvMixColumns applied to
+* the inner round keys, which is exactly what AESDEC (x86) and AESD/AESIMC
+* (ARMv8) expect.
+* Independent blocks (ECB, CBC and CFB decryption, CTR) are processed
+* AES_HW_LANES at a time, round by round, so the pipelined AES units work on
+* several blocks at once instead of waiting for the latency of each round.
+*/
+#define AES_HW_LANES 8
+
+/* Fully unrolled, the blocks of all lanes stay in registers */
+#define AES_HW_UNROLL _Pragma("GCC unroll 8")
+
+#if defined(MBEDTLS_AES_HW_X86)
+
+#define AES_HW_TARGET __attribute__((target("aes,sse2")))
+
+typedef __m128i aes_hw_block;
+
+AES_HW_TARGET static inline aes_hw_block aes_hw_load(const unsigned char* data)
+{
+    return (_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+}
+
+AES_HW_TARGET static inline void aes_hw_store(unsigned char* data, const aes_hw_block value)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), value);
+}
+
+AES_HW_TARGET static inline aes_hw_block aes_hw_xor(const aes_hw_block a, const aes_hw_block b)
+{
+    return (_mm_xor_si128(a, b));
+}
+
+/* The counter block, the 128 bits counter is stored big endian */
+AES_HW_TARGET static inline aes_hw_block aes_hw_counter(const uint64_t high, const uint64_t low)
+{
+    return (_mm_set_epi64x(static_cast<long long>(__builtin_bswap64(low)), static_cast<long long>(__builtin_bswap64(high))));
+}
+
+AES_HW_TARGET static inline void aes_hw_encrypt(const aes_hw_block rk[], const int nr, aes_hw_block x[], const int lanes)
+{
+    int i, r;
+
+    AES_HW_UNROLL
+    for (i = 0; i < lanes; i++)
+        x[i] = _mm_xor_si128(x[i], rk[0]);
+
+    for (r = 1; r < nr; r++) {
+        AES_HW_UNROLL
+        for (i = 0; i < lanes; i++)
+            x[i] = _mm_aesenc_si128(x[i], rk[r]);
+    }
+
+    AES_HW_UNROLL
+    for (i = 0; i < lanes; i++)
+        x[i] = _mm_aesenclast_si128(x[i], rk[nr]);
+}
+
+AES_HW_TARGET static inline void aes_hw_decrypt(const aes_hw_block rk[], const int nr, aes_hw_block x[], const int lanes)
+{
+    int i, r;
+
+    AES_HW_UNROLL
+    for (i = 0; i < lanes; i++)
+        x[i] = _mm_xor_si128(x[i], rk[0]);
+
+    for (r = 1; r < nr; r++) {
+        AES_HW_UNROLL
+        for (i = 0; i < lanes; i++)
+            x[i] = _mm_aesdec_si128(x[i], rk[r]);
+    }
+
+    AES_HW_UNROLL
+    for (i = 0; i < lanes; i++)
+        x[i] = _mm_aesdeclast_si128(x[i], rk[nr]);
+}
+
+#else /* MBEDTLS_AES_HW_ARMV8 */
+
+#if defined(__clang__)
+#define AES_HW_TARGET __attribute__((target("crypto")))
+#else
+#define AES_HW_TARGET __attribute__((target("+crypto")))
+#endif
+
+typedef uint8x16_t aes_hw_block;
+
+AES_HW_TARGET static inline aes_hw_block aes_hw_load(const unsigned char* data)
+{
+    return (vld1q_u8(data));
+}
+
+AES_HW_TARGET static inline void aes_hw_store(unsigned char* data, const aes_hw_block value)
+{
+    vst1q_u8(data, value);
+}
+
+AES_HW_TARGET static inline aes_hw_block aes_hw_xor(const aes_hw_block a, const aes_hw_block b)
+{
+    return (veorq_u8(a, b));
+}
+
+/* The counter block, the 128 bits counter is stored big endian */
+AES_HW_TARGET static inline aes_hw_block aes_hw_counter(const uint64_t high, const uint64_t low)
+{
+    return (vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(__builtin_bswap64(high)), vcreate_u64(__builtin_bswap64(low)))));
+}
+
+/* AESE does AddRoundKey first, so the last round key is added separately */
+AES_HW_TARGET static inline void aes_hw_encrypt(const aes_hw_block rk[], const int nr, aes_hw_block x[], const int lanes)
+{
+    int i, r;
+
+    for (r = 0; r < (nr - 1); r++) {
+        AES_HW_UNROLL
+        for (i = 0; i < lanes; i++)
+            x[i] = vaesmcq_u8(vaeseq_u8(x[i], rk[r]));
+    }
+
+    AES_HW_UNROLL
+    for (i = 0; i < lanes; i++)
+        x[i] = veorq_u8(vaeseq_u8(x[i], rk[nr - 1]), rk[nr]);
+}
+
+AES_HW_TARGET static inline void aes_hw_decrypt(const aes_hw_block rk[], const int nr, aes_hw_block x[], const int lanes)
+{
+    int i, r;
+
+    for (r = 0; r < (nr - 1); r++) {
+        AES_HW_UNROLL
+        for (i = 0; i < lanes; i++)
+            x[i] = vaesimcq_u8(vaesdq_u8(x[i], rk[r]));
+    }
+
+    AES_HW_UNROLL
+    for (i = 0; i < lanes; i++)
+        x[i] = veorq_u8(vaesdq_u8(x[i], rk[nr - 1]), rk[nr]);
+}
+
+#endif /* MBEDTLS_AES_HW_ARMV8 */
+
+AES_HW_TARGET static inline void aes_hw_keys(const mbedtls_aes_context* ctx, aes_hw_block rk[15])
+{
+    const unsigned char* keys = reinterpret_cast<const unsigned char*>(ctx->rk);
+    int r;
+
+    for (r = 0; r <= ctx->nr; r++)
+        rk[r] = aes_hw_load(&keys[r << 4]);
+}
+
+AES_HW_TARGET static void aes_hw_crypt_ecb(const mbedtls_aes_context* ctx, int mode, uint32_t blocks,
+    const unsigned char* input, unsigned char* output)
+{
+    aes_hw_block rk[15];
+    aes_hw_block x[AES_HW_LANES];
+    int i;
+
+    aes_hw_keys(ctx, rk);
+
+    for (; blocks >= AES_HW_LANES; blocks -= AES_HW_LANES) {
+        AES_HW_UNROLL
+        for (i = 0; i < AES_HW_LANES; i++)
+            x[i] = aes_hw_load(&input[i << 4]);
+
+        if (mode == MBEDTLS_AES_ENCRYPT)
+            aes_hw_encrypt(rk, ctx->nr, x, AES_HW_LANES);
+        else
+            aes_hw_decrypt(rk, ctx->nr, x, AES_HW_LANES);
+
+        AES_HW_UNROLL
+        for (i = 0; i < AES_HW_LANES; i++)
+            aes_hw_store(&output[i << 4], x[i]);
+
+        input += (AES_HW_LANES * 16);
+        output += (AES_HW_LANES * 16);
+    }
+
+    for (; blocks > 0; blocks--) {
+        x[0] = aes_hw_load(input);
+
+        if (mode == MBEDTLS_AES_ENCRYPT)
+            aes_hw_encrypt(rk, ctx->nr, x, 1);
+        else
+            aes_hw_decrypt(rk, ctx->nr, x, 1);
+
+        aes_hw_store(output, x[0]);
+
+        input += 16;
+        output += 16;
+    }
+}
+
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+AES_HW_TARGET static void aes_hw_crypt_cbc(const mbedtls_aes_context* ctx, int mode, uint32_t blocks,
+    unsigned char iv[16], const unsigned char* input, unsigned char* output)
+{
+    aes_hw_block rk[15];
+    aes_hw_block x[AES_HW_LANES];
+    aes_hw_block c[AES_HW_LANES];
+    aes_hw_block chain = aes_hw_load(iv);
+    int i;
+
+    aes_hw_keys(ctx, rk);
+
+    if (mode == MBEDTLS_AES_ENCRYPT) {
+        /* Every block depends on the previous one, no parallelism here */
+        for (; blocks > 0; blocks--) {
+            x[0] = aes_hw_xor(aes_hw_load(input), chain);
+            aes_hw_encrypt(rk, ctx->nr, x, 1);
+            chain = x[0];
+            aes_hw_store(output, chain);
+
+            input += 16;
+            output += 16;
+        }
+    } else {
+        /* Load all ciphertext blocks before storing, the buffers may overlap */
+        for (; blocks >= AES_HW_LANES; blocks -= AES_HW_LANES) {
+            AES_HW_UNROLL
+            for (i = 0; i < AES_HW_LANES; i++)
+                c[i] = x[i] = aes_hw_load(&input[i << 4]);
+
+            aes_hw_decrypt(rk, ctx->nr, x, AES_HW_LANES);
+
+            aes_hw_store(output, aes_hw_xor(x[0], chain));
+            AES_HW_UNROLL
+            for (i = 1; i < AES_HW_LANES; i++)
+                aes_hw_store(&output[i << 4], aes_hw_xor(x[i], c[i - 1]));
+
+            chain = c[AES_HW_LANES - 1];
+
+            input += (AES_HW_LANES * 16);
+            output += (AES_HW_LANES * 16);
+        }
+
+        for (; blocks > 0; blocks--) {
+            c[0] = x[0] = aes_hw_load(input);
+            aes_hw_decrypt(rk, ctx->nr, x, 1);
+            aes_hw_store(output, aes_hw_xor(x[0], chain));
+            chain = c[0];
+
+            input += 16;
+            output += 16;
+        }
+    }
+
+    aes_hw_store(iv, chain);
+}
+#endif /* MBEDTLS_CIPHER_MODE_CBC */
+
+#if defined(MBEDTLS_CIPHER_MODE_CFB)
+/* Whole blocks only, starting at a block boundary, the encryption key schedule is used in both directions */
+AES_HW_TARGET static void aes_hw_crypt_cfb128(const mbedtls_aes_context* ctx, int mode, uint32_t blocks,
+    unsigned char iv[16], const unsigned char* input, unsigned char* output)
+{
+    aes_hw_block rk[15];
+    aes_hw_block x[AES_HW_LANES];
+    aes_hw_block c[AES_HW_LANES];
+    aes_hw_block chain = aes_hw_load(iv);
+    int i;
+
+    aes_hw_keys(ctx, rk);
+
+    if (mode == MBEDTLS_AES_ENCRYPT) {
+        for (; blocks > 0; blocks--) {
+            x[0] = chain;
+            aes_hw_encrypt(rk, ctx->nr, x, 1);
+            chain = aes_hw_xor(x[0], aes_hw_load(input));
+            aes_hw_store(output, chain);
+
+            input += 16;
+            output += 16;
+        }
+    } else {
+        for (; blocks >= AES_HW_LANES; blocks -= AES_HW_LANES) {
+            x[0] = chain;
+            AES_HW_UNROLL
+            for (i = 0; i < AES_HW_LANES; i++) {
+                c[i] = aes_hw_load(&input[i << 4]);
+                if (i > 0)
+                    x[i] = c[i - 1];
+            }
+
+            aes_hw_encrypt(rk, ctx->nr, x, AES_HW_LANES);
+
+            AES_HW_UNROLL
+            for (i = 0; i < AES_HW_LANES; i++)
+                aes_hw_store(&output[i << 4], aes_hw_xor(x[i], c[i]));
+
+            chain = c[AES_HW_LANES - 1];
+
+            input += (AES_HW_LANES * 16);
+            output += (AES_HW_LANES * 16);
+        }
+
+        for (; blocks > 0; blocks--) {
+            x[0] = chain;
+            aes_hw_encrypt(rk, ctx->nr, x, 1);
+            chain = aes_hw_load(input);
+            aes_hw_store(output, aes_hw_xor(x[0], chain));
+
+            input += 16;
+            output += 16;
+        }
+    }
+
+    /* As the software implementation leaves it: the last ciphertext block */
+    aes_hw_store(iv, chain);
+}
+#endif /* MBEDTLS_CIPHER_MODE_CFB */
+
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+/* Whole blocks only, nonce_counter is updated to the next counter block */
+AES_HW_TARGET static void aes_hw_crypt_ctr(const mbedtls_aes_context* ctx, uint32_t blocks,
+    unsigned char nonce_counter[16], const unsigned char* input, unsigned char* output)
+{
+    aes_hw_block rk[15];
+    aes_hw_block x[AES_HW_LANES];
+    uint64_t high, low;
+    int i;
+
+    aes_hw_keys(ctx, rk);
+
+    memcpy(&high, &nonce_counter[0], 8);
+    memcpy(&low, &nonce_counter[8], 8);
+    high = __builtin_bswap64(high);
+    low = __builtin_bswap64(low);
+
+    for (; blocks >= AES_HW_LANES; blocks -= AES_HW_LANES) {
+        AES_HW_UNROLL
+        for (i = 0; i < AES_HW_LANES; i++) {
+            x[i] = aes_hw_counter(high, low);
+            if (++low == 0)
+                ++high;
+        }
+
+        aes_hw_encrypt(rk, ctx->nr, x, AES_HW_LANES);
+
+        AES_HW_UNROLL
+        for (i = 0; i < AES_HW_LANES; i++)
+            aes_hw_store(&output[i << 4], aes_hw_xor(x[i], aes_hw_load(&input[i << 4])));
+
+        input += (AES_HW_LANES * 16);
+        output += (AES_HW_LANES * 16);
+    }
+
+    for (; blocks > 0; blocks--) {
+        x[0] = aes_hw_counter(high, low);
+        if (++low == 0)
+            ++high;
+
+        aes_hw_encrypt(rk, ctx->nr, x, 1);
+        aes_hw_store(output, aes_hw_xor(x[0], aes_hw_load(input)));
+
+        input += 16;
+        output += 16;
+    }
+
+    high = __builtin_bswap64(high);
+    low = __builtin_bswap64(low);
+    memcpy(&nonce_counter[0], &high, 8);
+    memcpy(&nonce_counter[8], &low, 8);
+}
+#endif /* MBEDTLS_CIPHER_MODE_CTR */
+
+#endif /* MBEDTLS_AES_HW */
+
 /*
 * AES-ECB block encryption/decryption
 */
@@ -734,6 +1178,13 @@ int mbedtls_aes_crypt_ecb(mbedtls_aes_context* ctx,
     const unsigned char input[16],
     unsigned char output[16])
 {
+#if defined(MBEDTLS_AES_HW)
+    if (aes_hw_has_support()) {
+        aes_hw_crypt_ecb(ctx, mode, 1, input, output);
+        return (0);
+    }
+#endif
+
 #if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
     if (mbedtls_aesni_has_support(MBEDTLS_AESNI_AES))
         return (mbedtls_aesni_crypt_ecb(ctx, mode, input, output));
@@ -758,6 +1209,36 @@ int mbedtls_aes_crypt_ecb(mbedtls_aes_context* ctx,
     return (0);
 }
 
+/*
+* AES-ECB encryption/decryption of consecutive blocks
+*/
+int mbedtls_aes_crypt_ecb_blocks(mbedtls_aes_context* ctx,
+    int mode,
+    uint32_t length,
+    const unsigned char* input,
+    unsigned char* output)
+{
+    if (length % 16)
+        return (MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH);
+
+#if defined(MBEDTLS_AES_HW)
+    if (aes_hw_has_support()) {
+        aes_hw_crypt_ecb(ctx, mode, length / 16, input, output);
+        return (0);
+    }
+#endif
+
+    while (length > 0) {
+        mbedtls_aes_crypt_ecb(ctx, mode, input, output);
+
+        input += 16;
+        output += 16;
+        length -= 16;
+    }
+
+    return (0);
+}
+
 #if defined(MBEDTLS_CIPHER_MODE_CBC)
 /*
 * AES-CBC buffer encryption/decryption
@@ -786,6 +1267,13 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context* ctx,
     }
 #endif
 
+#if defined(MBEDTLS_AES_HW)
+    if (aes_hw_has_support()) {
+        aes_hw_crypt_cbc(ctx, mode, length / 16, iv, input, output);
+        return (0);
+    }
+#endif
+
     if (mode == MBEDTLS_AES_DECRYPT) {
         while (length > 0) {
             memcpy(temp, input, 16);
@@ -833,6 +1321,30 @@ int mbedtls_aes_crypt_cfb128(mbedtls_aes_context* ctx,
     int c;
     uint32_t n = static_cast<uint32_t>(*iv_off);
 
+#if defined(MBEDTLS_AES_HW)
+    if (aes_hw_has_support()) {
+        /* Finish the current block bytewise, the whole blocks after it go in bulk */
+        while ((n != 0) && (length > 0)) {
+            c = *input++;
+            *output++ = (unsigned char)(c ^ iv[n]);
+            iv[n] = (unsigned char)(mode == MBEDTLS_AES_DECRYPT ? c : output[-1]);
+
+            n = (n + 1) & 0x0F;
+            length--;
+        }
+
+        if (length >= 16) {
+            uint32_t blocks = length / 16;
+
+            aes_hw_crypt_cfb128(ctx, mode, blocks, iv, input, output);
+
+            input += (blocks * 16);
+            output += (blocks * 16);
+            length -= (blocks * 16);
+        }
+    }
+#endif
+
     if (mode == MBEDTLS_AES_DECRYPT) {
         while (length--) {
             if (n == 0)
@@ -907,6 +1419,29 @@ int mbedtls_aes_crypt_ctr(mbedtls_aes_context* ctx,
     int c, i;
     uint32_t n = *nc_off;
 
+#if defined(MBEDTLS_AES_HW)
+    if (aes_hw_has_support()) {
+        /* Use up the current stream block, the whole blocks after it go in bulk */
+        while ((n != 0) && (length > 0)) {
+            c = *input++;
+            *output++ = (unsigned char)(c ^ stream_block[n]);
+
+            n = (n + 1) & 0x0F;
+            length--;
+        }
+
+        if (length >= 16) {
+            uint32_t blocks = length / 16;
+
+            aes_hw_crypt_ctr(ctx, blocks, nonce_counter, input, output);
+
+            input += (blocks * 16);
+            output += (blocks * 16);
+            length -= (blocks * 16);
+        }
+    }
+#endif
+
     while (length--) {
         if (n == 0) {
             mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, nonce_counter, stream_block);
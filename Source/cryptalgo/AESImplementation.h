@@ -28,8 +28,8 @@
 #define MBEDTLS_CIPHER_MODE_CBC
 #define MBEDTLS_CIPHER_MODE_CFB
 #define MBEDTLS_CIPHER_MODE_OFB
+#define MBEDTLS_CIPHER_MODE_CTR
 #undef MBEDTLS_SELF_TEST
-#undef MBEDTLS_CIPHER_MODE_CTR
 
 #include <stddef.h>
 #include <stdint.h>
@@ -113,6 +113,51 @@ int mbedtls_aes_crypt_ecb(mbedtls_aes_context* ctx,
     const unsigned char input[16],
     unsigned char output[16]);
 
+/**
+	* \brief          AES-ECB encryption/decryption of consecutive blocks
+	*
+	*                 Same as calling mbedtls_aes_crypt_ecb() for every block,
+	*                 but the hardware implementation processes several blocks
+	*                 in parallel.
+	*
+	* \param ctx      AES context
+	* \param mode     MBEDTLS_AES_ENCRYPT or MBEDTLS_AES_DECRYPT
+	* \param length   length of the input data, a multiple of 16
+	* \param input    buffer holding the input data
+	* \param output   buffer holding the output data
+	*
+	* \return         0 if successful, or MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH
+	*/
+int mbedtls_aes_crypt_ecb_blocks(mbedtls_aes_context* ctx,
+    int mode,
+    uint32_t length,
+    const unsigned char* input,
+    unsigned char* output);
+
+/**
+	* \brief          Hardware acceleration (AES-NI on x86, the Cryptography
+	*                 Extensions on ARMv8) of all the modes.
+	*
+	*                 The CPU is probed once, at the first use. The software
+	*                 implementation is the fallback if the instructions are not
+	*                 available. Forcing the software implementation is meant
+	*                 for testing and benchmarking, it is not synchronized with
+	*                 operations running on other threads.
+	*
+	* \warning        The software implementation is table based and NOT
+	*                 constant time: the cache lines it touches depend on the
+	*                 key and the data, which leaks through cache timing to
+	*                 other code on the same CPU. Only the hardware path is
+	*                 constant time. Check the result of this function where
+	*                 that matters.
+	*
+	* \param enable   0 to force the software implementation, 1 to use the
+	*                 hardware if available, -1 to leave it as is
+	*
+	* \return         1 if the hardware instructions are in use, 0 otherwise
+	*/
+int mbedtls_aes_hw_support(int enable);
+
 #if defined(MBEDTLS_CIPHER_MODE_CBC)
 /**
 	* \brief          AES-CBC buffer encryption/decryption
@@ -45,6 +45,36 @@
 #include "Winsock2.h"
 #endif // __WIN32__
 
+// The SHA instructions are used through intrinsics in functions compiled for them with a
+// target attribute, so the rest of the library does not require them.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HASH_HW_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define HASH_HW_ARMV8
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA1
+#define HWCAP_SHA1 (1 << 5)
+#endif
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#endif
+
+#if defined(HASH_HW_X86) || defined(HASH_HW_ARMV8)
+#define HASH_HW
+#endif
+
+#if defined(HASH_HW_X86)
+#define HASH_HW_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#elif defined(HASH_HW_ARMV8) && defined(__clang__)
+#define HASH_HW_TARGET __attribute__((target("crypto")))
+#elif defined(HASH_HW_ARMV8)
+#define HASH_HW_TARGET __attribute__((target("+crypto")))
+#endif
+
 // --------------------------------------------------------------------------------------------
 // MD5 functionality
 // --------------------------------------------------------------------------------------------
@@ -196,6 +226,169 @@
 
 namespace WPEFramework {
 namespace Crypto {
+    // --------------------------------------------------------------------------------------------
+    // Hardware acceleration
+    // --------------------------------------------------------------------------------------------
+    // -1: not probed yet, 0: not available, 1: in use, 2: available, but disabled
+    static int hash_hw_support = -1;
+
+    static int hash_hw_probe()
+    {
+        int result = 0;
+
+#if defined(HASH_HW_X86)
+        unsigned int eax, ebx, ecx, edx;
+
+        if ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) && ((ecx & bit_SSSE3) != 0) && ((ecx & bit_SSE4_1) != 0) && (__get_cpuid_max(0, nullptr) >= 7)) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+            if ((ebx & bit_SHA) != 0) {
+                result = 1;
+            }
+        }
+#elif defined(HASH_HW_ARMV8)
+        unsigned long capabilities = getauxval(AT_HWCAP);
+
+        if (((capabilities & HWCAP_SHA1) != 0) && ((capabilities & HWCAP_SHA2) != 0)) {
+            result = 1;
+        }
+#endif
+
+        return (result);
+    }
+
+    static inline bool hash_hw()
+    {
+        if (hash_hw_support == -1) {
+            hash_hw_support = hash_hw_probe();
+        }
+
+        return (hash_hw_support == 1);
+    }
+
+    bool HashAcceleration()
+    {
+        return (hash_hw());
+    }
+
+    void HashAcceleration(const bool enable)
+    {
+        if ((hash_hw() == true) || (hash_hw_support == 2)) {
+            hash_hw_support = (enable == true ? 1 : 2);
+        }
+    }
+
+#if defined(HASH_HW_X86)
+    // After the reference code for the Intel SHA extensions. The 80 rounds are done in groups
+    // of 4 (SHA1RNDS4), the message schedule of the next groups is computed along.
+    HASH_HW_TARGET static void sha1_hw(uint32_t state[5], const uint8_t* message, uint64_t block_nb)
+    {
+        const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+        __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+        __m128i e[2] = { _mm_set_epi32(state[4], 0, 0, 0), _mm_setzero_si128() };
+        __m128i w[4];
+
+        while (block_nb-- > 0) {
+            const __m128i abcdSave = abcd;
+            const __m128i eSave = e[0];
+
+#pragma GCC unroll 20
+            for (int g = 0; g < 20; g++) {
+                __m128i& in = e[g & 1];
+
+                if (g < 4) {
+                    w[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&message[g << 4])), mask);
+                }
+
+                in = (g == 0 ? _mm_add_epi32(in, w[0]) : _mm_sha1nexte_epu32(in, w[g & 3]));
+                e[(g + 1) & 1] = abcd;
+
+                if ((g >= 3) && (g <= 18)) {
+                    w[(g + 1) & 3] = _mm_sha1msg2_epu32(w[(g + 1) & 3], w[g & 3]);
+                }
+
+                switch (g / 5) {
+                case 0:
+                    abcd = _mm_sha1rnds4_epu32(abcd, in, 0);
+                    break;
+                case 1:
+                    abcd = _mm_sha1rnds4_epu32(abcd, in, 1);
+                    break;
+                case 2:
+                    abcd = _mm_sha1rnds4_epu32(abcd, in, 2);
+                    break;
+                default:
+                    abcd = _mm_sha1rnds4_epu32(abcd, in, 3);
+                    break;
+                }
+
+                if ((g >= 1) && (g <= 16)) {
+                    w[(g + 3) & 3] = _mm_sha1msg1_epu32(w[(g + 3) & 3], w[g & 3]);
+                }
+                if ((g >= 2) && (g <= 17)) {
+                    w[(g + 2) & 3] = _mm_xor_si128(w[(g + 2) & 3], w[g & 3]);
+                }
+            }
+
+            e[0] = _mm_sha1nexte_epu32(e[0], eSave);
+            abcd = _mm_add_epi32(abcd, abcdSave);
+
+            message += 64;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+        state[4] = static_cast<uint32_t>(_mm_extract_epi32(e[0], 3));
+    }
+#elif defined(HASH_HW_ARMV8)
+    HASH_HW_TARGET static void sha1_hw(uint32_t state[5], const uint8_t* message, uint64_t block_nb)
+    {
+        const uint32x4_t k[4] = { vdupq_n_u32(0x5A827999), vdupq_n_u32(0x6ED9EBA1), vdupq_n_u32(0x8F1BBCDC), vdupq_n_u32(0xCA62C1D6) };
+        uint32x4_t abcd = vld1q_u32(state);
+        uint32_t e = state[4];
+        uint32x4_t w[4];
+
+        while (block_nb-- > 0) {
+            const uint32x4_t abcdSave = abcd;
+            const uint32_t eSave = e;
+
+            for (int g = 0; g < 4; g++) {
+                w[g] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&message[g << 4])));
+            }
+
+#pragma GCC unroll 20
+            for (int g = 0; g < 20; g++) {
+                const uint32x4_t wk = vaddq_u32(w[g & 3], k[g / 5]);
+                const uint32_t next = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+
+                switch (g / 5) {
+                case 0:
+                    abcd = vsha1cq_u32(abcd, e, wk);
+                    break;
+                case 2:
+                    abcd = vsha1mq_u32(abcd, e, wk);
+                    break;
+                default:
+                    abcd = vsha1pq_u32(abcd, e, wk);
+                    break;
+                }
+                e = next;
+
+                if (g < 16) {
+                    w[g & 3] = vsha1su1q_u32(vsha1su0q_u32(w[g & 3], w[(g + 1) & 3], w[(g + 2) & 3]), w[(g + 3) & 3]);
+                }
+            }
+
+            abcd = vaddq_u32(abcd, abcdSave);
+            e += eSave;
+
+            message += 64;
+        }
+
+        vst1q_u32(state, abcd);
+        state[4] = e;
+    }
+#endif
+
     // --------------------------------------------------------------------------------------------
     // SHA1 functionality
     // --------------------------------------------------------------------------------------------
@@ -217,31 +410,48 @@ namespace Crypto {
  *  Comments:
  *
  */
-    void SHA1::Input(const uint8_t message_array[], const uint16_t length)
+    void SHA1::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t counter = length;
+        uint64_t counter = length;
         const uint8_t* current = &(message_array[0]);
 
         ASSERT((_computed == false) || (_corrupted == false));
 
-        while (counter-- && !_corrupted) {
-            _messageBlock[_messageIndex++] = *current;
+        // The message length in bits must fit in 64 bits.
+        if ((length >= (1ULL << 61)) || ((_length + length) >= (1ULL << 61))) {
+            _corrupted = true; // Message is too long
+        }
+
+        if (_corrupted == false) {
+            _length += length;
+
+            if (_messageIndex > 0) {
+                uint32_t part = static_cast<uint32_t>(std::min(static_cast<uint64_t>(64 - _messageIndex), counter));
 
-            _lengthLow++;
-            if (_lengthLow == 0x20000000) {
-                _lengthLow = 0;
-                _lengthHigh++;
-                if (_lengthHigh == 0) {
-                    _corrupted = true; // Message is too long
+                ::memcpy(&(_messageBlock[_messageIndex]), current, part);
+                _messageIndex += part;
+                current += part;
+                counter -= part;
+
+                if (_messageIndex == 64) {
+                    ProcessMessageBlocks(_messageBlock, 1);
+                    _messageIndex = 0;
                 }
             }
 
-            if (_messageIndex == 64) {
-                ProcessMessageBlock();
-                _messageIndex = 0;
+            if (counter >= 64) {
+                // Whole blocks are processed in place, no need to copy them.
+                uint64_t blocks = counter / 64;
+
+                ProcessMessageBlocks(current, blocks);
+                current += (blocks * 64);
+                counter -= (blocks * 64);
             }
 
-            current++;
+            if (counter > 0) {
+                ::memcpy(_messageBlock, current, static_cast<size_t>(counter));
+                _messageIndex = static_cast<uint32_t>(counter);
+            }
         }
     }
 
@@ -300,14 +510,17 @@ namespace Crypto {
     }
 
     /*
- *  ProcessMessageBlock
+ *  ProcessMessageBlocks
  *
  *  Description:
- *      This function will process the next 512 bits of the message
- *      stored in the _messageBlock array.
+ *      This function will process the next 512 bits blocks of the
+ *      message.
  *
  *  Parameters:
- *      None.
+ *      blocks: [in]
+ *          The 512 bits blocks.
+ *      count: [in]
+ *          The number of blocks.
  *
  *  Returns:
  *      Nothing.
@@ -318,8 +531,15 @@ namespace Crypto {
  *      in the publication.
  *
  */
-    void SHA1::ProcessMessageBlock()
+    void SHA1::ProcessMessageBlocks(const uint8_t blocks[], const uint64_t count)
     {
+#if defined(HASH_HW)
+        if (hash_hw() == true) {
+            sha1_hw(H, blocks, count);
+            return;
+        }
+#endif
+
         const unsigned K[] = { // Constants defined for SHA-1
             0x5A827999,
             0x6ED9EBA1,
@@ -331,71 +551,75 @@ namespace Crypto {
         unsigned W[80]; // Word sequence
         unsigned A, B, C, D, E; // Word buffers
 
-        /*
-     *  Initialize the first 16 words in the array W
-     */
-        for (t = 0; t < 16; t++) {
-            W[t] = ((unsigned)_messageBlock[t * 4]) << 24;
-            W[t] |= ((unsigned)_messageBlock[t * 4 + 1]) << 16;
-            W[t] |= ((unsigned)_messageBlock[t * 4 + 2]) << 8;
-            W[t] |= ((unsigned)_messageBlock[t * 4 + 3]);
-        }
+        for (uint64_t index = 0; index < count; index++) {
+            const uint8_t* block = &(blocks[index * 64]);
+
+            /*
+         *  Initialize the first 16 words in the array W
+         */
+            for (t = 0; t < 16; t++) {
+                W[t] = ((unsigned)block[t * 4]) << 24;
+                W[t] |= ((unsigned)block[t * 4 + 1]) << 16;
+                W[t] |= ((unsigned)block[t * 4 + 2]) << 8;
+                W[t] |= ((unsigned)block[t * 4 + 3]);
+            }
 
-        for (t = 16; t < 80; t++) {
-            W[t] = CircularShift(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
-        }
+            for (t = 16; t < 80; t++) {
+                W[t] = CircularShift(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
+            }
 
-        A = H[0];
-        B = H[1];
-        C = H[2];
-        D = H[3];
-        E = H[4];
-
-        for (t = 0; t < 20; t++) {
-            temp = CircularShift(5, A) + ((B & C) | ((~B) & D)) + E + W[t] + K[0];
-            temp &= 0xFFFFFFFF;
-            E = D;
-            D = C;
-            C = CircularShift(30, B);
-            B = A;
-            A = temp;
-        }
+            A = H[0];
+            B = H[1];
+            C = H[2];
+            D = H[3];
+            E = H[4];
+
+            for (t = 0; t < 20; t++) {
+                temp = CircularShift(5, A) + ((B & C) | ((~B) & D)) + E + W[t] + K[0];
+                temp &= 0xFFFFFFFF;
+                E = D;
+                D = C;
+                C = CircularShift(30, B);
+                B = A;
+                A = temp;
+            }
 
-        for (t = 20; t < 40; t++) {
-            temp = CircularShift(5, A) + (B ^ C ^ D) + E + W[t] + K[1];
-            temp &= 0xFFFFFFFF;
-            E = D;
-            D = C;
-            C = CircularShift(30, B);
-            B = A;
-            A = temp;
-        }
+            for (t = 20; t < 40; t++) {
+                temp = CircularShift(5, A) + (B ^ C ^ D) + E + W[t] + K[1];
+                temp &= 0xFFFFFFFF;
+                E = D;
+                D = C;
+                C = CircularShift(30, B);
+                B = A;
+                A = temp;
+            }
 
-        for (t = 40; t < 60; t++) {
-            temp = CircularShift(5, A) + ((B & C) | (B & D) | (C & D)) + E + W[t] + K[2];
-            temp &= 0xFFFFFFFF;
-            E = D;
-            D = C;
-            C = CircularShift(30, B);
-            B = A;
-            A = temp;
-        }
+            for (t = 40; t < 60; t++) {
+                temp = CircularShift(5, A) + ((B & C) | (B & D) | (C & D)) + E + W[t] + K[2];
+                temp &= 0xFFFFFFFF;
+                E = D;
+                D = C;
+                C = CircularShift(30, B);
+                B = A;
+                A = temp;
+            }
 
-        for (t = 60; t < 80; t++) {
-            temp = CircularShift(5, A) + (B ^ C ^ D) + E + W[t] + K[3];
-            temp &= 0xFFFFFFFF;
-            E = D;
-            D = C;
-            C = CircularShift(30, B);
-            B = A;
-            A = temp;
-        }
+            for (t = 60; t < 80; t++) {
+                temp = CircularShift(5, A) + (B ^ C ^ D) + E + W[t] + K[3];
+                temp &= 0xFFFFFFFF;
+                E = D;
+                D = C;
+                C = CircularShift(30, B);
+                B = A;
+                A = temp;
+            }
 
-        H[0] = (H[0] + A) & 0xFFFFFFFF;
-        H[1] = (H[1] + B) & 0xFFFFFFFF;
-        H[2] = (H[2] + C) & 0xFFFFFFFF;
-        H[3] = (H[3] + D) & 0xFFFFFFFF;
-        H[4] = (H[4] + E) & 0xFFFFFFFF;
+            H[0] = (H[0] + A) & 0xFFFFFFFF;
+            H[1] = (H[1] + B) & 0xFFFFFFFF;
+            H[2] = (H[2] + C) & 0xFFFFFFFF;
+            H[3] = (H[3] + D) & 0xFFFFFFFF;
+            H[4] = (H[4] + E) & 0xFFFFFFFF;
+        }
     }
 
     /*
@@ -407,7 +631,7 @@ namespace Crypto {
  *      represent the length of the original message.  All bits in between
  *      should be 0.  This function will pad the message according to those
  *      rules by filling the message_block array accordingly.  It will also
- *      call ProcessMessageBlock() appropriately.  When it returns, it
+ *      call ProcessMessageBlocks() appropriately.  When it returns, it
  *      can be assumed that the message digest has been computed.
  *
  *  Parameters:
@@ -431,7 +655,7 @@ namespace Crypto {
 
             ::memset(&(_messageBlock[_messageIndex]), 0, (64 - _messageIndex));
 
-            ProcessMessageBlock();
+            ProcessMessageBlocks(_messageBlock, 1);
 
             _messageIndex = 0;
         } else {
@@ -442,16 +666,9 @@ namespace Crypto {
         /*
      *  Store the message length as the last 8 octets
      */
-        _messageBlock[56] = (_lengthHigh >> 24) & 0xFF;
-        _messageBlock[57] = (_lengthHigh >> 16) & 0xFF;
-        _messageBlock[58] = (_lengthHigh >> 8) & 0xFF;
-        _messageBlock[59] = (_lengthHigh)&0xFF;
-        _messageBlock[60] = (_lengthLow >> 21) & 0xFF;
-        _messageBlock[61] = (_lengthLow >> 13) & 0xFF;
-        _messageBlock[62] = (_lengthLow >> 5) & 0xFF;
-        _messageBlock[63] = (_lengthLow << 3) & 0xFF;
+        UNPACK64(_length << 3, &(_messageBlock[56]));
 
-        ProcessMessageBlock();
+        ProcessMessageBlocks(_messageBlock, 1);
 
         uint32_t* writer = reinterpret_cast<uint32_t*>(&_messageBlock[0]);
 
@@ -660,20 +877,18 @@ namespace Crypto {
         _context.buffer[15] = _context.d >> 24;
     }
 
-    void MD5::Input(const uint8_t message_array[], const uint16_t length)
+    void MD5::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
+        uint64_t sizeToHandle = length;
         const uint8_t* source = &message_array[0];
 
+        // An unsigned long might only be 32 bits.
         while (sizeToHandle > 0) {
-            if (sizeToHandle > 512) {
-                MD5_Update(&_context, source, 512);
-                source += 512;
-                sizeToHandle -= 512;
-            } else {
-                MD5_Update(&_context, source, sizeToHandle);
-                sizeToHandle = 0;
-            }
+            unsigned long size = static_cast<unsigned long>(std::min(sizeToHandle, static_cast<uint64_t>(0x40000000)));
+
+            MD5_Update(&_context, source, size);
+            source += size;
+            sizeToHandle -= size;
         }
     }
 
@@ -820,22 +1035,129 @@ namespace Crypto {
         0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
     };
 
+    // --------------------------------------------------------------------------------------------
+    // SHA256 hardware acceleration
+    // --------------------------------------------------------------------------------------------
+#if defined(HASH_HW_X86)
+    // After the reference code for the Intel SHA extensions. SHA256RNDS2 does 2 rounds on the
+    // state split in ABEF and CDGH, the message schedule of the next groups is computed along.
+    HASH_HW_TARGET static void sha256_hw(uint32_t state[8], const uint8_t* message, uint64_t block_nb)
+    {
+        const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+        __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1); // CDAB
+        __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B); // EFGH
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+        __m128i w[4];
+
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+
+        while (block_nb-- > 0) {
+            const __m128i abefSave = state0;
+            const __m128i cdghSave = state1;
+
+#pragma GCC unroll 16
+            for (int g = 0; g < 16; g++) {
+                if (g < 4) {
+                    w[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&message[g << 4])), mask);
+                }
+
+                __m128i wk = _mm_add_epi32(w[g & 3], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&sha256_k[g << 2])));
+
+                state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+
+                if ((g >= 3) && (g <= 14)) {
+                    tmp = _mm_alignr_epi8(w[g & 3], w[(g + 3) & 3], 4);
+                    w[(g + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(w[(g + 1) & 3], tmp), w[g & 3]);
+                }
+
+                wk = _mm_shuffle_epi32(wk, 0x0E);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+
+                if ((g >= 1) && (g <= 12)) {
+                    w[(g + 3) & 3] = _mm_sha256msg1_epu32(w[(g + 3) & 3], w[g & 3]);
+                }
+            }
+
+            state0 = _mm_add_epi32(state0, abefSave);
+            state1 = _mm_add_epi32(state1, cdghSave);
+
+            message += 64;
+        }
+
+        tmp = _mm_shuffle_epi32(state0, 0x1B); // FEBA
+        state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+        state1 = _mm_alignr_epi8(state1, tmp, 8); // ABEF
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+    }
+#elif defined(HASH_HW_ARMV8)
+    HASH_HW_TARGET static void sha256_hw(uint32_t state[8], const uint8_t* message, uint64_t block_nb)
+    {
+        uint32x4_t state0 = vld1q_u32(&state[0]);
+        uint32x4_t state1 = vld1q_u32(&state[4]);
+        uint32x4_t w[4];
+
+        while (block_nb-- > 0) {
+            const uint32x4_t abcdSave = state0;
+            const uint32x4_t efghSave = state1;
+
+            for (int g = 0; g < 4; g++) {
+                w[g] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&message[g << 4])));
+            }
+
+#pragma GCC unroll 16
+            for (int g = 0; g < 16; g++) {
+                const uint32x4_t wk = vaddq_u32(w[g & 3], vld1q_u32(&sha256_k[g << 2]));
+                const uint32x4_t abcd = state0;
+
+                if (g < 12) {
+                    w[g & 3] = vsha256su0q_u32(w[g & 3], w[(g + 1) & 3]);
+                }
+
+                state0 = vsha256hq_u32(state0, state1, wk);
+                state1 = vsha256h2q_u32(state1, abcd, wk);
+
+                if (g < 12) {
+                    w[g & 3] = vsha256su1q_u32(w[g & 3], w[(g + 2) & 3], w[(g + 3) & 3]);
+                }
+            }
+
+            state0 = vaddq_u32(state0, abcdSave);
+            state1 = vaddq_u32(state1, efghSave);
+
+            message += 64;
+        }
+
+        vst1q_u32(&state[0], state0);
+        vst1q_u32(&state[4], state1);
+    }
+#endif
+
     // --------------------------------------------------------------------------------------------
     // SHA256 functionality
     // --------------------------------------------------------------------------------------------
-    static void sha256_transf(SHA256::Context* ctx, const unsigned char* message, unsigned int block_nb)
+    static void sha256_transf(uint32_t h[8], const unsigned char* message, uint64_t block_nb)
     {
         uint32_t w[64];
         uint32_t wv[8];
         uint32_t t1, t2;
         const unsigned char* sub_block;
-        int i;
+        uint64_t i;
+
+#if defined(HASH_HW)
+        if (hash_hw() == true) {
+            sha256_hw(h, message, block_nb);
+            return;
+        }
+#endif
 
 #ifndef UNROLL_LOOPS
         int j;
 #endif
 
-        for (i = 0; i < (int)block_nb; i++) {
+        for (i = 0; i < block_nb; i++) {
             sub_block = message + (i << 6);
 
 #ifndef UNROLL_LOOPS
@@ -848,7 +1170,7 @@ namespace Crypto {
             }
 
             for (j = 0; j < 8; j++) {
-                wv[j] = ctx->h[j];
+                wv[j] = h[j];
             }
 
             for (j = 0; j < 64; j++) {
@@ -866,7 +1188,7 @@ namespace Crypto {
             }
 
             for (j = 0; j < 8; j++) {
-                ctx->h[j] += wv[j];
+                h[j] += wv[j];
             }
 #else
             PACK32(&sub_block[0], &w[0]);
@@ -935,14 +1257,14 @@ namespace Crypto {
             SHA256_SCR(62);
             SHA256_SCR(63);
 
-            wv[0] = ctx->h[0];
-            wv[1] = ctx->h[1];
-            wv[2] = ctx->h[2];
-            wv[3] = ctx->h[3];
-            wv[4] = ctx->h[4];
-            wv[5] = ctx->h[5];
-            wv[6] = ctx->h[6];
-            wv[7] = ctx->h[7];
+            wv[0] = h[0];
+            wv[1] = h[1];
+            wv[2] = h[2];
+            wv[3] = h[3];
+            wv[4] = h[4];
+            wv[5] = h[5];
+            wv[6] = h[6];
+            wv[7] = h[7];
 
             SHA256_EXP(0, 1, 2, 3, 4, 5, 6, 7, 0);
             SHA256_EXP(7, 0, 1, 2, 3, 4, 5, 6, 1);
@@ -1009,14 +1331,14 @@ namespace Crypto {
             SHA256_EXP(2, 3, 4, 5, 6, 7, 0, 1, 62);
             SHA256_EXP(1, 2, 3, 4, 5, 6, 7, 0, 63);
 
-            ctx->h[0] += wv[0];
-            ctx->h[1] += wv[1];
-            ctx->h[2] += wv[2];
-            ctx->h[3] += wv[3];
-            ctx->h[4] += wv[4];
-            ctx->h[5] += wv[5];
-            ctx->h[6] += wv[6];
-            ctx->h[7] += wv[7];
+            h[0] += wv[0];
+            h[1] += wv[1];
+            h[2] += wv[2];
+            h[3] += wv[3];
+            h[4] += wv[4];
+            h[5] += wv[5];
+            h[6] += wv[6];
+            h[7] += wv[7];
 #endif /* !UNROLL_LOOPS */
         }
     }
@@ -1044,10 +1366,10 @@ namespace Crypto {
         _computed = false;
     }
 
-    static void sha256_update(SHA256::Context* ctx, const unsigned char* message, unsigned int len)
+    static void sha256_update(SHA256::Context* ctx, const unsigned char* message, uint64_t len)
     {
-        unsigned int block_nb;
-        unsigned int new_len, rem_len, tmp_len;
+        uint64_t block_nb;
+        uint64_t new_len, rem_len, tmp_len;
         const unsigned char* shifted_message;
 
         tmp_len = SHA256_BLOCK_SIZE - ctx->len;
@@ -1056,7 +1378,7 @@ namespace Crypto {
         memcpy(&ctx->block[ctx->len], message, rem_len);
 
         if (ctx->len + len < SHA256_BLOCK_SIZE) {
-            ctx->len += len;
+            ctx->len += static_cast<uint32_t>(len);
             return;
         }
 
@@ -1065,15 +1387,15 @@ namespace Crypto {
 
         shifted_message = message + rem_len;
 
-        sha256_transf(ctx, ctx->block, 1);
-        sha256_transf(ctx, shifted_message, block_nb);
+        sha256_transf(ctx->h, ctx->block, 1);
+        sha256_transf(ctx->h, shifted_message, block_nb);
 
         rem_len = new_len % SHA256_BLOCK_SIZE;
 
         memcpy(ctx->block, &shifted_message[block_nb << 6],
             rem_len);
 
-        ctx->len = rem_len;
+        ctx->len = static_cast<uint32_t>(rem_len);
         ctx->tot_len += (block_nb + 1) << 6;
     }
 
@@ -1081,7 +1403,7 @@ namespace Crypto {
     {
         unsigned int block_nb;
         unsigned int pm_len;
-        unsigned int len_b;
+        uint64_t len_b;
 
 #ifndef UNROLL_LOOPS
         int i;
@@ -1094,9 +1416,9 @@ namespace Crypto {
 
         memset(_context.block + _context.len, 0, pm_len - _context.len);
         _context.block[_context.len] = 0x80;
-        UNPACK32(len_b, _context.block + pm_len - 4);
+        UNPACK64(len_b, _context.block + pm_len - 8);
 
-        sha256_transf(&_context, _context.block, block_nb);
+        sha256_transf(_context.h, _context.block, block_nb);
 
 #ifndef UNROLL_LOOPS
         for (i = 0; i < 8; i++) {
@@ -1114,19 +1436,216 @@ namespace Crypto {
 #endif /* !UNROLL_LOOPS */
     }
 
-    void SHA256::Input(const uint8_t message_array[], const uint16_t length)
+    void SHA256::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
-        const uint8_t* source = &message_array[0];
+        if (length > 0) {
+            sha256_update(&_context, &message_array[0], length);
+        }
+    }
 
-        while (sizeToHandle > 0) {
-            if (sizeToHandle > SHA256_BLOCK_SIZE) {
-                sha256_update(&_context, source, SHA256_BLOCK_SIZE);
-                source += SHA256_BLOCK_SIZE;
-                sizeToHandle -= SHA256_BLOCK_SIZE;
-            } else {
-                sha256_update(&_context, source, sizeToHandle);
-                sizeToHandle = 0;
+    // --------------------------------------------------------------------------------------------
+    // SHA256 multi-buffer functionality
+    // --------------------------------------------------------------------------------------------
+#define SHA256_LANES 4
+
+#if defined(__GNUC__)
+    typedef uint32_t sha256_lanes __attribute__((vector_size(16)));
+
+#define LANES_ROTR(x, n) ((x >> n) | (x << (32 - n)))
+#define LANES_F1(x) (LANES_ROTR(x, 2) ^ LANES_ROTR(x, 13) ^ LANES_ROTR(x, 22))
+#define LANES_F2(x) (LANES_ROTR(x, 6) ^ LANES_ROTR(x, 11) ^ LANES_ROTR(x, 25))
+#define LANES_F3(x) (LANES_ROTR(x, 7) ^ LANES_ROTR(x, 18) ^ (x >> 3))
+#define LANES_F4(x) (LANES_ROTR(x, 17) ^ LANES_ROTR(x, 19) ^ (x >> 10))
+
+    static inline uint32_t sha256_word(const unsigned char* data)
+    {
+        uint32_t result;
+
+        PACK32(data, &result);
+
+        return (result);
+    }
+
+    // The C implementation for four messages at once, one per lane of a 128 bits vector (SSE2 on
+    // x86, NEON on ARM), so every instruction works on all four of them.
+    static void sha256_transf_lanes(uint32_t* const state[SHA256_LANES], const unsigned char* const message[SHA256_LANES], uint64_t block_nb)
+    {
+        sha256_lanes w[16];
+        sha256_lanes wv[8];
+        sha256_lanes hv[8];
+        sha256_lanes t1, t2;
+        uint64_t i;
+        int j;
+
+        for (j = 0; j < 8; j++) {
+            hv[j] = (sha256_lanes) { state[0][j], state[1][j], state[2][j], state[3][j] };
+        }
+
+        for (i = 0; i < block_nb; i++) {
+            const uint64_t offset = (i << 6);
+
+            for (j = 0; j < 8; j++) {
+                wv[j] = hv[j];
+            }
+
+            for (j = 0; j < 64; j++) {
+                if (j < 16) {
+                    w[j] = (sha256_lanes) { sha256_word(&message[0][offset + (j << 2)]), sha256_word(&message[1][offset + (j << 2)]),
+                        sha256_word(&message[2][offset + (j << 2)]), sha256_word(&message[3][offset + (j << 2)]) };
+                } else {
+                    w[j & 15] += LANES_F4(w[(j - 2) & 15]) + w[(j - 7) & 15] + LANES_F3(w[(j - 15) & 15]);
+                }
+
+                t1 = wv[7] + LANES_F2(wv[4]) + CH(wv[4], wv[5], wv[6]) + sha256_k[j] + w[j & 15];
+                t2 = LANES_F1(wv[0]) + MAJ(wv[0], wv[1], wv[2]);
+                wv[7] = wv[6];
+                wv[6] = wv[5];
+                wv[5] = wv[4];
+                wv[4] = wv[3] + t1;
+                wv[3] = wv[2];
+                wv[2] = wv[1];
+                wv[1] = wv[0];
+                wv[0] = t1 + t2;
+            }
+
+            for (j = 0; j < 8; j++) {
+                hv[j] += wv[j];
+            }
+        }
+
+        for (j = 0; j < 8; j++) {
+            state[0][j] = hv[j][0];
+            state[1][j] = hv[j][1];
+            state[2][j] = hv[j][2];
+            state[3][j] = hv[j][3];
+        }
+    }
+#endif
+
+    // Whole blocks of up to SHA256_LANES messages, the number of blocks may differ per message.
+    static void sha256_transf_multi(const uint8_t lanes, uint32_t* const state[], const unsigned char* const source[], const uint64_t blocks[])
+    {
+        const unsigned char* message[SHA256_LANES];
+        uint64_t left[SHA256_LANES];
+        uint8_t lane;
+
+        for (lane = 0; lane < lanes; lane++) {
+            message[lane] = source[lane];
+            left[lane] = blocks[lane];
+        }
+
+        while (true) {
+            uint8_t active = 0;
+            uint8_t last = 0;
+            uint64_t common = ~0ULL;
+
+            for (lane = 0; lane < lanes; lane++) {
+                if (left[lane] > 0) {
+                    active++;
+                    last = lane;
+                    common = std::min(common, left[lane]);
+                }
+            }
+
+            if (active <= 1) {
+                if (active == 1) {
+                    sha256_transf(state[last], message[last], left[last]);
+                }
+                break;
+            }
+
+#if defined(HASH_HW)
+            if (hash_hw() == true) {
+                // The SHA instructions are bound by latency, not by throughput. With the blocks of
+                // the messages alternating, the out-of-order core overlaps their rounds.
+                for (uint64_t index = 0; index < common; index++) {
+                    for (lane = 0; lane < lanes; lane++) {
+                        if (left[lane] > 0) {
+                            sha256_hw(state[lane], &(message[lane][index << 6]), 1);
+                        }
+                    }
+                }
+            } else
+#endif
+            {
+#if defined(__GNUC__)
+                uint32_t unused[SHA256_LANES][8];
+                uint32_t* states[SHA256_LANES];
+                const unsigned char* messages[SHA256_LANES];
+
+                // Lanes without a message work on scratch state, reading the data of the last one.
+                for (lane = 0; lane < SHA256_LANES; lane++) {
+                    if ((lane < lanes) && (left[lane] > 0)) {
+                        states[lane] = state[lane];
+                        messages[lane] = message[lane];
+                    } else {
+                        states[lane] = unused[lane];
+                        messages[lane] = message[last];
+                    }
+                }
+
+                sha256_transf_lanes(states, messages, common);
+#else
+                for (lane = 0; lane < lanes; lane++) {
+                    if (left[lane] > 0) {
+                        sha256_transf(state[lane], message[lane], common);
+                    }
+                }
+#endif
+            }
+
+            for (lane = 0; lane < lanes; lane++) {
+                if (left[lane] > 0) {
+                    message[lane] += (common << 6);
+                    left[lane] -= common;
+                }
+            }
+        }
+    }
+
+    /* static */ void SHA256::Input(const uint8_t count, SHA256* const hashes[], const uint8_t* const messages[], const uint64_t lengths[])
+    {
+        for (uint8_t first = 0; first < count; first += SHA256_LANES) {
+            const uint8_t lanes = static_cast<uint8_t>(std::min(count - first, SHA256_LANES));
+            uint32_t* state[SHA256_LANES];
+            const uint8_t* source[SHA256_LANES];
+            uint64_t blocks[SHA256_LANES];
+            uint64_t left[SHA256_LANES];
+
+            for (uint8_t lane = 0; lane < lanes; lane++) {
+                Context& context = hashes[first + lane]->_context;
+                const uint8_t* message = messages[first + lane];
+                uint64_t length = lengths[first + lane];
+
+                ASSERT(hashes[first + lane]->_computed == false);
+
+                // Complete a partially filled block on its own first.
+                if ((context.len > 0) && (length > 0)) {
+                    uint64_t part = std::min(length, static_cast<uint64_t>(SHA256_BLOCK_SIZE - context.len));
+
+                    sha256_update(&context, message, part);
+                    message += part;
+                    length -= part;
+                }
+
+                state[lane] = context.h;
+                source[lane] = message;
+                blocks[lane] = length / SHA256_BLOCK_SIZE;
+                left[lane] = length;
+            }
+
+            sha256_transf_multi(lanes, state, source, blocks);
+
+            for (uint8_t lane = 0; lane < lanes; lane++) {
+                // Anything left means the partial block was completed, the context is block aligned.
+                if (left[lane] > 0) {
+                    Context& context = hashes[first + lane]->_context;
+                    const uint64_t whole = blocks[lane] * SHA256_BLOCK_SIZE;
+
+                    context.tot_len += whole;
+                    context.len = static_cast<uint32_t>(left[lane] - whole);
+                    ::memcpy(context.block, &(source[lane][whole]), context.len);
+                }
             }
         }
     }
@@ -1212,10 +1731,10 @@ namespace Crypto {
         _computed = false;
     }
 
-    static void sha224_update(SHA256::Context* ctx, const unsigned char* message, unsigned int len)
+    static void sha224_update(SHA256::Context* ctx, const unsigned char* message, uint64_t len)
     {
-        unsigned int block_nb;
-        unsigned int new_len, rem_len, tmp_len;
+        uint64_t block_nb;
+        uint64_t new_len, rem_len, tmp_len;
         const unsigned char* shifted_message;
 
         tmp_len = SHA224_BLOCK_SIZE - ctx->len;
@@ -1224,7 +1743,7 @@ namespace Crypto {
         memcpy(&ctx->block[ctx->len], message, rem_len);
 
         if (ctx->len + len < SHA224_BLOCK_SIZE) {
-            ctx->len += len;
+            ctx->len += static_cast<uint32_t>(len);
             return;
         }
 
@@ -1233,15 +1752,15 @@ namespace Crypto {
 
         shifted_message = message + rem_len;
 
-        sha256_transf(ctx, ctx->block, 1);
-        sha256_transf(ctx, shifted_message, block_nb);
+        sha256_transf(ctx->h, ctx->block, 1);
+        sha256_transf(ctx->h, shifted_message, block_nb);
 
         rem_len = new_len % SHA224_BLOCK_SIZE;
 
         memcpy(ctx->block, &shifted_message[block_nb << 6],
             rem_len);
 
-        ctx->len = rem_len;
+        ctx->len = static_cast<uint32_t>(rem_len);
         ctx->tot_len += (block_nb + 1) << 6;
     }
 
@@ -1249,7 +1768,7 @@ namespace Crypto {
     {
         unsigned int block_nb;
         unsigned int pm_len;
-        unsigned int len_b;
+        uint64_t len_b;
 
 #ifndef UNROLL_LOOPS
         int i;
@@ -1262,9 +1781,9 @@ namespace Crypto {
 
         memset(_context.block + _context.len, 0, pm_len - _context.len);
         _context.block[_context.len] = 0x80;
-        UNPACK32(len_b, _context.block + pm_len - 4);
+        UNPACK64(len_b, _context.block + pm_len - 8);
 
-        sha256_transf(&_context, _context.block, block_nb);
+        sha256_transf(_context.h, _context.block, block_nb);
 
 #ifndef UNROLL_LOOPS
         for (i = 0; i < 7; i++) {
@@ -1281,20 +1800,10 @@ namespace Crypto {
 #endif /* !UNROLL_LOOPS */
     }
 
-    void SHA224::Input(const uint8_t message_array[], const uint16_t length)
+    void SHA224::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
-        const uint8_t* source = &message_array[0];
-
-        while (sizeToHandle > 0) {
-            if (sizeToHandle > SHA224_BLOCK_SIZE) {
-                sha224_update(&_context, source, SHA224_BLOCK_SIZE);
-                source += SHA224_BLOCK_SIZE;
-                sizeToHandle -= SHA224_BLOCK_SIZE;
-            } else {
-                sha224_update(&_context, source, sizeToHandle);
-                sizeToHandle = 0;
-            }
+        if (length > 0) {
+            sha224_update(&_context, &message_array[0], length);
         }
     }
 
@@ -1356,15 +1865,16 @@ namespace Crypto {
     // --------------------------------------------------------------------------------------------
     // SHA512 functionality
     // --------------------------------------------------------------------------------------------
-    static void sha512_transf(SHA512::Context* ctx, const unsigned char* message, unsigned int block_nb)
+    static void sha512_transf(SHA512::Context* ctx, const unsigned char* message, uint64_t block_nb)
     {
         uint64_t w[80];
         uint64_t wv[8];
         uint64_t t1, t2;
         const unsigned char* sub_block;
-        int i, j;
+        uint64_t i;
+        int j;
 
-        for (i = 0; i < (int)block_nb; i++) {
+        for (i = 0; i < block_nb; i++) {
             sub_block = message + (i << 7);
 
 #ifndef UNROLL_LOOPS
@@ -1546,10 +2056,10 @@ namespace Crypto {
     }
 
     static void sha512_update(SHA512::Context* ctx, const unsigned char* message,
-        unsigned int len)
+        uint64_t len)
     {
-        unsigned int block_nb;
-        unsigned int new_len, rem_len, tmp_len;
+        uint64_t block_nb;
+        uint64_t new_len, rem_len, tmp_len;
         const unsigned char* shifted_message;
 
         tmp_len = SHA512_BLOCK_SIZE - ctx->len;
@@ -1558,7 +2068,7 @@ namespace Crypto {
         memcpy(&ctx->block[ctx->len], message, rem_len);
 
         if (ctx->len + len < SHA512_BLOCK_SIZE) {
-            ctx->len += len;
+            ctx->len += static_cast<uint32_t>(len);
             return;
         }
 
@@ -1575,7 +2085,7 @@ namespace Crypto {
         memcpy(ctx->block, &shifted_message[block_nb << 7],
             rem_len);
 
-        ctx->len = rem_len;
+        ctx->len = static_cast<uint32_t>(rem_len);
         ctx->tot_len += (block_nb + 1) << 7;
     }
 
@@ -1583,7 +2093,7 @@ namespace Crypto {
     {
         unsigned int block_nb;
         unsigned int pm_len;
-        unsigned int len_b;
+        uint64_t len_b;
 
 #ifndef UNROLL_LOOPS
         int i;
@@ -1596,7 +2106,7 @@ namespace Crypto {
 
         memset(_context.block + _context.len, 0, pm_len - _context.len);
         _context.block[_context.len] = 0x80;
-        UNPACK32(len_b, _context.block + pm_len - 4);
+        UNPACK64(len_b, _context.block + pm_len - 8);
 
         sha512_transf(&_context, _context.block, block_nb);
 
@@ -1616,20 +2126,10 @@ namespace Crypto {
 #endif /* !UNROLL_LOOPS */
     }
 
-    void SHA512::Input(const uint8_t message_array[], const uint16_t length)
+    void SHA512::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
-        const uint8_t* source = &message_array[0];
-
-        while (sizeToHandle > 0) {
-            if (sizeToHandle > SHA512_BLOCK_SIZE) {
-                sha512_update(&_context, source, SHA512_BLOCK_SIZE);
-                source += SHA512_BLOCK_SIZE;
-                sizeToHandle -= SHA512_BLOCK_SIZE;
-            } else {
-                sha512_update(&_context, source, sizeToHandle);
-                sizeToHandle = 0;
-            }
+        if (length > 0) {
+            sha512_update(&_context, &message_array[0], length);
         }
     }
 
@@ -1715,10 +2215,10 @@ namespace Crypto {
         _computed = false;
     }
 
-    static void sha384_update(SHA512::Context* ctx, const unsigned char* message, unsigned int len)
+    static void sha384_update(SHA512::Context* ctx, const unsigned char* message, uint64_t len)
     {
-        unsigned int block_nb;
-        unsigned int new_len, rem_len, tmp_len;
+        uint64_t block_nb;
+        uint64_t new_len, rem_len, tmp_len;
         const unsigned char* shifted_message;
 
         tmp_len = SHA384_BLOCK_SIZE - ctx->len;
@@ -1727,7 +2227,7 @@ namespace Crypto {
         memcpy(&ctx->block[ctx->len], message, rem_len);
 
         if (ctx->len + len < SHA384_BLOCK_SIZE) {
-            ctx->len += len;
+            ctx->len += static_cast<uint32_t>(len);
             return;
         }
 
@@ -1744,7 +2244,7 @@ namespace Crypto {
         memcpy(ctx->block, &shifted_message[block_nb << 7],
             rem_len);
 
-        ctx->len = rem_len;
+        ctx->len = static_cast<uint32_t>(rem_len);
         ctx->tot_len += (block_nb + 1) << 7;
     }
 
@@ -1752,7 +2252,7 @@ namespace Crypto {
     {
         unsigned int block_nb;
         unsigned int pm_len;
-        unsigned int len_b;
+        uint64_t len_b;
 
 #ifndef UNROLL_LOOPS
         int i;
@@ -1765,7 +2265,7 @@ namespace Crypto {
 
         memset(_context.block + _context.len, 0, pm_len - _context.len);
         _context.block[_context.len] = 0x80;
-        UNPACK32(len_b, _context.block + pm_len - 4);
+        UNPACK64(len_b, _context.block + pm_len - 8);
 
         sha512_transf(&_context, _context.block, block_nb);
 
@@ -1783,20 +2283,10 @@ namespace Crypto {
 #endif /* !UNROLL_LOOPS */
     }
 
-    void SHA384::Input(const uint8_t message_array[], const uint16_t length)
+    void SHA384::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
-        const uint8_t* source = &message_array[0];
-
-        while (sizeToHandle > 0) {
-            if (sizeToHandle > SHA384_BLOCK_SIZE) {
-                sha384_update(&_context, source, SHA384_BLOCK_SIZE);
-                source += SHA384_BLOCK_SIZE;
-                sizeToHandle -= SHA384_BLOCK_SIZE;
-            } else {
-                sha384_update(&_context, source, sizeToHandle);
-                sizeToHandle = 0;
-            }
+        if (length > 0) {
+            sha384_update(&_context, &message_array[0], length);
         }
     }
 
@@ -80,6 +80,13 @@ namespace Crypto {
         HASH_SHA512 = 64
     };
 
+    // The SHA1, SHA224 and SHA256 compression functions run on the SHA instructions of the
+    // CPU (SHA-NI on x86, the Cryptography Extensions on ARMv8) if available, detected once
+    // at run time. Forcing the C implementation is meant for testing and benchmarking, it is
+    // not synchronized with hashing going on in other threads.
+    EXTERNAL bool HashAcceleration();
+    EXTERNAL void HashAcceleration(const bool enable);
+
     class EXTERNAL SHA1 {
     private:
         SHA1(const SHA1&);
@@ -90,7 +97,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA1(const uint8_t message_array[], const uint16_t length)
+        inline SHA1(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -106,8 +113,7 @@ namespace Crypto {
 
         void Reset()
         {
-            _lengthLow = 0;
-            _lengthHigh = 0;
+            _length = 0;
             _messageIndex = 0;
 
             H[0] = 0x67452301;
@@ -137,16 +143,16 @@ namespace Crypto {
         /*
          *  Provide input to SHA1
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         SHA1& operator<<(const uint8_t message_array[]);
         SHA1& operator<<(const uint8_t message_element);
 
     private:
         /*
-         *  Process the next 512 bits of the message
+         *  Process the next 512 bits blocks of the message, straight from the input
          */
-        void ProcessMessageBlock();
+        void ProcessMessageBlocks(const uint8_t blocks[], const uint64_t count);
 
         /*
          *  Pads the current message block to 512 bits
@@ -178,8 +184,7 @@ namespace Crypto {
 
         uint32_t H[5]; // Message digest buffers
 
-        uint32_t _lengthLow; // Message length in bits
-        uint32_t _lengthHigh; // Message length in bits
+        uint64_t _length; // Message length in bytes
 
         uint8_t _messageBlock[64]; // 512-bit message blocks
         uint32_t _messageIndex; // Index into message block array
@@ -206,7 +211,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline MD5(const uint8_t message_array[], const uint16_t length)
+        inline MD5(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -252,7 +257,7 @@ namespace Crypto {
         /*
          *  Provide input to MD5
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         MD5& operator<<(const uint8_t message_array[]);
         MD5& operator<<(const uint8_t message_element);
@@ -269,7 +274,7 @@ namespace Crypto {
     class EXTERNAL SHA256 {
     public:
         typedef struct {
-            uint32_t tot_len;
+            uint64_t tot_len;
             uint32_t len;
             uint8_t block[2 * (512 / 8)];
             uint32_t h[8];
@@ -284,7 +289,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA256(const uint8_t message_array[], const uint16_t length)
+        inline SHA256(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -309,9 +314,29 @@ namespace Crypto {
         }
 
         /*
-         *  Provide input to SHA1
+         *  Provide input to SHA256
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
+
+        /*
+         *  Provide the next input of several independent messages, one per SHA256 object.
+         *  The blocks of the messages are compressed side by side, which keeps the execution
+         *  units busy where hashing a single message is bound by the latency of the rounds.
+         */
+        static void Input(const uint8_t count, SHA256* const hashes[], const uint8_t* const messages[], const uint64_t lengths[]);
+
+        /*
+         *  The intermediate state, to continue hashing a message at a later moment, e.g. after a restart.
+         */
+        inline const Context& State() const
+        {
+            return (_context);
+        }
+        inline void State(const Context& context)
+        {
+            _context = context;
+            _computed = false;
+        }
 
         SHA256& operator<<(const uint8_t message_array[]);
         SHA256& operator<<(const uint8_t message_element);
@@ -334,7 +359,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA224(const uint8_t message_array[], const uint16_t length)
+        inline SHA224(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -361,7 +386,7 @@ namespace Crypto {
         /*
          *  Provide input to SHA224
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         SHA224& operator<<(const uint8_t message_array[]);
         SHA224& operator<<(const uint8_t message_element);
@@ -377,7 +402,7 @@ namespace Crypto {
     class EXTERNAL SHA512 {
     public:
         typedef struct {
-            uint32_t tot_len;
+            uint64_t tot_len;
             uint32_t len;
             uint8_t block[2 * (1024 / 8)];
             uint64_t h[8];
@@ -392,7 +417,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA512(const uint8_t message_array[], const uint16_t length)
+        inline SHA512(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -419,7 +444,7 @@ namespace Crypto {
         /*
          *  Provide input to SHA512
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         SHA512& operator<<(const uint8_t message_array[]);
         SHA512& operator<<(const uint8_t message_element);
@@ -442,7 +467,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA384(const uint8_t message_array[], const uint16_t length)
+        inline SHA384(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -469,7 +494,7 @@ namespace Crypto {
         /*
          *  Provide input to SHA384
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         SHA384& operator<<(const uint8_t message_array[]);
         SHA384& operator<<(const uint8_t message_element);
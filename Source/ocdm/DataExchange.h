@@ -121,6 +121,346 @@ public:
     }
 };
 
+// Next to the DataExchange, which decrypts one sample per round-trip, the OCDM server can offer a
+// DecryptQueue per stream, named <BufferId>.video and <BufferId>.audio. The client fills up to Slots()
+// descriptors, each with its sample, and continues. The server decrypts the samples in place, in the
+// order they were submitted, and the client collects the completions when it needs the clear data.
+// The server creates the queue, the client only uses it if it exists.
+class DecryptQueue : public WPEFramework::Core::DataElementFile {
+private:
+    DecryptQueue() = delete;
+    DecryptQueue(const DecryptQueue&) = delete;
+    DecryptQueue& operator=(const DecryptQueue&) = delete;
+
+    static constexpr uint32_t QueueMagic = 0x4F43444D; // "OCDM"
+
+public:
+    struct Descriptor {
+        uint32_t Ticket;
+        uint32_t Status;
+        uint32_t Length;
+        uint8_t KeyId[17];
+        uint8_t IVLength;
+        uint8_t IV[24];
+        uint16_t SubLength;
+        uint8_t Sub[2048];
+        bool InitWithLast15;
+    };
+
+private:
+    struct Administration {
+        uint32_t Magic;
+        uint32_t Slots;
+        uint32_t SlotSize;
+        uint32_t Stride;
+#ifndef __WIN32__
+        sem_t Submitted;
+        sem_t Completed;
+#endif
+    };
+
+    static uint32_t Align(const uint32_t size)
+    {
+        return (((size + 63) / 64) * 64);
+    }
+
+public:
+    // Client side, opens the queue the server created.
+    DecryptQueue(const string& name)
+        : WPEFramework::Core::DataElementFile(name, READABLE | WRITABLE | SHAREABLE)
+        , _administration(nullptr)
+        , _head(0)
+        , _collect(0)
+        , _release(0)
+        , _allocated(false)
+        , _released()
+    {
+        if ((WPEFramework::Core::DataElementFile::IsValid() == true) && (Size() >= sizeof(Administration))) {
+            Administration* admin = reinterpret_cast<Administration*>(Buffer());
+
+            if ((admin->Magic == QueueMagic) && (Size() >= (Align(sizeof(Administration)) + (admin->Slots * admin->Stride)))) {
+                _administration = admin;
+                _released.resize(admin->Slots, true);
+            }
+        }
+    }
+    // Server side, creates the queue with "slots" descriptors for samples of at most "slotSize" bytes.
+    DecryptQueue(const string& name, const uint16_t slots, const uint32_t slotSize)
+        : WPEFramework::Core::DataElementFile(name, READABLE | WRITABLE | SHAREABLE | CREATE,
+              Align(sizeof(Administration)) + (slots * Align(sizeof(Descriptor) + slotSize)))
+        , _administration(nullptr)
+        , _head(0)
+        , _collect(0)
+        , _release(0)
+        , _allocated(false)
+        , _released()
+    {
+        ASSERT(slots > 0);
+
+        if (WPEFramework::Core::DataElementFile::IsValid() == true) {
+            Administration* admin = reinterpret_cast<Administration*>(Buffer());
+
+            ::memset(admin, 0, Align(sizeof(Administration)));
+
+            admin->Slots = slots;
+            admin->SlotSize = slotSize;
+            admin->Stride = Align(sizeof(Descriptor) + slotSize);
+
+#ifndef __WIN32__
+            sem_init(&(admin->Submitted), 1, 0);
+            sem_init(&(admin->Completed), 1, 0);
+
+            admin->Magic = QueueMagic;
+            _administration = admin;
+#endif
+        }
+    }
+    ~DecryptQueue()
+    {
+    }
+
+public:
+    inline bool IsValid() const
+    {
+        return (_administration != nullptr);
+    }
+    inline uint32_t Slots() const
+    {
+        return (_administration->Slots);
+    }
+    inline uint32_t SlotSize() const
+    {
+        return (_administration->SlotSize);
+    }
+    // Samples submitted, but not collected (client) or not completed (server) yet.
+    inline uint32_t Pending() const
+    {
+        return (_head - _collect);
+    }
+    // The ticket of the sample Collect (client) or Complete (server) handles next.
+    inline uint32_t Oldest() const
+    {
+        return (_collect);
+    }
+
+    // Client side: hand out the data area of the next free slot, so the sample can be written (or
+    // demuxed) into shared memory directly. Submitting that same area does not copy the sample.
+    uint8_t* Allocate(const uint32_t length)
+    {
+        uint8_t* result = nullptr;
+
+        if ((_allocated == false) && ((_head - _release) < _administration->Slots) && (length <= _administration->SlotSize)) {
+            _allocated = true;
+            result = Data(Slot(_head % _administration->Slots));
+        }
+
+        return (result);
+    }
+    inline bool IsAllocated(const uint8_t data[]) const
+    {
+        return ((_allocated == true) && (data == Data(Slot(_head % _administration->Slots))));
+    }
+
+    // Client side: queue a sample. The ticket identifies the completion of this sample. If the data
+    // was not allocated from the queue, it is copied into the next free slot.
+    uint32_t Submit(const uint8_t data[], const uint32_t length,
+        const uint8_t* ivData, const uint16_t ivDataLength,
+        const uint8_t* keyId, const uint16_t keyIdLength,
+        const bool initWithLast15, uint32_t& ticket)
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+        bool inPlace = IsAllocated(data);
+
+        if ((inPlace == true) || ((_allocated == false) && (Allocate(length) != nullptr))) {
+            Descriptor& descriptor = Slot(_head % _administration->Slots);
+
+            ASSERT(length <= _administration->SlotSize);
+
+            ticket = _head;
+
+            descriptor.Ticket = ticket;
+            descriptor.Status = 0;
+            descriptor.Length = std::min(length, _administration->SlotSize);
+            descriptor.KeyId[0] = static_cast<uint8_t>(keyIdLength <= 16 ? keyIdLength : 16);
+            if (descriptor.KeyId[0] != 0) {
+                ::memcpy(&(descriptor.KeyId[1]), keyId, descriptor.KeyId[0]);
+            }
+            descriptor.IVLength = static_cast<uint8_t>(ivDataLength <= sizeof(Descriptor::IV) ? ivDataLength : sizeof(Descriptor::IV));
+            ::memcpy(descriptor.IV, ivData, descriptor.IVLength);
+            ::memset(&(descriptor.IV[descriptor.IVLength]), 0, sizeof(Descriptor::IV) - descriptor.IVLength);
+            descriptor.SubLength = 0;
+            descriptor.InitWithLast15 = initWithLast15;
+
+            if (inPlace == false) {
+                ::memcpy(Data(descriptor), data, descriptor.Length);
+            }
+
+            _released[_head % _administration->Slots] = false;
+            _allocated = false;
+            _head++;
+
+#ifndef __WIN32__
+            sem_post(&(_administration->Submitted));
+#endif
+            result = WPEFramework::Core::ERROR_NONE;
+        }
+
+        return (result);
+    }
+    // Client side: wait for the oldest submitted sample to be decrypted. The clear data is left in
+    // place, in the slot, which stays in use until it is released.
+    const uint8_t* Collect(const uint32_t waitTime, uint32_t& ticket, uint32_t& length, uint32_t& status)
+    {
+        const uint8_t* result = nullptr;
+
+        if ((Pending() > 0) && (Completed(waitTime) == WPEFramework::Core::ERROR_NONE)) {
+            result = Take(ticket, length, status);
+        }
+
+        return (result);
+    }
+    // Client side: the above in two steps, so a client that guards the queue with a lock can wait
+    // without it. Completed waits for one more sample to be decrypted, without touching the
+    // bookkeeping. Each time it succeeds, one Take collects the oldest sample.
+    inline uint32_t Completed(const uint32_t waitTime)
+    {
+        return (Wait(false, waitTime));
+    }
+    const uint8_t* Take(uint32_t& ticket, uint32_t& length, uint32_t& status)
+    {
+        ASSERT(Pending() > 0);
+
+        const Descriptor& descriptor = Slot(_collect % _administration->Slots);
+
+        ticket = descriptor.Ticket;
+        status = descriptor.Status;
+        length = descriptor.Length;
+
+        _collect++;
+
+        return (Data(descriptor));
+    }
+    // Client side: as above, but copy the clear data out and release the slot right away.
+    uint32_t Collect(const uint32_t waitTime, uint32_t& ticket, uint8_t data[], const uint32_t length, uint32_t& status)
+    {
+        uint32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
+        uint32_t decrypted;
+
+        if (Pending() > 0) {
+            const uint8_t* clear = Collect(waitTime, ticket, decrypted, status);
+
+            if (clear == nullptr) {
+                result = WPEFramework::Core::ERROR_TIMEDOUT;
+            } else {
+                if (data != nullptr) {
+                    ::memcpy(data, clear, std::min(length, decrypted));
+                }
+                Release(ticket);
+
+                result = WPEFramework::Core::ERROR_NONE;
+            }
+        }
+
+        return (result);
+    }
+    // Client side: the sample with this ticket was collected, but not released yet.
+    inline bool IsHeld(const uint32_t ticket) const
+    {
+        return (((ticket - _release) < (_collect - _release)) && (_released[ticket % _administration->Slots] == false));
+    }
+    // Client side: the collected sample with this ticket is no longer used. Slots are reused in order,
+    // so a slot only becomes available once all older samples are released as well.
+    void Release(const uint32_t ticket)
+    {
+        ASSERT(IsHeld(ticket) == true);
+
+        _released[ticket % _administration->Slots] = true;
+
+        while ((_release != _collect) && (_released[_release % _administration->Slots] == true)) {
+            _release++;
+        }
+    }
+
+    // Server side: wait for the next sample to decrypt. It is decrypted in place, in Data(descriptor).
+    Descriptor* Receive(const uint32_t waitTime)
+    {
+        Descriptor* result = nullptr;
+
+        if (Wait(true, waitTime) == WPEFramework::Core::ERROR_NONE) {
+            result = &Slot(_head % _administration->Slots);
+            _head++;
+        }
+
+        return (result);
+    }
+    // Server side: hand the oldest received sample back to the client.
+    void Complete(const uint32_t status)
+    {
+        ASSERT(Pending() > 0);
+
+        Slot(_collect % _administration->Slots).Status = status;
+
+        _collect++;
+
+#ifndef __WIN32__
+        sem_post(&(_administration->Completed));
+#endif
+    }
+
+    inline uint8_t* Data(Descriptor& descriptor)
+    {
+        return (&(reinterpret_cast<uint8_t*>(&descriptor)[sizeof(Descriptor)]));
+    }
+    inline const uint8_t* Data(const Descriptor& descriptor) const
+    {
+        return (&(reinterpret_cast<const uint8_t*>(&descriptor)[sizeof(Descriptor)]));
+    }
+
+private:
+    inline Descriptor& Slot(const uint32_t index)
+    {
+        return (*reinterpret_cast<Descriptor*>(&(Buffer()[Align(sizeof(Administration)) + (index * _administration->Stride)])));
+    }
+    inline const Descriptor& Slot(const uint32_t index) const
+    {
+        return (*reinterpret_cast<const Descriptor*>(&(Buffer()[Align(sizeof(Administration)) + (index * _administration->Stride)])));
+    }
+    uint32_t Wait(const bool submitted, const uint32_t waitTime)
+    {
+#ifdef __WIN32__
+        // The queue is never valid on Windows, there is no process shared semaphore in the administration.
+        return (WPEFramework::Core::ERROR_UNAVAILABLE);
+#else
+        sem_t& semaphore(submitted == true ? _administration->Submitted : _administration->Completed);
+        int result;
+
+        if (waitTime == WPEFramework::Core::infinite) {
+            while (((result = sem_wait(&semaphore)) != 0) && (errno == EINTR)) {
+            }
+        } else {
+            struct timespec structTime;
+
+            clock_gettime(CLOCK_REALTIME, &structTime);
+            structTime.tv_nsec += ((waitTime % 1000) * 1000 * 1000);
+            structTime.tv_sec += (waitTime / 1000) + (structTime.tv_nsec / 1000000000);
+            structTime.tv_nsec = structTime.tv_nsec % 1000000000;
+
+            result = sem_timedwait(&semaphore, &structTime);
+        }
+
+        return (result == 0 ? WPEFramework::Core::ERROR_NONE : WPEFramework::Core::ERROR_TIMEDOUT);
+#endif
+    }
+
+private:
+    Administration* _administration;
+    uint32_t _head;
+    uint32_t _collect;
+    uint32_t _release;
+    bool _allocated;
+    std::vector<bool> _released;
+};
+
 } // namespace OCDM
 
 #endif // __DATAEXCHANGE_H
@@ -659,3 +659,63 @@ OpenCDMError opencdm_session_decrypt(struct OpenCDMSession* session,
     return (result);
 }
 
+OpenCDMError opencdm_session_decrypt_allocate(struct OpenCDMSession* session,
+    const StreamType stream,
+    const uint32_t length,
+    uint8_t** buffer)
+{
+    OpenCDMError result(ERROR_INVALID_SESSION);
+
+    if ((session != nullptr) && (buffer != nullptr)) {
+        result = static_cast<OpenCDMError>(session->Allocate(stream, length, *buffer));
+    }
+
+    return (result);
+}
+
+OpenCDMError opencdm_session_decrypt_submit(struct OpenCDMSession* session,
+    const StreamType stream,
+    uint8_t encrypted[],
+    const uint32_t encryptedLength,
+    const uint8_t* IV, uint16_t IVLength,
+    const uint8_t* keyId, const uint16_t keyIdLength,
+    uint32_t initWithLast15,
+    uint32_t* ticket)
+{
+    OpenCDMError result(ERROR_INVALID_SESSION);
+
+    if ((session != nullptr) && (ticket != nullptr)) {
+        result = static_cast<OpenCDMError>(session->Submit(
+            stream, encrypted, encryptedLength, IV, IVLength, keyId, keyIdLength, initWithLast15, *ticket));
+    }
+
+    return (result);
+}
+
+OpenCDMError opencdm_session_decrypt_collect(struct OpenCDMSession* session,
+    const StreamType stream,
+    const uint32_t waitTime,
+    uint32_t* ticket,
+    uint32_t* status)
+{
+    OpenCDMError result(ERROR_INVALID_SESSION);
+
+    if ((session != nullptr) && (ticket != nullptr) && (status != nullptr)) {
+        result = static_cast<OpenCDMError>(session->Collect(stream, waitTime, *ticket, *status));
+    }
+
+    return (result);
+}
+
+OpenCDMError opencdm_session_decrypt_release(struct OpenCDMSession* session,
+    const StreamType stream,
+    const uint32_t ticket)
+{
+    OpenCDMError result(ERROR_INVALID_SESSION);
+
+    if (session != nullptr) {
+        result = static_cast<OpenCDMError>(session->Release(stream, ticket));
+    }
+
+    return (result);
+}
@@ -211,9 +211,19 @@ typedef enum {
     ERROR_INVALID_ACCESSOR = 0x80000001,
     ERROR_KEYSYSTEM_NOT_SUPPORTED = 0x80000002,
     ERROR_INVALID_SESSION = 0x80000003,
-    ERROR_INVALID_DECRYPT_BUFFER = 0x80000004
+    ERROR_INVALID_DECRYPT_BUFFER = 0x80000004,
+    ERROR_QUEUE_FULL = 0x80000005,
+    ERROR_QUEUE_EMPTY = 0x80000006
 } OpenCDMError;
 
+/**
+ * Stream a sample belongs to, each stream has its own decrypt queue.
+ */
+typedef enum {
+    VideoStream = 0,
+    AudioStream
+} StreamType;
+
 /**
  * Registered callbacks with OCDM sessions.
  */
@@ -488,6 +498,88 @@ OpenCDMError opencdm_session_decrypt(struct OpenCDMSession* session,
     uint32_t initWithLast15);
 #endif // __cplusplus
 
+/**
+ * \brief Allocates a sample buffer in the memory shared with the OCDM server.
+ *
+ * A sample written into this buffer and submitted with
+ * \ref opencdm_session_decrypt_submit is decrypted in place, it is not copied
+ * on submission nor on collection. After collection, the clear data can be
+ * used from this buffer until \ref opencdm_session_decrypt_release is called.
+ * Only one buffer per stream can be allocated and not yet submitted.
+ * \param session \ref OpenCDMSession instance.
+ * \param stream The stream the sample belongs to.
+ * \param length Size of the sample (in bytes).
+ * \param buffer The allocated buffer.
+ * \return Zero on success, ERROR_QUEUE_FULL if all buffers are in use and
+ * ERROR_INVALID_DECRYPT_BUFFER if the server offers no shared buffers for this
+ * stream or they are too small.
+ */
+OpenCDMError opencdm_session_decrypt_allocate(struct OpenCDMSession* session,
+    const StreamType stream,
+    const uint32_t length,
+    uint8_t** buffer);
+
+/**
+ * \brief Queues a sample for decryption, without waiting for the result.
+ *
+ * Up to the number of slots the OCDM server offers per stream, samples can be
+ * submitted before the first one is collected, so the client and the server
+ * work in parallel. The samples are decrypted in the order they are submitted.
+ * If the server offers no queue for this stream, the sample is decrypted
+ * before this call returns and its completion is queued.
+ * \param session \ref OpenCDMSession instance.
+ * \param stream The stream the sample belongs to.
+ * \param encrypted Buffer containing encrypted data. It must stay valid until
+ * the sample is collected, the decrypted data will be stored here. If it was
+ * allocated with \ref opencdm_session_decrypt_allocate, it is not copied.
+ * \param encryptedLength Length of encrypted data buffer (in bytes).
+ * \param IV Initial vector (IV) used during decryption.
+ * \param IVLength Length of IV buffer (in bytes).
+ * \param keyID keyID to use for decryption
+ * \param keyIDLength Length of keyID buffer (in bytes).
+ * \param initWithLast15 Whether decryption context needs to be initialized with
+ * last 15 bytes.
+ * \param ticket Identifies the sample when it is collected.
+ * \return Zero on success, ERROR_QUEUE_FULL if the oldest sample needs to be
+ * collected first and ERROR_INVALID_DECRYPT_BUFFER if the sample does not fit
+ * the buffers of this stream (use opencdm_session_decrypt for it).
+ */
+OpenCDMError opencdm_session_decrypt_submit(struct OpenCDMSession* session,
+    const StreamType stream,
+    uint8_t encrypted[],
+    const uint32_t encryptedLength,
+    const uint8_t* IV, uint16_t IVLength,
+    const uint8_t* keyId, const uint16_t keyIdLength,
+    uint32_t initWithLast15,
+    uint32_t* ticket);
+
+/**
+ * \brief Waits for the oldest submitted sample of a stream to be decrypted.
+ * \param session \ref OpenCDMSession instance.
+ * \param stream The stream the sample belongs to.
+ * \param waitTime Time to wait for the decryption to complete (in milliseconds).
+ * \param ticket The ticket of the collected sample.
+ * \param status Result of the decryption of that sample, zero on success.
+ * \return Zero on success, ERROR_QUEUE_EMPTY if no sample completed in time.
+ */
+OpenCDMError opencdm_session_decrypt_collect(struct OpenCDMSession* session,
+    const StreamType stream,
+    const uint32_t waitTime,
+    uint32_t* ticket,
+    uint32_t* status);
+
+/**
+ * \brief Returns the buffer of a collected, in place decrypted, sample.
+ * \param session \ref OpenCDMSession instance.
+ * \param stream The stream the sample belongs to.
+ * \param ticket The ticket of the sample.
+ * \return Zero on success, ERROR_INVALID_DECRYPT_BUFFER if the ticket does not
+ * refer to a collected sample in an allocated buffer.
+ */
+OpenCDMError opencdm_session_decrypt_release(struct OpenCDMSession* session,
+    const StreamType stream,
+    const uint32_t ticket);
+
 #ifdef __cplusplus
 }
 #endif
@@ -636,6 +636,174 @@ private:
         bool _busy;
     };
 
+    // One per stream, so audio and video samples do not wait for each other. If the server did not
+    // create the queue for this stream, the samples are decrypted synchronously through the
+    // DataExchange while submitting, and only their completions are queued here.
+    class DecryptQueue : public OCDM::DecryptQueue {
+    private:
+        DecryptQueue() = delete;
+        DecryptQueue(const DecryptQueue&) = delete;
+        DecryptQueue& operator=(DecryptQueue&) = delete;
+
+        struct Completion {
+            uint32_t Ticket;
+            uint32_t Status;
+        };
+
+    public:
+        DecryptQueue(const string& bufferName)
+            : OCDM::DecryptQueue(bufferName)
+            , _lock()
+            , _destinations(OCDM::DecryptQueue::IsValid() == true ? Slots() : 0, nullptr)
+            , _completions()
+            , _tickets(0)
+        {
+            TRACE_L1("Decrypt queue %s: %s", bufferName.c_str(), (OCDM::DecryptQueue::IsValid() == true ? _T("pipelined") : _T("synchronous")));
+        }
+        ~DecryptQueue()
+        {
+            if ((OCDM::DecryptQueue::IsValid() == true) && (Pending() > 0)) {
+                TRACE_L1("Destructed a DecryptQueue with %d samples in progress. %p", Pending(), this);
+
+                // The server writes into these slots, so wait for it to finish before unmapping.
+                uint32_t ticket, status;
+                while ((Pending() > 0) && (OCDM::DecryptQueue::Collect(1000, ticket, nullptr, 0, status) == Core::ERROR_NONE)) {
+                }
+            }
+        }
+
+    public:
+        uint32_t Submit(DataExchange& exchange, uint8_t* encryptedData, uint32_t encryptedDataLength,
+            const uint8_t* ivData, uint16_t ivDataLength,
+            const uint8_t* keyId, uint16_t keyIdLength,
+            uint32_t initWithLast15, uint32_t& ticket)
+        {
+            uint32_t result = Core::ERROR_NONE;
+
+            _lock.Lock();
+
+            if (OCDM::DecryptQueue::IsValid() == false) {
+                Completion completion;
+
+                completion.Ticket = _tickets++;
+                completion.Status = exchange.Decrypt(encryptedData, encryptedDataLength, ivData, ivDataLength, keyId, keyIdLength, initWithLast15);
+                _completions.push_back(completion);
+
+                ticket = completion.Ticket;
+            } else if ((IsAllocated(encryptedData) == false) && (encryptedDataLength > SlotSize())) {
+                // A sample that does not fit a slot will never fit, retrying does not help.
+                result = Core::ERROR_INVALID_INPUT_LENGTH;
+            } else {
+                // Samples allocated from the queue are decrypted in place, there is nothing to copy back.
+                uint8_t* destination = (IsAllocated(encryptedData) == true ? nullptr : encryptedData);
+
+                if (OCDM::DecryptQueue::Submit(encryptedData, encryptedDataLength, ivData, ivDataLength, keyId, keyIdLength, (initWithLast15 != 0), ticket) == Core::ERROR_NONE) {
+                    _destinations[ticket % _destinations.size()] = destination;
+                } else {
+                    // All slots are in use, the oldest samples need to be collected (or released) first.
+                    result = Core::ERROR_INPROGRESS;
+                }
+            }
+
+            _lock.Unlock();
+
+            return (result);
+        }
+        uint32_t Collect(const uint32_t waitTime, uint32_t& ticket, uint32_t& status)
+        {
+            uint32_t result = Core::ERROR_UNAVAILABLE;
+            bool pending = false;
+
+            _lock.Lock();
+
+            if (OCDM::DecryptQueue::IsValid() == false) {
+                if (_completions.empty() == false) {
+                    ticket = _completions.front().Ticket;
+                    status = _completions.front().Status;
+                    _completions.pop_front();
+                    result = Core::ERROR_NONE;
+                }
+            } else {
+                pending = (Pending() > 0);
+            }
+
+            _lock.Unlock();
+
+            // The wait is the only part that takes long, Submit, Allocate and Release go on meanwhile.
+            if (pending == true) {
+                if (OCDM::DecryptQueue::Completed(waitTime) != Core::ERROR_NONE) {
+                    result = Core::ERROR_TIMEDOUT;
+                } else {
+                    const uint8_t* clear;
+                    uint8_t* destination;
+                    uint32_t length;
+
+                    _lock.Lock();
+
+                    // Completions come in submission order, so the oldest ticket tells where the clear data goes.
+                    destination = _destinations[Oldest() % _destinations.size()];
+                    clear = OCDM::DecryptQueue::Take(ticket, length, status);
+
+                    _lock.Unlock();
+
+                    // If there is no destination, the clear data stays where the caller wrote the encrypted
+                    // sample, until Release. Otherwise the slot is ours until we release it, so it is copied
+                    // out without the lock as well.
+                    if (destination != nullptr) {
+                        ::memcpy(destination, clear, std::min(length, SlotSize()));
+
+                        _lock.Lock();
+                        OCDM::DecryptQueue::Release(ticket);
+                        _lock.Unlock();
+                    }
+
+                    result = Core::ERROR_NONE;
+                }
+            }
+
+            return (result);
+        }
+
+        uint32_t Allocate(const uint32_t length, uint8_t*& buffer)
+        {
+            uint32_t result = Core::ERROR_UNAVAILABLE;
+
+            _lock.Lock();
+
+            // A sample that does not fit will never fit, a full queue only needs samples to be collected or released.
+            if ((OCDM::DecryptQueue::IsValid() == true) && (length <= SlotSize())) {
+                buffer = OCDM::DecryptQueue::Allocate(length);
+                result = (buffer != nullptr ? Core::ERROR_NONE : Core::ERROR_INPROGRESS);
+            }
+
+            _lock.Unlock();
+
+            return (result);
+        }
+        uint32_t Release(const uint32_t ticket)
+        {
+            uint32_t result = Core::ERROR_UNAVAILABLE;
+
+            _lock.Lock();
+
+            // Only samples that were allocated from the queue are held after they are collected.
+            if ((OCDM::DecryptQueue::IsValid() == true) && (IsHeld(ticket) == true) && (_destinations[ticket % _destinations.size()] == nullptr)) {
+                OCDM::DecryptQueue::Release(ticket);
+                result = Core::ERROR_NONE;
+            }
+
+            _lock.Unlock();
+
+            return (result);
+        }
+
+    private:
+        Core::CriticalSection _lock;
+        std::vector<uint8_t*> _destinations;
+        std::list<Completion> _completions;
+        uint32_t _tickets;
+    };
+
 public:
     OpenCDMSession()
         : _sessionId()
@@ -643,7 +811,11 @@ public:
         , _sessionExt(nullptr)
         , _decryptSession(nullptr)
         , _refCount(1)
+        , _queueLock()
     {
+        _queues[VideoStream] = nullptr;
+        _queues[AudioStream] = nullptr;
+
         TRACE_L1("Constructing the Session Client side: %p, (nil)", this);
     }
     explicit OpenCDMSession(OCDM::ISession* session)
@@ -652,7 +824,10 @@ public:
         , _sessionExt(nullptr)
         , _decryptSession(new DataExchange(_session->BufferId()))
         , _refCount(1)
+        , _queueLock()
     {
+        _queues[VideoStream] = nullptr;
+        _queues[AudioStream] = nullptr;
 
         ASSERT(session != nullptr);
 
@@ -662,6 +837,8 @@ public:
     }
     virtual ~OpenCDMSession()
     {
+        CloseQueues();
+
         if (_session != nullptr) {
             _session->Release();
         }
@@ -739,6 +916,63 @@ public:
         }
         return (result);
     }
+    uint32_t Submit(const StreamType stream, uint8_t* encryptedData, const uint32_t encryptedDataLength,
+        const uint8_t* ivData, uint16_t ivDataLength,
+        const uint8_t* keyId, const uint16_t keyIdLength,
+        uint32_t initWithLast15, uint32_t& ticket)
+    {
+        uint32_t result = OpenCDMError::ERROR_INVALID_DECRYPT_BUFFER;
+
+        if (_decryptSession != nullptr) {
+            uint32_t outcome = Queue(stream).Submit(*_decryptSession, encryptedData, encryptedDataLength, ivData, ivDataLength, keyId, keyIdLength, initWithLast15, ticket);
+
+            if (outcome == Core::ERROR_NONE) {
+                result = OpenCDMError::ERROR_NONE;
+            } else if (outcome == Core::ERROR_INPROGRESS) {
+                result = OpenCDMError::ERROR_QUEUE_FULL;
+            }
+        }
+        return (result);
+    }
+    uint32_t Collect(const StreamType stream, const uint32_t waitTime, uint32_t& ticket, uint32_t& status)
+    {
+        uint32_t result = OpenCDMError::ERROR_INVALID_DECRYPT_BUFFER;
+
+        if (_decryptSession != nullptr) {
+            if (Queue(stream).Collect(waitTime, ticket, status) == Core::ERROR_NONE) {
+                result = OpenCDMError::ERROR_NONE;
+            } else {
+                result = OpenCDMError::ERROR_QUEUE_EMPTY;
+            }
+        }
+        return (result);
+    }
+    uint32_t Allocate(const StreamType stream, const uint32_t length, uint8_t*& buffer)
+    {
+        uint32_t result = OpenCDMError::ERROR_INVALID_DECRYPT_BUFFER;
+
+        buffer = nullptr;
+
+        if (_decryptSession != nullptr) {
+            uint32_t outcome = Queue(stream).Allocate(length, buffer);
+
+            if (outcome == Core::ERROR_NONE) {
+                result = OpenCDMError::ERROR_NONE;
+            } else if (outcome == Core::ERROR_INPROGRESS) {
+                result = OpenCDMError::ERROR_QUEUE_FULL;
+            }
+        }
+        return (result);
+    }
+    uint32_t Release(const StreamType stream, const uint32_t ticket)
+    {
+        uint32_t result = OpenCDMError::ERROR_INVALID_DECRYPT_BUFFER;
+
+        if ((_decryptSession != nullptr) && (Queue(stream).Release(ticket) == Core::ERROR_NONE)) {
+            result = OpenCDMError::ERROR_NONE;
+        }
+        return (result);
+    }
     inline void Revoke(OCDM::ISession::ICallback* callback)
     {
 
@@ -748,6 +982,39 @@ public:
         return (_session->Revoke(callback));
     }
 
+private:
+    DecryptQueue& Queue(const StreamType stream)
+    {
+        ASSERT(_decryptSession != nullptr);
+        ASSERT(stream <= AudioStream);
+
+        // The first calls for a stream might come from different threads, only one of them opens the queue.
+        _queueLock.Lock();
+
+        if (_queues[stream] == nullptr) {
+            _queues[stream] = new DecryptQueue(_decryptSession->Name() + (stream == AudioStream ? _T(".audio") : _T(".video")));
+        }
+
+        DecryptQueue& result(*(_queues[stream]));
+
+        _queueLock.Unlock();
+
+        return (result);
+    }
+    void CloseQueues()
+    {
+        _queueLock.Lock();
+
+        for (uint8_t index = 0; index < (sizeof(_queues) / sizeof(_queues[0])); index++) {
+            if (_queues[index] != nullptr) {
+                delete _queues[index];
+                _queues[index] = nullptr;
+            }
+        }
+
+        _queueLock.Unlock();
+    }
+
 protected:
     void Session(OCDM::ISession* session)
     {
@@ -761,6 +1028,7 @@ protected:
         if (_session != nullptr) {
             _decryptSession = new DataExchange(_session->BufferId());
         } else {
+            CloseQueues();
             delete _decryptSession;
             _decryptSession = nullptr;
         }
@@ -778,6 +1046,7 @@ protected:
         if (_sessionExt != nullptr) {
             _decryptSession = new DataExchange(_sessionExt->BufferIdExt());
         } else {
+            CloseQueues();
             delete _decryptSession;
             _decryptSession = nullptr;
         }
@@ -795,4 +1064,6 @@ protected:
 
 private:
     uint32_t _refCount;
+    Core::CriticalSection _queueLock;
+    DecryptQueue* _queues[2];
 };
@@ -112,6 +112,7 @@ namespace PluginHost {
         Core::JSONRPC::Handler& CreateHandler(const std::vector<uint8_t>& versions)
         {
             _handlers.emplace_back([&](const uint32_t id, const string& designator, const string& data) { Notify(id, designator, data); }, versions);
+            _handlers.back().Instrumentation(_handlers.front().IsInstrumented());
             return (_handlers.back());
         }
         Core::JSONRPC::Handler& CreateHandler(const std::vector<uint8_t>& versions, const Core::JSONRPC::Handler& source)
@@ -136,6 +137,33 @@ namespace PluginHost {
 			return (result);
         }
 
+        //
+        // Per method call counts, errors, payload sizes and latencies. Methods with the same name in different versions are
+        // reported as one. Recording is off until the instrumentation is switched on.
+        // ------------------------------------------------------------------------------------------------------------------------------
+        void Instrumentation(const bool enabled)
+        {
+            for (Core::JSONRPC::Handler& handler : _handlers) {
+                handler.Instrumentation(enabled);
+            }
+        }
+        bool IsInstrumented() const
+        {
+            return (_handlers.front().IsInstrumented());
+        }
+        void Statistics(Core::JSONRPC::Handler::Reports& reports) const
+        {
+            for (const Core::JSONRPC::Handler& handler : _handlers) {
+                handler.Statistics(reports);
+            }
+        }
+        void ResetStatistics()
+        {
+            for (Core::JSONRPC::Handler& handler : _handlers) {
+                handler.ResetStatistics();
+            }
+        }
+
         //
         // Register/Unregister methods for incoming method handling on the "base" handler elements.
         // ------------------------------------------------------------------------------------------------------------------------------
@@ -202,11 +202,113 @@ ENUM_CONVERSION_BEGIN(PluginHost::MetaData::Channel::state)
     {
     }
 
+    MetaData::Percentiles::Percentiles()
+        : Core::JSON::Container()
+    {
+        Add(_T("count"), &Count);
+        Add(_T("minimum"), &Minimum);
+        Add(_T("maximum"), &Maximum);
+        Add(_T("average"), &Average);
+        Add(_T("p50"), &P50);
+        Add(_T("p90"), &P90);
+        Add(_T("p99"), &P99);
+        Add(_T("p999"), &P999);
+    }
+    MetaData::Percentiles::Percentiles(const MetaData::Percentiles& copy)
+        : Core::JSON::Container()
+        , Count(copy.Count)
+        , Minimum(copy.Minimum)
+        , Maximum(copy.Maximum)
+        , Average(copy.Average)
+        , P50(copy.P50)
+        , P90(copy.P90)
+        , P99(copy.P99)
+        , P999(copy.P999)
+    {
+        Add(_T("count"), &Count);
+        Add(_T("minimum"), &Minimum);
+        Add(_T("maximum"), &Maximum);
+        Add(_T("average"), &Average);
+        Add(_T("p50"), &P50);
+        Add(_T("p90"), &P90);
+        Add(_T("p99"), &P99);
+        Add(_T("p999"), &P999);
+    }
+    MetaData::Percentiles::~Percentiles()
+    {
+    }
+
+    MetaData::Percentiles& MetaData::Percentiles::operator=(const Core::Histogram::Snapshot& RHS)
+    {
+        Count = RHS.Count();
+        Minimum = RHS.Min();
+        Maximum = RHS.Max();
+        Average = RHS.Average();
+        P50 = RHS.Percentile(50.0);
+        P90 = RHS.Percentile(90.0);
+        P99 = RHS.Percentile(99.0);
+        P999 = RHS.Percentile(99.9);
+
+        return (*this);
+    }
+
+    MetaData::Method::Method()
+        : Core::JSON::Container()
+    {
+        Add(_T("name"), &Name);
+        Add(_T("calls"), &Calls);
+        Add(_T("errors"), &Errors);
+        Add(_T("received"), &Received);
+        Add(_T("sent"), &Sent);
+        Add(_T("latency"), &Latency);
+    }
+    MetaData::Method::Method(const MetaData::Method& copy)
+        : Core::JSON::Container()
+        , Name(copy.Name)
+        , Calls(copy.Calls)
+        , Errors(copy.Errors)
+        , Received(copy.Received)
+        , Sent(copy.Sent)
+        , Latency(copy.Latency)
+    {
+        Add(_T("name"), &Name);
+        Add(_T("calls"), &Calls);
+        Add(_T("errors"), &Errors);
+        Add(_T("received"), &Received);
+        Add(_T("sent"), &Sent);
+        Add(_T("latency"), &Latency);
+    }
+    MetaData::Method::~Method()
+    {
+    }
+
+    MetaData::Method& MetaData::Method::operator=(const Core::JSONRPC::Handler::Report& RHS)
+    {
+        Calls = RHS.Calls();
+        Errors = RHS.Errors();
+        Received = RHS.Received();
+        Sent = RHS.Sent();
+        Latency = RHS.Latency();
+
+        return (*this);
+    }
+
     MetaData::Server::Server()
     {
         Core::JSON::Container::Add(_T("threads"), &ThreadPoolRuns);
         Core::JSON::Container::Add(_T("pending"), &PendingRequests);
         Core::JSON::Container::Add(_T("occupation"), &PoolOccupation);
+        Core::JSON::Container::Add(_T("minimum"), &Minimum);
+        Core::JSON::Container::Add(_T("maximum"), &Maximum);
+        Core::JSON::Container::Add(_T("peak"), &Peak);
+        Core::JSON::Container::Add(_T("created"), &Created);
+        Core::JSON::Container::Add(_T("reaped"), &Reaped);
+        Core::JSON::Container::Add(_T("utilization"), &Utilization);
+        Core::JSON::Container::Add(_T("queuewait"), &QueueWait);
+        Core::JSON::Container::Add(_T("waittime"), &WaitTime);
+        Core::JSON::Container::Add(_T("runtime"), &RunTime);
+        Core::JSON::Container::Add(_T("comrpc"), &COMRPC);
+        Core::JSON::Container::Add(_T("jsonrpc"), &JSONRPC);
     }
     MetaData::Server::~Server()
     {
@@ -132,6 +132,50 @@ namespace PluginHost {
             Core::JSON::Boolean Secure;
         };
 
+        // Latencies in microseconds, from a Core::Histogram.
+        class EXTERNAL Percentiles : public Core::JSON::Container {
+        private:
+            Percentiles& operator=(const Percentiles&) = delete;
+
+        public:
+            Percentiles();
+            Percentiles(const Percentiles& copy);
+            ~Percentiles();
+
+        public:
+            Percentiles& operator=(const Core::Histogram::Snapshot& RHS);
+
+            Core::JSON::DecUInt64 Count;
+            Core::JSON::DecUInt32 Minimum;
+            Core::JSON::DecUInt32 Maximum;
+            Core::JSON::DecUInt32 Average;
+            Core::JSON::DecUInt32 P50;
+            Core::JSON::DecUInt32 P90;
+            Core::JSON::DecUInt32 P99;
+            Core::JSON::DecUInt32 P999;
+        };
+
+        // Statistics of a single JSON-RPC method, payload sizes are in bytes.
+        class EXTERNAL Method : public Core::JSON::Container {
+        private:
+            Method& operator=(const Method&) = delete;
+
+        public:
+            Method();
+            Method(const Method& copy);
+            ~Method();
+
+        public:
+            Method& operator=(const Core::JSONRPC::Handler::Report& RHS);
+
+            Core::JSON::String Name;
+            Core::JSON::DecUInt64 Calls;
+            Core::JSON::DecUInt64 Errors;
+            Core::JSON::DecUInt64 Received;
+            Core::JSON::DecUInt64 Sent;
+            Percentiles Latency;
+        };
+
         class EXTERNAL Server : public Core::JSON::Container {
         private:
             Server(const Server& copy) = delete;
@@ -144,12 +188,25 @@ namespace PluginHost {
             inline void Clear()
             {
                 ThreadPoolRuns.Clear();
+                QueueWait.Clear();
             }
 
         public:
             Core::JSON::ArrayType<Core::JSON::DecUInt32> ThreadPoolRuns;
             Core::JSON::DecUInt32 PendingRequests;
             Core::JSON::DecUInt32 PoolOccupation;
+            Core::JSON::DecUInt16 Minimum;
+            Core::JSON::DecUInt16 Maximum;
+            Core::JSON::DecUInt16 Peak;
+            Core::JSON::DecUInt32 Created;
+            Core::JSON::DecUInt32 Reaped;
+            Core::JSON::DecUInt8 Utilization;
+            // Jobs per queue wait bucket, bucket N counts the jobs that waited less than 2^N ms.
+            Core::JSON::ArrayType<Core::JSON::DecUInt32> QueueWait;
+            Percentiles WaitTime;
+            Percentiles RunTime;
+            Percentiles COMRPC;
+            Percentiles JSONRPC;
         };
 
         class EXTERNAL SubSystem : public Core::JSON::Container {
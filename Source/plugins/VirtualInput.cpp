@@ -107,6 +107,8 @@ ENUM_CONVERSION_BEGIN(PluginHost::VirtualInput::KeyMap::modifier)
                 ChangeIterator updated(updatedKeys);
                 _parent.MapChanges(updated);
             }
+
+            _lookup.Build(_keyMap);
         }
 
         return (result);
@@ -177,6 +179,7 @@ ENUM_CONVERSION_BEGIN(PluginHost::VirtualInput::KeyMap::modifier)
         , _modifiers(0)
         , _defaultMap(nullptr)
         , _notifierMap()
+        , _notifierLookup()
         , _pressedCode(0)
         , _repeatCounter(0)
         , _repeatLimit(0)
@@ -219,6 +222,8 @@ ENUM_CONVERSION_BEGIN(PluginHost::VirtualInput::KeyMap::modifier)
 
             notifierList.push_back(callback);
 
+            Compile();
+
             _lock.Unlock();
         }
     }
@@ -264,6 +269,8 @@ ENUM_CONVERSION_BEGIN(PluginHost::VirtualInput::KeyMap::modifier)
                     if (notifierList.empty() == true) {
                         _notifierMap.erase(it);
                     }
+
+                    Compile();
                 }
             }
 
@@ -451,11 +458,10 @@ ENUM_CONVERSION_BEGIN(PluginHost::VirtualInput::KeyMap::modifier)
             element->Dispatch(type, code);
         }
 
-        NotifierMap::iterator it(_notifierMap.find(code));
+        const NotifierList* const* notifierList(_notifierLookup.Find(code));
 
-        if (it != _notifierMap.end()) {
-            const NotifierList& notifierList = it->second;
-            for (INotifier* element : notifierList) {
+        if (notifierList != nullptr) {
+            for (INotifier* element : **notifierList) {
                 element->Dispatch(type, code);
             }
         }
@@ -463,6 +469,12 @@ ENUM_CONVERSION_BEGIN(PluginHost::VirtualInput::KeyMap::modifier)
         _lock.Unlock();
     }
 
+    void VirtualInput::Compile()
+    {
+        // The lists themselves stay in the map, their addresses do not change as long as they are in there.
+        _notifierLookup.Build(_notifierMap, [](const NotifierList& list) -> const NotifierList* { return (&list); });
+    }
+
 #if !defined(__WIN32__) && !defined(__APPLE__)
 
     LinuxKeyboardInput::LinuxKeyboardInput(const string& source, const string& inputName)
@@ -614,17 +626,47 @@ ENUM_CONVERSION_BEGIN(PluginHost::VirtualInput::KeyMap::modifier)
 
     IPCKeyboardInput::IPCKeyboardInput(const Core::NodeId& sourceName)
         : _service(*this, sourceName)
+        , _source(sourceName.Type() == Core::NodeId::TYPE_DOMAIN ? sourceName.HostName() : string())
+        , _ring(nullptr)
+        , _sequence(0)
     {
         TRACE_L1("Constructing IPCKeyboardInput for %s on %s", sourceName.HostAddress().c_str(), sourceName.HostName().c_str());
+
+        // The ring lives next to the socket, so only clients on this host can find it.
+        if (sourceName.Type() == Core::NodeId::TYPE_DOMAIN) {
+            _ring = new Core::SharedEventRing(sourceName.HostName() + _T(".ring"), RingEvents, sizeof(KeyData));
+
+            if (_ring->IsValid() == false) {
+                delete _ring;
+                _ring = nullptr;
+            }
+        }
     }
 
     /* virtual */ IPCKeyboardInput::~IPCKeyboardInput()
     {
+        if (_ring != nullptr) {
+            Core::File(_ring->Name()).Destroy();
+            delete _ring;
+        }
     }
 
     /* virtual */ uint32_t IPCKeyboardInput::Open()
     {
-        return (_service.Open(2000));
+        uint32_t result = _service.Open(2000);
+
+#ifndef __WIN32__
+        // Whoever may connect to the socket, may read the keys from the ring, and nobody else.
+        if ((result == Core::ERROR_NONE) && (_ring != nullptr)) {
+            struct stat properties;
+
+            if ((::stat(_source.c_str(), &properties) != 0) || (::chmod(_ring->Name().c_str(), properties.st_mode & (S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)) != 0)) {
+                TRACE_L1("Could not give the ring %s the permissions of the socket. Error %d", _ring->Name().c_str(), errno);
+            }
+        }
+#endif
+
+        return (result);
     }
 
     /* virtual */ uint32_t IPCKeyboardInput::Close()
@@ -640,6 +682,12 @@ ENUM_CONVERSION_BEGIN(PluginHost::VirtualInput::KeyMap::modifier)
         message->Parameters().Action = type;
         message->Parameters().Code = code;
 
+        // Clients on the ring pick it up from there, without us waiting for them.
+        if (_ring != nullptr) {
+            _sequence = _ring->Produced();
+            _ring->Produce(reinterpret_cast<const uint8_t*>(&(message->Parameters())), sizeof(KeyData));
+        }
+
         Core::ProxyType<Core::IIPC> base(Core::proxy_cast<Core::IIPC>(message));
 
         TRACE_L1("Sending keycode to all clients: %d", code);
@@ -652,11 +700,12 @@ ENUM_CONVERSION_BEGIN(PluginHost::VirtualInput::KeyMap::modifier)
     {
 
         uint16_t index = 0;
-        Core::ProxyType<KeyboardLink> current(_service[index++]);
+        Core::ProxyType<VirtualInputChannelServer::Client> current(_service[index++]);
 
+        // The link is the extension of the channel, not a base of it.
         while (current.IsValid() == true) {
-            if (current->Name() == linkName) {
-                current->Reload();
+            if (current->Extension().Name() == linkName) {
+                current->Extension().Reload();
             }
             current = _service[index++];
         }
@@ -90,6 +90,107 @@ namespace PluginHost {
             RIGHTCTRL = 20 // 20..23 bits are for RightCtrl reference counting (max 15)
         };
 
+        // The lookups done on every key press (key map, post lookup, notifiers) are compiled into this
+        // table whenever their source changes. It is a single array with open addressing, so finding a
+        // code takes a few probes and never allocates. The new table is built aside and swapped in.
+        template <typename VALUE>
+        class FlatLookupType {
+        private:
+            FlatLookupType(const FlatLookupType<VALUE>&) = delete;
+            FlatLookupType<VALUE>& operator=(const FlatLookupType<VALUE>&) = delete;
+
+            struct Entry {
+                uint32_t Key;
+                bool Used;
+                VALUE Value;
+            };
+
+        public:
+            FlatLookupType()
+                : _shift(32)
+                , _count(0)
+                , _entries()
+            {
+            }
+            FlatLookupType(FlatLookupType<VALUE>&&) = default;
+            ~FlatLookupType()
+            {
+            }
+
+        public:
+            inline uint32_t Count() const
+            {
+                return (_count);
+            }
+            inline const VALUE* Find(const uint32_t key) const
+            {
+                const VALUE* result = nullptr;
+
+                if (_count != 0) {
+                    const uint32_t mask = static_cast<uint32_t>(_entries.size() - 1);
+                    uint32_t slot = Hash(key);
+
+                    // There is always at least one unused entry, so this ends.
+                    while ((_entries[slot].Used == true) && (_entries[slot].Key != key)) {
+                        slot = (slot + 1) & mask;
+                    }
+                    if (_entries[slot].Used == true) {
+                        result = &(_entries[slot].Value);
+                    }
+                }
+
+                return (result);
+            }
+            // Takes anything that iterates over pairs of a code and its value, like a std::map.
+            template <typename CONTAINER, typename CONVERTER>
+            void Build(const CONTAINER& source, CONVERTER converter)
+            {
+                uint8_t bits = 1;
+
+                // Keep it at most half full, the probe sequences stay short.
+                while ((static_cast<size_t>(1) << bits) < (source.size() * 2)) {
+                    bits++;
+                }
+
+                std::vector<Entry> entries(static_cast<size_t>(1) << bits);
+                const uint32_t mask = static_cast<uint32_t>(entries.size() - 1);
+
+                _shift = 32 - bits;
+
+                for (const auto& element : source) {
+                    uint32_t slot = Hash(static_cast<uint32_t>(element.first));
+
+                    while (entries[slot].Used == true) {
+                        slot = (slot + 1) & mask;
+                    }
+
+                    entries[slot].Key = static_cast<uint32_t>(element.first);
+                    entries[slot].Used = true;
+                    entries[slot].Value = converter(element.second);
+                }
+
+                _entries.swap(entries);
+                _count = static_cast<uint32_t>(source.size());
+            }
+            template <typename CONTAINER>
+            inline void Build(const CONTAINER& source)
+            {
+                Build(source, [](const VALUE& value) -> VALUE { return (value); });
+            }
+
+        private:
+            inline uint32_t Hash(const uint32_t key) const
+            {
+                // Fibonacci hashing, remote codes tend to differ in the low bits only.
+                return (static_cast<uint32_t>((key * 2654435761U) >> _shift));
+            }
+
+        private:
+            uint8_t _shift;
+            uint32_t _count;
+            std::vector<Entry> _entries;
+        };
+
     public:
         class EXTERNAL KeyMap {
         public:
@@ -157,6 +258,8 @@ namespace PluginHost {
             KeyMap(KeyMap&&) = default;
             KeyMap(VirtualInput& parent)
                 : _parent(parent)
+                , _keyMap()
+                , _lookup()
                 , _passThrough(false)
             {
             }
@@ -191,9 +294,7 @@ namespace PluginHost {
 
             inline const ConversionInfo* operator[](const uint32_t code) const
             {
-                std::map<const uint32_t, const ConversionInfo>::const_iterator index(_keyMap.find(code));
-
-                return (index != _keyMap.end() ? &(index->second) : nullptr);
+                return (_lookup.Find(code));
             }
             inline bool Add(const uint32_t code, const uint16_t key, const uint16_t modifiers)
             {
@@ -206,6 +307,7 @@ namespace PluginHost {
                     element.Modifiers = modifiers;
 
                     _keyMap.insert(std::pair<const uint32_t, const ConversionInfo>(code, element));
+                    _lookup.Build(_keyMap);
                     added = true;
                 }
                 return (added);
@@ -216,20 +318,28 @@ namespace PluginHost {
 
                 if (index != _keyMap.end()) {
                     _keyMap.erase(index);
+                    _lookup.Build(_keyMap);
                 }
             }
 
             inline bool Modify(const uint32_t code, const uint16_t key, const uint16_t modifiers)
             {
-                // Delete if exist
-                Delete(code);
+                ConversionInfo element;
+                element.Code = key;
+                element.Modifiers = modifiers;
 
-                return (Add(code, key, modifiers));
+                // Replace it if it exists, the lookup is only rebuilt once.
+                _keyMap.erase(code);
+                _keyMap.insert(std::pair<const uint32_t, const ConversionInfo>(code, element));
+                _lookup.Build(_keyMap);
+
+                return (true);
             }
 
         private:
             VirtualInput& _parent;
             LookupMap _keyMap;
+            FlatLookupType<ConversionInfo> _lookup;
             bool _passThrough;
         };
 
@@ -245,7 +355,7 @@ namespace PluginHost {
             virtual ~INotifier() {}
             virtual void Dispatch(const actiontype action, const uint32_t code) = 0;
         };
-        typedef std::map<const uint32_t, const uint32_t> PostLookupEntries;
+        typedef FlatLookupType<uint32_t> PostLookupEntries;
 
     private:
         class PostLookupTable : public Core::JSON::Container {
@@ -333,6 +443,7 @@ namespace PluginHost {
         typedef std::map<const string, KeyMap> TableMap;
         typedef std::vector<INotifier*> NotifierList;
         typedef std::map<uint32_t, NotifierList> NotifierMap;
+        typedef FlatLookupType<const NotifierList*> NotifierLookup;
         typedef std::map<const string, PostLookupEntries> PostLookupMap;
 
     public:
@@ -410,17 +521,8 @@ namespace PluginHost {
                 info.FromFile(data);
                 Core::JSON::ArrayType<PostLookupTable::Conversion>::Iterator index(info.Conversions.Elements());
 
-                _lock.Lock();
+                std::map<uint32_t, uint32_t> conversions;
 
-                PostLookupMap::iterator postMap(_postLookupTable.find(linkName));
-                if (postMap != _postLookupTable.end()) {
-                    postMap->second.clear();
-                } else {
-                    auto newElement = _postLookupTable.emplace(std::piecewise_construct,
-                        std::make_tuple(linkName),
-                        std::make_tuple());
-                    postMap = newElement.first;
-                }
                 while (index.Next() == true) {
                     if ((index.Current().In.IsSet() == true) && (index.Current().Out.IsSet() == true)) {
                         uint32_t from = index.Current().In.Code.Value();
@@ -429,12 +531,28 @@ namespace PluginHost {
                         from |= (Modifiers(index.Current().In.Mods) << 16);
                         to |= (Modifiers(index.Current().In.Mods) << 16);
 
-                        postMap->second.insert(std::pair<const uint32_t, const uint32_t>(from, to));
+                        conversions.insert(std::pair<const uint32_t, const uint32_t>(from, to));
                     }
                 }
 
-                if (postMap->second.size() == 0) {
-                    _postLookupTable.erase(postMap);
+                _lock.Lock();
+
+                PostLookupMap::iterator postMap(_postLookupTable.find(linkName));
+
+                if (conversions.size() == 0) {
+                    if (postMap != _postLookupTable.end()) {
+                        _postLookupTable.erase(postMap);
+                    }
+                } else {
+                    if (postMap == _postLookupTable.end()) {
+                        auto newElement = _postLookupTable.emplace(std::piecewise_construct,
+                            std::make_tuple(linkName),
+                            std::make_tuple());
+                        postMap = newElement.first;
+                    }
+
+                    // The links keep pointing to the same entry, it is swapped in as a whole.
+                    postMap->second.Build(conversions);
                 }
 
                 LookupChanges(linkName);
@@ -458,6 +576,7 @@ namespace PluginHost {
         bool SendModifier(const actiontype type, const enumModifier mode);
         void AdministerAndSendKey(const actiontype type, const uint32_t code);
         void DispatchRegisteredKey(const actiontype type, uint32_t code);
+        void Compile();
 
         virtual void SendKey(const actiontype type, const uint32_t code) = 0;
 
@@ -484,6 +603,7 @@ namespace PluginHost {
         KeyMap* _defaultMap;
         NotifierList _notifierList;
         NotifierMap _notifierMap;
+        NotifierLookup _notifierLookup;
         PostLookupMap _postLookupTable;
         string _keyTable;
         uint32_t _pressedCode;
@@ -525,8 +645,33 @@ namespace PluginHost {
             uint32_t Code;
         };
 
+        struct RingData {
+            char Name[128];
+        };
+        struct JoinData {
+            uint64_t Sequence;
+        };
+        struct SequencedKeyData {
+            VirtualInput::actiontype Action;
+            uint32_t Code;
+            uint64_t Sequence;
+        };
+
         typedef Core::IPCMessageType<0, KeyData, Core::Void> KeyMessage;
         typedef Core::IPCMessageType<1, Core::Void, Core::IPC::Text<20>> NameMessage;
+        // Sent by a client that can read the keys from the shared event ring, instead of receiving a
+        // KeyMessage per key. The response is the name of the ring, empty if there is none.
+        typedef Core::IPCMessageType<2, Core::Void, RingData> RingMessage;
+        // The keys for a client that left the ring again, with their sequence number on the ring, so the
+        // client can tell which of them it read from the ring already.
+        typedef Core::IPCMessageType<3, SequencedKeyData, Core::Void> SequencedKeyMessage;
+        // Sent by a client once it opened the ring, the KeyMessages only stop after this. The response is
+        // the sequence number of the first key it has to read from the ring, ~0 if it stays on the
+        // KeyMessages. A client that can not open the ring never sends it.
+        typedef Core::IPCMessageType<4, Core::Void, JoinData> JoinMessage;
+
+        // The number of key events a client can fall behind, before it loses keys.
+        static constexpr uint32_t RingEvents = 128;
 
         IPCKeyboardInput(const IPCKeyboardInput&) = delete;
         IPCKeyboardInput& operator=(const IPCKeyboardInput&) = delete;
@@ -539,11 +684,15 @@ namespace PluginHost {
 
         public:
             KeyboardLink(Core::IPCChannelType<Core::SocketPort, KeyboardLink>*)
-                : _enabled(false)
+                : _adminLock()
+                , _enabled(false)
+                , _ring(~0)
+                , _left(~0)
                 , _name()
                 , _parent(nullptr)
                 , _postLookup(nullptr)
                 , _replacement(Core::ProxyType<KeyMessage>::Create())
+                , _sequenced(Core::ProxyType<SequencedKeyMessage>::Create())
             {
             }
             virtual ~KeyboardLink()
@@ -560,24 +709,41 @@ namespace PluginHost {
                 Core::ProxyType<Core::IIPC> result;
 
                 if (_enabled == true) {
-                    if (_postLookup == nullptr) {
-                        result = element;
-                    } else {
-                        KeyMessage& copy(static_cast<KeyMessage&>(*element));
+                    KeyMessage& copy(static_cast<KeyMessage&>(*element));
+                    uint32_t code = copy.Parameters().Code;
+
+                    ASSERT(dynamic_cast<KeyMessage*>(&(*element)) != nullptr);
 
-                        ASSERT(dynamic_cast<KeyMessage*>(&(*element)) != nullptr);
+                    // See if we need to convert this keycode..
+                    if (_postLookup != nullptr) {
+                        const uint32_t* converted(_postLookup->Find(code));
 
-                        // See if we need to convert this keycode..
-                        PostLookupEntries::const_iterator index(_postLookup->find(copy.Parameters().Code));
-                        if (index == _postLookup->end()) {
+                        if (converted != nullptr) {
+                            code = *converted;
+                        }
+                    }
+
+                    // The sequence number of this key on the ring is compared with the moments the client
+                    // joined and left the ring, under the same lock these are taken.
+                    _adminLock.Lock();
+
+                    if ((_ring.load() == static_cast<uint64_t>(~0)) || (_parent->_sequence < _ring.load())) {
+                        // Not on the ring, or produced before the client joined it.
+                        if (code == copy.Parameters().Code) {
                             result = element;
                         } else {
-
                             _replacement->Parameters().Action = copy.Parameters().Action;
-                            _replacement->Parameters().Code = index->second;
+                            _replacement->Parameters().Code = code;
                             result = _replacement;
                         }
+                    } else if (_parent->_sequence >= _left.load()) {
+                        _sequenced->Parameters().Action = copy.Parameters().Action;
+                        _sequenced->Parameters().Code = code;
+                        _sequenced->Parameters().Sequence = _parent->_sequence;
+                        result = _sequenced;
                     }
+
+                    _adminLock.Unlock();
                 }
                 return (result);
             }
@@ -585,6 +751,12 @@ namespace PluginHost {
             {
                 return (_name);
             }
+            // The keys on the ring are not translated, a client with a post lookup table has to receive
+            // them one by one.
+            inline bool IsTranslated() const
+            {
+                return (_postLookup != nullptr);
+            }
             inline void Parent(IPCKeyboardInput& parent)
             {
                 // We assume it will only be set, if the client reports it self in, once !
@@ -594,6 +766,26 @@ namespace PluginHost {
             inline void Reload()
             {
                 _postLookup = _parent->FindPostLookup(_name);
+
+                Translated();
+            }
+            // Returns the sequence number of the first key the client reads from the ring, or ~0 if it
+            // stays on the KeyMessages.
+            inline uint64_t Ring(const Core::SharedEventRing& ring)
+            {
+                uint64_t result = ~0;
+
+                // A client that left the ring, does not come back to it.
+                _adminLock.Lock();
+
+                if ((_postLookup == nullptr) && (_ring.load() == static_cast<uint64_t>(~0))) {
+                    result = ring.Produced();
+                    _ring.store(result);
+                }
+
+                _adminLock.Unlock();
+
+                return (result);
             }
 
         private:
@@ -604,25 +796,136 @@ namespace PluginHost {
                 _name = (static_cast<NameMessage&>(element).Response().Value());
                 _enabled = true;
                 _postLookup = _parent->FindPostLookup(_name);
+
+                Translated();
+            }
+            inline void Translated()
+            {
+                _adminLock.Lock();
+
+                if ((_ring.load() != static_cast<uint64_t>(~0)) && (_left.load() == static_cast<uint64_t>(~0)) && (_postLookup != nullptr)) {
+                    // From here on the keys go out one by one, the client drops the ones it reads from
+                    // the ring with the same or a later sequence number.
+                    TRACE_L1("Keys for %s are translated, moving it off the ring.", _name.c_str());
+                    _left.store(_parent->_ring->Produced());
+                }
+
+                _adminLock.Unlock();
             }
 
         private:
+            mutable Core::CriticalSection _adminLock;
             bool _enabled;
+            std::atomic<uint64_t> _ring;
+            std::atomic<uint64_t> _left;
             string _name;
             IPCKeyboardInput* _parent;
             const PostLookupEntries* _postLookup;
             Core::ProxyType<KeyMessage> _replacement;
+            Core::ProxyType<SequencedKeyMessage> _sequenced;
         };
 
         class VirtualInputChannelServer : public Core::IPCChannelServerType<KeyboardLink, true> {
         private:
             typedef Core::IPCChannelServerType<KeyboardLink, true> BaseClass;
 
+            class RingHandler : public Core::IPCServerType<RingMessage> {
+            private:
+                RingHandler() = delete;
+                RingHandler(const RingHandler&) = delete;
+                RingHandler& operator=(const RingHandler&) = delete;
+
+            public:
+                RingHandler(IPCKeyboardInput* parent)
+                    : _parent(*parent)
+                {
+                }
+                virtual ~RingHandler()
+                {
+                }
+
+            public:
+                virtual void Procedure(Core::IPCChannel& source, Core::ProxyType<RingMessage>& data)
+                {
+                    KeyboardLink& link(static_cast<Core::IPCChannelType<Core::SocketPort, KeyboardLink>&>(source).Extension());
+
+                    RingData& response(data->Response());
+
+                    response.Name[0] = '\0';
+
+                    // Only offered, the client is on the ring once it confirms it could open it.
+                    if ((_parent._ring != nullptr) && (link.IsTranslated() == false)) {
+                        const string& name(_parent._ring->Name());
+                        const size_t length(std::min(name.length(), sizeof(response.Name) - 1));
+
+                        ::memcpy(response.Name, name.c_str(), length);
+                        response.Name[length] = '\0';
+                    }
+
+                    Core::ProxyType<Core::IIPC> returnData(Core::proxy_cast<Core::IIPC>(data));
+                    source.ReportResponse(returnData);
+                }
+
+            private:
+                IPCKeyboardInput& _parent;
+            };
+
+            class JoinHandler : public Core::IPCServerType<JoinMessage> {
+            private:
+                JoinHandler() = delete;
+                JoinHandler(const JoinHandler&) = delete;
+                JoinHandler& operator=(const JoinHandler&) = delete;
+
+            public:
+                JoinHandler(IPCKeyboardInput* parent)
+                    : _parent(*parent)
+                {
+                }
+                virtual ~JoinHandler()
+                {
+                }
+
+            public:
+                virtual void Procedure(Core::IPCChannel& source, Core::ProxyType<JoinMessage>& data)
+                {
+                    KeyboardLink& link(static_cast<Core::IPCChannelType<Core::SocketPort, KeyboardLink>&>(source).Extension());
+
+                    data->Response().Sequence = (_parent._ring != nullptr ? link.Ring(*(_parent._ring)) : ~0);
+
+                    Core::ProxyType<Core::IIPC> returnData(Core::proxy_cast<Core::IIPC>(data));
+                    source.ReportResponse(returnData);
+                }
+
+            private:
+                IPCKeyboardInput& _parent;
+            };
+
         public:
             VirtualInputChannelServer(IPCKeyboardInput& parent, const Core::NodeId& sourceName)
                 : BaseClass(sourceName, 32)
                 , _parent(parent)
+                , _ringHandler(Core::ProxyType<RingHandler>::Create(&parent))
+                , _joinHandler(Core::ProxyType<JoinHandler>::Create(&parent))
+            {
+                CreateFactory<RingMessage>(1);
+                CreateFactory<JoinMessage>(1);
+                Register(_ringHandler);
+                Register(_joinHandler);
+            }
+            virtual ~VirtualInputChannelServer()
             {
+                // The handler is attached to the clients that are still there, they are only closed after this.
+                uint32_t index = 0;
+                Core::ProxyType<Client> current(BaseClass::operator[](index++));
+
+                while (current.IsValid() == true) {
+                    current->Unregister(_ringHandler);
+                    current->Unregister(_joinHandler);
+                    current = BaseClass::operator[](index++);
+                }
+
+                Unregister(_ringHandler);
+                Unregister(_joinHandler);
             }
 
             virtual void Added(Core::ProxyType<Client>& client) override
@@ -641,6 +944,8 @@ namespace PluginHost {
 
         private:
             IPCKeyboardInput& _parent;
+            Core::ProxyType<Core::IIPCServer> _ringHandler;
+            Core::ProxyType<Core::IIPCServer> _joinHandler;
         };
 
     public:
@@ -657,6 +962,11 @@ namespace PluginHost {
 
     private:
         VirtualInputChannelServer _service;
+        // The socket the clients connect to, if it is a domain socket.
+        const string _source;
+        Core::SharedEventRing* _ring;
+        // The sequence number on the ring of the key that is being sent.
+        uint64_t _sequence;
     };
 
     class EXTERNAL InputHandler {
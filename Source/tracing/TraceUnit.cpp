@@ -91,7 +91,11 @@ namespace Trace {
     }
 
     TraceUnit::TraceBuffer::TraceBuffer(const string& name)
+#if defined(__LINUX__) && !defined(__APPLE__)
+        : Core::CyclicBuffer(name, TRACE_CYCLIC_BUFFER_SIZE, true, true)
+#else
         : Core::CyclicBuffer(name, TRACE_CYCLIC_BUFFER_SIZE, true)
+#endif
         , _doorBell(TRACE_CYCLIC_BUFFER_PREFIX)
     {
     }
@@ -4,15 +4,29 @@
 namespace WPEFramework {
 namespace VirtualKeyboard {
 
-    class Controller {
+    class Controller : public Core::IDispatchType<Core::IIPC> {
 
     private:
         struct KeyData {
             actiontype Action;
             uint32_t Code;
         };
+        struct RingData {
+            char Name[128];
+        };
+        struct JoinData {
+            uint64_t Sequence;
+        };
+        struct SequencedKeyData {
+            actiontype Action;
+            uint32_t Code;
+            uint64_t Sequence;
+        };
         typedef Core::IPCMessageType<0, KeyData, Core::IPC::Void> KeyMessage;
         typedef Core::IPCMessageType<1, Core::IPC::Void, Core::IPC::Text<20>> NameMessage;
+        typedef Core::IPCMessageType<2, Core::IPC::Void, RingData> RingMessage;
+        typedef Core::IPCMessageType<3, SequencedKeyData, Core::IPC::Void> SequencedKeyMessage;
+        typedef Core::IPCMessageType<4, Core::IPC::Void, JoinData> JoinMessage;
 
         class KeyEventHandler : public Core::IPCServerType<KeyMessage> {
         private:
@@ -21,8 +35,8 @@ namespace VirtualKeyboard {
             KeyEventHandler& operator=(const KeyEventHandler&) = delete;
 
         public:
-            KeyEventHandler(FNKeyEvent callback)
-                : _callback(callback)
+            KeyEventHandler(Controller* parent)
+                : _parent(*parent)
             {
             }
             virtual ~KeyEventHandler()
@@ -32,14 +46,46 @@ namespace VirtualKeyboard {
         public:
             virtual void Procedure(Core::IPCChannel& source, Core::ProxyType<KeyMessage>& data)
             {
-                ASSERT(_callback != nullptr);
-                _callback(data->Parameters().Action, data->Parameters().Code);
+                // Keys only come this way if we are not on the ring (yet).
+                _parent.Key(data->Parameters().Action, data->Parameters().Code);
+
                 Core::ProxyType<Core::IIPC> returnData(Core::proxy_cast<Core::IIPC>(data));
                 source.ReportResponse(returnData);
             }
 
         private:
-            FNKeyEvent _callback;
+            Controller& _parent;
+        };
+
+        class SequencedKeyEventHandler : public Core::IPCServerType<SequencedKeyMessage> {
+        private:
+            SequencedKeyEventHandler() = delete;
+            SequencedKeyEventHandler(const SequencedKeyEventHandler&) = delete;
+            SequencedKeyEventHandler& operator=(const SequencedKeyEventHandler&) = delete;
+
+        public:
+            SequencedKeyEventHandler(Controller* parent)
+                : _parent(*parent)
+            {
+            }
+            virtual ~SequencedKeyEventHandler()
+            {
+            }
+
+        public:
+            virtual void Procedure(Core::IPCChannel& source, Core::ProxyType<SequencedKeyMessage>& data)
+            {
+                // The server moved us off the ring, the keys we read from it already are not delivered twice.
+                if (_parent.Leave(data->Parameters().Sequence) == true) {
+                    _parent.Key(data->Parameters().Action, data->Parameters().Code);
+                }
+
+                Core::ProxyType<Core::IIPC> returnData(Core::proxy_cast<Core::IIPC>(data));
+                source.ReportResponse(returnData);
+            }
+
+        private:
+            Controller& _parent;
         };
 
         class NameEventHandler : public Core::IPCServerType<NameMessage> {
@@ -71,6 +117,119 @@ namespace VirtualKeyboard {
             string _name;
         };
 
+        // Reads the keys from the shared event ring of the server, so the server does not have to
+        // wait for us, per key.
+        class RingReader : public Core::Thread {
+        private:
+            RingReader() = delete;
+            RingReader(const RingReader&) = delete;
+            RingReader& operator=(const RingReader&) = delete;
+
+        public:
+            RingReader(Controller& parent, const string& name)
+                : Core::Thread(Core::Thread::DefaultStackSize(), _T("VirtualKeyboardRing"))
+                , _parent(parent)
+                , _ring(name)
+                , _joined(false)
+                , _start(0)
+                , _stop(~0)
+                , _delivered(0)
+                , _stopped(false, true)
+            {
+            }
+            virtual ~RingReader()
+            {
+                Stop();
+            }
+
+        public:
+            inline bool IsValid() const
+            {
+                return (_ring.IsValid());
+            }
+            inline uint64_t Dropped() const
+            {
+                return (_ring.Dropped());
+            }
+            // Delivers the keys before the given sequence number and drops the rest. Returns whether the
+            // key with that sequence number still has to be delivered, as it was not read from the ring.
+            bool Leave(const uint64_t sequence)
+            {
+                if (sequence < _stop.load()) {
+                    TRACE_L1("Server moved us off the ring at %llu. %d", static_cast<unsigned long long>(sequence), __LINE__);
+                    _stop.store(sequence);
+                }
+
+                // Everything up to the sequence number is on the ring already, so this never waits long.
+                _ring.Interrupt();
+                _stopped.Lock(Core::infinite);
+
+                return (sequence >= _delivered.load());
+            }
+            void Stop()
+            {
+                // Nothing is ours anymore, so the reader blocks itself.
+                _stop.store(0);
+                _ring.Interrupt();
+                Wait(Core::Thread::BLOCKED | Core::Thread::STOPPED, Core::infinite);
+            }
+
+        private:
+            virtual uint32_t Worker() override
+            {
+                uint32_t result = 0;
+                KeyData data;
+                uint16_t length;
+                uint64_t timestamp;
+
+                if (_joined == false) {
+                    // The ring is open, so now the server can stop sending us KeyMessages. Everything
+                    // before the sequence number it answers came that way, or is still coming.
+                    const uint64_t sequence = _parent.Join();
+
+                    _joined = true;
+
+                    if (sequence == static_cast<uint64_t>(~0)) {
+                        _stop.store(0);
+                    } else {
+                        _start = sequence;
+                        _delivered.store(sequence);
+                    }
+                }
+
+                if (_ring.Next() < _stop.load()) {
+                    if (_ring.Consume(reinterpret_cast<uint8_t*>(&data), length, timestamp, Core::infinite) == Core::ERROR_NONE) {
+                        const uint64_t sequence = _ring.Next() - 1;
+
+                        if ((sequence >= _start) && (sequence < _stop.load())) {
+                            _parent.Latency(static_cast<uint32_t>(Core::SharedEventRing::Now() - timestamp));
+                            _parent.Key(data.Action, data.Code);
+                            _delivered.store(_ring.Next());
+                        }
+                    }
+                }
+
+                if (_ring.Next() >= _stop.load()) {
+                    Block();
+                    _stopped.SetEvent();
+                    result = Core::infinite;
+                }
+
+                return (result);
+            }
+
+        private:
+            Controller& _parent;
+            Core::SharedEventRing _ring;
+            bool _joined;
+            // The sequence number from which on the keys are ours, the one from which on they are no
+            // longer ours, and the one after the last key we delivered.
+            uint64_t _start;
+            std::atomic<uint64_t> _stop;
+            std::atomic<uint64_t> _delivered;
+            Core::Event _stopped;
+        };
+
     private:
         Controller() = delete;
         Controller(const Controller&) = delete;
@@ -78,33 +237,149 @@ namespace VirtualKeyboard {
 
     public:
         Controller(const string& name, const Core::NodeId& source, FNKeyEvent callback)
-            : _channel(source, 32)
-            , _keyHandler(Core::ProxyType<KeyEventHandler>::Create(callback))
+            : _adminLock()
+            , _channel(source, 32)
+            , _callback(callback)
+            , _keyHandler(Core::ProxyType<KeyEventHandler>::Create(this))
+            , _sequencedKeyHandler(Core::ProxyType<SequencedKeyEventHandler>::Create(this))
             , _nameHandler(Core::ProxyType<NameEventHandler>::Create(name))
+            , _ringMessage(Core::ProxyType<RingMessage>::Create())
+            , _joinMessage(Core::ProxyType<JoinMessage>::Create())
+            , _reader(nullptr)
+            , _latency()
         {
+            ASSERT(_callback != nullptr);
+
             _channel.CreateFactory<KeyMessage>(1);
+            _channel.CreateFactory<SequencedKeyMessage>(1);
             _channel.CreateFactory<NameMessage>(1);
 
             _channel.Register(_keyHandler);
+            _channel.Register(_sequencedKeyHandler);
             _channel.Register(_nameHandler);
 
-            _channel.Open(2000); // Try opening this channel for 2S
+            // Try opening this channel for 2S
+            if (_channel.Open(2000) == Core::ERROR_NONE) {
+                // Ask for the ring, a server that does not have one never answers or answers without a
+                // name, and keeps sending KeyMessages.
+                Core::ProxyType<Core::IIPC> message(Core::proxy_cast<Core::IIPC>(_ringMessage));
+
+                _ringMessage->Response().Name[0] = '\0';
+                _channel.Invoke(message, this);
+            }
         }
         ~Controller()
         {
+            // No more answers on the RingMessage after this, so no reader is started anymore.
             _channel.Close(Core::infinite);
 
+            if (_reader != nullptr) {
+                delete _reader;
+                _reader = nullptr;
+            }
+
             _channel.Unregister(_keyHandler);
+            _channel.Unregister(_sequencedKeyHandler);
             _channel.Unregister(_nameHandler);
 
             _channel.DestroyFactory<KeyMessage>();
+            _channel.DestroyFactory<SequencedKeyMessage>();
             _channel.DestroyFactory<NameMessage>();
         }
 
+    public:
+        inline void Key(const actiontype action, const uint32_t code)
+        {
+            _callback(action, code);
+        }
+        inline void Latency(const uint32_t latency)
+        {
+            _adminLock.Lock();
+            _latency.Set(latency);
+            _adminLock.Unlock();
+        }
+        void Statistics(uint32_t& events, uint32_t& dropped, uint32_t& average, uint32_t& maximum) const
+        {
+            _adminLock.Lock();
+
+            events = _latency.Measurements();
+            dropped = (_reader != nullptr ? static_cast<uint32_t>(_reader->Dropped()) : 0);
+            average = _latency.Average();
+            maximum = (events != 0 ? _latency.Max() : 0);
+
+            _adminLock.Unlock();
+        }
+        bool Leave(const uint64_t sequence)
+        {
+            bool result = true;
+
+            _adminLock.Lock();
+            RingReader* reader = _reader;
+            _adminLock.Unlock();
+
+            // The reader reports its latencies under the lock, so we wait for it without. It is only
+            // deleted once the channel is closed, so no handler calls this anymore.
+            if (reader != nullptr) {
+                result = reader->Leave(sequence);
+            }
+
+            return (result);
+        }
+        // Called by the reader, once it opened the ring. Returns the sequence number of the first key
+        // it has to read from it, or ~0 if we stay on the KeyMessages.
+        uint64_t Join()
+        {
+            Core::ProxyType<Core::IIPC> message(Core::proxy_cast<Core::IIPC>(_joinMessage));
+
+            // Also the answer if the channel closes before the server answered.
+            _joinMessage->Response().Sequence = ~0;
+
+            // Until the server answers, it might put us on the ring any moment, so we wait for it.
+            if (_channel.Invoke(message, Core::infinite) != Core::ERROR_NONE) {
+                _joinMessage->Response().Sequence = ~0;
+            }
+
+            return (_joinMessage->Response().Sequence);
+        }
+
     private:
+        virtual void Dispatch(Core::IIPC& element) override
+        {
+            ASSERT(dynamic_cast<RingMessage*>(&element) != nullptr);
+
+            const RingData& response(static_cast<RingMessage&>(element).Response());
+
+            if (response.Name[0] != '\0') {
+                const string name(response.Name, ::strnlen(response.Name, sizeof(response.Name)));
+                RingReader* reader = new RingReader(*this, name);
+
+                // The ring is not ours to open (permissions, another mount namespace), we never join
+                // it, so the server keeps sending us KeyMessages.
+                if (reader->IsValid() == false) {
+                    delete reader;
+                } else {
+                    _adminLock.Lock();
+
+                    ASSERT(_reader == nullptr);
+                    _reader = reader;
+                    _reader->Run();
+
+                    _adminLock.Unlock();
+                }
+            }
+        }
+
+    private:
+        mutable Core::CriticalSection _adminLock;
         Core::IPCChannelClientType<Core::Void, false, true> _channel;
+        FNKeyEvent _callback;
         Core::ProxyType<Core::IIPCServer> _keyHandler;
+        Core::ProxyType<Core::IIPCServer> _sequencedKeyHandler;
         Core::ProxyType<Core::IIPCServer> _nameHandler;
+        Core::ProxyType<RingMessage> _ringMessage;
+        Core::ProxyType<JoinMessage> _joinMessage;
+        RingReader* _reader;
+        Core::MeasurementType<uint32_t> _latency;
     };
 }
 }
@@ -130,6 +405,18 @@ void Destruct(void* handle)
     delete reinterpret_cast<VirtualKeyboard::Controller*>(handle);
 }
 
+void KeyStatistics(void* handle, unsigned int* events, unsigned int* dropped, unsigned int* averageLatency, unsigned int* maximumLatency)
+{
+    uint32_t received, lost, average, maximum;
+
+    reinterpret_cast<VirtualKeyboard::Controller*>(handle)->Statistics(received, lost, average, maximum);
+
+    *events = received;
+    *dropped = lost;
+    *averageLatency = average;
+    *maximumLatency = maximum;
+}
+
 #ifdef __cplusplus
 }
 #endif
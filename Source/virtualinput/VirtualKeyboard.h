@@ -22,6 +22,10 @@ typedef void (*FNKeyEvent)(enum actiontype type, unsigned int code);
 EXTERNAL void* Construct(const char listenerName[], const char connector[], FNKeyEvent callback);
 EXTERNAL void Destruct(void* handle);
 
+// The keys read from the shared event ring of the server: how many were received and how many were
+// lost as they were not picked up in time, and how long (microseconds) it took them to get here.
+EXTERNAL void KeyStatistics(void* handle, unsigned int* events, unsigned int* dropped, unsigned int* averageLatency, unsigned int* maximumLatency);
+
 #ifdef __cplusplus
 }
 #endif
@@ -219,6 +219,11 @@ namespace Web {
             // Signal a state change, Opened, Closed or Accepted
             virtual void StateChange()
             {
+                if (ACTUALLINK::IsOpen() == true) {
+                    // A message cut off on a previous connection, is not continued on this one.
+                    _parent._deserialiserImpl.Reset();
+                }
+
                 _parent.StateChange();
             }
 
@@ -224,7 +224,8 @@ namespace Web {
             MAN,
             M_X,
             S_T,
-			AUTHORIZATION
+			AUTHORIZATION,
+            RANGE
         };
 
         enum type {
@@ -378,6 +379,17 @@ namespace Web {
 
                 _lock.Unlock();
             }
+            // Drop whatever was received so far, e.g. if the connection it came in on, went down.
+            inline void Reset()
+            {
+                _lock.Lock();
+
+                _state = VERB;
+                _parser.Reset();
+                _current = nullptr;
+
+                _lock.Unlock();
+            }
             inline uint16_t Deserialize(const uint8_t stream[], const uint16_t maxLength)
             {
                 _lock.Lock();
@@ -570,6 +582,7 @@ namespace Web {
             MX.Clear();
             ST.Clear();
             WebToken.Clear();
+            Range.Clear();
 
             if (_body.IsValid() == true) {
                 _body.Release();
@@ -607,6 +620,7 @@ namespace Web {
         Core::OptionalType<string> ST;
         Core::OptionalType<uint32_t> MX;
         Core::OptionalType<Authorization> WebToken;
+        Core::OptionalType<string> Range;
 
         inline bool HasBody() const
         {
@@ -219,6 +219,17 @@ namespace Web {
 
                 _lock.Unlock();
             }
+            // Drop whatever was received so far, e.g. if the connection it came in on, went down.
+            inline void Reset()
+            {
+                _lock.Lock();
+
+                _state = VERSION;
+                _parser.Reset();
+                _current = nullptr;
+
+                _lock.Unlock();
+            }
             inline uint16_t Deserialize(const uint8_t stream[], const uint16_t maxLength)
             {
                 _lock.Lock();
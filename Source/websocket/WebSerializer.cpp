@@ -44,6 +44,7 @@ static const TCHAR __ST[] = _T("ST:");
 static const TCHAR __MAN[] = _T("MAN:");
 static const TCHAR __MX[] = _T("MX:");
 static const TCHAR __AUTHORIZATION[] = _T("AUTHORIZATION:");
+static const TCHAR __RANGE[] = _T("RANGE:");
 
 static const TCHAR __DATE[] = _T("DATE:");
 static const TCHAR __SERVER[] = _T("SERVER:");
@@ -212,6 +213,7 @@ ENUM_CONVERSION_BEGIN(Web::Request::keywords)
     { Web::Request::M_X, __TXT(__MX) },
     { Web::Request::S_T, __TXT(__ST) },
     { Web::Request::AUTHORIZATION, __TXT(__AUTHORIZATION) },
+    { Web::Request::RANGE, __TXT(__RANGE) },
 
 ENUM_CONVERSION_END(Web::Request::keywords)
 
@@ -790,15 +792,20 @@ namespace Web
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __AUTHORIZATION : _T("Authorization:"));
                             FromAuthorization(_current->WebToken.Value(), _value);
                             _offset = 0;
-                        } else if ((_keyIndex <= 22) && (((_bodyLength = (_current->_body.IsValid() ? _current->_body->Serialize() : 0)) > 0) || (_current->ContentLength.IsSet() == true) || (!_current->Connection.IsSet()) || (_current->Connection.Value() != Request::CONNECTION_CLOSE))) {
-                            _keyIndex = (_bodyLength > 0 ? 23 : 24);
+                        } else if ((_keyIndex <= 22) && (_current->Range.IsSet() == true)) {
+                            _keyIndex = 23;
+                            _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __RANGE : _T("Range:"));
+                            _value = _current->Range.Value();
+                            _offset = 0;
+                        } else if ((_keyIndex <= 23) && (((_bodyLength = (_current->_body.IsValid() ? _current->_body->Serialize() : 0)) > 0) || (_current->ContentLength.IsSet() == true) || (!_current->Connection.IsSet()) || (_current->Connection.Value() != Request::CONNECTION_CLOSE))) {
+                            _keyIndex = (_bodyLength > 0 ? 24 : 25);
 
                             Core::NumberType<uint32_t, false, BASE_DECIMAL> number(_bodyLength);
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __CONTENT_LENGTH : _T("Content-Length:"));
                             number.Serialize(_value);
                             _offset = 0;
-                        } else if ((_keyIndex <= 23) && (_current->ContentSignature.IsSet() == true)) {
-                            _keyIndex = 24;
+                        } else if ((_keyIndex <= 24) && (_current->ContentSignature.IsSet() == true)) {
+                            _keyIndex = 25;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __CONTENT_SIGNATURE : _T("Content-HMAC:"));
                             FromSignature(_current->ContentSignature.Value(), _value);
                             _offset = 0;
@@ -1461,6 +1468,9 @@ namespace Web
             case Request::AUTHORIZATION:
                 _current->WebToken = ToAuthorization(buffer);
                 break;
+            case Request::RANGE:
+                _current->Range = buffer;
+                break;
             case Request::CONTENT_SIGNATURE:
                 _current->ContentSignature = ToSignature(buffer);
                 break;
@@ -247,10 +247,11 @@ namespace Web {
             // Read all Data
             uint32_t length = FileBody::Serialize();
 
-            uint8_t buffer[64];
+            // The hash takes any length, fewer and larger reads are cheaper.
+            uint8_t buffer[4 * 1024];
 
             while (length > 0) {
-                uint16_t size = (length > 64 ? 64 : length);
+                uint16_t size = static_cast<uint16_t>(length > sizeof(buffer) ? sizeof(buffer) : length);
                 FileBody::Serialize(buffer, size);
                 _hash.Input(buffer, size);
                 length -= size;
@@ -27,6 +27,9 @@ namespace Web {
     public:
         inline Core::ProxyType<ELEMENT> Element()
         {
+            // The element is reused, nothing of the previous message (headers, body) may stick.
+            _singleElement.Clear();
+
             return (Core::ProxyType<ELEMENT>(&_singleElement, &_singleElement));
         }
 
@@ -117,13 +120,14 @@ namespace Web {
         public:
             void StartTransfer(const Core::ProxyType<Web::Request>& request)
             {
-                ASSERT(_request->IsValid() == false);
-                ASSERT(_response->IsValid() == false);
+                ASSERT(_request.IsValid() == false);
+                ASSERT(_response.IsValid() == false);
+
+                _request = request;
 
                 if (BaseClass::IsOpen() == true) {
                     BaseClass::Submit(request);
                 } else {
-                    _request = request;
                     BaseClass::Open(0);
                 }
             }
@@ -147,7 +151,7 @@ namespace Web {
             // Notification of a Response send.
             virtual void Send(const Core::ProxyType<Web::Request>& request)
             {
-                ASSERT(_request->IsValid() != false);
+                ASSERT(_request.IsValid() != false);
                 ASSERT(_request == request);
                 DEBUG_VARIABLE(request);
                 // Oke the message is gone, ready for a new one !!
@@ -157,14 +161,20 @@ namespace Web {
             virtual void StateChange()
             {
                 if (BaseClass::IsOpen() == true) {
-                    ASSERT(_request->IsValid() == true);
+                    ASSERT(_request.IsValid() == true);
 
                     BaseClass::Submit(_request);
-                } else if (_response.IsValid() == true) {
-                    // Close the link and thus the transfer..
-                    _parent.EndTransfer(_response);
+                } else if (_request.IsValid() == true) {
+                    // Close the link and thus the transfer. Without a response, the connection
+                    // could not be made or was lost halfway.
+                    Core::ProxyType<Web::Response> response(_response);
+
+                    _request.Release();
+                    if (_response.IsValid() == true) {
+                        _response.Release();
+                    }
 
-                    _response.Release();
+                    _parent.EndTransfer(response);
                 }
             }
 
@@ -305,6 +315,14 @@ namespace Web {
         }
 
         uint32_t Download(const Core::URL& source, Core::File& destination)
+        {
+            return (Download(source, destination, 0, 0));
+        }
+
+        // Download a part of the source, length 0 means up to the end. The data is written at the
+        // current position of the destination. If the server does not honour the range, the body
+        // is dropped and the transfer completes with ERROR_INVALID_RANGE.
+        uint32_t Download(const Core::URL& source, Core::File& destination, const uint64_t offset, const uint64_t length)
         {
             uint32_t result = Core::ERROR_INPROGRESS;
 
@@ -329,6 +347,12 @@ namespace Web {
                         _request->Verb = Web::Request::HTTP_GET;
                         _request->Path = '/' + source.Path().Value().Text();
 
+                        if ((offset == 0) && (length == 0)) {
+                            _request->Range.Clear();
+                        } else {
+                            _request->Range = _T("bytes=") + Core::NumberType<uint64_t>(offset).Text() + '-' + (length == 0 ? string() : Core::NumberType<uint64_t>(offset + length - 1).Text());
+                        }
+
                         // Prepare the request for processing
                         _channel.StartTransfer(_request);
                     }
@@ -343,6 +367,12 @@ namespace Web {
         virtual bool Setup(const Core::URL& remote) = 0;
         virtual void Transfered(const uint32_t result, const FILEBODY& file) = 0;
 
+    protected:
+        inline FILEBODY& Body()
+        {
+            return (*_fileBody);
+        }
+
     private:
         inline void EndTransfer(const Core::ProxyType<Web::Response>& response)
         {
@@ -351,8 +381,12 @@ namespace Web {
             // We are done, change state
             _adminLock.Lock();
 
-            if (response->ErrorCode == Web::STATUS_NOT_FOUND) {
+            if (response.IsValid() == false) {
+                errorCode = Core::ERROR_CONNECTION_CLOSED;
+            } else if (response->ErrorCode == Web::STATUS_NOT_FOUND) {
                 errorCode = Core::ERROR_UNAVAILABLE;
+            } else if ((_state == TRANSFER_DOWNLOAD) && (IsRangeRefused(*response) == true)) {
+                errorCode = Core::ERROR_INVALID_RANGE;
             } else if ((response->ErrorCode == Web::STATUS_UNAUTHORIZED) || ((_state == TRANSFER_DOWNLOAD) && (_DeserializedHashValue<LINK, FILEBODY>(response->ContentSignature) == false))) {
                 errorCode = Core::ERROR_INCORRECT_HASH;
             }
@@ -365,7 +399,14 @@ namespace Web {
         // Notification of a Partial Request received, time to attach a body..
         inline void LinkBody(Core::ProxyType<Web::Response>& element)
         {
-            element->Body(_fileBody);
+            // Do not write a complete file, or an error page, where a part was requested.
+            if (IsRangeRefused(*element) == false) {
+                element->Body(_fileBody);
+            }
+        }
+        inline bool IsRangeRefused(const Web::Response& response) const
+        {
+            return ((_request->Range.IsSet() == true) && (response.ErrorCode != Web::STATUS_PARTIAL_CONTENT));
         }
 
     private:
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <broadcast/broadcast.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Broadcast;
+
+namespace {
+
+const uint16_t g_networkId = 0x0001;
+const uint16_t g_transportStreamId = 0x0002;
+const uint16_t g_serviceId = 0x0100;
+
+// Seconds since the epoch at which the events of the tests start: 1 January 2020, 00:00 UTC.
+const uint32_t g_day = 18262 * 86400;
+
+// Builds an EIT section, with a short event descriptor as title for each event.
+class Section {
+public:
+   Section(const Section&) = delete;
+   Section& operator=(const Section&) = delete;
+
+   Section(const uint8_t tableId, const uint8_t version, const uint8_t sectionNumber)
+      : _data()
+   {
+      const uint8_t header[] = {
+         tableId, 0xF0, 0x00, (g_serviceId >> 8), (g_serviceId & 0xFF), static_cast<uint8_t>(0xC1 | ((version & 0x1F) << 1)), sectionNumber, sectionNumber,
+         (g_transportStreamId >> 8), (g_transportStreamId & 0xFF), (g_networkId >> 8), (g_networkId & 0xFF), sectionNumber, tableId
+      };
+
+      _data.assign(header, header + sizeof(header));
+   }
+
+   // Start in seconds after g_day, within the day.
+   void Add(const uint16_t eventId, const uint32_t start, const uint32_t duration, const string& title)
+   {
+      const uint16_t mjd = static_cast<uint16_t>((g_day / 86400) + 40587);
+
+      _data.push_back(eventId >> 8);
+      _data.push_back(eventId & 0xFF);
+      _data.push_back(mjd >> 8);
+      _data.push_back(mjd & 0xFF);
+      BCD(start);
+      BCD(duration);
+
+      const uint16_t descriptorLength = static_cast<uint16_t>(2 + 3 + 1 + title.length() + 1);
+
+      _data.push_back(0x80 | (descriptorLength >> 8)); // Running, not scrambled.
+      _data.push_back(descriptorLength & 0xFF);
+
+      _data.push_back(0x4D);
+      _data.push_back(static_cast<uint8_t>(descriptorLength - 2));
+      _data.push_back('e');
+      _data.push_back('n');
+      _data.push_back('g');
+      _data.push_back(static_cast<uint8_t>(title.length()));
+      _data.insert(_data.end(), title.begin(), title.end());
+      _data.push_back(0);
+   }
+
+   DVB::EIT Table()
+   {
+      // Room for the CRC, the EIT does not check it, the SectionCache did.
+      _complete = _data;
+      _complete.resize(_complete.size() + 4, 0);
+      _complete[1] = 0xF0 | (((_complete.size() - 3) >> 8) & 0x0F);
+      _complete[2] = (_complete.size() - 3) & 0xFF;
+
+      return (DVB::EIT(MPEG::Section(Core::DataElement(_complete.size(), _complete.data()))));
+   }
+
+private:
+   void BCD(const uint32_t seconds)
+   {
+      const uint32_t values[] = { seconds / 3600, (seconds / 60) % 60, seconds % 60 };
+
+      for (const uint32_t value : values) {
+         _data.push_back(static_cast<uint8_t>(((value / 10) << 4) | (value % 10)));
+      }
+   }
+
+private:
+   std::vector<uint8_t> _data;
+   std::vector<uint8_t> _complete;
+};
+
+const uint64_t g_service = EventStore::Service(g_networkId, g_transportStreamId, g_serviceId);
+
+}
+
+TEST(Broadcast_EventStore, insert)
+{
+   EventStore store;
+   Section section(DVB::EIT::SCHEDULE_ACTUAL, 0, 0);
+
+   section.Add(1, 3600, 1800, _T("News"));
+   section.Add(2, 5400, 3600, _T("Movie"));
+
+   EXPECT_TRUE(store.Load(section.Table()));
+   EXPECT_EQ(store.Count(), 2u);
+
+   // The same version again, changes nothing.
+   EXPECT_FALSE(store.Load(section.Table()));
+   EXPECT_EQ(store.Count(), 2u);
+
+   EventStore::Event now, next;
+
+   EXPECT_EQ(store.NowNext(g_service, g_day + 3700, now, next), EventStore::NOW | EventStore::NEXT);
+   EXPECT_EQ(now.EventId, 1u);
+   EXPECT_EQ(now.Start, g_day + 3600);
+   EXPECT_EQ(now.Duration, 1800u);
+   EXPECT_EQ(now.Title, _T("News"));
+   EXPECT_EQ(now.Language, _T("eng"));
+   EXPECT_EQ(next.EventId, 2u);
+   EXPECT_EQ(next.Title, _T("Movie"));
+
+   Core::Singleton::Dispose();
+}
+
+TEST(Broadcast_EventStore, replace)
+{
+   EventStore store;
+   Section version0(DVB::EIT::SCHEDULE_ACTUAL, 0, 0);
+   Section version1(DVB::EIT::SCHEDULE_ACTUAL, 1, 0);
+
+   version0.Add(1, 3600, 1800, _T("News"));
+   version0.Add(2, 5400, 3600, _T("Movie"));
+
+   version1.Add(2, 5400, 3600, _T("Another movie"));
+   version1.Add(3, 9000, 1800, _T("Weather"));
+
+   EXPECT_TRUE(store.Load(version0.Table()));
+   EXPECT_TRUE(store.Load(version1.Table()));
+
+   // Event 1 is no longer carried, event 2 got a new title.
+   EXPECT_EQ(store.Count(), 2u);
+
+   EventStore::Events events;
+
+   EXPECT_EQ(store.Window(g_service, g_day, g_day + 86400, events), 2u);
+   ASSERT_EQ(events.size(), 2u);
+   EXPECT_EQ(events[0].EventId, 2u);
+   EXPECT_EQ(events[0].Title, _T("Another movie"));
+   EXPECT_EQ(events[1].EventId, 3u);
+   EXPECT_EQ(events[1].Title, _T("Weather"));
+
+   Core::Singleton::Dispose();
+}
+
+TEST(Broadcast_EventStore, expire)
+{
+   EventStore store;
+   Section schedule(DVB::EIT::SCHEDULE_ACTUAL, 0, 0);
+
+   schedule.Add(1, 3600, 1800, _T("News"));
+   schedule.Add(2, 5400, 3600, _T("Movie"));
+
+   EXPECT_TRUE(store.Load(schedule.Table()));
+
+   EXPECT_EQ(store.Expire(g_day + 3600 + 1800 + 1), 1u);
+   EXPECT_EQ(store.Count(), 1u);
+
+   // The strings of the expired event are gone too.
+   EXPECT_EQ(store.StringPoolSize(), 1u + 4u + 6u);
+
+   EventStore::Event now, next;
+   EXPECT_EQ(store.NowNext(g_service, g_day + 3700, now, next), static_cast<uint8_t>(EventStore::NEXT));
+   EXPECT_EQ(next.EventId, 2u);
+
+   // Expiring again, finds nothing.
+   EXPECT_EQ(store.Expire(g_day + 3600 + 1800 + 1), 0u);
+
+   Core::Singleton::Dispose();
+}
+
+TEST(Broadcast_EventStore, expireAndReinsert)
+{
+   EventStore store;
+   Section version0(DVB::EIT::SCHEDULE_ACTUAL, 0, 0);
+
+   version0.Add(1, 3600, 1800, _T("News"));
+   version0.Add(2, 5400, 3600, _T("Movie"));
+
+   EXPECT_TRUE(store.Load(version0.Table()));
+   EXPECT_EQ(store.Expire(g_day + 3600 + 1800 + 1), 1u);
+
+   // The same version, repeated by the carousel, does not bring the expired event back.
+   EXPECT_FALSE(store.Load(version0.Table()));
+   EXPECT_EQ(store.Count(), 1u);
+
+   // The event id is reused in another section, for a later event.
+   Section segment(DVB::EIT::SCHEDULE_ACTUAL, 0, 8);
+   segment.Add(1, 30000, 1800, _T("Late news"));
+
+   EXPECT_TRUE(store.Load(segment.Table()));
+   EXPECT_EQ(store.Count(), 2u);
+
+   // A next version of the first section, without event 1, must leave the event of the other section alone.
+   Section version1(DVB::EIT::SCHEDULE_ACTUAL, 1, 0);
+   version1.Add(2, 5400, 3600, _T("Movie"));
+
+   EXPECT_TRUE(store.Load(version1.Table()));
+   EXPECT_EQ(store.Count(), 2u);
+
+   EventStore::Events events;
+
+   EXPECT_EQ(store.Window(g_service, g_day, g_day + 86400, events), 2u);
+   ASSERT_EQ(events.size(), 2u);
+   EXPECT_EQ(events[0].EventId, 2u);
+   EXPECT_EQ(events[1].EventId, 1u);
+   EXPECT_EQ(events[1].Title, _T("Late news"));
+
+   // And a next version that carries event 1 again, owns it next to the other section.
+   Section version2(DVB::EIT::SCHEDULE_ACTUAL, 2, 0);
+   version2.Add(1, 30000, 1800, _T("Late news"));
+
+   EXPECT_TRUE(store.Load(version2.Table()));
+   EXPECT_EQ(store.Count(), 1u);
+
+   Section segment1(DVB::EIT::SCHEDULE_ACTUAL, 1, 8);
+   segment1.Add(3, 32000, 1800, _T("Sports"));
+
+   EXPECT_TRUE(store.Load(segment1.Table()));
+   EXPECT_EQ(store.Count(), 2u);
+
+   events.clear();
+   EXPECT_EQ(store.Window(g_service, g_day, g_day + 86400, events), 2u);
+   ASSERT_EQ(events.size(), 2u);
+   EXPECT_EQ(events[0].EventId, 1u);
+   EXPECT_EQ(events[1].EventId, 3u);
+
+   Core::Singleton::Dispose();
+}
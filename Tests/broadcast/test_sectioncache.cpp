@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <broadcast/broadcast.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Broadcast;
+
+namespace {
+
+// A section with the section syntax, 4 bytes of payload and a valid CRC.
+class Frame {
+public:
+   Frame(const Frame&) = delete;
+   Frame& operator=(const Frame&) = delete;
+
+   Frame(const uint8_t tableId, const uint16_t extension, const uint8_t version, const uint8_t sectionNumber, const uint8_t payload)
+   {
+      _data[0] = tableId;
+      _data[1] = 0xB0 | ((sizeof(_data) - 3) >> 8);
+      _data[2] = (sizeof(_data) - 3) & 0xFF;
+      _data[3] = (extension >> 8);
+      _data[4] = (extension & 0xFF);
+      _data[5] = 0xC1 | ((version & 0x1F) << 1);
+      _data[6] = sectionNumber;
+      _data[7] = 1;
+      memset(&(_data[8]), payload, 4);
+
+      Seal();
+   }
+
+   void Seal()
+   {
+      const uint32_t crc = Core::DataElement(sizeof(_data), _data).CRC32(0, sizeof(_data) - 4);
+
+      _data[12] = (crc >> 24) & 0xFF;
+      _data[13] = (crc >> 16) & 0xFF;
+      _data[14] = (crc >> 8) & 0xFF;
+      _data[15] = crc & 0xFF;
+   }
+   MPEG::SectionCache::verdict Admit(MPEG::SectionCache& cache)
+   {
+      return (cache.Admit(MPEG::Section(Core::DataElement(sizeof(_data), _data)), _data, sizeof(_data)));
+   }
+
+   uint8_t _data[16];
+};
+
+}
+
+TEST(Broadcast_SectionCache, duplicates)
+{
+   MPEG::SectionCache cache;
+   Frame first(0x4E, 0x1234, 0, 0, 0x11);
+   Frame second(0x4E, 0x1234, 0, 1, 0x22);
+
+   EXPECT_EQ(first.Admit(cache), MPEG::SectionCache::ADMITTED);
+   EXPECT_EQ(second.Admit(cache), MPEG::SectionCache::ADMITTED);
+
+   // The carousel repeats both, unchanged.
+   EXPECT_EQ(first.Admit(cache), MPEG::SectionCache::REPEATED);
+   EXPECT_EQ(second.Admit(cache), MPEG::SectionCache::REPEATED);
+   EXPECT_EQ(first.Admit(cache), MPEG::SectionCache::REPEATED);
+
+   EXPECT_EQ(cache.Hits(), 3u);
+   EXPECT_EQ(cache.Misses(), 2u);
+
+   // The same section on another extension is not a repetition.
+   Frame other(0x4E, 0x1235, 0, 0, 0x11);
+   EXPECT_EQ(other.Admit(cache), MPEG::SectionCache::ADMITTED);
+
+   // A corrupted section is neither delivered nor remembered.
+   Frame corrupted(0x4E, 0x1234, 0, 2, 0x33);
+   corrupted._data[9] ^= 0xFF;
+   EXPECT_EQ(corrupted.Admit(cache), MPEG::SectionCache::CORRUPTED);
+   corrupted._data[9] ^= 0xFF;
+   EXPECT_EQ(corrupted.Admit(cache), MPEG::SectionCache::ADMITTED);
+
+   // Sections without the section syntax are never cached.
+   Frame plain(0x70, 0, 0, 0, 0x44);
+   plain._data[1] &= 0x7F;
+   EXPECT_EQ(plain.Admit(cache), MPEG::SectionCache::ADMITTED);
+   EXPECT_EQ(plain.Admit(cache), MPEG::SectionCache::ADMITTED);
+   EXPECT_EQ(cache.Hits(), 3u);
+   EXPECT_EQ(cache.Misses(), 5u);
+
+   Core::Singleton::Dispose();
+}
+
+TEST(Broadcast_SectionCache, versionChange)
+{
+   MPEG::SectionCache cache;
+   Frame version0(0x4E, 0x1234, 0, 0, 0x11);
+   Frame version1(0x4E, 0x1234, 1, 0, 0x11);
+
+   EXPECT_EQ(version0.Admit(cache), MPEG::SectionCache::ADMITTED);
+   EXPECT_EQ(version0.Admit(cache), MPEG::SectionCache::REPEATED);
+
+   // A new version replaces the old one, so going back is a change too.
+   EXPECT_EQ(version1.Admit(cache), MPEG::SectionCache::ADMITTED);
+   EXPECT_EQ(version1.Admit(cache), MPEG::SectionCache::REPEATED);
+   EXPECT_EQ(version0.Admit(cache), MPEG::SectionCache::ADMITTED);
+
+   // Same version, other content: the CRC tells them apart.
+   Frame changed(0x4E, 0x1234, 0, 0, 0x99);
+   EXPECT_EQ(changed.Admit(cache), MPEG::SectionCache::ADMITTED);
+   EXPECT_EQ(changed.Admit(cache), MPEG::SectionCache::REPEATED);
+
+   // Forgetting the table, delivers it again.
+   cache.Forget(0x4E);
+   EXPECT_EQ(changed.Admit(cache), MPEG::SectionCache::ADMITTED);
+
+   Core::Singleton::Dispose();
+}
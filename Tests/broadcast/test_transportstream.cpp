@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <broadcast/broadcast.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Broadcast;
+
+namespace {
+
+// sections.ts holds 13 packets:
+//   PID 0x0000: a PAT, sent twice.
+//   PID 0x0011: an SDT of 468 bytes over 3 packets, sent twice, and an SDT section with a wrong CRC.
+//   PID 0x0012: EIT sections 0 and 1 (version 0) in a single packet, section 0 in version 1, and then
+//               sections 0 and 1 in version 0 again.
+//   PID 0x0100: a packet nobody filters.
+const string g_capture(string(CAPTURE_DIRECTORY) + _T("/sections.ts"));
+
+std::vector<uint8_t> Load()
+{
+   std::vector<uint8_t> result;
+   Core::File file(g_capture);
+
+   if (file.Open(true) == true) {
+      result.resize(static_cast<size_t>(file.Size()));
+      result.resize(file.Read(result.data(), static_cast<uint32_t>(result.size())));
+   }
+
+   EXPECT_EQ(result.size(), 13u * MPEG::Demultiplexer::PacketSize);
+
+   return (result);
+}
+
+class Collector : public ISection {
+public:
+   Collector(const Collector&) = delete;
+   Collector& operator=(const Collector&) = delete;
+
+   Collector()
+      : _sections()
+   {
+   }
+   ~Collector() override
+   {
+   }
+
+   void Handle(const MPEG::Section& section) override
+   {
+      EXPECT_TRUE(section.IsValid());
+      _sections.push_back(std::make_pair(section.TableId(), (static_cast<uint16_t>(section.Version()) << 8) | section.SectionNumber()));
+   }
+
+   // Table id, version and section number, in the order they were received.
+   std::vector<std::pair<uint8_t, uint16_t>> _sections;
+};
+
+// Removes its own filter, and the other one on the PID, from within the callback.
+class Unsubscriber : public ISection {
+public:
+   Unsubscriber(const Unsubscriber&) = delete;
+   Unsubscriber& operator=(const Unsubscriber&) = delete;
+
+   Unsubscriber(MPEG::Demultiplexer& demultiplexer)
+      : _demultiplexer(demultiplexer)
+      , _calls(0)
+   {
+   }
+   ~Unsubscriber() override
+   {
+   }
+
+   void Handle(const MPEG::Section&) override
+   {
+      _calls++;
+      EXPECT_EQ(_demultiplexer.Filter(0x12, 0x4E, 0x0010, nullptr), Core::ERROR_NONE);
+      EXPECT_EQ(_demultiplexer.Filter(0x12, 0, nullptr), Core::ERROR_NONE);
+   }
+
+   MPEG::Demultiplexer& _demultiplexer;
+   uint32_t _calls;
+};
+
+}
+
+TEST(Broadcast_TransportStream, reassembly)
+{
+   const std::vector<uint8_t> capture(Load());
+
+   // Packets split over the chunks in every possible way.
+   for (uint32_t chunk : { 1, 7, 100, 188, 189, 1000, 4096 }) {
+      MPEG::Demultiplexer demultiplexer;
+      Collector pat, sdt, eit;
+
+      EXPECT_EQ(demultiplexer.Filter(0x00, 0x00, &pat), Core::ERROR_NONE);
+      EXPECT_EQ(demultiplexer.Filter(0x11, 0x42, &sdt), Core::ERROR_NONE);
+      EXPECT_EQ(demultiplexer.Filter(0x12, 0x4E, 0x0010, &eit), Core::ERROR_NONE);
+      EXPECT_FALSE(demultiplexer.IsFiltered(0x100));
+
+      for (uint32_t offset = 0; offset < capture.size(); offset += chunk) {
+         demultiplexer.Deliver(&(capture[offset]), std::min(chunk, static_cast<uint32_t>(capture.size() - offset)));
+      }
+
+      // Repeated sections are handed over once, a changed version again.
+      EXPECT_EQ(pat._sections.size(), 1u);
+      ASSERT_EQ(sdt._sections.size(), 1u);
+      EXPECT_EQ(sdt._sections[0].second, 0x0300);
+
+      const std::vector<std::pair<uint8_t, uint16_t>> expected = { { 0x4E, 0x0000 }, { 0x4E, 0x0001 }, { 0x4E, 0x0100 }, { 0x4E, 0x0000 } };
+      EXPECT_EQ(eit._sections, expected);
+
+      EXPECT_EQ(demultiplexer.Packets(), 13u);
+      EXPECT_EQ(demultiplexer.Sections(), 6u);
+      EXPECT_EQ(demultiplexer.Errors(), 1u);
+      EXPECT_EQ(demultiplexer.Discontinuities(), 0u);
+
+      uint64_t hits, misses;
+      demultiplexer.Repeated(hits, misses);
+      EXPECT_EQ(hits, 3u);
+      EXPECT_EQ(misses, 7u);
+   }
+}
+
+TEST(Broadcast_TransportStream, filterChangesFromCallback)
+{
+   const std::vector<uint8_t> capture(Load());
+   MPEG::Demultiplexer demultiplexer;
+   Collector all;
+   Unsubscriber first(demultiplexer);
+
+   // Both get the first EIT section, but the first callback removes both filters before the other is called.
+   EXPECT_EQ(demultiplexer.Filter(0x12, 0x4E, 0x0010, &first), Core::ERROR_NONE);
+   EXPECT_EQ(demultiplexer.Filter(0x12, 0, &all), Core::ERROR_NONE);
+
+   demultiplexer.Deliver(capture.data(), static_cast<uint32_t>(capture.size()));
+
+   EXPECT_EQ(first._calls, 1u);
+   EXPECT_TRUE(all._sections.empty());
+   EXPECT_FALSE(demultiplexer.IsFiltered(0x12));
+}
+
+TEST(Broadcast_TransportStream, feedReplay)
+{
+   MPEG::Demultiplexer demultiplexer;
+   MPEG::Feed feed(demultiplexer);
+   Collector eit;
+
+   EXPECT_EQ(demultiplexer.Filter(0x12, 0x4E, &eit), Core::ERROR_NONE);
+
+   ASSERT_EQ(feed.Open(g_capture), Core::ERROR_NONE);
+   EXPECT_TRUE(feed.Completed(5000));
+   EXPECT_EQ(feed.Close(), Core::ERROR_NONE);
+
+   EXPECT_EQ(feed.Bytes(), 13u * MPEG::Demultiplexer::PacketSize);
+   EXPECT_EQ(eit._sections.size(), 4u);
+}
+
+TEST(Broadcast_TransportStream, throughput)
+{
+   const std::vector<uint8_t> capture(Load());
+   const uint32_t repeats = 20000;
+   MPEG::Demultiplexer demultiplexer;
+   Collector pat, sdt, eit;
+
+   demultiplexer.Filter(0x00, 0x00, &pat);
+   demultiplexer.Filter(0x11, 0x42, &sdt);
+   demultiplexer.Filter(0x12, 0x4E, &eit);
+
+   uint64_t start = Core::Time::Now().Ticks();
+
+   for (uint32_t index = 0; index < repeats; index++) {
+      demultiplexer.Deliver(capture.data(), static_cast<uint32_t>(capture.size()));
+   }
+
+   uint64_t duration = Core::Time::Now().Ticks() - start;
+   uint64_t bytes = static_cast<uint64_t>(capture.size()) * repeats;
+   uint64_t hits, misses;
+
+   demultiplexer.Repeated(hits, misses);
+
+   printf("Demultiplexer: %llu packets in %llu us, %.1f MB/s, %llu sections, %llu repeated\n",
+      static_cast<unsigned long long>(demultiplexer.Packets()), static_cast<unsigned long long>(duration),
+      (duration == 0 ? 0.0 : static_cast<double>(bytes) / static_cast<double>(duration)),
+      static_cast<unsigned long long>(demultiplexer.Sections()), static_cast<unsigned long long>(hits));
+
+   EXPECT_EQ(demultiplexer.Packets(), 13ULL * repeats);
+
+   Core::Singleton::Dispose();
+}
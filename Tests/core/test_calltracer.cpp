@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <com/com.h>
+
+using namespace WPEFramework;
+
+namespace {
+
+class Implementation {
+public:
+   uint64_t _value;
+};
+
+const char g_traceDirectory[] = "/tmp/";
+
+}
+
+TEST(Core_CallTracer, traceRoundTrip)
+{
+   Implementation implementation;
+   RPC::Data::Input input;
+
+   // A method id beyond 127 is a method like any other, also when traced.
+   input.Set(&implementation, 0x12345678, 200);
+   input.Writer().Number<uint32_t>(0xCAFEBABE);
+
+   const uint32_t length = input.Length();
+
+   input.Trace(42, 0x0102030405060708ULL);
+   EXPECT_TRUE(input.IsTraced());
+   EXPECT_EQ(input.Length(), length + RPC::Data::Input::TraceSize);
+   EXPECT_EQ(input.MethodId(), 200u);
+   EXPECT_EQ(input.Implementation<Implementation>(), &implementation);
+
+   // A stub that does not know about tracing finds its parameters where they always were.
+   EXPECT_EQ(input.Reader().Number<uint32_t>(), 0xCAFEBABEu);
+
+   uint32_t traceId = 0;
+   uint64_t sent = 0;
+
+   input.Untrace(traceId, sent);
+   EXPECT_FALSE(input.IsTraced());
+   EXPECT_EQ(traceId, 42u);
+   EXPECT_EQ(sent, 0x0102030405060708ULL);
+   EXPECT_EQ(input.Length(), length);
+   EXPECT_EQ(input.MethodId(), 200u);
+   EXPECT_EQ(input.InterfaceId(), 0x12345678u);
+   EXPECT_EQ(input.Reader().Number<uint32_t>(), 0xCAFEBABEu);
+
+   RPC::Data::Output output;
+   output.Writer().Number<uint64_t>(0x1122334455667788ULL);
+
+   output.Trace(1000, 2000, 3, 4);
+   EXPECT_EQ(output.Length(), sizeof(uint64_t) + RPC::Data::Output::TraceSize);
+
+   uint64_t received = 0, returned = 0;
+   uint32_t process = 0, thread = 0;
+
+   EXPECT_TRUE(output.Untrace(received, returned, process, thread));
+   EXPECT_EQ(received, 1000u);
+   EXPECT_EQ(returned, 2000u);
+   EXPECT_EQ(process, 3u);
+   EXPECT_EQ(thread, 4u);
+   EXPECT_EQ(output.Length(), sizeof(uint64_t));
+   EXPECT_EQ(output.Reader().Number<uint64_t>(), 0x1122334455667788ULL);
+}
+
+TEST(Core_CallTracer, untracedFrames)
+{
+   Implementation implementation;
+   RPC::Data::Input input;
+
+   // Method ids with the highest bit set are not mistaken for a trace.
+   input.Set(&implementation, 0x00000042, 0x80);
+   input.Writer().Number<uint64_t>(0xFFFFFFFFFFFFFFFFULL);
+   EXPECT_FALSE(input.IsTraced());
+   EXPECT_EQ(input.MethodId(), 0x80u);
+   EXPECT_EQ(input.Implementation<Implementation>(), &implementation);
+
+   // Parameters as long as the trace information are only a trace if they close with the check.
+   RPC::Data::Input other;
+   other.Set(&implementation, 0x00000042, 1);
+   other.Writer().Number<uint32_t>(42);
+   other.Writer().Number<uint64_t>(0x0102030405060708ULL);
+   other.Writer().Number<uint32_t>(0x54524143);
+   EXPECT_FALSE(other.IsTraced());
+
+   // An answer without the trace information is left as it is, however long it is.
+   RPC::Data::Output output;
+   RPC::Data::Frame::Writer writer(output.Writer());
+
+   for (uint8_t index = 0; index < 8; index++) {
+      writer.Number<uint32_t>(0x10101010 * index);
+   }
+
+   const uint32_t length = output.Length();
+   ASSERT_GE(length, static_cast<uint32_t>(RPC::Data::Output::TraceSize));
+
+   uint64_t received = 0, returned = 0;
+   uint32_t process = 0, thread = 0;
+
+   EXPECT_FALSE(output.Untrace(received, returned, process, thread));
+   EXPECT_EQ(output.Length(), length);
+
+   RPC::Data::Frame::Reader reader(output.Reader());
+   for (uint8_t index = 0; index < 8; index++) {
+      EXPECT_EQ(reader.Number<uint32_t>(), 0x10101010u * index);
+   }
+}
+
+TEST(Core_CallTracer, openAndClose)
+{
+   RPC::CallTracer& tracer(RPC::CallTracer::Instance());
+   const string fileName(string(g_traceDirectory) + COMRPC_TRACE_PREFIX + '.' + Core::NumberType<uint32_t>(RPC::CallTracer::ProcessId()).Text());
+
+   // Too small for a single span, it still holds the minimum.
+   ASSERT_EQ(tracer.Open(g_traceDirectory, 1, 10), Core::ERROR_NONE);
+   EXPECT_TRUE(tracer.IsActive());
+   EXPECT_TRUE(Core::File(fileName).Exists());
+
+   RPC::CallTracer::Span span;
+   ::memset(&span, 0, sizeof(span));
+   span.TraceId = tracer.Sample();
+   span.Sent = 1000;
+   span.Received = 2000;
+   span.Returned = 3000;
+   span.Completed = 4000;
+   tracer.Record(span);
+
+   string json;
+   EXPECT_EQ(RPC::CallTracer::Export(g_traceDirectory, json), Core::ERROR_NONE);
+   EXPECT_NE(json.find(_T("\"trace\":") + Core::NumberType<uint32_t>(span.TraceId).Text() + _T("}")), string::npos);
+
+   // Closing leaves nothing behind.
+   EXPECT_EQ(tracer.Close(), Core::ERROR_NONE);
+   EXPECT_FALSE(tracer.IsActive());
+   EXPECT_FALSE(Core::File(fileName).Exists());
+
+   Core::Singleton::Dispose();
+}
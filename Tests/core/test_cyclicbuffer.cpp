@@ -0,0 +1,351 @@
+#include "../IPTestAdministrator.h"
+
+#include <gtest/gtest.h>
+#include <core/core.h>
+
+#include <sched.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+namespace {
+
+const uint32_t g_cyclicBufferSize = 64 * 1024;
+const uint32_t g_recordSize = 256;
+const uint32_t g_recordCount = 64 * 1024;
+const char g_cyclicBufferName[] = "/tmp/cyclicbuffer01";
+
+struct Throughput {
+   uint32_t received;
+   uint32_t outOfOrder;
+   uint64_t duration; // In microseconds.
+};
+
+// Consumer runs in this process, the producer on the other side, so each record crosses the process boundary.
+Throughput MeasureThroughput(const bool lockFree)
+{
+   IPTestAdministrator::OtherSideMain otherSide = [](IPTestAdministrator & testAdmin) {
+      testAdmin.Sync("setup consumer");
+
+      CyclicBuffer buffer(g_cyclicBufferName);
+
+      uint8_t record[g_recordSize];
+      memset(record, 0xAA, sizeof(record));
+
+      testAdmin.Sync("start");
+
+      for (uint32_t index = 0; index < g_recordCount; index++) {
+         // Do not let the buffer overwrite records the consumer did not read yet.
+         while (buffer.Free() <= g_recordSize) {
+            ::SleepMs(0);
+         }
+
+         memcpy(record, &index, sizeof(index));
+
+         buffer.Reserve(g_recordSize);
+         buffer.Write(record, g_recordSize);
+      }
+
+      testAdmin.Sync("done");
+   };
+
+   Throughput result = {};
+
+   IPTestAdministrator testAdmin(otherSide);
+
+   {
+      CyclicBuffer buffer(g_cyclicBufferName, g_cyclicBufferSize, false, lockFree);
+      EXPECT_EQ(buffer.IsLockFree(), lockFree);
+
+      testAdmin.Sync("setup consumer");
+
+      uint8_t record[g_recordSize];
+      uint32_t expected = 0;
+      uint32_t idle = 0;
+
+      testAdmin.Sync("start");
+
+      uint64_t start = Time::Now().Ticks();
+
+      while ((result.received < g_recordCount) && (idle < 10)) {
+         if (buffer.Lock(true, 100) == ERROR_NONE) {
+            while (buffer.Read(record, g_recordSize) == g_recordSize) {
+               uint32_t sequence;
+               memcpy(&sequence, record, sizeof(sequence));
+
+               if (sequence != expected) {
+                  result.outOfOrder++;
+               }
+               expected = sequence + 1;
+               result.received++;
+            }
+            buffer.Unlock();
+            idle = 0;
+         } else {
+            idle++;
+         }
+      }
+
+      result.duration = Time::Now().Ticks() - start;
+
+      testAdmin.Sync("done");
+   }
+
+   return (result);
+}
+
+// Moves "count" records of "recordSize" through the buffer, either copying them with Reserve/Write/Read or filling
+// and draining them in place with Reserve/Commit and Claim/Release. Returns the time it took in microseconds.
+uint64_t MeasureRecords(CyclicBuffer& buffer, const uint32_t recordSize, const uint32_t count, const bool zeroCopy)
+{
+   uint8_t* record = new uint8_t[recordSize];
+   uint32_t failures = 0;
+
+   memset(record, 0x55, recordSize);
+
+   uint64_t start = Time::Now().Ticks();
+
+   for (uint32_t index = 0; index < count; index++) {
+      if (zeroCopy == false) {
+         memcpy(record, &index, sizeof(index));
+         buffer.Reserve(recordSize);
+         buffer.Write(record, recordSize);
+
+         if (buffer.Read(record, recordSize) != recordSize) {
+            failures++;
+         }
+      } else {
+         CyclicBuffer::Span span;
+
+         buffer.Reserve(recordSize, span);
+         memcpy(span.Data(0), &index, std::min(static_cast<uint32_t>(sizeof(index)), span.Length(0)));
+         buffer.Commit(recordSize);
+
+         if ((buffer.Claim(recordSize, span) != recordSize) || (buffer.Release(span) != recordSize)) {
+            failures++;
+         }
+      }
+   }
+
+   uint64_t duration = Time::Now().Ticks() - start;
+
+   EXPECT_EQ(failures, 0u);
+
+   delete[] record;
+
+   return (duration);
+}
+
+void Report(const char name[], const Throughput& measurement)
+{
+   uint64_t bytes = static_cast<uint64_t>(measurement.received) * g_recordSize;
+
+   printf("CyclicBuffer %-8s: %u records of %u bytes in %llu us, %.1f MB/s\n",
+      name, measurement.received, g_recordSize,
+      static_cast<unsigned long long>(measurement.duration),
+      (measurement.duration == 0 ? 0.0 : static_cast<double>(bytes) / static_cast<double>(measurement.duration)));
+}
+
+}
+
+TEST(Core_CyclicBuffer, crossProcessThroughput)
+{
+   Throughput locked = MeasureThroughput(false);
+   Report("mutex", locked);
+
+   EXPECT_EQ(locked.received, g_recordCount);
+   EXPECT_EQ(locked.outOfOrder, 0u);
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+   Throughput lockFree = MeasureThroughput(true);
+   Report("futex", lockFree);
+
+   EXPECT_EQ(lockFree.received, g_recordCount);
+   EXPECT_EQ(lockFree.outOfOrder, 0u);
+#endif
+
+   Core::Singleton::Dispose();
+}
+
+#if defined(__LINUX__) && !defined(__APPLE__)
+TEST(Core_CyclicBuffer, reservationOfDeadProducer)
+{
+   CyclicBuffer buffer(g_cyclicBufferName, 1024, false, true);
+
+   ASSERT_TRUE(buffer.IsLockFree());
+
+   // A producer that dies halfway its reservation, does not block the others forever.
+   pid_t child = ::fork();
+   if (child == 0) {
+      CyclicBuffer producer(g_cyclicBufferName);
+      producer.Reserve(64);
+      ::_exit(0);
+   }
+   ASSERT_GT(child, 0);
+   ::waitpid(child, nullptr, 0);
+
+   uint8_t data[32];
+   memset(data, 0xAA, sizeof(data));
+
+   uint64_t start = Time::Now().Ticks();
+   EXPECT_EQ(buffer.Reserve(sizeof(data)), sizeof(data));
+   EXPECT_LT(Time::Now().Ticks() - start, 5000u * Time::TicksPerMillisecond);
+   EXPECT_EQ(buffer.Write(data, sizeof(data)), sizeof(data));
+
+   EXPECT_EQ(buffer.Read(data, sizeof(data)), sizeof(data));
+   EXPECT_EQ(data[0], 0xAA);
+}
+
+TEST(Core_CyclicBuffer, reservationOfDeadProducerInOtherNamespace)
+{
+   CyclicBuffer buffer(g_cyclicBufferName, 1024, false, true);
+
+   ASSERT_TRUE(buffer.IsLockFree());
+
+   // The producer is the first process of a new PID namespace, so its PID is 1, which is alive here.
+   pid_t child = ::fork();
+   if (child == 0) {
+      int result = 1;
+
+      if (::unshare(CLONE_NEWPID) == 0) {
+         pid_t grandChild = ::fork();
+         if (grandChild == 0) {
+            CyclicBuffer producer(g_cyclicBufferName);
+            producer.Reserve(64);
+            ::_exit(::getpid() == 1 ? 0 : 1);
+         }
+         int status = 1;
+         ::waitpid(grandChild, &status, 0);
+         result = WEXITSTATUS(status);
+      }
+      ::_exit(result);
+   }
+   ASSERT_GT(child, 0);
+
+   int status = 1;
+   ::waitpid(child, &status, 0);
+
+   if (WEXITSTATUS(status) != 0) {
+      GTEST_SKIP() << "Not allowed to create a PID namespace";
+   }
+
+   uint8_t data[32];
+   memset(data, 0xBB, sizeof(data));
+
+   uint64_t start = Time::Monotonic();
+   EXPECT_EQ(buffer.Reserve(sizeof(data)), sizeof(data));
+   EXPECT_LT(Time::Monotonic() - start, 5000u * Time::TicksPerMillisecond);
+   EXPECT_EQ(buffer.Write(data, sizeof(data)), sizeof(data));
+
+   EXPECT_EQ(buffer.Read(data, sizeof(data)), sizeof(data));
+   EXPECT_EQ(data[0], 0xBB);
+}
+
+TEST(Core_CyclicBuffer, reservationOfLiveProducer)
+{
+   CyclicBuffer buffer(g_cyclicBufferName, 1024, false, true);
+
+   ASSERT_TRUE(buffer.IsLockFree());
+
+   int reserved[2];
+   ASSERT_EQ(::pipe(reserved), 0);
+
+   // A producer that takes longer than the checks of the waiting producers, keeps its reservation.
+   pid_t child = ::fork();
+   if (child == 0) {
+      CyclicBuffer producer(g_cyclicBufferName);
+      uint8_t data[64];
+      memset(data, 0x11, sizeof(data));
+      producer.Reserve(sizeof(data));
+      ::write(reserved[1], data, 1);
+      SleepMs(500);
+      producer.Write(data, sizeof(data));
+      ::_exit(0);
+   }
+   ASSERT_GT(child, 0);
+
+   // Wait till the child holds its reservation.
+   uint8_t signal;
+   EXPECT_EQ(::read(reserved[0], &signal, 1), 1);
+   ::close(reserved[0]);
+   ::close(reserved[1]);
+
+   uint8_t data[32];
+   memset(data, 0x22, sizeof(data));
+
+   EXPECT_EQ(buffer.Reserve(sizeof(data)), sizeof(data));
+   EXPECT_EQ(buffer.Write(data, sizeof(data)), sizeof(data));
+   ::waitpid(child, nullptr, 0);
+
+   uint8_t first[64];
+   EXPECT_EQ(buffer.Read(first, sizeof(first)), sizeof(first));
+   EXPECT_EQ(first[0], 0x11);
+   EXPECT_EQ(first[63], 0x11);
+   EXPECT_EQ(buffer.Read(data, sizeof(data)), sizeof(data));
+   EXPECT_EQ(data[0], 0x22);
+}
+#endif
+
+TEST(Core_CyclicBuffer, zeroCopySpans)
+{
+   const uint32_t bufferSize = 100;
+
+   CyclicBuffer buffer(g_cyclicBufferName, bufferSize, false);
+   CyclicBuffer::Span span;
+   uint8_t data[80];
+
+   // Move the head and tail close to the end, so the next record wraps.
+   memset(data, 0, sizeof(data));
+   buffer.Write(data, 80);
+   EXPECT_EQ(buffer.Read(data, 80), 80u);
+
+   EXPECT_EQ(buffer.Reserve(40, span), 40u);
+   EXPECT_EQ(span.Size(), 40u);
+   EXPECT_EQ(span.Length(0), 20u);
+   EXPECT_EQ(span.Length(1), 20u);
+
+   for (uint8_t index = 0; index < 40; index++) {
+      uint8_t segment = (index < span.Length(0) ? 0 : 1);
+      span.Data(segment)[segment == 0 ? index : index - span.Length(0)] = index;
+   }
+   EXPECT_EQ(buffer.Used(), 0u);
+   EXPECT_EQ(buffer.Commit(40), 40u);
+   EXPECT_EQ(buffer.Used(), 40u);
+
+   EXPECT_EQ(buffer.Peek(data, 40), 40u);
+   for (uint8_t index = 0; index < 40; index++) {
+      EXPECT_EQ(data[index], index);
+   }
+
+   EXPECT_EQ(buffer.Claim(40, span), 40u);
+   EXPECT_EQ(span.Length(0), 20u);
+   EXPECT_EQ(span.Data(1)[0], 20);
+   EXPECT_EQ(buffer.Release(span), 40u);
+   EXPECT_EQ(buffer.Used(), 0u);
+
+   // A released span can not be released again, the tail moved.
+   EXPECT_EQ(buffer.Release(span), 0u);
+
+   Core::Singleton::Dispose();
+}
+
+TEST(Core_CyclicBuffer, recordThroughput)
+{
+   const uint32_t recordSizes[] = { 16, 1024, 64 * 1024 };
+   const uint64_t volume = 256 * 1024 * 1024;
+
+   CyclicBuffer buffer(g_cyclicBufferName, 1024 * 1024, false);
+
+   for (uint8_t index = 0; index < (sizeof(recordSizes) / sizeof(recordSizes[0])); index++) {
+      const uint32_t recordSize = recordSizes[index];
+      const uint32_t count = static_cast<uint32_t>(std::min(volume / recordSize, static_cast<uint64_t>(1024 * 1024)));
+
+      uint64_t copied = MeasureRecords(buffer, recordSize, count, false);
+      uint64_t inPlace = MeasureRecords(buffer, recordSize, count, true);
+
+      printf("CyclicBuffer %6u byte records: copy %8.1f ns/record, zero-copy %8.1f ns/record\n", recordSize,
+         (static_cast<double>(copied) * 1000.0) / count, (static_cast<double>(inPlace) * 1000.0) / count);
+   }
+
+   Core::Singleton::Dispose();
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <core/core.h>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+namespace {
+
+const uint32_t g_mappingSize = 64 * 1024 * 1024;
+const uint32_t g_randomAccesses = 4 * 1024 * 1024;
+const char g_mappingName[] = "/dev/shm/dataelementfile01";
+
+// Counts the data TLB misses of this thread, if the kernel and the hardware allow it.
+class TLBMisses {
+public:
+   TLBMisses(const TLBMisses&) = delete;
+   TLBMisses& operator=(const TLBMisses&) = delete;
+
+   TLBMisses()
+      : _descriptor(-1)
+   {
+      struct perf_event_attr attributes;
+
+      memset(&attributes, 0, sizeof(attributes));
+      attributes.size = sizeof(attributes);
+      attributes.type = PERF_TYPE_HW_CACHE;
+      attributes.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      attributes.exclude_kernel = 1;
+      attributes.exclude_hv = 1;
+
+      _descriptor = static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+   }
+   ~TLBMisses()
+   {
+      if (_descriptor != -1) {
+         ::close(_descriptor);
+      }
+   }
+
+   bool IsValid() const
+   {
+      return (_descriptor != -1);
+   }
+   uint64_t Value() const
+   {
+      uint64_t result = 0;
+
+      if ((_descriptor != -1) && (::read(_descriptor, &result, sizeof(result)) != sizeof(result))) {
+         result = 0;
+      }
+
+      return (result);
+   }
+
+private:
+   int _descriptor;
+};
+
+struct Latency {
+   uint64_t map;         // Constructing the mapping, in microseconds.
+   uint64_t firstAccess; // Touching every page once, in microseconds.
+   uint64_t random;      // Random reads over the complete mapping, in microseconds.
+   uint64_t misses;      // Data TLB misses during the random reads.
+};
+
+Latency Measure(const uint32_t options)
+{
+   Latency result = {};
+   TLBMisses counter;
+   uint32_t checksum = 0;
+
+   ::unlink(g_mappingName);
+
+   uint64_t start = Time::Now().Ticks();
+
+   DataElementFile mapping(g_mappingName, DataElementFile::READABLE | DataElementFile::WRITABLE | DataElementFile::SHAREABLE | DataElementFile::CREATE | options, g_mappingSize);
+
+   result.map = Time::Now().Ticks() - start;
+
+   EXPECT_TRUE(mapping.IsValid());
+
+   if (mapping.IsValid() == true) {
+      uint8_t* buffer = mapping.Buffer();
+      const uint32_t pageSize = getpagesize();
+
+      start = Time::Now().Ticks();
+
+      for (uint32_t offset = 0; offset < g_mappingSize; offset += pageSize) {
+         buffer[offset] = static_cast<uint8_t>(offset >> 12);
+      }
+
+      result.firstAccess = Time::Now().Ticks() - start;
+
+      uint64_t misses = counter.Value();
+      uint32_t index = 0x12345678;
+
+      start = Time::Now().Ticks();
+
+      for (uint32_t count = 0; count < g_randomAccesses; count++) {
+         // A cheap LCG is good enough to defeat the prefetchers.
+         index = (index * 1664525) + 1013904223;
+         checksum += buffer[index % g_mappingSize];
+      }
+
+      result.random = Time::Now().Ticks() - start;
+      result.misses = counter.Value() - misses;
+   }
+
+   ::unlink(g_mappingName);
+
+   // Keep the compiler from optimising the random reads away.
+   EXPECT_NE(checksum, 0xFFFFFFFF);
+
+   return (result);
+}
+
+void Report(const char name[], const Latency& measurement, const bool counted)
+{
+   printf("DataElementFile %-10s: map %7llu us, first access %7llu us (%6.1f ns/page), random %7.1f ns/read, dTLB misses %s\n",
+      name,
+      static_cast<unsigned long long>(measurement.map),
+      static_cast<unsigned long long>(measurement.firstAccess),
+      (static_cast<double>(measurement.firstAccess) * 1000.0) / (g_mappingSize / getpagesize()),
+      (static_cast<double>(measurement.random) * 1000.0) / g_randomAccesses,
+      (counted == true ? std::to_string(measurement.misses).c_str() : "n/a"));
+}
+
+}
+
+TEST(Core_DataElementFile, mappingOptions)
+{
+   const char name[] = "/dev/shm/dataelementfile02";
+   const uint32_t options = DataElementFile::PREFAULT | DataElementFile::WILLNEED | DataElementFile::HUGETLB;
+
+   ::unlink(name);
+
+   {
+      DataElementFile producer(name, DataElementFile::READABLE | DataElementFile::WRITABLE | DataElementFile::SHAREABLE | DataElementFile::CREATE | options, 10000);
+
+      ASSERT_TRUE(producer.IsValid());
+      EXPECT_EQ(producer.Flags() & options, options);
+      EXPECT_EQ(producer.Size(), 10000u);
+
+      // Not on a hugetlbfs mount, so the HUGETLB option falls back to the regular page size.
+      EXPECT_EQ(producer.PageSize(), static_cast<uint32_t>(getpagesize()));
+      EXPECT_EQ(producer.AllocatedSize() % producer.PageSize(), 0u);
+
+      memset(producer.Buffer(), 0xA5, 10000);
+
+      DataElementFile consumer(name, DataElementFile::READABLE | DataElementFile::WRITABLE | DataElementFile::SHAREABLE | DataElementFile::SEQUENTIAL);
+
+      ASSERT_TRUE(consumer.IsValid());
+      EXPECT_EQ(consumer.Buffer()[0], 0xA5);
+      EXPECT_EQ(consumer.Buffer()[9999], 0xA5);
+   }
+
+   ::unlink(name);
+}
+
+TEST(Core_DataElementFile, sharedBufferMapping)
+{
+   const char name[] = "/dev/shm/dataelementfile03";
+
+   {
+      // The mapping options travel in their own type, next to the producer and consumer signatures.
+      SharedBuffer producer(name, 4096, 16, DataElementFile::Mapping(DataElementFile::PREFAULT));
+      SharedBuffer consumer(name);
+
+      ASSERT_TRUE(producer.IsValid());
+      ASSERT_TRUE(consumer.IsValid());
+      EXPECT_EQ(producer.Flags() & DataElementFile::PREFAULT, static_cast<uint32_t>(DataElementFile::PREFAULT));
+      EXPECT_EQ(consumer.Flags() & DataElementFile::PREFAULT, 0u);
+      EXPECT_EQ(consumer.Size(), 4096u);
+   }
+
+   ::unlink(name);
+   ::unlink((string(name) + ".admin").c_str());
+}
+
+TEST(Core_DataElementFile, firstAccessLatency)
+{
+   const bool counted = TLBMisses().IsValid();
+
+   Report("default", Measure(0), counted);
+   Report("prefault", Measure(DataElementFile::PREFAULT), counted);
+   Report("willneed", Measure(DataElementFile::WILLNEED), counted);
+   Report("hugepages", Measure(DataElementFile::HUGEPAGES), counted);
+   Report("both", Measure(DataElementFile::PREFAULT | DataElementFile::HUGEPAGES), counted);
+
+   Core::Singleton::Dispose();
+}
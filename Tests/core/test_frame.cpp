@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <com/com.h>
+
+using namespace WPEFramework;
+
+namespace {
+
+// Sends the frame out in chunks, the way the IPC serializer does.
+std::vector<uint8_t> Stream(const RPC::Data::Frame& frame, const uint16_t chunk)
+{
+   std::vector<uint8_t> result(frame.Length());
+   uint32_t offset = 0;
+
+   while (offset < frame.Length()) {
+      offset += frame.Serialize(offset, &(result[offset]), static_cast<uint16_t>(std::min(static_cast<uint32_t>(chunk), frame.Length() - offset)));
+   }
+
+   return (result);
+}
+
+void Fill(std::vector<uint8_t>& buffer, const uint8_t seed)
+{
+   for (uint32_t index = 0; index < buffer.size(); index++) {
+      buffer[index] = static_cast<uint8_t>(seed + (index * 7));
+   }
+}
+
+void Write(RPC::Data::Frame& frame, const std::vector<uint8_t>& first, const std::vector<uint8_t>& second)
+{
+   RPC::Data::Frame::Writer writer(frame, 0);
+
+   writer.Number<uint32_t>(0x12345678);
+   writer.Reference<uint32_t>(static_cast<uint32_t>(first.size()), first.data());
+   writer.Text(_T("between"));
+   writer.Reference<uint16_t>(static_cast<uint16_t>(second.size()), second.data());
+   writer.Boolean(true);
+}
+
+void Check(const RPC::Data::Frame& frame, const std::vector<uint8_t>& first, const std::vector<uint8_t>& second)
+{
+   RPC::Data::Frame::Reader reader(frame, 0);
+   const uint8_t* buffer;
+
+   EXPECT_EQ(reader.Number<uint32_t>(), 0x12345678u);
+
+   uint32_t length = reader.LockBuffer<uint32_t>(buffer);
+   ASSERT_EQ(length, first.size());
+   EXPECT_EQ(::memcmp(buffer, first.data(), length), 0);
+   reader.UnlockBuffer(length);
+
+   EXPECT_EQ(reader.Text(), _T("between"));
+
+   uint16_t size = reader.LockBuffer<uint16_t>(buffer);
+   ASSERT_EQ(size, second.size());
+   EXPECT_EQ(::memcmp(buffer, second.data(), size), 0);
+   reader.UnlockBuffer(size);
+
+   EXPECT_TRUE(reader.Boolean());
+   EXPECT_FALSE(reader.HasData());
+}
+
+}
+
+TEST(Core_Frame, beyond64K)
+{
+   RPC::Data::Frame frame;
+   std::vector<uint8_t> data(200 * 1024);
+
+   Fill(data, 3);
+
+   RPC::Data::Frame::Writer writer(frame, 0);
+   writer.Buffer<uint32_t>(static_cast<uint32_t>(data.size()), data.data());
+   writer.Number<uint64_t>(42);
+
+   EXPECT_EQ(frame.Size(), sizeof(uint32_t) + data.size() + sizeof(uint64_t));
+
+   RPC::Data::Frame::Reader reader(frame, 0);
+   std::vector<uint8_t> result(data.size());
+
+   EXPECT_EQ(reader.Buffer<uint32_t>(static_cast<uint32_t>(result.size()), result.data()), data.size());
+   EXPECT_EQ(result, data);
+   EXPECT_EQ(reader.Number<uint64_t>(), 42u);
+}
+
+TEST(Core_Frame, gatheredBuffers)
+{
+   std::vector<uint8_t> first(100 * 1024);
+   std::vector<uint8_t> second(2000);
+
+   Fill(first, 1);
+   Fill(second, 2);
+
+   RPC::Data::Frame copied;
+   RPC::Data::Frame gathered(true);
+
+   Write(copied, first, second);
+   Write(gathered, first, second);
+
+   // Only the small parts went into the frame, the wire sees the same.
+   EXPECT_LT(gathered.Size(), 1024u);
+   EXPECT_EQ(gathered.Length(), copied.Length());
+
+   for (uint16_t chunk : { 1, 13, 1000, 8192 }) {
+      EXPECT_EQ(Stream(gathered, chunk), Stream(copied, chunk));
+   }
+
+   // And the receiver reads it back as any other frame.
+   std::vector<uint8_t> stream(Stream(gathered, 4096));
+   RPC::Data::Frame received;
+   received.Deserialize(0, stream.data(), static_cast<uint16_t>(std::min(stream.size(), static_cast<size_t>(0xFFFF))));
+   for (uint32_t offset = 0xFFFF; offset < stream.size(); offset += 0xFFFF) {
+      received.Deserialize(offset, &(stream[offset]), static_cast<uint16_t>(std::min(stream.size() - offset, static_cast<size_t>(0xFFFF))));
+   }
+
+   Check(received, first, second);
+}
+
+TEST(Core_Frame, detach)
+{
+   std::vector<uint8_t> first(8 * 1024);
+   std::vector<uint8_t> second(4000);
+
+   Fill(first, 5);
+   Fill(second, 6);
+
+   RPC::Data::Frame gathered(true);
+   Write(gathered, first, second);
+
+   const uint32_t length = gathered.Length();
+   const std::vector<uint8_t> before(Stream(gathered, 512));
+
+   gathered.Detach();
+
+   // The caller may now reuse its buffers.
+   Fill(first, 9);
+   Fill(second, 9);
+
+   EXPECT_EQ(gathered.Size(), length);
+   EXPECT_EQ(gathered.Length(), length);
+   EXPECT_EQ(Stream(gathered, 512), before);
+
+   gathered.Clear();
+   EXPECT_EQ(gathered.Length(), 0u);
+}
+
+TEST(Core_Frame, storage)
+{
+   uint32_t size = 1000;
+   uint8_t* block = Core::FrameStorage::Allocate(size);
+
+   ASSERT_NE(block, nullptr);
+   EXPECT_EQ(size, 1024u);
+
+   Core::FrameStorage::Release(block, size);
+
+   // The released block is handed out again, for the same size class.
+   uint32_t again = 1024;
+   EXPECT_EQ(Core::FrameStorage::Allocate(again), block);
+   EXPECT_EQ(again, 1024u);
+   Core::FrameStorage::Release(block, again);
+
+   uint32_t large = Core::FrameStorage::LargestBlock + 1;
+   uint8_t* huge = Core::FrameStorage::Allocate(large);
+   ASSERT_NE(huge, nullptr);
+   EXPECT_EQ(large, Core::FrameStorage::LargestBlock + 1);
+   Core::FrameStorage::Release(huge, large);
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <core/core.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+namespace {
+
+// The reported value of a bucket may be at most 1/SubBuckets above the recorded one.
+void ExpectClose(const uint32_t reported, const uint32_t recorded)
+{
+   EXPECT_GE(reported, recorded);
+   EXPECT_LE(reported - recorded, std::max(static_cast<uint32_t>(1), recorded / Histogram::SubBuckets));
+}
+
+}
+
+TEST(Core_Histogram, buckets)
+{
+   uint16_t previous = 0;
+
+   // Small values are exact, buckets never go backwards and a value maps inside its own bucket.
+   for (uint32_t value = 0; value < (1 << 20); value++) {
+      uint16_t index = Histogram::Index(value);
+
+      EXPECT_GE(index, previous);
+      EXPECT_LE(index - previous, 1);
+      ExpectClose(Histogram::Value(index), value);
+
+      if (value < (2 * Histogram::SubBuckets)) {
+         EXPECT_EQ(Histogram::Value(index), value);
+      }
+
+      previous = index;
+   }
+
+   EXPECT_EQ(Histogram::Index(static_cast<uint32_t>(~0)), Histogram::Buckets - 1);
+   EXPECT_EQ(Histogram::Value(Histogram::Buckets - 1), static_cast<uint32_t>(~0));
+}
+
+TEST(Core_Histogram, percentiles)
+{
+   Histogram histogram;
+   Histogram::Snapshot empty;
+
+   histogram.Merge(empty);
+   EXPECT_EQ(empty.Count(), 0u);
+   EXPECT_EQ(empty.Percentile(99.0), 0u);
+
+   std::mt19937 generator(42);
+   std::lognormal_distribution<double> latency(6.0, 1.5);
+   std::vector<uint32_t> recorded;
+
+   for (uint32_t index = 0; index < 100000; index++) {
+      uint32_t value = static_cast<uint32_t>(latency(generator));
+
+      recorded.push_back(value);
+      histogram.Set(value);
+   }
+
+   std::sort(recorded.begin(), recorded.end());
+
+   Histogram::Snapshot snapshot;
+   histogram.Merge(snapshot);
+
+   EXPECT_EQ(snapshot.Count(), recorded.size());
+   EXPECT_EQ(snapshot.Min(), recorded.front());
+   EXPECT_EQ(snapshot.Max(), recorded.back());
+   EXPECT_EQ(snapshot.Percentile(100.0), recorded.back());
+
+   const double percentiles[] = { 1.0, 50.0, 90.0, 99.0, 99.9 };
+
+   for (const double percentile : percentiles) {
+      uint32_t exact = recorded[static_cast<size_t>(((percentile * recorded.size()) / 100.0) + 0.5) - 1];
+
+      ExpectClose(snapshot.Percentile(percentile), exact);
+   }
+
+   histogram.Reset();
+
+   Histogram::Snapshot cleared;
+   histogram.Merge(cleared);
+   EXPECT_EQ(cleared.Count(), 0u);
+   EXPECT_EQ(cleared.Max(), 0u);
+}
+
+TEST(Core_Histogram, mergeAndShards)
+{
+   const uint8_t threadCount = 8;
+   const uint32_t perThread = 200000;
+
+   Histogram histogram(4);
+   std::vector<std::thread> threads;
+
+   for (uint8_t thread = 0; thread < threadCount; thread++) {
+      threads.emplace_back([&histogram, thread]() {
+         for (uint32_t index = 0; index < perThread; index++) {
+            histogram.Set((thread * 1000) + (index % 1000));
+         }
+      });
+   }
+   for (std::thread& thread : threads) {
+      thread.join();
+   }
+
+   Histogram::Snapshot snapshot;
+   histogram.Merge(snapshot);
+
+   // Not a single recording may get lost between the threads.
+   EXPECT_EQ(snapshot.Count(), static_cast<uint64_t>(threadCount) * perThread);
+   EXPECT_EQ(snapshot.Min(), 0u);
+   EXPECT_EQ(snapshot.Max(), static_cast<uint32_t>((threadCount * 1000) - 1));
+
+   Histogram other;
+   other.Set(1000000);
+
+   Histogram::Snapshot merged(snapshot);
+   other.Merge(merged);
+
+   EXPECT_EQ(merged.Count(), snapshot.Count() + 1);
+   EXPECT_EQ(merged.Max(), 1000000u);
+   EXPECT_EQ(merged.Percentile(50.0), snapshot.Percentile(50.0));
+
+   Histogram::Snapshot combined;
+   combined.Merge(snapshot);
+   combined.Merge(snapshot);
+   EXPECT_EQ(combined.Count(), 2 * snapshot.Count());
+   EXPECT_EQ(combined.Average(), snapshot.Average());
+}
@@ -0,0 +1,414 @@
+#include "../IPTestAdministrator.h"
+
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <com/com.h>
+
+namespace {
+
+const string g_connectorName = _T("/tmp/wperpc02");
+
+}
+
+namespace WPEFramework {
+namespace Exchange {
+    struct ISource : virtual public Core::IUnknown {
+        enum { ID = 0x80000002 };
+        // A copy of count strings, "element<n>".
+        virtual RPC::IStringIterator* Strings(const uint32_t count) = 0;
+        // A live view on the values, it grows with Append().
+        virtual RPC::IValueIterator* Values() = 0;
+        virtual void Append(const uint32_t count) = 0;
+        // The number of times the cursor of the Values() implementation was reset.
+        virtual uint32_t Resets() = 0;
+    };
+}
+}
+
+using namespace WPEFramework;
+
+namespace {
+
+class Source : public Exchange::ISource {
+private:
+   class Live : public RPC::IValueIterator {
+   public:
+      Live(const Live&) = delete;
+      Live& operator=(const Live&) = delete;
+
+      Live(Source* parent)
+         : _parent(*parent)
+         , _index(0)
+      {
+      }
+      ~Live() override
+      {
+      }
+
+   public:
+      bool Next(uint32_t& result) override
+      {
+         if (_index <= Count()) {
+            _index++;
+         }
+         if (IsValid() == true) {
+            result = Current();
+         }
+         return (IsValid());
+      }
+      bool Previous(uint32_t& result) override
+      {
+         if (_index > 0) {
+            _index = std::min(_index, Count() + 1) - 1;
+         }
+         if (IsValid() == true) {
+            result = Current();
+         }
+         return (IsValid());
+      }
+      void Reset(const uint32_t position) override
+      {
+         _parent._resets++;
+         _index = std::min(position, Count() + 1);
+      }
+      bool IsValid() const override
+      {
+         return ((_index > 0) && (_index <= Count()));
+      }
+      uint32_t Count() const override
+      {
+         return (static_cast<uint32_t>(_parent._values.size()));
+      }
+      uint32_t Current() const override
+      {
+         return (_parent._values[_index - 1]);
+      }
+
+      BEGIN_INTERFACE_MAP(Live)
+         INTERFACE_ENTRY(RPC::IValueIterator)
+      END_INTERFACE_MAP
+
+   private:
+      Source& _parent;
+      uint32_t _index;
+   };
+
+public:
+   Source(const Source&) = delete;
+   Source& operator=(const Source&) = delete;
+
+   Source()
+      : _values()
+      , _resets(0)
+   {
+   }
+   ~Source() override
+   {
+   }
+
+public:
+   RPC::IStringIterator* Strings(const uint32_t count) override
+   {
+      std::list<string> elements;
+
+      for (uint32_t index = 0; index < count; index++) {
+         elements.push_back(_T("element") + Core::NumberType<uint32_t>(index).Text());
+      }
+
+      return (Core::Service<RPC::StringIterator>::Create<RPC::IStringIterator>(elements));
+   }
+   RPC::IValueIterator* Values() override
+   {
+      return (Core::Service<Live>::Create<RPC::IValueIterator>(this));
+   }
+   void Append(const uint32_t count) override
+   {
+      for (uint32_t index = 0; index < count; index++) {
+         _values.push_back(static_cast<uint32_t>(_values.size()) * 3);
+      }
+   }
+   uint32_t Resets() override
+   {
+      return (_resets);
+   }
+
+   BEGIN_INTERFACE_MAP(Source)
+      INTERFACE_ENTRY(Exchange::ISource)
+   END_INTERFACE_MAP
+
+private:
+   std::vector<uint32_t> _values;
+   uint32_t _resets;
+};
+
+}
+
+// Proxystubs.
+namespace WPEFramework {
+
+ProxyStub::MethodHandler SourceStubMethods[] = {
+   [](Core::ProxyType<Core::IPCChannel>& channel, Core::ProxyType<RPC::InvokeMessage>& message) {
+      // virtual RPC::IStringIterator* Strings(const uint32_t count) = 0;
+      RPC::Data::Frame::Reader parameters(message->Parameters().Reader());
+      RPC::Data::Frame::Writer response(message->Response().Writer());
+
+      RPC::IStringIterator* output = message->Parameters().Implementation<Exchange::ISource>()->Strings(parameters.Number<uint32_t>());
+
+      response.Number<RPC::IStringIterator*>(output);
+      RPC::Administrator::Instance().RegisterInterface(channel, output);
+   },
+   [](Core::ProxyType<Core::IPCChannel>& channel, Core::ProxyType<RPC::InvokeMessage>& message) {
+      // virtual RPC::IValueIterator* Values() = 0;
+      RPC::Data::Frame::Writer response(message->Response().Writer());
+
+      RPC::IValueIterator* output = message->Parameters().Implementation<Exchange::ISource>()->Values();
+
+      response.Number<RPC::IValueIterator*>(output);
+      RPC::Administrator::Instance().RegisterInterface(channel, output);
+   },
+   [](Core::ProxyType<Core::IPCChannel>& channel VARIABLE_IS_NOT_USED, Core::ProxyType<RPC::InvokeMessage>& message) {
+      // virtual void Append(const uint32_t count) = 0;
+      RPC::Data::Frame::Reader parameters(message->Parameters().Reader());
+
+      message->Parameters().Implementation<Exchange::ISource>()->Append(parameters.Number<uint32_t>());
+   },
+   [](Core::ProxyType<Core::IPCChannel>& channel VARIABLE_IS_NOT_USED, Core::ProxyType<RPC::InvokeMessage>& message) {
+      // virtual uint32_t Resets() = 0;
+      RPC::Data::Frame::Writer response(message->Response().Writer());
+
+      response.Number<uint32_t>(message->Parameters().Implementation<Exchange::ISource>()->Resets());
+   },
+   nullptr
+};
+
+typedef ProxyStub::UnknownStubType<Exchange::ISource, SourceStubMethods> SourceStub;
+
+class SourceProxy : public ProxyStub::UnknownProxyType<Exchange::ISource> {
+public:
+   SourceProxy(const Core::ProxyType<Core::IPCChannel>& channel, void* implementation, const bool otherSideInformed)
+      : BaseClass(channel, implementation, otherSideInformed)
+   {
+   }
+   ~SourceProxy() override
+   {
+   }
+
+public:
+   RPC::IStringIterator* Strings(const uint32_t count) override
+   {
+      IPCMessage newMessage(BaseClass::Message(0));
+      RPC::Data::Frame::Writer writer(newMessage->Parameters().Writer());
+      RPC::IStringIterator* result = nullptr;
+
+      writer.Number<uint32_t>(count);
+
+      if (Invoke(newMessage) == Core::ERROR_NONE) {
+         RPC::Data::Frame::Reader reader(newMessage->Response().Reader());
+         result = reinterpret_cast<RPC::IStringIterator*>(Interface(reader.Number<void*>(), RPC::IStringIterator::ID));
+      }
+
+      return (result);
+   }
+   RPC::IValueIterator* Values() override
+   {
+      IPCMessage newMessage(BaseClass::Message(1));
+      RPC::IValueIterator* result = nullptr;
+
+      if (Invoke(newMessage) == Core::ERROR_NONE) {
+         RPC::Data::Frame::Reader reader(newMessage->Response().Reader());
+         result = reinterpret_cast<RPC::IValueIterator*>(Interface(reader.Number<void*>(), RPC::IValueIterator::ID));
+      }
+
+      return (result);
+   }
+   void Append(const uint32_t count) override
+   {
+      IPCMessage newMessage(BaseClass::Message(2));
+      RPC::Data::Frame::Writer writer(newMessage->Parameters().Writer());
+
+      writer.Number<uint32_t>(count);
+
+      Invoke(newMessage);
+   }
+   uint32_t Resets() override
+   {
+      IPCMessage newMessage(BaseClass::Message(3));
+      uint32_t result = 0;
+
+      if (Invoke(newMessage) == Core::ERROR_NONE) {
+         result = newMessage->Response().Reader().Number<uint32_t>();
+      }
+
+      return (result);
+   }
+};
+
+namespace {
+
+   class Instantiation {
+   public:
+      Instantiation()
+      {
+         RPC::Administrator::Instance().Announce<Exchange::ISource, SourceProxy, SourceStub>();
+      }
+      ~Instantiation()
+      {
+      }
+
+   } instantiation;
+}
+}
+
+namespace {
+
+class ExternalAccess : public RPC::Communicator {
+private:
+   ExternalAccess() = delete;
+   ExternalAccess(const ExternalAccess&) = delete;
+   ExternalAccess& operator=(const ExternalAccess&) = delete;
+
+public:
+   ExternalAccess(const Core::NodeId& source)
+      : RPC::Communicator(source, Core::ProxyType<RPC::InvokeServerType<4, 1>>::Create(), _T(""))
+   {
+      Open(Core::infinite);
+   }
+   ~ExternalAccess()
+   {
+      Close(Core::infinite);
+   }
+
+private:
+   void* Aquire(const string& className VARIABLE_IS_NOT_USED, const uint32_t interfaceId, const uint32_t versionId VARIABLE_IS_NOT_USED) override
+   {
+      void* result = nullptr;
+
+      if (interfaceId == Exchange::ISource::ID) {
+         result = Core::Service<Source>::Create<Exchange::ISource>();
+      }
+
+      return (result);
+   }
+};
+
+string Element(const uint32_t index)
+{
+   return (_T("element") + Core::NumberType<uint32_t>(index).Text());
+}
+
+}
+
+TEST(Core_RPC, iterators)
+{
+   IPTestAdministrator::OtherSideMain otherSide = [](IPTestAdministrator& testAdmin) {
+      ExternalAccess communicator(Core::NodeId(g_connectorName.c_str()));
+
+      testAdmin.Sync("setup server");
+
+      testAdmin.Sync("done testing");
+
+      communicator.Close(Core::infinite);
+   };
+
+   IPTestAdministrator testAdmin(otherSide);
+
+   testAdmin.Sync("setup server");
+
+   {
+      Core::ProxyType<RPC::IHandler> handler(Core::ProxyType<RPC::InvokeServerType<4, 1>>::Create(Core::Thread::DefaultStackSize()));
+      Core::ProxyType<RPC::CommunicatorClient> client(Core::ProxyType<RPC::CommunicatorClient>::Create(Core::NodeId(g_connectorName.c_str()), handler));
+
+      Exchange::ISource* source = client->Open<Exchange::ISource>(_T("Source"));
+
+      ASSERT_TRUE(source != nullptr);
+
+      // Strings, more than fit in a single batch, forward, backward and from a position.
+      for (const uint32_t count : { 0u, 1u, 5u, 1000u }) {
+         RPC::IStringIterator* strings = source->Strings(count);
+         string element;
+         uint32_t index = 0;
+
+         ASSERT_TRUE(strings != nullptr);
+         EXPECT_EQ(strings->Count(), count);
+
+         while (strings->Next(element) == true) {
+            EXPECT_EQ(element, Element(index));
+            EXPECT_EQ(strings->Current(), element);
+            index++;
+         }
+
+         EXPECT_EQ(index, count);
+         EXPECT_FALSE(strings->IsValid());
+
+         while (strings->Previous(element) == true) {
+            index--;
+            EXPECT_EQ(element, Element(index));
+         }
+
+         EXPECT_EQ(index, 0u);
+
+         if (count > 3) {
+            strings->Reset(3);
+            EXPECT_EQ(strings->Current(), Element(2));
+            EXPECT_TRUE(strings->Next(element));
+            EXPECT_EQ(element, Element(3));
+         }
+
+         strings->Reset(0);
+
+         RPC::IStringIterator* copy = Core::Service<RPC::StringIterator>::Create<RPC::IStringIterator>(strings);
+         EXPECT_EQ(copy->Count(), count);
+         copy->Release();
+
+         strings->Release();
+      }
+
+      // Values, a walk through them continues from the cursor of the implementation, only a jump resets it.
+      source->Append(1000);
+
+      RPC::IValueIterator* values = source->Values();
+      uint32_t value = 0;
+      uint32_t index = 0;
+
+      ASSERT_TRUE(values != nullptr);
+      EXPECT_EQ(values->Count(), 1000u);
+
+      while (values->Next(value) == true) {
+         EXPECT_EQ(value, index * 3);
+         index++;
+      }
+      EXPECT_EQ(index, 1000u);
+
+      const uint32_t resets = source->Resets();
+
+      EXPECT_EQ(resets, 1u);
+
+      values->Reset(500);
+      EXPECT_EQ(values->Current(), 499u * 3);
+      EXPECT_EQ(source->Resets(), resets + 1);
+
+      // The count is a snapshot, it is taken again on a Reset().
+      source->Append(24);
+      EXPECT_EQ(values->Count(), 1000u);
+
+      values->Reset(0);
+      EXPECT_EQ(values->Count(), 1024u);
+
+      index = 0;
+      while (values->Next(value) == true) {
+         EXPECT_EQ(value, index * 3);
+         index++;
+      }
+      EXPECT_EQ(index, 1024u);
+      EXPECT_EQ(source->Resets(), resets + 2);
+
+      values->Release();
+      source->Release();
+
+      client->Close(Core::infinite);
+      Core::Singleton::Dispose();
+   }
+
+   testAdmin.Sync("done testing");
+}
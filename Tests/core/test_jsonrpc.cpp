@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <core/core.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+TEST(Core_JSONRPC, methodStatistics)
+{
+   JSONRPC::Handler handler([](const uint32_t, const string&, const string&) {}, { 1 });
+   const JSONRPC::Connection connection(1, 1);
+   string response;
+
+   handler.Register<JSON::String, JSON::String>(_T("echo"), [](const JSON::String& inbound, JSON::String& outbound) -> uint32_t {
+      outbound = inbound.Value();
+      return (inbound.Value().empty() == true ? ERROR_BAD_REQUEST : ERROR_NONE);
+   });
+   handler.Register<void, void>(_T("idle"), []() -> uint32_t { return (ERROR_NONE); });
+
+   // Nothing is recorded, as long as the instrumentation is off.
+   EXPECT_FALSE(handler.IsInstrumented());
+   EXPECT_EQ(handler.Invoke(connection, _T("echo"), _T("\"hello\""), response), ERROR_NONE);
+
+   JSONRPC::Handler::Reports reports;
+   handler.Statistics(reports);
+   EXPECT_TRUE(reports.empty());
+
+   handler.Instrumentation(true);
+
+   EXPECT_EQ(handler.Invoke(connection, _T("echo"), _T("\"hello\""), response), ERROR_NONE);
+   EXPECT_EQ(response, _T("\"hello\""));
+   EXPECT_EQ(handler.Invoke(connection, _T("echo"), _T("\"\""), response), ERROR_BAD_REQUEST);
+   EXPECT_EQ(handler.Invoke(connection, _T("unknown"), _T(""), response), ERROR_UNKNOWN_KEY);
+
+   handler.Statistics(reports);
+   ASSERT_EQ(reports.size(), 1u);
+
+   const JSONRPC::Handler::Report& echo(reports[_T("echo")]);
+   EXPECT_EQ(echo.Calls(), 2u);
+   EXPECT_EQ(echo.Errors(), 1u);
+   EXPECT_EQ(echo.Received(), 9u);
+   EXPECT_EQ(echo.Sent(), 7u);
+   EXPECT_EQ(echo.Latency().Count(), 2u);
+
+   // A reset starts from zero, without losing what comes after it.
+   handler.ResetStatistics();
+   EXPECT_EQ(handler.Invoke(connection, _T("idle"), _T(""), response), ERROR_NONE);
+
+   reports.clear();
+   handler.Statistics(reports);
+   ASSERT_EQ(reports.size(), 2u);
+   EXPECT_EQ(reports[_T("echo")].Calls(), 0u);
+   EXPECT_EQ(reports[_T("echo")].Errors(), 0u);
+   EXPECT_EQ(reports[_T("echo")].Latency().Max(), 0u);
+   EXPECT_EQ(reports[_T("idle")].Calls(), 1u);
+   EXPECT_EQ(reports[_T("idle")].Received(), 0u);
+
+   handler.Instrumentation(false);
+   EXPECT_EQ(handler.Invoke(connection, _T("idle"), _T(""), response), ERROR_NONE);
+
+   reports.clear();
+   handler.Statistics(reports);
+   EXPECT_EQ(reports[_T("idle")].Calls(), 1u);
+}
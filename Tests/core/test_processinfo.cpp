@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <core/core.h>
+
+#include <sys/wait.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+TEST(Core_ProcessInfo, sampler)
+{
+   ProcessInfo::Sampler sampler;
+   ProcessInfo self;
+
+   EXPECT_EQ(sampler.Add(self.Id()), ERROR_NONE);
+   EXPECT_EQ(sampler.Add(self.Id()), ERROR_DUPLICATE_KEY);
+   EXPECT_EQ(sampler.Add(static_cast<uint32_t>(~0)), ERROR_UNAVAILABLE);
+
+   ProcessInfo::Sampler::Snapshot snapshot;
+   EXPECT_FALSE(sampler.Get(self.Id(), snapshot));
+
+   EXPECT_EQ(sampler.Sample(), 1u);
+   EXPECT_EQ(sampler.Cycle(), 1u);
+
+   ASSERT_TRUE(sampler.Get(self.Id(), snapshot));
+   EXPECT_EQ(snapshot.Id, self.Id());
+   EXPECT_EQ(snapshot.Parent, static_cast<uint32_t>(::getppid()));
+   EXPECT_EQ(snapshot.Name, self.Executable());
+   EXPECT_GE(snapshot.Threads, 1u);
+   EXPECT_GT(snapshot.Allocated, 0u);
+   EXPECT_GT(snapshot.Resident, 0u);
+   EXPECT_LE(snapshot.Resident, snapshot.Allocated);
+
+   uint64_t total = 0, idle = 0;
+   sampler.Ticks(total, idle);
+   EXPECT_GT(total, 0u);
+   EXPECT_LE(idle, total);
+
+   // A process that is gone, is dropped from the next cycle.
+   pid_t child = ::fork();
+   if (child == 0) {
+      ::pause();
+      ::_exit(0);
+   }
+   ASSERT_GT(child, 0);
+   EXPECT_EQ(sampler.Add(static_cast<uint32_t>(child)), ERROR_NONE);
+   EXPECT_EQ(sampler.Sample(), 2u);
+
+   ::kill(child, SIGKILL);
+   ::waitpid(child, nullptr, 0);
+
+   EXPECT_EQ(sampler.Sample(), 1u);
+   EXPECT_FALSE(sampler.Get(static_cast<uint32_t>(child), snapshot));
+
+   ProcessInfo::Sampler::Snapshots snapshots;
+   sampler.Get(snapshots);
+   ASSERT_EQ(snapshots.size(), 1u);
+   EXPECT_EQ(snapshots[0].Id, self.Id());
+
+   EXPECT_EQ(sampler.Remove(self.Id()), ERROR_NONE);
+   EXPECT_EQ(sampler.Remove(self.Id()), ERROR_UNKNOWN_KEY);
+   EXPECT_EQ(sampler.Sample(), 0u);
+}
+
+TEST(Core_ProcessInfo, findByName)
+{
+   ProcessInfo self;
+
+   // Twice, the second scan is served from the name cache.
+   for (uint8_t round = 0; round < 2; round++) {
+      ProcessInfo::Iterator index(self.Executable(), true);
+      bool found = false;
+
+      while (index.Next() == true) {
+         found = found || (index.Current().Id() == self.Id());
+      }
+      EXPECT_TRUE(found);
+   }
+}
+
+TEST(Core_ProcessInfo, findAfterExec)
+{
+   ProcessInfo self;
+   int trigger[2];
+
+   ASSERT_EQ(::pipe(trigger), 0);
+
+   // The child is a copy of us, until it executes another program.
+   pid_t child = ::fork();
+   ASSERT_NE(child, -1);
+
+   if (child == 0) {
+      char go;
+      ::close(trigger[1]);
+      if (::read(trigger[0], &go, 1) == 1) {
+         ::execl("/bin/sleep", "sleep", "5", static_cast<char*>(nullptr));
+      }
+      ::_exit(1);
+   }
+
+   ::close(trigger[0]);
+
+   bool found = false;
+   ProcessInfo::Iterator before(self.Executable(), true);
+   while (before.Next() == true) {
+      found = found || (before.Current().Id() == static_cast<uint32_t>(child));
+   }
+   EXPECT_TRUE(found);
+
+   EXPECT_EQ(::write(trigger[1], "x", 1), 1);
+   ::close(trigger[1]);
+
+   // The pid stays the same, the name in the cache may not.
+   for (uint32_t wait = 0; (wait < 200) && (ProcessInfo(child).Executable() == self.Executable()); wait++) {
+      SleepMs(10);
+   }
+
+   found = false;
+   ProcessInfo::Iterator after(self.Executable(), true);
+   while (after.Next() == true) {
+      found = found || (after.Current().Id() == static_cast<uint32_t>(child));
+   }
+   EXPECT_FALSE(found);
+
+   found = false;
+   ProcessInfo::Iterator renamed(_T("sleep"), false);
+   while (renamed.Next() == true) {
+      found = found || (renamed.Current().Id() == static_cast<uint32_t>(child));
+   }
+   EXPECT_TRUE(found);
+
+   ::kill(child, SIGKILL);
+   ::waitpid(child, nullptr, 0);
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <core/core.h>
+
+#include <thread>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+namespace {
+
+const char g_eventRingName[] = "/tmp/eventring01";
+
+struct KeyEvent {
+   uint32_t sequence;
+   uint32_t code;
+};
+
+}
+
+TEST(Core_SharedEventRing, producerAndConsumers)
+{
+   File(string(g_eventRingName)).Destroy();
+
+   SharedEventRing producer(g_eventRingName, 5, sizeof(KeyEvent));
+
+   ASSERT_TRUE(producer.IsValid());
+   EXPECT_EQ(producer.Events(), 8u);
+   EXPECT_EQ(producer.EventSize(), sizeof(KeyEvent));
+
+   // Only what is produced after opening reaches a consumer.
+   KeyEvent event = { 0, 0 };
+   EXPECT_EQ(producer.Produce(reinterpret_cast<const uint8_t*>(&event), sizeof(event)), ERROR_NONE);
+
+   SharedEventRing first(g_eventRingName);
+   SharedEventRing second(g_eventRingName);
+
+   ASSERT_TRUE(first.IsValid());
+   ASSERT_TRUE(second.IsValid());
+
+   KeyEvent received;
+   uint16_t length;
+   uint64_t timestamp;
+
+   EXPECT_EQ(first.Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, 0), ERROR_TIMEDOUT);
+
+   for (uint32_t index = 1; index <= 4; index++) {
+      event = { index, index * 10 };
+      EXPECT_EQ(producer.Produce(reinterpret_cast<const uint8_t*>(&event), sizeof(event)), ERROR_NONE);
+   }
+
+   // Each consumer reads all of them, at its own pace.
+   for (SharedEventRing* consumer : { &first, &second }) {
+      for (uint32_t index = 1; index <= 4; index++) {
+         ASSERT_EQ(consumer->Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, 0), ERROR_NONE);
+         EXPECT_EQ(length, sizeof(KeyEvent));
+         EXPECT_EQ(received.sequence, index);
+         EXPECT_EQ(received.code, index * 10);
+         EXPECT_LE(timestamp, SharedEventRing::Now());
+      }
+      EXPECT_EQ(consumer->Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, 0), ERROR_TIMEDOUT);
+      EXPECT_EQ(consumer->Dropped(), 0u);
+   }
+
+   File(string(g_eventRingName)).Destroy();
+}
+
+TEST(Core_SharedEventRing, overrun)
+{
+   File(string(g_eventRingName)).Destroy();
+
+   SharedEventRing producer(g_eventRingName, 8, sizeof(KeyEvent));
+   SharedEventRing consumer(g_eventRingName);
+
+   ASSERT_TRUE(consumer.IsValid());
+
+   // The producer never waits, the consumer loses the oldest ones.
+   for (uint32_t index = 0; index < 20; index++) {
+      KeyEvent event = { index, 0 };
+      EXPECT_EQ(producer.Produce(reinterpret_cast<const uint8_t*>(&event), sizeof(event)), ERROR_NONE);
+   }
+
+   KeyEvent received;
+   uint16_t length;
+   uint64_t timestamp;
+
+   for (uint32_t index = 12; index < 20; index++) {
+      ASSERT_EQ(consumer.Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, 0), ERROR_NONE);
+      EXPECT_EQ(received.sequence, index);
+   }
+   EXPECT_EQ(consumer.Dropped(), 12u);
+
+   File(string(g_eventRingName)).Destroy();
+}
+
+TEST(Core_SharedEventRing, waitAndInterrupt)
+{
+   File(string(g_eventRingName)).Destroy();
+
+   SharedEventRing producer(g_eventRingName, 8, sizeof(KeyEvent));
+   SharedEventRing consumer(g_eventRingName);
+
+   ASSERT_TRUE(consumer.IsValid());
+
+   KeyEvent received;
+   uint16_t length;
+   uint64_t timestamp;
+
+   // A waiting consumer is woken by the producer.
+   std::thread wakeUp([&producer]() {
+      SleepMs(50);
+      KeyEvent event = { 42, 0 };
+      producer.Produce(reinterpret_cast<const uint8_t*>(&event), sizeof(event));
+   });
+
+   EXPECT_EQ(consumer.Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, 2000), ERROR_NONE);
+   EXPECT_EQ(received.sequence, 42u);
+   wakeUp.join();
+
+   // And gives up on an Interrupt.
+   std::thread interrupt([&consumer]() {
+      SleepMs(50);
+      consumer.Interrupt();
+   });
+
+   EXPECT_EQ(consumer.Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, infinite), ERROR_ASYNC_ABORTED);
+   interrupt.join();
+
+   EXPECT_EQ(consumer.Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, 20), ERROR_TIMEDOUT);
+
+   File(string(g_eventRingName)).Destroy();
+}
+
+TEST(Core_SharedEventRing, startAtSequence)
+{
+   File(string(g_eventRingName)).Destroy();
+
+   SharedEventRing producer(g_eventRingName, 8, sizeof(KeyEvent));
+
+   ASSERT_TRUE(producer.IsValid());
+
+   KeyEvent event = { 0, 0 };
+   producer.Produce(reinterpret_cast<const uint8_t*>(&event), sizeof(event));
+
+   // The producer hands out the sequence number, events produced before the consumer opens are its too.
+   const uint64_t sequence = producer.Produced();
+   EXPECT_EQ(sequence, 1u);
+
+   for (uint32_t index = 1; index <= 3; index++) {
+      event = { index, 0 };
+      producer.Produce(reinterpret_cast<const uint8_t*>(&event), sizeof(event));
+   }
+
+   SharedEventRing consumer(g_eventRingName, sequence);
+
+   ASSERT_TRUE(consumer.IsValid());
+   EXPECT_EQ(consumer.Next(), sequence);
+
+   KeyEvent received;
+   uint16_t length;
+   uint64_t timestamp;
+
+   for (uint32_t index = 1; index <= 3; index++) {
+      ASSERT_EQ(consumer.Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, 0), ERROR_NONE);
+      EXPECT_EQ(received.sequence, index);
+      EXPECT_EQ(consumer.Next() - 1, index);
+   }
+   EXPECT_EQ(consumer.Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, 0), ERROR_TIMEDOUT);
+
+   // A sequence number that is not produced yet, starts at the next one produced.
+   SharedEventRing future(g_eventRingName, sequence + 100);
+   EXPECT_EQ(future.Next(), producer.Produced());
+
+   // One that is overwritten already, reports what is lost.
+   for (uint32_t index = 4; index < 20; index++) {
+      event = { index, 0 };
+      producer.Produce(reinterpret_cast<const uint8_t*>(&event), sizeof(event));
+   }
+
+   SharedEventRing late(g_eventRingName, sequence);
+
+   ASSERT_EQ(late.Consume(reinterpret_cast<uint8_t*>(&received), length, timestamp, 0), ERROR_NONE);
+   EXPECT_EQ(received.sequence, 12u);
+   EXPECT_EQ(late.Dropped(), 11u);
+
+   File(string(g_eventRingName)).Destroy();
+}
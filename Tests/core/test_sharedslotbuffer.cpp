@@ -0,0 +1,249 @@
+#include "../IPTestAdministrator.h"
+
+#include <gtest/gtest.h>
+#include <core/core.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+namespace {
+
+const char g_slotBufferName[] = "/tmp/slotbuffer01";
+const uint32_t g_frameSize = 64 * 1024;
+const uint32_t g_frameCount = 2000;
+
+// The variant to measure, set before the other side is forked.
+uint8_t g_slots = 0; // 0 is the single SharedBuffer.
+SharedSlotBuffer::mode g_mode = SharedSlotBuffer::QUEUE;
+
+struct Handoff {
+   uint32_t received;
+   uint32_t outOfOrder;
+   uint64_t duration;   // In microseconds.
+   uint64_t latency;    // Sum of the produce to consume latencies, in microseconds.
+   uint64_t maxLatency; // In microseconds.
+};
+
+struct Frame {
+   uint32_t sequence;
+   uint64_t produced;
+};
+
+// Stands in for the work on a frame: fills or reads the whole of it.
+void Fill(uint8_t buffer[], const uint32_t sequence)
+{
+   Frame frame = { sequence, Time::Now().Ticks() };
+
+   memset(&(buffer[sizeof(frame)]), static_cast<uint8_t>(sequence), g_frameSize - sizeof(frame));
+   memcpy(buffer, &frame, sizeof(frame));
+}
+
+void Check(const uint8_t buffer[], Handoff& result, uint32_t& expected, const bool inOrder)
+{
+   uint8_t scratch[g_frameSize];
+   Frame frame;
+
+   memcpy(scratch, buffer, g_frameSize);
+   memcpy(&frame, scratch, sizeof(frame));
+
+   uint64_t latency = Time::Now().Ticks() - frame.produced;
+
+   if ((inOrder == true) ? (frame.sequence != expected) : (frame.sequence < expected)) {
+      result.outOfOrder++;
+   }
+
+   expected = frame.sequence + 1;
+   result.received++;
+   result.latency += latency;
+   result.maxLatency = std::max(result.maxLatency, latency);
+}
+
+void Producer(IPTestAdministrator& testAdmin)
+{
+   if (g_slots == 0) {
+      SharedBuffer buffer(g_slotBufferName, g_frameSize, 16);
+
+      testAdmin.Sync("setup producer");
+      testAdmin.Sync("setup consumer");
+
+      for (uint32_t index = 0; index < g_frameCount; index++) {
+         if (buffer.RequestProduce(1000) == ERROR_NONE) {
+            Fill(buffer.Buffer(), index);
+            buffer.Produced();
+         }
+      }
+
+      testAdmin.Sync("done");
+   } else {
+      SharedSlotBuffer buffer(g_slotBufferName, g_slots, g_frameSize, g_mode);
+
+      testAdmin.Sync("setup producer");
+      testAdmin.Sync("setup consumer");
+
+      for (uint32_t index = 0; index < g_frameCount; index++) {
+         if (buffer.RequestProduce(1000) == ERROR_NONE) {
+            Fill(buffer.Buffer(), index);
+            buffer.Produced(g_frameSize);
+         }
+      }
+
+      testAdmin.Sync("done");
+   }
+}
+
+// Producer in the other process, consumer in this one.
+Handoff Measure(const uint8_t slots, const SharedSlotBuffer::mode type)
+{
+   Handoff result = {};
+   uint32_t expected = 0;
+
+   g_slots = slots;
+   g_mode = type;
+
+   IPTestAdministrator testAdmin(Producer);
+
+   testAdmin.Sync("setup producer");
+
+   if (slots == 0) {
+      SharedBuffer buffer(g_slotBufferName);
+
+      testAdmin.Sync("setup consumer");
+
+      uint64_t start = Time::Now().Ticks();
+
+      while ((result.received < g_frameCount) && (buffer.RequestConsume(1000) == ERROR_NONE)) {
+         Check(buffer.Buffer(), result, expected, true);
+         buffer.Consumed();
+      }
+
+      result.duration = Time::Now().Ticks() - start;
+   } else {
+      SharedSlotBuffer buffer(g_slotBufferName);
+
+      EXPECT_TRUE(buffer.IsValid());
+      EXPECT_EQ(buffer.Slots(), slots);
+
+      testAdmin.Sync("setup consumer");
+
+      uint64_t start = Time::Now().Ticks();
+
+      while ((expected < g_frameCount) && (buffer.RequestConsume(1000) == ERROR_NONE)) {
+         EXPECT_EQ(buffer.Length(), g_frameSize);
+         Check(buffer.Data(), result, expected, (type == SharedSlotBuffer::QUEUE));
+         EXPECT_EQ(buffer.Sequence(), expected);
+         buffer.Consumed();
+      }
+
+      result.duration = Time::Now().Ticks() - start;
+
+      EXPECT_EQ(result.received + buffer.Skipped(), g_frameCount);
+   }
+
+   testAdmin.Sync("done");
+
+   return (result);
+}
+
+void Report(const char name[], const Handoff& measurement)
+{
+   printf("%-20s: %4u frames of %u KB in %7llu us, %7.1f frames/s, latency avg %6.1f us, max %6llu us\n",
+      name, measurement.received, g_frameSize / 1024,
+      static_cast<unsigned long long>(measurement.duration),
+      (measurement.duration == 0 ? 0.0 : (measurement.received * 1000000.0) / measurement.duration),
+      (measurement.received == 0 ? 0.0 : static_cast<double>(measurement.latency) / measurement.received),
+      static_cast<unsigned long long>(measurement.maxLatency));
+}
+
+}
+
+TEST(Core_SharedSlotBuffer, queueAndLatest)
+{
+   {
+      SharedSlotBuffer producer(g_slotBufferName, 3, 100, SharedSlotBuffer::QUEUE);
+      SharedSlotBuffer consumer(g_slotBufferName);
+
+      ASSERT_TRUE(consumer.IsValid());
+      EXPECT_EQ(consumer.SlotSize(), 100u);
+      EXPECT_EQ(consumer.Mode(), SharedSlotBuffer::QUEUE);
+      EXPECT_EQ(consumer.TryConsume(), ERROR_TIMEDOUT);
+
+      for (uint8_t index = 1; index <= 3; index++) {
+         EXPECT_EQ(producer.TryProduce(), ERROR_NONE);
+         EXPECT_EQ(producer.TryProduce(), ERROR_ILLEGAL_STATE);
+         producer.Buffer()[0] = index;
+         EXPECT_EQ(producer.Produced(index), ERROR_NONE);
+      }
+
+      // All slots are taken, a queue does not drop frames.
+      EXPECT_EQ(producer.TryProduce(), ERROR_TIMEDOUT);
+      EXPECT_EQ(producer.RequestProduce(10), ERROR_TIMEDOUT);
+
+      for (uint8_t index = 1; index <= 3; index++) {
+         EXPECT_EQ(consumer.TryConsume(), ERROR_NONE);
+         EXPECT_EQ(consumer.Sequence(), index);
+         EXPECT_EQ(consumer.Length(), index);
+         EXPECT_EQ(consumer.Data()[0], index);
+         EXPECT_EQ(consumer.Consumed(), ERROR_NONE);
+      }
+      EXPECT_EQ(consumer.Skipped(), 0u);
+   }
+   {
+      SharedSlotBuffer producer(g_slotBufferName, 3, 100, SharedSlotBuffer::LATEST);
+      SharedSlotBuffer consumer(g_slotBufferName);
+
+      // The producer never waits, older frames are recycled.
+      for (uint8_t index = 1; index <= 5; index++) {
+         EXPECT_EQ(producer.TryProduce(), ERROR_NONE);
+         producer.Buffer()[0] = index;
+         producer.Produced(1);
+      }
+
+      EXPECT_EQ(consumer.TryConsume(), ERROR_NONE);
+      EXPECT_EQ(consumer.Sequence(), 5u);
+      EXPECT_EQ(consumer.Data()[0], 5);
+      EXPECT_EQ(consumer.Skipped(), 4u);
+
+      // While the consumer holds frame 5, the producer keeps going on the other two slots.
+      for (uint8_t index = 6; index <= 8; index++) {
+         EXPECT_EQ(producer.TryProduce(), ERROR_NONE);
+         producer.Buffer()[0] = index;
+         producer.Produced(1);
+      }
+      EXPECT_EQ(consumer.Data()[0], 5);
+      consumer.Consumed();
+
+      EXPECT_EQ(consumer.TryConsume(), ERROR_NONE);
+      EXPECT_EQ(consumer.Sequence(), 8u);
+      consumer.Consumed();
+      EXPECT_EQ(consumer.TryConsume(), ERROR_TIMEDOUT);
+   }
+
+   ::unlink(g_slotBufferName);
+}
+
+TEST(Core_SharedSlotBuffer, crossProcessExchange)
+{
+   Handoff single = Measure(0, SharedSlotBuffer::QUEUE);
+   Report("SharedBuffer", single);
+   EXPECT_EQ(single.received, g_frameCount);
+   EXPECT_EQ(single.outOfOrder, 0u);
+
+   Handoff doubled = Measure(2, SharedSlotBuffer::QUEUE);
+   Report("2 slots, queue", doubled);
+   EXPECT_EQ(doubled.received, g_frameCount);
+   EXPECT_EQ(doubled.outOfOrder, 0u);
+
+   Handoff tripled = Measure(3, SharedSlotBuffer::QUEUE);
+   Report("3 slots, queue", tripled);
+   EXPECT_EQ(tripled.received, g_frameCount);
+   EXPECT_EQ(tripled.outOfOrder, 0u);
+
+   Handoff latest = Measure(3, SharedSlotBuffer::LATEST);
+   Report("3 slots, latest", latest);
+   EXPECT_EQ(latest.outOfOrder, 0u);
+
+   ::unlink(g_slotBufferName);
+   ::unlink((string(g_slotBufferName) + ".admin").c_str());
+
+   Core::Singleton::Dispose();
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <core/core.h>
+
+#include <atomic>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+namespace {
+
+// A job that keeps a thread busy for a while, and counts itself done.
+class Work {
+public:
+   Work()
+      : _done(nullptr)
+      , _duration(0)
+      , _id(0)
+   {
+   }
+   Work(std::atomic<uint32_t>& done, const uint32_t duration, const uint32_t id)
+      : _done(&done)
+      , _duration(duration)
+      , _id(id)
+   {
+   }
+   Work(const Work& copy)
+      : _done(copy._done)
+      , _duration(copy._duration)
+      , _id(copy._id)
+   {
+   }
+   ~Work()
+   {
+   }
+
+   Work& operator=(const Work& RHS)
+   {
+      _done = RHS._done;
+      _duration = RHS._duration;
+      _id = RHS._id;
+
+      return (*this);
+   }
+   bool operator==(const Work& RHS) const
+   {
+      return ((_done == RHS._done) && (_id == RHS._id));
+   }
+   bool operator!=(const Work& RHS) const
+   {
+      return (!operator==(RHS));
+   }
+
+public:
+   void Dispatch()
+   {
+      SleepMs(_duration);
+      _done->fetch_add(1);
+   }
+
+private:
+   std::atomic<uint32_t>* _done;
+   uint32_t _duration;
+   uint32_t _id;
+};
+
+typedef DynamicThreadPoolType<Work> Pool;
+
+const uint32_t g_idleTime = 100;
+const uint32_t g_latency = 5;
+// Long enough to never be hit, growing only happens on the queue length.
+const uint32_t g_noLatency = 10000;
+
+bool WaitFor(const std::atomic<uint32_t>& done, const uint32_t count)
+{
+   for (uint32_t round = 0; (round < 500) && (done.load() < count); round++) {
+      SleepMs(10);
+   }
+
+   return (done.load() == count);
+}
+
+}
+
+TEST(Core_DynamicThreadPool, growsUnderLoad)
+{
+   std::atomic<uint32_t> done(0);
+   Pool pool(1, 4, Thread::DefaultStackSize(), g_idleTime, g_latency);
+
+   pool.Run();
+
+   EXPECT_EQ(pool.Minimum(), 1u);
+   EXPECT_EQ(pool.Maximum(), 4u);
+   EXPECT_EQ(pool.Count(), 1u);
+
+   // More jobs than threads, the pool grows, but never beyond its maximum.
+   for (uint32_t index = 0; index < 12; index++) {
+      pool.Submit(Work(done, 30, index), Core::infinite);
+      EXPECT_LE(pool.Count(), 4u);
+   }
+
+   EXPECT_GT(pool.Count(), 1u);
+   EXPECT_TRUE(WaitFor(done, 12));
+
+   Pool::Statistics statistics;
+   std::list<uint32_t> runs;
+
+   pool.Collect(statistics, runs);
+
+   EXPECT_EQ(statistics.Threads, pool.Count());
+   EXPECT_EQ(statistics.Peak, statistics.Threads);
+   EXPECT_EQ(statistics.Created, static_cast<uint32_t>(statistics.Peak));
+   EXPECT_EQ(statistics.Reaped, 0u);
+   EXPECT_EQ(statistics.Active, 0u);
+   EXPECT_EQ(statistics.Pending, 0u);
+   EXPECT_GT(statistics.Utilization, 0u);
+   EXPECT_LE(statistics.Utilization, 100u);
+
+   // Every job is in one of the queue wait buckets, and in the runs of one of the threads.
+   uint32_t waited = 0;
+   for (uint8_t index = 0; index < Pool::Buckets; index++) {
+      waited += statistics.QueueWait[index];
+   }
+   EXPECT_EQ(waited, 12u);
+
+   uint32_t ran = 0;
+   for (uint32_t count : runs) {
+      ran += count;
+   }
+   EXPECT_EQ(runs.size(), static_cast<size_t>(statistics.Threads));
+   EXPECT_EQ(ran, 12u);
+
+   // Nothing ran since, so a new window has nothing to report.
+   SleepMs(20);
+   runs.clear();
+   pool.Collect(statistics, runs);
+   EXPECT_EQ(statistics.Utilization, 0u);
+
+   Histogram::Snapshot wait, run;
+   pool.Latencies(wait, run);
+   EXPECT_EQ(wait.Count(), 12u);
+   EXPECT_EQ(run.Count(), 12u);
+   EXPECT_GE(run.Min(), 30u * Time::TicksPerMillisecond);
+
+   Core::Singleton::Dispose();
+}
+
+TEST(Core_DynamicThreadPool, reapsIdleThreads)
+{
+   std::atomic<uint32_t> done(0);
+   Pool pool(2, 6, Thread::DefaultStackSize(), g_idleTime, g_noLatency);
+
+   pool.Run();
+
+   EXPECT_EQ(pool.Count(), 2u);
+
+   for (uint32_t index = 0; index < 12; index++) {
+      pool.Submit(Work(done, 20, index), Core::infinite);
+   }
+   EXPECT_TRUE(WaitFor(done, 12));
+
+   const uint16_t grown = pool.Count();
+   EXPECT_GT(grown, 2u);
+
+   // Threads idle for longer than the idle time step out, down to the minimum. They are cleaned up
+   // on the next submit.
+   SleepMs(4 * g_idleTime);
+   EXPECT_EQ(pool.Count(), 2u);
+
+   pool.Submit(Work(done, 0, 12), Core::infinite);
+   EXPECT_TRUE(WaitFor(done, 13));
+
+   Pool::Statistics statistics;
+   std::list<uint32_t> runs;
+
+   pool.Collect(statistics, runs);
+
+   EXPECT_EQ(statistics.Threads, 2u);
+   EXPECT_EQ(statistics.Peak, grown);
+   EXPECT_EQ(statistics.Created, static_cast<uint32_t>(grown));
+   EXPECT_EQ(statistics.Reaped, static_cast<uint32_t>(grown - 2));
+   EXPECT_EQ(runs.size(), 2u);
+
+   Core::Singleton::Dispose();
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <core/core.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+namespace {
+   typedef TimeSeriesType<uint32_t, 1> Store;
+
+   const uint64_t Second = Time::TicksPerMillisecond * 1000;
+   const uint64_t Start = 1000 * 3600 * Second;
+}
+
+TEST(Core_TimeSeries, rangeAndRollups)
+{
+   const string directory(_T("/tmp/timeseries01/"));
+   ::system("rm -rf /tmp/timeseries01");
+
+   {
+      Store store(directory, 1024 * 1024);
+
+      // Two hours of one sample per second, with values that do not compress too well.
+      for (uint32_t index = 0; index < 7200; index++) {
+         EXPECT_EQ(store.Record(_T("cpu"), Start + (index * Second), (index * 7919) % 1000), ERROR_NONE);
+      }
+      EXPECT_EQ(store.Record(_T("cpu"), Start, 1), ERROR_BAD_REQUEST);
+      EXPECT_EQ(store.Record(_T("../cpu"), Start, 1), ERROR_BAD_REQUEST);
+
+      Store::Points points;
+      EXPECT_EQ(store.Range(_T("memory"), Store::SAMPLE, 0, ~0, points), ERROR_UNKNOWN_KEY);
+
+      // A range in the middle, spanning files.
+      EXPECT_EQ(store.Range(_T("cpu"), Store::SAMPLE, Start + (3000 * Second), Start + (3999 * Second), points), ERROR_NONE);
+      ASSERT_EQ(points.size(), 1000u);
+      for (uint32_t index = 0; index < points.size(); index++) {
+         EXPECT_EQ(points[index].Time, Start + ((3000 + index) * Second));
+         EXPECT_EQ(points[index].Value, ((3000 + index) * 7919) % 1000);
+      }
+
+      // The last minute is still being averaged.
+      points.clear();
+      EXPECT_EQ(store.Range(_T("cpu"), Store::MINUTE, 0, ~0, points), ERROR_NONE);
+      ASSERT_EQ(points.size(), 119u);
+      EXPECT_EQ(points[0].Time, Start);
+      EXPECT_EQ(points[1].Time, Start + (60 * Second));
+
+      uint64_t sum = 0;
+      for (uint32_t index = 60; index < 120; index++) {
+         sum += (index * 7919) % 1000;
+      }
+      EXPECT_EQ(points[1].Value, sum / 60);
+
+      Store::Summary summary;
+      EXPECT_EQ(store.Summarize(_T("cpu"), Store::SAMPLE, Start + (10 * Second), Start + (7000 * Second), summary), ERROR_NONE);
+      EXPECT_EQ(summary.Count, 6991u);
+      EXPECT_EQ(summary.Minimum, 0u);
+      EXPECT_EQ(summary.Maximum, 999u);
+
+      std::list<string> series;
+      store.Series(series);
+      ASSERT_EQ(series.size(), 1u);
+      EXPECT_EQ(series.front(), _T("cpu"));
+   }
+
+   {
+      // Everything recorded is still there after a restart, and recording continues behind it.
+      Store store(directory, 1024 * 1024);
+      Store::Points points;
+
+      EXPECT_EQ(store.Record(_T("cpu"), Start, 1), ERROR_BAD_REQUEST);
+      EXPECT_EQ(store.Record(_T("cpu"), Start + (7200 * Second), 5), ERROR_NONE);
+      EXPECT_EQ(store.Range(_T("cpu"), Store::SAMPLE, Start + (7198 * Second), ~0, points), ERROR_NONE);
+      ASSERT_EQ(points.size(), 3u);
+      EXPECT_EQ(points[2].Value, 5u);
+
+      points.clear();
+      EXPECT_EQ(store.Range(_T("cpu"), Store::SAMPLE, 0, ~0, points), ERROR_NONE);
+      EXPECT_EQ(points.size(), 7201u);
+   }
+
+   ::system("rm -rf /tmp/timeseries01");
+}
+
+TEST(Core_TimeSeries, rotation)
+{
+   const string directory(_T("/tmp/timeseries02/"));
+   ::system("rm -rf /tmp/timeseries02");
+
+   {
+      Store store(directory, 4 * 1024);
+
+      for (uint32_t index = 0; index < 20000; index++) {
+         store.Record(_T("memory"), Start + (index * Second), (index * 7919) % 100000);
+      }
+
+      Store::Points points;
+      EXPECT_EQ(store.Range(_T("memory"), Store::SAMPLE, 0, ~0, points), ERROR_NONE);
+      ASSERT_FALSE(points.empty());
+      EXPECT_LT(points.size(), 20000u);
+      EXPECT_EQ(points.back().Time, Start + (19999 * Second));
+      EXPECT_GT(points.front().Time, Start);
+
+      uint64_t size = 0;
+      Directory files((directory + _T("memory/")).c_str(), _T("sample.*"));
+      while (files.Next() == true) {
+         size += File(files.Current()).Size();
+      }
+      EXPECT_LT(size, 8 * 1024u);
+   }
+
+   ::system("rm -rf /tmp/timeseries02");
+}
@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+#include <core/core.h>
+#include <cryptalgo/cryptalgo.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Crypto;
+
+namespace {
+
+const uint8_t g_key[32] = {
+   0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+   0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+// FIPS-197, appendix C.
+const uint8_t g_fipsPlain[16] = {
+   0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+const uint8_t g_fipsCipher[3][16] = {
+   { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a },
+   { 0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0, 0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91 },
+   { 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89 }
+};
+
+// NIST SP 800-38A, F.2.1 (CBC-AES128) and F.5.1 (CTR-AES128).
+const uint8_t g_nistKey[16] = {
+   0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+const uint8_t g_nistPlain[64] = {
+   0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+   0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+   0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+   0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+const uint8_t g_nistCBCIV[16] = {
+   0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+const uint8_t g_nistCBCCipher[64] = {
+   0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+   0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+   0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+   0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7
+};
+const uint8_t g_nistCTRCounter[16] = {
+   0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+const uint8_t g_nistCTRCipher[64] = {
+   0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+   0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+   0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+   0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee
+};
+
+enum chainMode {
+   ECB,
+   CBC,
+   CFB8,
+   CFB128,
+   OFB,
+   CTR
+};
+
+// Runs a mode on the mbedtls level, in uneven chunks for the stream modes, so the
+// bulk paths are entered at every offset within a block.
+void Crypt(const chainMode type, const int mode, const uint32_t keyLength, const uint32_t length, const uint8_t input[], uint8_t output[])
+{
+   static const uint32_t chunks[] = { 1, 15, 16, 33, 7, 129, 64, 255, 3, 500 };
+
+   mbedtls_aes_context context;
+   uint8_t iv[16];
+   uint8_t stream[16];
+   size_t offset = 0;
+   uint32_t counter = 0;
+
+   memset(iv, 0xFF, sizeof(iv)); // The CTR counter carries over all 128 bits
+   iv[0] = 0x5A;
+   memset(stream, 0, sizeof(stream));
+
+   mbedtls_aes_init(&context);
+
+   if (((type == ECB) || (type == CBC)) && (mode == MBEDTLS_AES_DECRYPT)) {
+      mbedtls_aes_setkey_dec(&context, g_key, keyLength);
+   } else {
+      mbedtls_aes_setkey_enc(&context, g_key, keyLength);
+   }
+
+   switch (type) {
+   case ECB:
+      mbedtls_aes_crypt_ecb_blocks(&context, mode, length, input, output);
+      break;
+   case CBC:
+      mbedtls_aes_crypt_cbc(&context, mode, length, iv, input, output);
+      break;
+   case CFB8:
+      mbedtls_aes_crypt_cfb8(&context, mode, length, iv, input, output);
+      break;
+   default:
+      for (uint32_t done = 0, index = 0; done < length; index++) {
+         uint32_t chunk = std::min(chunks[index % (sizeof(chunks) / sizeof(chunks[0]))], length - done);
+
+         if (type == CFB128) {
+            mbedtls_aes_crypt_cfb128(&context, mode, chunk, &offset, iv, &(input[done]), &(output[done]));
+         } else if (type == OFB) {
+            mbedtls_aes_crypt_ofb(&context, chunk, &offset, iv, &(input[done]), &(output[done]));
+         } else {
+            mbedtls_aes_crypt_ctr(&context, chunk, &counter, iv, stream, &(input[done]), &(output[done]));
+         }
+         done += chunk;
+      }
+      break;
+   }
+
+   mbedtls_aes_free(&context);
+}
+
+class Throughput {
+public:
+   Throughput(const Throughput&) = delete;
+   Throughput& operator=(const Throughput&) = delete;
+
+   Throughput(const aesType type, const uint8_t keyLength)
+      : _encryption(type)
+      , _decryption(type)
+   {
+      _encryption.Key(keyLength, g_key);
+      _decryption.Key(keyLength, g_key);
+   }
+
+   // In MB/s, over the given amount of data in chunks of the buffer size.
+   double Measure(const bool encrypt, const uint32_t total, const uint32_t length, const uint8_t input[], uint8_t output[])
+   {
+      uint64_t start = Core::Time::Now().Ticks();
+
+      for (uint32_t done = 0; done < total; done += length) {
+         if (encrypt == true) {
+            _encryption.Encrypt(length, input, output);
+         } else {
+            _decryption.Decrypt(length, input, output);
+         }
+      }
+
+      uint64_t duration = Core::Time::Now().Ticks() - start;
+
+      return (duration == 0 ? 0.0 : static_cast<double>(total) / duration);
+   }
+
+private:
+   AESEncryption _encryption;
+   AESDecryption _decryption;
+};
+
+}
+
+TEST(Crypto_AES, knownAnswers)
+{
+   const int hardware = mbedtls_aes_hw_support(-1);
+
+   // Both implementations, if the hardware is there.
+   for (int enable = hardware; enable >= 0; enable--) {
+      mbedtls_aes_hw_support(enable);
+
+      for (uint8_t index = 0; index < 3; index++) {
+         AESEncryption encryption(AES_ECB);
+         AESDecryption decryption(AES_ECB);
+         uint8_t output[16];
+
+         encryption.Key(16 + (index * 8), g_key);
+         decryption.Key(16 + (index * 8), g_key);
+
+         encryption.Encrypt(sizeof(output), g_fipsPlain, output);
+         EXPECT_EQ(memcmp(output, g_fipsCipher[index], sizeof(output)), 0);
+         decryption.Decrypt(sizeof(output), output, output);
+         EXPECT_EQ(memcmp(output, g_fipsPlain, sizeof(output)), 0);
+      }
+      {
+         AESEncryption encryption(AES_CBC);
+         AESDecryption decryption(AES_CBC);
+         uint8_t output[64];
+
+         encryption.Key(sizeof(g_nistKey), g_nistKey);
+         encryption.InitialVector(g_nistCBCIV);
+         encryption.Encrypt(sizeof(output), g_nistPlain, output);
+         EXPECT_EQ(memcmp(output, g_nistCBCCipher, sizeof(output)), 0);
+
+         // In place, as the ciphertext is chained it must be read before it is overwritten.
+         decryption.Key(sizeof(g_nistKey), g_nistKey);
+         decryption.InitialVector(g_nistCBCIV);
+         decryption.Decrypt(sizeof(output), output, output);
+         EXPECT_EQ(memcmp(output, g_nistPlain, sizeof(output)), 0);
+      }
+      {
+         AESEncryption encryption(AES_CTR);
+         AESDecryption decryption(AES_CTR);
+         uint8_t output[64];
+
+         encryption.Key(sizeof(g_nistKey), g_nistKey);
+         encryption.InitialVector(g_nistCTRCounter);
+         encryption.Encrypt(sizeof(output), g_nistPlain, output);
+         EXPECT_EQ(memcmp(output, g_nistCTRCipher, sizeof(output)), 0);
+
+         // A stream mode, it continues where the previous call left off.
+         decryption.Key(sizeof(g_nistKey), g_nistKey);
+         decryption.InitialVector(g_nistCTRCounter);
+         decryption.Decrypt(5, output, output);
+         decryption.Decrypt(sizeof(output) - 5, &(output[5]), &(output[5]));
+         EXPECT_EQ(memcmp(output, g_nistPlain, sizeof(output)), 0);
+      }
+   }
+
+   mbedtls_aes_hw_support(hardware);
+}
+
+TEST(Crypto_AES, hardwareMatchesSoftware)
+{
+   const int hardware = mbedtls_aes_hw_support(-1);
+
+   if (hardware == 0) {
+      printf("AES: no hardware acceleration on this CPU, nothing to compare\n");
+   } else {
+      const uint32_t length = 4096 + 48;
+      const chainMode modes[] = { ECB, CBC, CFB8, CFB128, OFB, CTR };
+
+      uint8_t plain[length];
+      uint8_t software[length];
+      uint8_t accelerated[length];
+      uint8_t decrypted[length];
+
+      for (uint32_t index = 0; index < length; index++) {
+         plain[index] = static_cast<uint8_t>((index * 7) ^ (index >> 5));
+      }
+
+      for (const chainMode type : modes) {
+         for (uint32_t keyLength = 128; keyLength <= 256; keyLength += 64) {
+            mbedtls_aes_hw_support(0);
+            Crypt(type, MBEDTLS_AES_ENCRYPT, keyLength, length, plain, software);
+
+            mbedtls_aes_hw_support(1);
+            Crypt(type, MBEDTLS_AES_ENCRYPT, keyLength, length, plain, accelerated);
+            EXPECT_EQ(memcmp(software, accelerated, length), 0) << "mode " << type << ", key " << keyLength;
+
+            memcpy(decrypted, accelerated, length);
+            Crypt(type, MBEDTLS_AES_DECRYPT, keyLength, length, decrypted, decrypted);
+            EXPECT_EQ(memcmp(decrypted, plain, length), 0) << "mode " << type << ", key " << keyLength;
+         }
+      }
+
+      mbedtls_aes_hw_support(hardware);
+   }
+}
+
+TEST(Crypto_AES, throughput)
+{
+   struct Mode {
+      const char* name;
+      aesType type;
+      bool encrypt;
+   };
+
+   const Mode modes[] = {
+      { "ECB encrypt", AES_ECB, true },
+      { "ECB decrypt", AES_ECB, false },
+      { "CBC encrypt", AES_CBC, true },
+      { "CBC decrypt", AES_CBC, false },
+      { "CFB128 encrypt", AES_CFB128, true },
+      { "CFB128 decrypt", AES_CFB128, false },
+      { "CTR", AES_CTR, true }
+   };
+
+   const uint32_t total = 16 * 1024 * 1024;
+   const uint32_t length = 16 * 1024;
+   const int hardware = mbedtls_aes_hw_support(-1);
+
+   std::vector<uint8_t> input(length, 0xA5);
+   std::vector<uint8_t> output(length);
+
+   for (uint8_t keyLength = 16; keyLength <= 32; keyLength += 8) {
+      for (const Mode& mode : modes) {
+         Throughput measurement(mode.type, keyLength);
+         double accelerated = 0.0;
+
+         if (hardware != 0) {
+            mbedtls_aes_hw_support(1);
+            accelerated = measurement.Measure(mode.encrypt, total, length, input.data(), output.data());
+         }
+
+         mbedtls_aes_hw_support(0);
+         double software = measurement.Measure(mode.encrypt, total, length, input.data(), output.data());
+
+         printf("AES-%d %-15s: hardware %8.1f MB/s, software %7.1f MB/s\n", keyLength * 8, mode.name, accelerated, software);
+      }
+   }
+
+   mbedtls_aes_hw_support(hardware);
+
+   Core::Singleton::Dispose();
+}
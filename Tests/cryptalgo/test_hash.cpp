@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+#include <core/core.h>
+#include <cryptalgo/cryptalgo.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Crypto;
+
+namespace {
+
+// FIPS 180-2, appendix A, B and C, plus 513 MB of the byte pattern below, so the message
+// length in bits no longer fits in 32 bits.
+const char g_oneBlock[] = "abc";
+const char g_twoBlocks[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+struct Vector {
+   const char* oneBlock;
+   const char* twoBlocks;
+   const char* million;
+   const char* large;
+};
+
+const Vector g_sha1 = {
+   "a9993e364706816aba3e25717850c26c9cd0d89d",
+   "84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+   "34aa973cd4c4daa4f61eeb2bdbad27316534016f",
+   "03dab43f4328470c37236be9426868352d2963f0"
+};
+const Vector g_sha224 = {
+   "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7",
+   "75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525",
+   "20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67",
+   nullptr
+};
+const Vector g_sha256 = {
+   "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+   "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+   "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+   "099be0a986c59c84e1f003edab074a30969079f00c8cf557a023b82074e4e8e1"
+};
+const Vector g_sha384 = {
+   "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7",
+   "3391fdddfc8dc7393707a65b1b4709397cf8b1d162af05abfe8f450de5f36bc6b0455a8520bc4e6f5fe95b1fe3c8452b",
+   "9d0e1809716474cb086e834e310a4a1ced149e9c00f248527972cec5704c2a5b07b8b3dc38ecc4ebae97ddd87f3d8985",
+   nullptr
+};
+const Vector g_sha512 = {
+   "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+   "204a8fc6dda82f0a0ced7beb8e08a41657c16ef468b228a8279be331a703c33596fd15c13b1b07f9aa1d3bea57789ca031ad85c7a71dd70354ec631238ca3445",
+   "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b",
+   "13c69512528815c1b351cf62dd8e8f68697c46e64169de111f65a3da7dbb7281b970a13c99b3097b2792b2763d01e296560d71f9eb7b5b9d2aacd8a874567c55"
+};
+
+const uint32_t g_largeChunk = 1024 * 1024;
+const uint32_t g_largeChunks = 513;
+
+string Hex(const uint8_t digest[], const uint8_t length)
+{
+   string result;
+
+   for (uint8_t index = 0; index < length; index++) {
+      char text[3];
+      snprintf(text, sizeof(text), "%02x", digest[index]);
+      result += text;
+   }
+
+   return (result);
+}
+
+template <typename HASH>
+string Digest(const uint8_t message[], const uint64_t length)
+{
+   HASH hash(message, length);
+
+   return (Hex(hash.Result(), HASH::Length));
+}
+
+template <typename HASH>
+void Check(const Vector& vector, const bool large)
+{
+   const std::vector<uint8_t> million(1000000, 'a');
+
+   EXPECT_EQ(Digest<HASH>(reinterpret_cast<const uint8_t*>(g_oneBlock), strlen(g_oneBlock)), vector.oneBlock);
+   EXPECT_EQ(Digest<HASH>(reinterpret_cast<const uint8_t*>(g_twoBlocks), strlen(g_twoBlocks)), vector.twoBlocks);
+
+   // In one go, where the length used to be truncated to 16 bits.
+   EXPECT_EQ(Digest<HASH>(million.data(), million.size()), vector.million);
+
+   if ((large == true) && (vector.large != nullptr)) {
+      std::vector<uint8_t> chunk(g_largeChunk);
+      HASH hash;
+
+      for (uint32_t index = 0; index < g_largeChunk; index++) {
+         chunk[index] = static_cast<uint8_t>(index);
+      }
+      for (uint32_t index = 0; index < g_largeChunks; index++) {
+         hash.Input(chunk.data(), chunk.size());
+      }
+
+      EXPECT_EQ(Hex(hash.Result(), HASH::Length), vector.large);
+   }
+}
+
+// Feeds the message in uneven chunks, so every offset within a block is hit.
+template <typename HASH>
+string Chunked(const uint8_t message[], const uint32_t length)
+{
+   static const uint32_t chunks[] = { 1, 63, 64, 65, 7, 129, 128, 255, 3, 1000 };
+
+   HASH hash;
+
+   for (uint32_t done = 0, index = 0; done < length; index++) {
+      uint32_t chunk = std::min(chunks[index % (sizeof(chunks) / sizeof(chunks[0]))], length - done);
+
+      hash.Input(&(message[done]), chunk);
+      done += chunk;
+   }
+
+   return (Hex(hash.Result(), HASH::Length));
+}
+
+// In MB/s, over the given amount of data in chunks of the buffer size.
+template <typename HASH>
+double Throughput(const uint32_t total, const std::vector<uint8_t>& buffer)
+{
+   HASH hash;
+   uint64_t start = Core::Time::Now().Ticks();
+
+   for (uint32_t done = 0; done < total; done += buffer.size()) {
+      hash.Input(buffer.data(), buffer.size());
+   }
+   hash.Result();
+
+   uint64_t duration = Core::Time::Now().Ticks() - start;
+
+   return (duration == 0 ? 0.0 : static_cast<double>(total) / duration);
+}
+
+double MultiBufferThroughput(const uint32_t total, const std::vector<uint8_t>& buffer)
+{
+   SHA256 hash[4];
+   SHA256* hashes[4] = { &hash[0], &hash[1], &hash[2], &hash[3] };
+   const uint8_t* messages[4] = { buffer.data(), buffer.data(), buffer.data(), buffer.data() };
+   const uint64_t lengths[4] = { buffer.size(), buffer.size(), buffer.size(), buffer.size() };
+
+   uint64_t start = Core::Time::Now().Ticks();
+
+   for (uint32_t done = 0; done < total; done += (4 * buffer.size())) {
+      SHA256::Input(4, hashes, messages, lengths);
+   }
+   for (SHA256& entry : hash) {
+      entry.Result();
+   }
+
+   uint64_t duration = Core::Time::Now().Ticks() - start;
+
+   return (duration == 0 ? 0.0 : static_cast<double>(total) / duration);
+}
+
+}
+
+TEST(Crypto_Hash, knownAnswers)
+{
+   const bool hardware = HashAcceleration();
+
+   // Both implementations, if the hardware is there. The large message only once, it is slow in C.
+   for (int enable = (hardware ? 1 : 0); enable >= 0; enable--) {
+      HashAcceleration(enable == 1);
+
+      Check<SHA1>(g_sha1, (enable == (hardware ? 1 : 0)));
+      Check<SHA224>(g_sha224, false);
+      Check<SHA256>(g_sha256, (enable == (hardware ? 1 : 0)));
+      Check<SHA384>(g_sha384, false);
+      Check<SHA512>(g_sha512, (enable == 0));
+   }
+
+   HashAcceleration(hardware);
+}
+
+TEST(Crypto_Hash, hardwareMatchesSoftware)
+{
+   const bool hardware = HashAcceleration();
+
+   if (hardware == false) {
+      printf("Hash: no hardware acceleration on this CPU, nothing to compare\n");
+   } else {
+      const uint32_t length = 8192 + 17;
+      uint8_t message[length];
+
+      for (uint32_t index = 0; index < length; index++) {
+         message[index] = static_cast<uint8_t>((index * 7) ^ (index >> 5));
+      }
+
+      // Every length around the block and padding boundaries, then the uneven chunks.
+      for (uint32_t size = 0; size <= 200; size++) {
+         HashAcceleration(false);
+         string sha1 = Digest<SHA1>(message, size);
+         string sha256 = Digest<SHA256>(message, size);
+
+         HashAcceleration(true);
+         EXPECT_EQ(Digest<SHA1>(message, size), sha1) << "length " << size;
+         EXPECT_EQ(Digest<SHA256>(message, size), sha256) << "length " << size;
+      }
+
+      HashAcceleration(false);
+      string sha1 = Chunked<SHA1>(message, length);
+      string sha224 = Chunked<SHA224>(message, length);
+      string sha256 = Chunked<SHA256>(message, length);
+
+      HashAcceleration(true);
+      EXPECT_EQ(Chunked<SHA1>(message, length), sha1);
+      EXPECT_EQ(Chunked<SHA224>(message, length), sha224);
+      EXPECT_EQ(Chunked<SHA256>(message, length), sha256);
+
+      HashAcceleration(hardware);
+   }
+}
+
+TEST(Crypto_Hash, multiBuffer)
+{
+   const bool hardware = HashAcceleration();
+   const uint32_t length = 4096 + 100;
+   uint8_t message[length];
+
+   for (uint32_t index = 0; index < length; index++) {
+      message[index] = static_cast<uint8_t>((index * 13) ^ (index >> 3));
+   }
+
+   for (int enable = (hardware ? 1 : 0); enable >= 0; enable--) {
+      HashAcceleration(enable == 1);
+
+      // Differing lengths and a partial block already pending in some of the streams.
+      const uint64_t prefix[6] = { 0, 10, 63, 64, 0, 1 };
+      const uint64_t lengths[6] = { length, 4000, 64, 0, 129, length - 1 };
+      const uint8_t* messages[6];
+      SHA256 streams[6];
+      SHA256* hashes[6];
+
+      for (uint8_t index = 0; index < 6; index++) {
+         streams[index].Input(message, prefix[index]);
+         messages[index] = &(message[prefix[index]]);
+         hashes[index] = &(streams[index]);
+      }
+
+      // A second round continues where the first one left off.
+      SHA256::Input(6, hashes, messages, lengths);
+      SHA256::Input(6, hashes, messages, lengths);
+
+      for (uint8_t index = 0; index < 6; index++) {
+         SHA256 single;
+
+         single.Input(message, prefix[index]);
+         single.Input(messages[index], lengths[index]);
+         single.Input(messages[index], lengths[index]);
+
+         EXPECT_EQ(Hex(streams[index].Result(), SHA256::Length), Hex(single.Result(), SHA256::Length)) << "stream " << static_cast<uint32_t>(index) << ", hardware " << enable;
+      }
+   }
+
+   HashAcceleration(hardware);
+}
+
+TEST(Crypto_Hash, throughput)
+{
+   const uint32_t total = 64 * 1024 * 1024;
+   const bool hardware = HashAcceleration();
+   const std::vector<uint8_t> buffer(16 * 1024, 0xA5);
+
+   struct Measurement {
+      const char* name;
+      double (*measure)(const uint32_t, const std::vector<uint8_t>&);
+   };
+
+   const Measurement measurements[] = {
+      { "SHA1", Throughput<SHA1> },
+      { "SHA256", Throughput<SHA256> },
+      { "SHA256 x4 streams", MultiBufferThroughput },
+      { "SHA512", Throughput<SHA512> },
+      { "MD5", Throughput<MD5> }
+   };
+
+   for (const Measurement& measurement : measurements) {
+      double accelerated = 0.0;
+
+      if (hardware == true) {
+         HashAcceleration(true);
+         accelerated = measurement.measure(total, buffer);
+      }
+
+      HashAcceleration(false);
+      double software = measurement.measure(total, buffer);
+
+      printf("%-17s: hardware %7.2f GB/s, software %5.2f GB/s\n", measurement.name, accelerated / 1000.0, software / 1000.0);
+   }
+
+   HashAcceleration(hardware);
+
+   Core::Singleton::Dispose();
+}
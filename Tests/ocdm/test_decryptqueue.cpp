@@ -0,0 +1,267 @@
+#include "../IPTestAdministrator.h"
+
+#include <gtest/gtest.h>
+#include <core/core.h>
+#include <ocdm/DataExchange.h>
+
+using namespace WPEFramework;
+using namespace WPEFramework::Core;
+
+namespace {
+
+const char g_queueName[] = "/tmp/decryptqueue01.video";
+const uint16_t g_slots = 4;
+const uint32_t g_sampleSize = 256 * 1024;
+const uint32_t g_sampleCount = 2000;
+
+// Stands in for the DRM system: touches every byte of the sample, like a software decryptor would.
+void Decrypt(uint8_t data[], const uint32_t length, const uint32_t key)
+{
+   uint64_t* words = reinterpret_cast<uint64_t*>(data);
+   uint64_t pattern = 0x0101010101010101ULL * static_cast<uint8_t>(key);
+
+   for (uint32_t index = 0; index < (length / sizeof(uint64_t)); index++) {
+      words[index] ^= pattern;
+   }
+}
+
+void Server(IPTestAdministrator& testAdmin)
+{
+   OCDM::DecryptQueue queue(g_queueName, g_slots, g_sampleSize);
+
+   testAdmin.Sync("setup server");
+
+   OCDM::DecryptQueue::Descriptor* descriptor;
+
+   while ((descriptor = queue.Receive(1000)) != nullptr) {
+      Decrypt(queue.Data(*descriptor), descriptor->Length, descriptor->Ticket);
+      queue.Complete(0);
+   }
+
+   testAdmin.Sync("done");
+}
+
+struct Result {
+   uint32_t samples;
+   uint32_t errors;
+   uint64_t duration; // In microseconds.
+   uint64_t latency;  // Sum of submit to collect latencies, in microseconds.
+};
+
+// Runs "g_sampleCount" samples through the queue with at most "depth" in flight.
+Result Measure(OCDM::DecryptQueue& queue, const bool zeroCopy, const uint16_t depth)
+{
+   Result result = {};
+   uint8_t* samples = new uint8_t[depth * g_sampleSize];
+   uint64_t submitted[g_slots];
+   uint8_t iv[16] = {};
+   uint32_t collected = 0;
+   uint32_t next = 0;
+   const uint32_t first = queue.Oldest();
+
+   uint64_t start = Time::Now().Ticks();
+
+   while (collected < g_sampleCount) {
+      uint32_t ticket;
+
+      if ((next < g_sampleCount) && (queue.Pending() < depth)) {
+         uint8_t* sample = (zeroCopy == true ? queue.Allocate(g_sampleSize) : &(samples[(next % depth) * g_sampleSize]));
+
+         if (sample != nullptr) {
+            // The demuxer writes the encrypted sample.
+            memset(sample, static_cast<uint8_t>(first + next), g_sampleSize);
+
+            submitted[next % g_slots] = Time::Now().Ticks();
+
+            if (queue.Submit(sample, g_sampleSize, iv, sizeof(iv), nullptr, 0, false, ticket) != ERROR_NONE) {
+               result.errors++;
+            }
+            next++;
+            continue;
+         }
+      }
+
+      uint32_t status;
+      const uint8_t* clear;
+      uint32_t length;
+
+      if (zeroCopy == true) {
+         clear = queue.Collect(1000, ticket, length, status);
+      } else {
+         uint8_t* destination = &(samples[(collected % depth) * g_sampleSize]);
+         clear = (queue.Collect(1000, ticket, destination, g_sampleSize, status) == ERROR_NONE ? destination : nullptr);
+         length = g_sampleSize;
+      }
+
+      if (clear == nullptr) {
+         result.errors++;
+         break;
+      }
+
+      result.latency += Time::Now().Ticks() - submitted[ticket % g_slots];
+
+      // The decoder reads the clear sample, the stand-in decryptor cleared it.
+      if (((ticket - first) != collected) || (status != 0) || (length != g_sampleSize) || (clear[0] != 0) || (clear[g_sampleSize - 1] != 0)) {
+         result.errors++;
+      }
+
+      if (zeroCopy == true) {
+         queue.Release(ticket);
+      }
+      collected++;
+   }
+
+   result.duration = Time::Now().Ticks() - start;
+   result.samples = collected;
+
+   delete[] samples;
+
+   return (result);
+}
+
+void Report(const char name[], const Result& measurement)
+{
+   printf("DecryptQueue %-24s: %u samples of %u KB, %8.1f MB/s, latency %7.1f us/sample\n",
+      name, measurement.samples, g_sampleSize / 1024,
+      (measurement.duration == 0 ? 0.0 : (static_cast<double>(measurement.samples) * g_sampleSize) / measurement.duration),
+      (measurement.samples == 0 ? 0.0 : static_cast<double>(measurement.latency) / measurement.samples));
+}
+
+}
+
+TEST(OCDM_DecryptQueue, inPlaceDecryption)
+{
+   IPTestAdministrator testAdmin(Server);
+
+   testAdmin.Sync("setup server");
+
+   {
+      OCDM::DecryptQueue queue(g_queueName);
+
+      ASSERT_TRUE(queue.IsValid());
+      EXPECT_EQ(queue.Slots(), g_slots);
+      EXPECT_EQ(queue.SlotSize(), g_sampleSize);
+      EXPECT_EQ(queue.Allocate(g_sampleSize + 1), nullptr);
+
+      uint8_t iv[16] = {};
+      uint32_t ticket, length, status;
+
+      for (uint8_t index = 0; index < g_slots; index++) {
+         uint8_t* sample = queue.Allocate(g_sampleSize);
+
+         ASSERT_NE(sample, nullptr);
+         EXPECT_TRUE(queue.IsAllocated(sample));
+
+         // Only one sample can be allocated before it is submitted.
+         EXPECT_EQ(queue.Allocate(g_sampleSize), nullptr);
+
+         memset(sample, 0x5A, g_sampleSize);
+         EXPECT_EQ(queue.Submit(sample, g_sampleSize, iv, sizeof(iv), nullptr, 0, false, ticket), ERROR_NONE);
+         EXPECT_EQ(ticket, index);
+      }
+
+      for (uint8_t index = 0; index < g_slots; index++) {
+         const uint8_t* clear = queue.Collect(1000, ticket, length, status);
+
+         ASSERT_NE(clear, nullptr);
+         EXPECT_EQ(ticket, index);
+         EXPECT_EQ(length, g_sampleSize);
+         EXPECT_EQ(clear[0], 0x5A ^ index);
+         EXPECT_EQ(clear[g_sampleSize - 1], 0x5A ^ index);
+         EXPECT_TRUE(queue.IsHeld(ticket));
+      }
+
+      // All slots still hold clear samples, slots are reused in order.
+      EXPECT_EQ(queue.Allocate(g_sampleSize), nullptr);
+      queue.Release(1);
+      EXPECT_EQ(queue.Allocate(g_sampleSize), nullptr);
+      queue.Release(0);
+      EXPECT_FALSE(queue.IsHeld(0));
+      EXPECT_NE(queue.Allocate(g_sampleSize), nullptr);
+   }
+
+   testAdmin.Sync("done");
+}
+
+TEST(OCDM_DecryptQueue, collectInTwoSteps)
+{
+   IPTestAdministrator testAdmin(Server);
+
+   testAdmin.Sync("setup server");
+
+   {
+      OCDM::DecryptQueue queue(g_queueName);
+
+      ASSERT_TRUE(queue.IsValid());
+
+      uint8_t* sample = new uint8_t[g_sampleSize];
+      uint8_t iv[16] = {};
+      uint32_t ticket, length, status;
+
+      memset(sample, 0x33, g_sampleSize);
+      ASSERT_EQ(queue.Submit(sample, g_sampleSize, iv, sizeof(iv), nullptr, 0, false, ticket), ERROR_NONE);
+
+      // The wait leaves the bookkeeping alone, the sample is only collected by Take.
+      EXPECT_EQ(queue.Completed(1000), ERROR_NONE);
+      EXPECT_EQ(queue.Pending(), 1u);
+
+      // Meanwhile the next sample can be submitted.
+      EXPECT_EQ(queue.Submit(sample, g_sampleSize, iv, sizeof(iv), nullptr, 0, false, ticket), ERROR_NONE);
+      EXPECT_EQ(ticket, 1u);
+
+      const uint8_t* clear = queue.Take(ticket, length, status);
+      EXPECT_EQ(ticket, 0u);
+      EXPECT_EQ(length, g_sampleSize);
+      EXPECT_EQ(clear[0], 0x33);
+      queue.Release(ticket);
+
+      EXPECT_EQ(queue.Completed(1000), ERROR_NONE);
+      clear = queue.Take(ticket, length, status);
+      EXPECT_EQ(ticket, 1u);
+      EXPECT_EQ(clear[g_sampleSize - 1], 0x33 ^ 0x01);
+      queue.Release(ticket);
+
+      // Nothing decrypted anymore.
+      EXPECT_EQ(queue.Pending(), 0u);
+      EXPECT_EQ(queue.Completed(10), ERROR_TIMEDOUT);
+
+      delete[] sample;
+   }
+
+   testAdmin.Sync("done");
+}
+
+TEST(OCDM_DecryptQueue, sampleThroughput)
+{
+   IPTestAdministrator testAdmin(Server);
+
+   testAdmin.Sync("setup server");
+
+   {
+      OCDM::DecryptQueue queue(g_queueName);
+
+      ASSERT_TRUE(queue.IsValid());
+
+      Result copied = Measure(queue, false, 1);
+      Report("copy, one at a time", copied);
+      EXPECT_EQ(copied.errors, 0u);
+
+      Result pipelined = Measure(queue, false, g_slots);
+      Report("copy, pipelined", pipelined);
+      EXPECT_EQ(pipelined.errors, 0u);
+
+      Result inPlace = Measure(queue, true, 1);
+      Report("in place, one at a time", inPlace);
+      EXPECT_EQ(inPlace.errors, 0u);
+
+      Result zeroCopy = Measure(queue, true, g_slots);
+      Report("in place, pipelined", zeroCopy);
+      EXPECT_EQ(zeroCopy.errors, 0u);
+   }
+
+   testAdmin.Sync("done");
+
+   ::unlink(g_queueName);
+
+   Core::Singleton::Dispose();
+}
@@ -0,0 +1,537 @@
+// Benchmark of the COM-RPC stack. The benchmark starts itself a second time, as the server, that offers an
+// Exchange::IPerformance implementation over an RPC::Communicator. The client measures the round trip times
+// of Send, Receive and Exchange for a range of payload sizes, number of calling threads and with a proxy
+// that exists already (warm) or that has to be set up for the call (cold). The results are reported as
+// JSON, so they can be compared from run to run.
+
+#include <core/core.h>
+#include <com/com.h>
+#include <interfaces/IPerformance.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace WPEFramework;
+
+namespace {
+
+    // Exchange::IPerformance takes 16 bit sizes, a larger payload takes more calls.
+    static constexpr uint32_t MaxCallPayload = 32768;
+    // Every configuration moves at most this many bytes, so the large payloads do not take forever.
+    static constexpr uint32_t MaxBytesPerRun = 64 * 1024 * 1024;
+    static constexpr uint32_t ConnectTime = 2000;
+
+    static const uint32_t PayloadSizes[] = { 0, 64, 1024, 16384, 65536, 262144, 1048576 };
+
+    class ConsoleOptions : public Core::Options {
+    public:
+        ConsoleOptions(int argumentCount, TCHAR* arguments[])
+            : Core::Options(argumentCount, arguments, _T("c:o:i:t:sh"))
+            , Connector(nullptr)
+            , Output(nullptr)
+            , Iterations(1000)
+            , Threads(4)
+            , Server(false)
+        {
+            Parse();
+        }
+        ~ConsoleOptions()
+        {
+        }
+
+    public:
+        const TCHAR* Connector;
+        const TCHAR* Output;
+        uint32_t Iterations;
+        uint8_t Threads;
+        bool Server;
+
+    private:
+        virtual void Option(const TCHAR option, const TCHAR* argument)
+        {
+            switch (option) {
+            case 'c':
+                Connector = argument;
+                break;
+            case 'o':
+                Output = argument;
+                break;
+            case 'i':
+                Iterations = Core::NumberType<uint32_t>(Core::TextFragment(argument)).Value();
+                break;
+            case 't':
+                Threads = Core::NumberType<uint8_t>(Core::TextFragment(argument)).Value();
+                break;
+            case 's':
+                Server = true;
+                break;
+            case 'h':
+            default:
+                RequestUsage(true);
+                break;
+            }
+        }
+    };
+
+    class Performance : public Exchange::IPerformance {
+    private:
+        Performance(const Performance&) = delete;
+        Performance& operator=(const Performance&) = delete;
+
+    public:
+        Performance()
+        {
+        }
+        virtual ~Performance()
+        {
+        }
+
+    public:
+        virtual uint32_t Send(const uint16_t sendSize VARIABLE_IS_NOT_USED, const uint8_t buffer[] VARIABLE_IS_NOT_USED) override
+        {
+            return (Core::ERROR_NONE);
+        }
+        virtual uint32_t Receive(uint16_t& bufferSize, uint8_t buffer[]) const override
+        {
+            ::memset(buffer, 0xAA, bufferSize);
+
+            return (Core::ERROR_NONE);
+        }
+        virtual uint32_t Exchange(uint16_t& bufferSize VARIABLE_IS_NOT_USED, uint8_t buffer[] VARIABLE_IS_NOT_USED, const uint16_t maxBufferSize VARIABLE_IS_NOT_USED) override
+        {
+            // Hand back what was received.
+            return (Core::ERROR_NONE);
+        }
+
+        BEGIN_INTERFACE_MAP(Performance)
+            INTERFACE_ENTRY(Exchange::IPerformance)
+        END_INTERFACE_MAP
+    };
+
+    class Server : public RPC::Communicator {
+    private:
+        Server() = delete;
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+    public:
+        Server(const Core::NodeId& source)
+            : RPC::Communicator(source, Core::ProxyType<RPC::InvokeServerType<16, 4>>::Create(), _T(""))
+        {
+        }
+        ~Server()
+        {
+        }
+
+    private:
+        virtual void* Aquire(const string& className VARIABLE_IS_NOT_USED, const uint32_t interfaceId, const uint32_t versionId VARIABLE_IS_NOT_USED) override
+        {
+            void* result = nullptr;
+
+            if (interfaceId == Exchange::IPerformance::ID) {
+                result = Core::Service<Performance>::Create<Exchange::IPerformance>();
+            }
+
+            return (result);
+        }
+    };
+
+    class Distribution : public Core::JSON::Container {
+    public:
+        Distribution()
+            : Core::JSON::Container()
+            , Min(0)
+            , Mean(0)
+            , P50(0)
+            , P90(0)
+            , P99(0)
+            , Max(0)
+        {
+            Add(_T("min"), &Min);
+            Add(_T("mean"), &Mean);
+            Add(_T("p50"), &P50);
+            Add(_T("p90"), &P90);
+            Add(_T("p99"), &P99);
+            Add(_T("max"), &Max);
+        }
+        Distribution(const Distribution& copy)
+            : Core::JSON::Container()
+            , Min(copy.Min)
+            , Mean(copy.Mean)
+            , P50(copy.P50)
+            , P90(copy.P90)
+            , P99(copy.P99)
+            , Max(copy.Max)
+        {
+            Add(_T("min"), &Min);
+            Add(_T("mean"), &Mean);
+            Add(_T("p50"), &P50);
+            Add(_T("p90"), &P90);
+            Add(_T("p99"), &P99);
+            Add(_T("max"), &Max);
+        }
+        ~Distribution()
+        {
+        }
+
+    public:
+        // Nanoseconds per operation.
+        Core::JSON::DecUInt64 Min;
+        Core::JSON::DecUInt64 Mean;
+        Core::JSON::DecUInt64 P50;
+        Core::JSON::DecUInt64 P90;
+        Core::JSON::DecUInt64 P99;
+        Core::JSON::DecUInt64 Max;
+    };
+
+    class Result : public Core::JSON::Container {
+    public:
+        Result()
+            : Core::JSON::Container()
+            , Method()
+            , Payload(0)
+            , Threads(0)
+            , Proxy()
+            , Calls(0)
+            , Operations(0)
+            , Latency()
+            , OperationsPerSecond(0)
+            , BytesPerSecond(0)
+        {
+            Register();
+        }
+        Result(const Result& copy)
+            : Core::JSON::Container()
+            , Method(copy.Method)
+            , Payload(copy.Payload)
+            , Threads(copy.Threads)
+            , Proxy(copy.Proxy)
+            , Calls(copy.Calls)
+            , Operations(copy.Operations)
+            , Latency(copy.Latency)
+            , OperationsPerSecond(copy.OperationsPerSecond)
+            , BytesPerSecond(copy.BytesPerSecond)
+        {
+            Register();
+        }
+        ~Result()
+        {
+        }
+
+    private:
+        void Register()
+        {
+            Add(_T("method"), &Method);
+            Add(_T("payload"), &Payload);
+            Add(_T("threads"), &Threads);
+            Add(_T("proxy"), &Proxy);
+            Add(_T("calls"), &Calls);
+            Add(_T("operations"), &Operations);
+            Add(_T("latency"), &Latency);
+            Add(_T("operationspersecond"), &OperationsPerSecond);
+            Add(_T("bytespersecond"), &BytesPerSecond);
+        }
+
+    public:
+        Core::JSON::String Method;
+        Core::JSON::DecUInt32 Payload;
+        Core::JSON::DecUInt8 Threads;
+        // "warm": the proxy exists, "cold": the remote object and its proxy are created for the call.
+        Core::JSON::String Proxy;
+        // The number of calls a single operation takes to move the payload.
+        Core::JSON::DecUInt32 Calls;
+        Core::JSON::DecUInt32 Operations;
+        Distribution Latency;
+        Core::JSON::DecUInt64 OperationsPerSecond;
+        Core::JSON::DecUInt64 BytesPerSecond;
+    };
+
+    class Report : public Core::JSON::Container {
+    private:
+        Report(const Report&) = delete;
+        Report& operator=(const Report&) = delete;
+
+    public:
+        Report()
+            : Core::JSON::Container()
+            , Iterations(0)
+            , Results()
+        {
+            Add(_T("iterations"), &Iterations);
+            Add(_T("results"), &Results);
+        }
+        ~Report()
+        {
+        }
+
+    public:
+        Core::JSON::DecUInt32 Iterations;
+        Core::JSON::ArrayType<Result> Results;
+    };
+
+    enum method {
+        SEND,
+        RECEIVE,
+        EXCHANGE
+    };
+
+    const TCHAR* MethodName(const method value)
+    {
+        return (value == SEND ? _T("send") : (value == RECEIVE ? _T("receive") : _T("exchange")));
+    }
+
+    // Move the complete payload, in as many calls as needed.
+    bool Operation(Exchange::IPerformance* performance, const method type, const uint32_t payload, uint8_t buffer[])
+    {
+        uint32_t offset = 0;
+        bool result = true;
+
+        do {
+            uint16_t size = static_cast<uint16_t>(std::min(payload - offset, MaxCallPayload));
+
+            switch (type) {
+            case SEND:
+                result = (performance->Send(size, buffer) == Core::ERROR_NONE);
+                break;
+            case RECEIVE:
+                result = (performance->Receive(size, buffer) == Core::ERROR_NONE);
+                break;
+            case EXCHANGE:
+                result = (performance->Exchange(size, buffer, MaxCallPayload) == Core::ERROR_NONE);
+                break;
+            }
+
+            offset += size;
+
+        } while ((result == true) && (offset < payload));
+
+        return (result);
+    }
+
+    void Measure(RPC::CommunicatorClient& client, Exchange::IPerformance* performance, const method type, const uint32_t payload, const uint8_t threads, const bool cold, uint32_t iterations, Result& result)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        iterations = std::max(static_cast<uint32_t>(10), std::min(iterations, MaxBytesPerRun / std::max(payload, static_cast<uint32_t>(1))));
+
+        std::vector<std::vector<uint64_t>> samples(threads);
+        std::vector<std::thread> callers;
+        std::atomic<uint32_t> failures(0);
+
+        auto caller = [&](std::vector<uint64_t>& durations) {
+            std::vector<uint8_t> buffer(MaxCallPayload, 0x55);
+            uint32_t failed = 0;
+
+            durations.reserve(iterations);
+
+            // Warm up, the first calls fill the message pools.
+            for (uint32_t index = 0; (cold == false) && (index < (iterations / 10)); index++) {
+                Operation(performance, type, payload, buffer.data());
+            }
+
+            for (uint32_t index = 0; index < iterations; index++) {
+                Clock::time_point start = Clock::now();
+
+                Exchange::IPerformance* target = performance;
+
+                if (cold == true) {
+                    target = client.Aquire<Exchange::IPerformance>(ConnectTime, _T("Performance"), ~0);
+                }
+
+                if ((target == nullptr) || (Operation(target, type, payload, buffer.data()) == false)) {
+                    failed++;
+                }
+
+                if ((cold == true) && (target != nullptr)) {
+                    target->Release();
+                }
+
+                durations.push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+            }
+
+            failures += failed;
+        };
+
+        Clock::time_point start = Clock::now();
+
+        for (uint8_t index = 0; index < threads; index++) {
+            callers.emplace_back(caller, std::ref(samples[index]));
+        }
+        for (std::thread& thread : callers) {
+            thread.join();
+        }
+
+        uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+        std::vector<uint64_t> durations;
+        uint64_t total = 0;
+
+        for (const std::vector<uint64_t>& sample : samples) {
+            durations.insert(durations.end(), sample.begin(), sample.end());
+        }
+
+        std::sort(durations.begin(), durations.end());
+
+        for (const uint64_t duration : durations) {
+            total += duration;
+        }
+
+        const uint64_t operations = durations.size();
+        const uint64_t direction = (type == EXCHANGE ? 2 : 1);
+
+        if (failures != 0) {
+            fprintf(stderr, "%s of %d bytes failed %d times.\n", MethodName(type), payload, failures.load());
+        }
+
+        result.Method = MethodName(type);
+        result.Payload = payload;
+        result.Threads = threads;
+        result.Proxy = (cold == true ? _T("cold") : _T("warm"));
+        result.Calls = std::max(static_cast<uint32_t>(1), (payload + MaxCallPayload - 1) / MaxCallPayload);
+        result.Operations = static_cast<uint32_t>(operations);
+
+        // Without calling threads, there is nothing to report on.
+        if (operations != 0) {
+            result.Latency.Min = durations.front();
+            result.Latency.Mean = total / operations;
+            result.Latency.P50 = durations[(operations * 50) / 100];
+            result.Latency.P90 = durations[(operations * 90) / 100];
+            result.Latency.P99 = durations[(operations * 99) / 100];
+            result.Latency.Max = durations.back();
+            result.OperationsPerSecond = (operations * 1000000000) / std::max(elapsed, static_cast<uint64_t>(1));
+            result.BytesPerSecond = (operations * payload * direction * 1000000000) / std::max(elapsed, static_cast<uint64_t>(1));
+        }
+    }
+
+    int Serve(const Core::NodeId& node)
+    {
+        sigset_t signals;
+        int signal;
+
+        // Block them before any thread is started, so they all inherit the mask and we can wait for them here.
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGTERM);
+        sigaddset(&signals, SIGINT);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        {
+            Server server(node);
+
+            if (server.Open(Core::infinite) != Core::ERROR_NONE) {
+                fprintf(stderr, "Could not open %s.\n", node.HostName().c_str());
+            } else {
+                sigwait(&signals, &signal);
+
+                server.Close(Core::infinite);
+            }
+        }
+
+        Core::Singleton::Dispose();
+
+        return (0);
+    }
+
+    int Run(const TCHAR application[], const ConsoleOptions& options, const string& connector)
+    {
+        Core::Process server(false);
+        Core::Process::Options serverOptions(application);
+        uint32_t pid;
+        int result = 1;
+
+        serverOptions[_T("-c")] = connector;
+        serverOptions.Set(_T("-s"));
+
+        if (server.Launch(serverOptions, &pid) != Core::ERROR_NONE) {
+            fprintf(stderr, "Could not start the server.\n");
+        } else {
+            Report report;
+
+            {
+                Core::ProxyType<RPC::IHandler> handler(Core::ProxyType<RPC::InvokeServerType<4, 1>>::Create());
+                Core::ProxyType<RPC::CommunicatorClient> client(Core::ProxyType<RPC::CommunicatorClient>::Create(Core::NodeId(connector.c_str()), handler));
+                Exchange::IPerformance* performance = nullptr;
+                uint32_t waited = 0;
+
+                // Give the server the time to open up.
+                while ((waited < ConnectTime) && ((performance = client->Open<Exchange::IPerformance>(_T("Performance"))) == nullptr)) {
+                    SleepMs(50);
+                    waited += 50;
+                }
+
+                if (performance == nullptr) {
+                    fprintf(stderr, "Could not connect to the server at %s.\n", connector.c_str());
+                } else {
+                    report.Iterations = options.Iterations;
+
+                    for (const method type : { SEND, RECEIVE, EXCHANGE }) {
+                        for (const uint32_t payload : PayloadSizes) {
+                            // Wider than the option, so the doubling ends instead of wrapping past 128.
+                            for (uint16_t threads = 1; threads <= options.Threads; threads = (threads << 1)) {
+                                fprintf(stderr, "%s, %d bytes, %d thread(s)\n", MethodName(type), payload, threads);
+                                Measure(*client, performance, type, payload, static_cast<uint8_t>(threads), false, options.Iterations, report.Results.Add());
+                            }
+                            // Aquiring an interface is not thread safe on the client, so cold is measured from a single thread.
+                            fprintf(stderr, "%s, %d bytes, cold proxy\n", MethodName(type), payload);
+                            Measure(*client, performance, type, payload, 1, true, std::max(options.Iterations / 10, static_cast<uint32_t>(1)), report.Results.Add());
+                        }
+                    }
+
+                    performance->Release();
+
+                    result = 0;
+                }
+
+                client->Close(Core::infinite);
+            }
+
+            server.Kill(false);
+            server.WaitProcessCompleted(ConnectTime);
+
+            if (options.Output == nullptr) {
+                string text;
+
+                report.ToString(text);
+                printf("%s\n", text.c_str());
+            } else {
+                Core::File file(string(options.Output));
+
+                // Replace the report of a previous run.
+                if (file.Exists() == true) {
+                    file.Destroy();
+                }
+
+                if (file.Create() == false) {
+                    fprintf(stderr, "Could not create %s.\n", options.Output);
+                    result = 1;
+                } else {
+                    report.ToFile(file);
+                    file.Close();
+                }
+            }
+        }
+
+        Core::Singleton::Dispose();
+
+        return (result);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ConsoleOptions options(argc, argv);
+
+    if ((options.RequestUsage() == true) || (options.Threads == 0)) {
+        printf("Usage: %s <options>\n", argv[0]);
+        printf("    [-c <connector>]   The socket the client and server meet on.\n");
+        printf("    [-o <file>]        Write the JSON report to this file, instead of to stdout.\n");
+        printf("    [-i <iterations>]  Operations per thread per configuration, default 1000.\n");
+        printf("    [-t <threads>]     Measure with 1, 2, 4, .. up to this many calling threads, default 4.\n");
+        return (1);
+    }
+
+    const string connector(options.Connector != nullptr ? string(options.Connector) : _T("/tmp/rpcbenchmark.") + Core::NumberType<uint32_t>(Core::ProcessInfo().Id()).Text());
+
+    return (options.Server == true ? Serve(Core::NodeId(connector.c_str())) : Run(argv[0], options, connector));
+}
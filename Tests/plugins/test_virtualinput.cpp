@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include "../../Source/plugins/VirtualInput.h"
+
+#include <fstream>
+
+using namespace WPEFramework;
+using namespace WPEFramework::PluginHost;
+
+namespace {
+
+const char g_keyMapName[] = "/tmp/virtualinput01.json";
+
+// The slot a key starts probing at, in a table of 2^bits entries, the same Fibonacci hash as the lookup.
+uint32_t Slot(const uint32_t key, const uint8_t bits)
+{
+   return (static_cast<uint32_t>((key * 2654435761U) >> (32 - bits)));
+}
+
+// Finds "count" keys, starting at "from", that all start probing at the given slot.
+std::vector<uint32_t> Colliding(const uint32_t slot, const uint8_t bits, const uint32_t count, uint32_t from = 1)
+{
+   std::vector<uint32_t> keys;
+
+   while (keys.size() < count) {
+      if (Slot(from, bits) == slot) {
+         keys.push_back(from);
+      }
+      from++;
+   }
+
+   return (keys);
+}
+
+class Input : public VirtualInput {
+public:
+   Input()
+      : VirtualInput()
+   {
+   }
+   virtual ~Input()
+   {
+   }
+
+public:
+   virtual uint32_t Open() override
+   {
+      return (Core::ERROR_NONE);
+   }
+   virtual uint32_t Close() override
+   {
+      return (Core::ERROR_NONE);
+   }
+
+private:
+   virtual void MapChanges(ChangeIterator&) override
+   {
+   }
+   virtual void LookupChanges(const string&) override
+   {
+   }
+   virtual void SendKey(const actiontype, const uint32_t) override
+   {
+   }
+};
+
+}
+
+TEST(Plugins_FlatLookup, empty)
+{
+   VirtualInput::PostLookupEntries lookup;
+
+   EXPECT_EQ(lookup.Count(), 0u);
+   EXPECT_EQ(lookup.Find(0), nullptr);
+   EXPECT_EQ(lookup.Find(42), nullptr);
+
+   std::map<uint32_t, uint32_t> source;
+   lookup.Build(source);
+
+   EXPECT_EQ(lookup.Count(), 0u);
+   EXPECT_EQ(lookup.Find(0), nullptr);
+   EXPECT_EQ(lookup.Find(42), nullptr);
+
+   // Emptied again after it held something.
+   source[42] = 1;
+   lookup.Build(source);
+   ASSERT_NE(lookup.Find(42), nullptr);
+
+   source.clear();
+   lookup.Build(source);
+   EXPECT_EQ(lookup.Count(), 0u);
+   EXPECT_EQ(lookup.Find(42), nullptr);
+}
+
+TEST(Plugins_FlatLookup, findAndBuild)
+{
+   VirtualInput::PostLookupEntries lookup;
+   std::map<uint32_t, uint32_t> source;
+
+   for (uint32_t index = 0; index < 100; index++) {
+      source[0x1000 + (index * 7)] = index;
+   }
+
+   lookup.Build(source);
+   EXPECT_EQ(lookup.Count(), 100u);
+
+   for (const auto& element : source) {
+      const uint32_t* value = lookup.Find(element.first);
+      ASSERT_NE(value, nullptr);
+      EXPECT_EQ(*value, element.second);
+   }
+   EXPECT_EQ(lookup.Find(0x1001), nullptr);
+   EXPECT_EQ(lookup.Find(0), nullptr);
+   EXPECT_EQ(lookup.Find(~0), nullptr);
+
+   // The converter is applied to every value.
+   lookup.Build(source, [](const uint32_t value) -> uint32_t { return (value * 2); });
+   ASSERT_NE(lookup.Find(0x1000 + 7), nullptr);
+   EXPECT_EQ(*lookup.Find(0x1000 + 7), 2u);
+
+   // A rebuild replaces what was there.
+   source.erase(0x1000);
+   source[5] = 500;
+   lookup.Build(source);
+   EXPECT_EQ(lookup.Count(), 100u);
+   EXPECT_EQ(lookup.Find(0x1000), nullptr);
+   ASSERT_NE(lookup.Find(5), nullptr);
+   EXPECT_EQ(*lookup.Find(5), 500u);
+}
+
+TEST(Plugins_FlatLookup, collisionsAndWrapAround)
+{
+   // Four entries are kept in a table of eight, all of these start at the last slot, so they probe around
+   // to the front.
+   const uint8_t bits = 3;
+   std::vector<uint32_t> keys(Colliding(7, bits, 5));
+
+   VirtualInput::PostLookupEntries lookup;
+   std::map<uint32_t, uint32_t> source;
+
+   for (uint32_t index = 0; index < 4; index++) {
+      source[keys[index]] = index + 1;
+   }
+
+   lookup.Build(source);
+   EXPECT_EQ(lookup.Count(), 4u);
+
+   for (uint32_t index = 0; index < 4; index++) {
+      const uint32_t* value = lookup.Find(keys[index]);
+      ASSERT_NE(value, nullptr);
+      EXPECT_EQ(*value, index + 1);
+   }
+
+   // Probes past all of them, to the first unused slot.
+   EXPECT_EQ(lookup.Find(keys[4]), nullptr);
+}
+
+TEST(Plugins_VirtualInput, keyMapLookup)
+{
+   Input input;
+   VirtualInput::KeyMap& keyMap(input.Table(_T("test")));
+
+   EXPECT_EQ(keyMap[0x10], nullptr);
+
+   EXPECT_TRUE(keyMap.Add(0x10, 30, VirtualInput::KeyMap::LEFTSHIFT));
+   EXPECT_FALSE(keyMap.Add(0x10, 31, 0));
+   ASSERT_NE(keyMap[0x10], nullptr);
+   EXPECT_EQ(keyMap[0x10]->Code, 30);
+   EXPECT_EQ(keyMap[0x10]->Modifiers, VirtualInput::KeyMap::LEFTSHIFT);
+
+   EXPECT_TRUE(keyMap.Modify(0x10, 40, 0));
+   ASSERT_NE(keyMap[0x10], nullptr);
+   EXPECT_EQ(keyMap[0x10]->Code, 40);
+   EXPECT_EQ(keyMap[0x10]->Modifiers, 0);
+
+   // Modifying a code that is not there, adds it.
+   EXPECT_TRUE(keyMap.Modify(0x11, 41, VirtualInput::KeyMap::LEFTCTRL));
+   ASSERT_NE(keyMap[0x11], nullptr);
+   EXPECT_EQ(keyMap[0x11]->Code, 41);
+
+   keyMap.Delete(0x10);
+   EXPECT_EQ(keyMap[0x10], nullptr);
+   ASSERT_NE(keyMap[0x11], nullptr);
+
+   keyMap.Delete(0x11);
+   EXPECT_EQ(keyMap[0x11], nullptr);
+
+   // Loading replaces the whole map.
+   EXPECT_TRUE(keyMap.Add(0x12, 42, 0));
+   {
+      std::ofstream file(g_keyMapName, std::ios::trunc);
+      file << "[{\"code\":\"0x20\",\"key\":50},{\"code\":\"0x21\",\"key\":51,\"modifiers\":[\"rightalt\"]}]";
+   }
+   EXPECT_EQ(keyMap.Load(g_keyMapName), Core::ERROR_NONE);
+   EXPECT_EQ(keyMap[0x12], nullptr);
+   ASSERT_NE(keyMap[0x20], nullptr);
+   EXPECT_EQ(keyMap[0x20]->Code, 50);
+   ASSERT_NE(keyMap[0x21], nullptr);
+   EXPECT_EQ(keyMap[0x21]->Code, 51);
+   EXPECT_EQ(keyMap[0x21]->Modifiers, VirtualInput::KeyMap::RIGHTALT);
+
+   ::unlink(g_keyMapName);
+
+   // A key map reports its keys as removed on destruction, so it goes before the input does.
+   input.ClearTable(_T("test"));
+
+   Core::Singleton::Dispose();
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include "../../Source/WPEFramework/DownloadEngine.h"
+
+using namespace WPEFramework;
+using namespace WPEFramework::PluginHost;
+
+namespace {
+
+const char g_checkpointName[] = "/tmp/downloadengine01.checkpoint";
+const char g_source[] = "http://127.0.0.1/firmware.bin";
+
+// The ranges follow each other without a gap or an overlap, from the offset up to the size.
+void ExpectContiguous(const std::vector<DownloadEngine::Range>& ranges, const uint64_t offset, const uint64_t size)
+{
+   uint64_t next = offset;
+
+   for (const DownloadEngine::Range& range : ranges) {
+      EXPECT_EQ(range._begin, next);
+      EXPECT_EQ(range._received, 0u);
+      EXPECT_FALSE(range._done);
+      next += range._length;
+   }
+
+   EXPECT_EQ(next, size);
+}
+
+}
+
+TEST(WPEFramework_DownloadEngine, splitRanges)
+{
+   std::vector<DownloadEngine::Range> ranges;
+
+   // Without a size there is nothing to divide, the one range runs up to the end.
+   DownloadEngine::Split(0, 0, 4, ranges);
+   ASSERT_EQ(ranges.size(), 1u);
+   EXPECT_EQ(ranges[0]._begin, 0u);
+   EXPECT_EQ(ranges[0]._length, 0u);
+
+   DownloadEngine::Split(12345, 0, 4, ranges);
+   ASSERT_EQ(ranges.size(), 1u);
+   EXPECT_EQ(ranges[0]._begin, 12345u);
+   EXPECT_EQ(ranges[0]._length, 0u);
+
+   // The last range takes the remainder of the division.
+   const uint64_t size = (10 * DownloadEngine::MinimumRange) + 3;
+   DownloadEngine::Split(0, size, 4, ranges);
+   ASSERT_EQ(ranges.size(), 4u);
+   EXPECT_EQ(ranges[0]._length, size / 4);
+   EXPECT_EQ(ranges[3]._length, size - (3 * (size / 4)));
+   ExpectContiguous(ranges, 0, size);
+
+   // Never more connections than the maximum...
+   const uint64_t large = 64ULL * DownloadEngine::MinimumRange;
+   DownloadEngine::Split(0, large, 200, ranges);
+   EXPECT_EQ(ranges.size(), static_cast<size_t>(DownloadEngine::MaxConnections));
+   ExpectContiguous(ranges, 0, large);
+
+   // ...and no ranges below the minimum.
+   DownloadEngine::Split(0, (2 * DownloadEngine::MinimumRange) + 1, 8, ranges);
+   EXPECT_EQ(ranges.size(), 2u);
+   ExpectContiguous(ranges, 0, (2 * DownloadEngine::MinimumRange) + 1);
+
+   DownloadEngine::Split(0, DownloadEngine::MinimumRange - 1, 8, ranges);
+   EXPECT_EQ(ranges.size(), 1u);
+   ExpectContiguous(ranges, 0, DownloadEngine::MinimumRange - 1);
+}
+
+TEST(WPEFramework_DownloadEngine, splitResumedRanges)
+{
+   std::vector<DownloadEngine::Range> ranges;
+
+   // A resumed download only divides what is left, also beyond the 4GB a 32 bits offset reaches.
+   const uint64_t offset = 5ULL * 1024 * 1024 * 1024;
+   const uint64_t size = offset + (6 * DownloadEngine::MinimumRange);
+
+   DownloadEngine::Split(offset, size, 3, ranges);
+   ASSERT_EQ(ranges.size(), 3u);
+   EXPECT_EQ(ranges[1]._begin, offset + (2 * DownloadEngine::MinimumRange));
+   ExpectContiguous(ranges, offset, size);
+
+   // Only the part that is left counts for the minimum.
+   DownloadEngine::Split(offset, offset + DownloadEngine::MinimumRange, 4, ranges);
+   ASSERT_EQ(ranges.size(), 1u);
+   EXPECT_EQ(ranges[0]._begin, offset);
+   EXPECT_EQ(ranges[0]._length, static_cast<uint64_t>(DownloadEngine::MinimumRange));
+
+   // Complete already, a single empty range remains.
+   DownloadEngine::Split(size, size, 4, ranges);
+   ASSERT_EQ(ranges.size(), 1u);
+   EXPECT_EQ(ranges[0]._begin, size);
+   EXPECT_EQ(ranges[0]._length, 0u);
+}
+
+TEST(WPEFramework_DownloadEngine, checkpointOffsets)
+{
+   const uint64_t offset = 3ULL * 1024 * 1024 * 1024;
+   uint8_t hash[Crypto::HASH_SHA256];
+   uint8_t other[Crypto::HASH_SHA256];
+   const uint8_t data[] = "The first part of the firmware";
+
+   ::memset(hash, 0x11, sizeof(hash));
+   ::memset(other, 0x22, sizeof(other));
+
+   DownloadEngine::Checkpoint checkpoint(g_checkpointName);
+   checkpoint.Destroy();
+
+   Crypto::SHA256 hashed(data, sizeof(data));
+   Crypto::SHA256::Context context;
+
+   // No checkpoint, start at the beginning.
+   EXPECT_EQ(checkpoint.Load(g_source, hash, context), 0u);
+
+   ASSERT_TRUE(checkpoint.Save(g_source, hash, offset, hashed.State()));
+
+   // Only the same source and hash continue where the previous attempt was.
+   EXPECT_EQ(checkpoint.Load(g_source, other, context), 0u);
+   EXPECT_EQ(checkpoint.Load(string(g_source) + _T("?v=2"), hash, context), 0u);
+   EXPECT_EQ(checkpoint.Load(_T("http://127.0.0.2/firmware.bin"), hash, context), 0u);
+
+   ::memset(&context, 0, sizeof(context));
+   EXPECT_EQ(checkpoint.Load(g_source, hash, context), offset);
+
+   // The restored state continues the hash as if it never stopped.
+   const uint8_t tail[] = "and the rest of it";
+   Crypto::SHA256 restored;
+   restored.State(context);
+   restored.Input(tail, sizeof(tail));
+   hashed.Input(tail, sizeof(tail));
+   EXPECT_EQ(::memcmp(restored.Result(), hashed.Result(), Crypto::SHA256::Length), 0);
+
+   // A later checkpoint replaces the earlier one.
+   ASSERT_TRUE(checkpoint.Save(g_source, hash, offset + 4096, context));
+   EXPECT_EQ(checkpoint.Load(g_source, hash, context), offset + 4096);
+
+   // A cut off checkpoint is no checkpoint.
+   {
+      Core::File file(checkpoint.Name());
+      ASSERT_TRUE(file.Open(false));
+      EXPECT_TRUE(file.SetSize(16));
+      file.Close();
+   }
+   EXPECT_EQ(checkpoint.Load(g_source, hash, context), 0u);
+
+   checkpoint.Destroy();
+}
+
+TEST(WPEFramework_DownloadEngine, seekBeyond2GB)
+{
+   const char name[] = "/tmp/downloadengine02";
+   const uint64_t offset = (3ULL * 1024 * 1024 * 1024) + 7;
+   const uint8_t marker = 0x5A;
+   uint8_t value = 0;
+
+   Core::File file(name, true);
+   ASSERT_TRUE(file.Create());
+
+   // A sparse file, the offset would wrap to a negative 32 bits position.
+   ASSERT_TRUE(file.Seek(offset));
+   EXPECT_EQ(file.Write(&marker, 1), 1u);
+   file.Close();
+
+   ASSERT_TRUE(file.Open(true));
+   EXPECT_EQ(file.Size(), offset + 1);
+   ASSERT_TRUE(file.Seek(offset));
+   EXPECT_EQ(file.Read(&value, 1), 1u);
+   EXPECT_EQ(value, marker);
+   file.Destroy();
+
+   Core::Singleton::Dispose();
+}
@@ -899,7 +899,8 @@ def GenerateStubs(output_file, source_file, defaults = "", scan_only = False):
                                     proxy_params += 1
                                 if not p.obj and p.is_ptr:
                                     if p.is_input:
-                                        emit.Line("writer.%s(%s, param%i);" % (p.RpcType(), p.length_expr, c))
+                                        # the caller waits for the call to complete, so large buffers are sent straight from its memory
+                                        emit.Line("writer.%s(%s, param%i);" % (p.RpcType().replace("Buffer<", "Reference<"), p.length_expr, c))
                                 elif not p.is_input and p.is_nonconstref and p.is_nonconstptr:
                                     pass
                                 elif (not p.is_length or not params[p.length_target].is_input or p.is_maxlength) and (p.is_input or (not p.is_nonconstref and not p.is_nonconstptr) or p.obj):